@@ -0,0 +1,826 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class InterpreterCacheBenchmark {
+    // Define 384 fields, read by the large loop below. Each iget of the loop
+    // is a separate entry of the interpreter cache, and the loop spans more
+    // than the 256 entries of the first level of the cache, so without a
+    // second level every iteration misses on many of them.
+    public int field_0000 = 0;
+    public int field_0001 = 1;
+    public int field_0002 = 2;
+    public int field_0003 = 3;
+    public int field_0004 = 4;
+    public int field_0005 = 5;
+    public int field_0006 = 6;
+    public int field_0007 = 7;
+    public int field_0008 = 8;
+    public int field_0009 = 9;
+    public int field_0010 = 10;
+    public int field_0011 = 11;
+    public int field_0012 = 12;
+    public int field_0013 = 13;
+    public int field_0014 = 14;
+    public int field_0015 = 15;
+    public int field_0016 = 16;
+    public int field_0017 = 17;
+    public int field_0018 = 18;
+    public int field_0019 = 19;
+    public int field_0020 = 20;
+    public int field_0021 = 21;
+    public int field_0022 = 22;
+    public int field_0023 = 23;
+    public int field_0024 = 24;
+    public int field_0025 = 25;
+    public int field_0026 = 26;
+    public int field_0027 = 27;
+    public int field_0028 = 28;
+    public int field_0029 = 29;
+    public int field_0030 = 30;
+    public int field_0031 = 31;
+    public int field_0032 = 32;
+    public int field_0033 = 33;
+    public int field_0034 = 34;
+    public int field_0035 = 35;
+    public int field_0036 = 36;
+    public int field_0037 = 37;
+    public int field_0038 = 38;
+    public int field_0039 = 39;
+    public int field_0040 = 40;
+    public int field_0041 = 41;
+    public int field_0042 = 42;
+    public int field_0043 = 43;
+    public int field_0044 = 44;
+    public int field_0045 = 45;
+    public int field_0046 = 46;
+    public int field_0047 = 47;
+    public int field_0048 = 48;
+    public int field_0049 = 49;
+    public int field_0050 = 50;
+    public int field_0051 = 51;
+    public int field_0052 = 52;
+    public int field_0053 = 53;
+    public int field_0054 = 54;
+    public int field_0055 = 55;
+    public int field_0056 = 56;
+    public int field_0057 = 57;
+    public int field_0058 = 58;
+    public int field_0059 = 59;
+    public int field_0060 = 60;
+    public int field_0061 = 61;
+    public int field_0062 = 62;
+    public int field_0063 = 63;
+    public int field_0064 = 64;
+    public int field_0065 = 65;
+    public int field_0066 = 66;
+    public int field_0067 = 67;
+    public int field_0068 = 68;
+    public int field_0069 = 69;
+    public int field_0070 = 70;
+    public int field_0071 = 71;
+    public int field_0072 = 72;
+    public int field_0073 = 73;
+    public int field_0074 = 74;
+    public int field_0075 = 75;
+    public int field_0076 = 76;
+    public int field_0077 = 77;
+    public int field_0078 = 78;
+    public int field_0079 = 79;
+    public int field_0080 = 80;
+    public int field_0081 = 81;
+    public int field_0082 = 82;
+    public int field_0083 = 83;
+    public int field_0084 = 84;
+    public int field_0085 = 85;
+    public int field_0086 = 86;
+    public int field_0087 = 87;
+    public int field_0088 = 88;
+    public int field_0089 = 89;
+    public int field_0090 = 90;
+    public int field_0091 = 91;
+    public int field_0092 = 92;
+    public int field_0093 = 93;
+    public int field_0094 = 94;
+    public int field_0095 = 95;
+    public int field_0096 = 96;
+    public int field_0097 = 97;
+    public int field_0098 = 98;
+    public int field_0099 = 99;
+    public int field_0100 = 100;
+    public int field_0101 = 101;
+    public int field_0102 = 102;
+    public int field_0103 = 103;
+    public int field_0104 = 104;
+    public int field_0105 = 105;
+    public int field_0106 = 106;
+    public int field_0107 = 107;
+    public int field_0108 = 108;
+    public int field_0109 = 109;
+    public int field_0110 = 110;
+    public int field_0111 = 111;
+    public int field_0112 = 112;
+    public int field_0113 = 113;
+    public int field_0114 = 114;
+    public int field_0115 = 115;
+    public int field_0116 = 116;
+    public int field_0117 = 117;
+    public int field_0118 = 118;
+    public int field_0119 = 119;
+    public int field_0120 = 120;
+    public int field_0121 = 121;
+    public int field_0122 = 122;
+    public int field_0123 = 123;
+    public int field_0124 = 124;
+    public int field_0125 = 125;
+    public int field_0126 = 126;
+    public int field_0127 = 127;
+    public int field_0128 = 128;
+    public int field_0129 = 129;
+    public int field_0130 = 130;
+    public int field_0131 = 131;
+    public int field_0132 = 132;
+    public int field_0133 = 133;
+    public int field_0134 = 134;
+    public int field_0135 = 135;
+    public int field_0136 = 136;
+    public int field_0137 = 137;
+    public int field_0138 = 138;
+    public int field_0139 = 139;
+    public int field_0140 = 140;
+    public int field_0141 = 141;
+    public int field_0142 = 142;
+    public int field_0143 = 143;
+    public int field_0144 = 144;
+    public int field_0145 = 145;
+    public int field_0146 = 146;
+    public int field_0147 = 147;
+    public int field_0148 = 148;
+    public int field_0149 = 149;
+    public int field_0150 = 150;
+    public int field_0151 = 151;
+    public int field_0152 = 152;
+    public int field_0153 = 153;
+    public int field_0154 = 154;
+    public int field_0155 = 155;
+    public int field_0156 = 156;
+    public int field_0157 = 157;
+    public int field_0158 = 158;
+    public int field_0159 = 159;
+    public int field_0160 = 160;
+    public int field_0161 = 161;
+    public int field_0162 = 162;
+    public int field_0163 = 163;
+    public int field_0164 = 164;
+    public int field_0165 = 165;
+    public int field_0166 = 166;
+    public int field_0167 = 167;
+    public int field_0168 = 168;
+    public int field_0169 = 169;
+    public int field_0170 = 170;
+    public int field_0171 = 171;
+    public int field_0172 = 172;
+    public int field_0173 = 173;
+    public int field_0174 = 174;
+    public int field_0175 = 175;
+    public int field_0176 = 176;
+    public int field_0177 = 177;
+    public int field_0178 = 178;
+    public int field_0179 = 179;
+    public int field_0180 = 180;
+    public int field_0181 = 181;
+    public int field_0182 = 182;
+    public int field_0183 = 183;
+    public int field_0184 = 184;
+    public int field_0185 = 185;
+    public int field_0186 = 186;
+    public int field_0187 = 187;
+    public int field_0188 = 188;
+    public int field_0189 = 189;
+    public int field_0190 = 190;
+    public int field_0191 = 191;
+    public int field_0192 = 192;
+    public int field_0193 = 193;
+    public int field_0194 = 194;
+    public int field_0195 = 195;
+    public int field_0196 = 196;
+    public int field_0197 = 197;
+    public int field_0198 = 198;
+    public int field_0199 = 199;
+    public int field_0200 = 200;
+    public int field_0201 = 201;
+    public int field_0202 = 202;
+    public int field_0203 = 203;
+    public int field_0204 = 204;
+    public int field_0205 = 205;
+    public int field_0206 = 206;
+    public int field_0207 = 207;
+    public int field_0208 = 208;
+    public int field_0209 = 209;
+    public int field_0210 = 210;
+    public int field_0211 = 211;
+    public int field_0212 = 212;
+    public int field_0213 = 213;
+    public int field_0214 = 214;
+    public int field_0215 = 215;
+    public int field_0216 = 216;
+    public int field_0217 = 217;
+    public int field_0218 = 218;
+    public int field_0219 = 219;
+    public int field_0220 = 220;
+    public int field_0221 = 221;
+    public int field_0222 = 222;
+    public int field_0223 = 223;
+    public int field_0224 = 224;
+    public int field_0225 = 225;
+    public int field_0226 = 226;
+    public int field_0227 = 227;
+    public int field_0228 = 228;
+    public int field_0229 = 229;
+    public int field_0230 = 230;
+    public int field_0231 = 231;
+    public int field_0232 = 232;
+    public int field_0233 = 233;
+    public int field_0234 = 234;
+    public int field_0235 = 235;
+    public int field_0236 = 236;
+    public int field_0237 = 237;
+    public int field_0238 = 238;
+    public int field_0239 = 239;
+    public int field_0240 = 240;
+    public int field_0241 = 241;
+    public int field_0242 = 242;
+    public int field_0243 = 243;
+    public int field_0244 = 244;
+    public int field_0245 = 245;
+    public int field_0246 = 246;
+    public int field_0247 = 247;
+    public int field_0248 = 248;
+    public int field_0249 = 249;
+    public int field_0250 = 250;
+    public int field_0251 = 251;
+    public int field_0252 = 252;
+    public int field_0253 = 253;
+    public int field_0254 = 254;
+    public int field_0255 = 255;
+    public int field_0256 = 256;
+    public int field_0257 = 257;
+    public int field_0258 = 258;
+    public int field_0259 = 259;
+    public int field_0260 = 260;
+    public int field_0261 = 261;
+    public int field_0262 = 262;
+    public int field_0263 = 263;
+    public int field_0264 = 264;
+    public int field_0265 = 265;
+    public int field_0266 = 266;
+    public int field_0267 = 267;
+    public int field_0268 = 268;
+    public int field_0269 = 269;
+    public int field_0270 = 270;
+    public int field_0271 = 271;
+    public int field_0272 = 272;
+    public int field_0273 = 273;
+    public int field_0274 = 274;
+    public int field_0275 = 275;
+    public int field_0276 = 276;
+    public int field_0277 = 277;
+    public int field_0278 = 278;
+    public int field_0279 = 279;
+    public int field_0280 = 280;
+    public int field_0281 = 281;
+    public int field_0282 = 282;
+    public int field_0283 = 283;
+    public int field_0284 = 284;
+    public int field_0285 = 285;
+    public int field_0286 = 286;
+    public int field_0287 = 287;
+    public int field_0288 = 288;
+    public int field_0289 = 289;
+    public int field_0290 = 290;
+    public int field_0291 = 291;
+    public int field_0292 = 292;
+    public int field_0293 = 293;
+    public int field_0294 = 294;
+    public int field_0295 = 295;
+    public int field_0296 = 296;
+    public int field_0297 = 297;
+    public int field_0298 = 298;
+    public int field_0299 = 299;
+    public int field_0300 = 300;
+    public int field_0301 = 301;
+    public int field_0302 = 302;
+    public int field_0303 = 303;
+    public int field_0304 = 304;
+    public int field_0305 = 305;
+    public int field_0306 = 306;
+    public int field_0307 = 307;
+    public int field_0308 = 308;
+    public int field_0309 = 309;
+    public int field_0310 = 310;
+    public int field_0311 = 311;
+    public int field_0312 = 312;
+    public int field_0313 = 313;
+    public int field_0314 = 314;
+    public int field_0315 = 315;
+    public int field_0316 = 316;
+    public int field_0317 = 317;
+    public int field_0318 = 318;
+    public int field_0319 = 319;
+    public int field_0320 = 320;
+    public int field_0321 = 321;
+    public int field_0322 = 322;
+    public int field_0323 = 323;
+    public int field_0324 = 324;
+    public int field_0325 = 325;
+    public int field_0326 = 326;
+    public int field_0327 = 327;
+    public int field_0328 = 328;
+    public int field_0329 = 329;
+    public int field_0330 = 330;
+    public int field_0331 = 331;
+    public int field_0332 = 332;
+    public int field_0333 = 333;
+    public int field_0334 = 334;
+    public int field_0335 = 335;
+    public int field_0336 = 336;
+    public int field_0337 = 337;
+    public int field_0338 = 338;
+    public int field_0339 = 339;
+    public int field_0340 = 340;
+    public int field_0341 = 341;
+    public int field_0342 = 342;
+    public int field_0343 = 343;
+    public int field_0344 = 344;
+    public int field_0345 = 345;
+    public int field_0346 = 346;
+    public int field_0347 = 347;
+    public int field_0348 = 348;
+    public int field_0349 = 349;
+    public int field_0350 = 350;
+    public int field_0351 = 351;
+    public int field_0352 = 352;
+    public int field_0353 = 353;
+    public int field_0354 = 354;
+    public int field_0355 = 355;
+    public int field_0356 = 356;
+    public int field_0357 = 357;
+    public int field_0358 = 358;
+    public int field_0359 = 359;
+    public int field_0360 = 360;
+    public int field_0361 = 361;
+    public int field_0362 = 362;
+    public int field_0363 = 363;
+    public int field_0364 = 364;
+    public int field_0365 = 365;
+    public int field_0366 = 366;
+    public int field_0367 = 367;
+    public int field_0368 = 368;
+    public int field_0369 = 369;
+    public int field_0370 = 370;
+    public int field_0371 = 371;
+    public int field_0372 = 372;
+    public int field_0373 = 373;
+    public int field_0374 = 374;
+    public int field_0375 = 375;
+    public int field_0376 = 376;
+    public int field_0377 = 377;
+    public int field_0378 = 378;
+    public int field_0379 = 379;
+    public int field_0380 = 380;
+    public int field_0381 = 381;
+    public int field_0382 = 382;
+    public int field_0383 = 383;
+
+    public void timeLargeLoop(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += field_0000;
+            sum += field_0001;
+            sum += field_0002;
+            sum += field_0003;
+            sum += field_0004;
+            sum += field_0005;
+            sum += field_0006;
+            sum += field_0007;
+            sum += field_0008;
+            sum += field_0009;
+            sum += field_0010;
+            sum += field_0011;
+            sum += field_0012;
+            sum += field_0013;
+            sum += field_0014;
+            sum += field_0015;
+            sum += field_0016;
+            sum += field_0017;
+            sum += field_0018;
+            sum += field_0019;
+            sum += field_0020;
+            sum += field_0021;
+            sum += field_0022;
+            sum += field_0023;
+            sum += field_0024;
+            sum += field_0025;
+            sum += field_0026;
+            sum += field_0027;
+            sum += field_0028;
+            sum += field_0029;
+            sum += field_0030;
+            sum += field_0031;
+            sum += field_0032;
+            sum += field_0033;
+            sum += field_0034;
+            sum += field_0035;
+            sum += field_0036;
+            sum += field_0037;
+            sum += field_0038;
+            sum += field_0039;
+            sum += field_0040;
+            sum += field_0041;
+            sum += field_0042;
+            sum += field_0043;
+            sum += field_0044;
+            sum += field_0045;
+            sum += field_0046;
+            sum += field_0047;
+            sum += field_0048;
+            sum += field_0049;
+            sum += field_0050;
+            sum += field_0051;
+            sum += field_0052;
+            sum += field_0053;
+            sum += field_0054;
+            sum += field_0055;
+            sum += field_0056;
+            sum += field_0057;
+            sum += field_0058;
+            sum += field_0059;
+            sum += field_0060;
+            sum += field_0061;
+            sum += field_0062;
+            sum += field_0063;
+            sum += field_0064;
+            sum += field_0065;
+            sum += field_0066;
+            sum += field_0067;
+            sum += field_0068;
+            sum += field_0069;
+            sum += field_0070;
+            sum += field_0071;
+            sum += field_0072;
+            sum += field_0073;
+            sum += field_0074;
+            sum += field_0075;
+            sum += field_0076;
+            sum += field_0077;
+            sum += field_0078;
+            sum += field_0079;
+            sum += field_0080;
+            sum += field_0081;
+            sum += field_0082;
+            sum += field_0083;
+            sum += field_0084;
+            sum += field_0085;
+            sum += field_0086;
+            sum += field_0087;
+            sum += field_0088;
+            sum += field_0089;
+            sum += field_0090;
+            sum += field_0091;
+            sum += field_0092;
+            sum += field_0093;
+            sum += field_0094;
+            sum += field_0095;
+            sum += field_0096;
+            sum += field_0097;
+            sum += field_0098;
+            sum += field_0099;
+            sum += field_0100;
+            sum += field_0101;
+            sum += field_0102;
+            sum += field_0103;
+            sum += field_0104;
+            sum += field_0105;
+            sum += field_0106;
+            sum += field_0107;
+            sum += field_0108;
+            sum += field_0109;
+            sum += field_0110;
+            sum += field_0111;
+            sum += field_0112;
+            sum += field_0113;
+            sum += field_0114;
+            sum += field_0115;
+            sum += field_0116;
+            sum += field_0117;
+            sum += field_0118;
+            sum += field_0119;
+            sum += field_0120;
+            sum += field_0121;
+            sum += field_0122;
+            sum += field_0123;
+            sum += field_0124;
+            sum += field_0125;
+            sum += field_0126;
+            sum += field_0127;
+            sum += field_0128;
+            sum += field_0129;
+            sum += field_0130;
+            sum += field_0131;
+            sum += field_0132;
+            sum += field_0133;
+            sum += field_0134;
+            sum += field_0135;
+            sum += field_0136;
+            sum += field_0137;
+            sum += field_0138;
+            sum += field_0139;
+            sum += field_0140;
+            sum += field_0141;
+            sum += field_0142;
+            sum += field_0143;
+            sum += field_0144;
+            sum += field_0145;
+            sum += field_0146;
+            sum += field_0147;
+            sum += field_0148;
+            sum += field_0149;
+            sum += field_0150;
+            sum += field_0151;
+            sum += field_0152;
+            sum += field_0153;
+            sum += field_0154;
+            sum += field_0155;
+            sum += field_0156;
+            sum += field_0157;
+            sum += field_0158;
+            sum += field_0159;
+            sum += field_0160;
+            sum += field_0161;
+            sum += field_0162;
+            sum += field_0163;
+            sum += field_0164;
+            sum += field_0165;
+            sum += field_0166;
+            sum += field_0167;
+            sum += field_0168;
+            sum += field_0169;
+            sum += field_0170;
+            sum += field_0171;
+            sum += field_0172;
+            sum += field_0173;
+            sum += field_0174;
+            sum += field_0175;
+            sum += field_0176;
+            sum += field_0177;
+            sum += field_0178;
+            sum += field_0179;
+            sum += field_0180;
+            sum += field_0181;
+            sum += field_0182;
+            sum += field_0183;
+            sum += field_0184;
+            sum += field_0185;
+            sum += field_0186;
+            sum += field_0187;
+            sum += field_0188;
+            sum += field_0189;
+            sum += field_0190;
+            sum += field_0191;
+            sum += field_0192;
+            sum += field_0193;
+            sum += field_0194;
+            sum += field_0195;
+            sum += field_0196;
+            sum += field_0197;
+            sum += field_0198;
+            sum += field_0199;
+            sum += field_0200;
+            sum += field_0201;
+            sum += field_0202;
+            sum += field_0203;
+            sum += field_0204;
+            sum += field_0205;
+            sum += field_0206;
+            sum += field_0207;
+            sum += field_0208;
+            sum += field_0209;
+            sum += field_0210;
+            sum += field_0211;
+            sum += field_0212;
+            sum += field_0213;
+            sum += field_0214;
+            sum += field_0215;
+            sum += field_0216;
+            sum += field_0217;
+            sum += field_0218;
+            sum += field_0219;
+            sum += field_0220;
+            sum += field_0221;
+            sum += field_0222;
+            sum += field_0223;
+            sum += field_0224;
+            sum += field_0225;
+            sum += field_0226;
+            sum += field_0227;
+            sum += field_0228;
+            sum += field_0229;
+            sum += field_0230;
+            sum += field_0231;
+            sum += field_0232;
+            sum += field_0233;
+            sum += field_0234;
+            sum += field_0235;
+            sum += field_0236;
+            sum += field_0237;
+            sum += field_0238;
+            sum += field_0239;
+            sum += field_0240;
+            sum += field_0241;
+            sum += field_0242;
+            sum += field_0243;
+            sum += field_0244;
+            sum += field_0245;
+            sum += field_0246;
+            sum += field_0247;
+            sum += field_0248;
+            sum += field_0249;
+            sum += field_0250;
+            sum += field_0251;
+            sum += field_0252;
+            sum += field_0253;
+            sum += field_0254;
+            sum += field_0255;
+            sum += field_0256;
+            sum += field_0257;
+            sum += field_0258;
+            sum += field_0259;
+            sum += field_0260;
+            sum += field_0261;
+            sum += field_0262;
+            sum += field_0263;
+            sum += field_0264;
+            sum += field_0265;
+            sum += field_0266;
+            sum += field_0267;
+            sum += field_0268;
+            sum += field_0269;
+            sum += field_0270;
+            sum += field_0271;
+            sum += field_0272;
+            sum += field_0273;
+            sum += field_0274;
+            sum += field_0275;
+            sum += field_0276;
+            sum += field_0277;
+            sum += field_0278;
+            sum += field_0279;
+            sum += field_0280;
+            sum += field_0281;
+            sum += field_0282;
+            sum += field_0283;
+            sum += field_0284;
+            sum += field_0285;
+            sum += field_0286;
+            sum += field_0287;
+            sum += field_0288;
+            sum += field_0289;
+            sum += field_0290;
+            sum += field_0291;
+            sum += field_0292;
+            sum += field_0293;
+            sum += field_0294;
+            sum += field_0295;
+            sum += field_0296;
+            sum += field_0297;
+            sum += field_0298;
+            sum += field_0299;
+            sum += field_0300;
+            sum += field_0301;
+            sum += field_0302;
+            sum += field_0303;
+            sum += field_0304;
+            sum += field_0305;
+            sum += field_0306;
+            sum += field_0307;
+            sum += field_0308;
+            sum += field_0309;
+            sum += field_0310;
+            sum += field_0311;
+            sum += field_0312;
+            sum += field_0313;
+            sum += field_0314;
+            sum += field_0315;
+            sum += field_0316;
+            sum += field_0317;
+            sum += field_0318;
+            sum += field_0319;
+            sum += field_0320;
+            sum += field_0321;
+            sum += field_0322;
+            sum += field_0323;
+            sum += field_0324;
+            sum += field_0325;
+            sum += field_0326;
+            sum += field_0327;
+            sum += field_0328;
+            sum += field_0329;
+            sum += field_0330;
+            sum += field_0331;
+            sum += field_0332;
+            sum += field_0333;
+            sum += field_0334;
+            sum += field_0335;
+            sum += field_0336;
+            sum += field_0337;
+            sum += field_0338;
+            sum += field_0339;
+            sum += field_0340;
+            sum += field_0341;
+            sum += field_0342;
+            sum += field_0343;
+            sum += field_0344;
+            sum += field_0345;
+            sum += field_0346;
+            sum += field_0347;
+            sum += field_0348;
+            sum += field_0349;
+            sum += field_0350;
+            sum += field_0351;
+            sum += field_0352;
+            sum += field_0353;
+            sum += field_0354;
+            sum += field_0355;
+            sum += field_0356;
+            sum += field_0357;
+            sum += field_0358;
+            sum += field_0359;
+            sum += field_0360;
+            sum += field_0361;
+            sum += field_0362;
+            sum += field_0363;
+            sum += field_0364;
+            sum += field_0365;
+            sum += field_0366;
+            sum += field_0367;
+            sum += field_0368;
+            sum += field_0369;
+            sum += field_0370;
+            sum += field_0371;
+            sum += field_0372;
+            sum += field_0373;
+            sum += field_0374;
+            sum += field_0375;
+            sum += field_0376;
+            sum += field_0377;
+            sum += field_0378;
+            sum += field_0379;
+            sum += field_0380;
+            sum += field_0381;
+            sum += field_0382;
+            sum += field_0383;
+        }
+        $noinline$foo(sum);
+    }
+
+    public void timeSmallLoop(int count) {
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += field_0000;
+            sum += field_0001;
+            sum += field_0002;
+            sum += field_0003;
+            sum += field_0004;
+            sum += field_0005;
+            sum += field_0006;
+            sum += field_0007;
+            sum += field_0008;
+            sum += field_0009;
+            sum += field_0010;
+            sum += field_0011;
+            sum += field_0012;
+            sum += field_0013;
+            sum += field_0014;
+            sum += field_0015;
+        }
+        $noinline$foo(sum);
+    }
+
+    static void $noinline$foo(int sum) {
+        if (doThrow) { throw new Error(); }
+    }
+
+    public static boolean doThrow = false;
+}
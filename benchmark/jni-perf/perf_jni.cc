@@ -17,6 +17,7 @@
 #include <assert.h>
 
 #include "jni.h"
+#include "jni/art_jni_extensions.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
 
@@ -34,6 +35,94 @@ extern "C" JNIEXPORT void JNICALL Java_JniPerfBenchmark_perfSOAUncheckedCall(JNI
   ScopedObjectAccessUnchecked soa(Thread::Current());
 }
 
+// The bulk access functions below sum what they read, so that each one touches every byte
+// of its string or array, as a native parser or checksum would.
+
+template <typename T>
+jint Sum(const T* data, jsize length) {
+  jint sum = 0;
+  for (jsize i = 0; i != length; ++i) {
+    sum += data[i];
+  }
+  return sum;
+}
+
+const ArtJniExtensions* GetArtJniExtensions(JNIEnv* env) {
+  JavaVM* vm = nullptr;
+  env->GetJavaVM(&vm);
+  const ArtJniExtensions* ext = nullptr;
+  if (vm->GetEnv(reinterpret_cast<void**>(&ext), ART_JNI_EXTENSIONS_VERSION) != JNI_OK) {
+    return nullptr;
+  }
+  return ext;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfGetStringCritical(
+    JNIEnv* env, jclass, jint reps, jstring s) {
+  jint sum = 0;
+  jsize length = env->GetStringLength(s);
+  for (jint i = 0; i < reps; ++i) {
+    const jchar* chars = env->GetStringCritical(s, nullptr);
+    sum += Sum(chars, length);
+    env->ReleaseStringCritical(s, chars);
+  }
+  return sum;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfGetStringUTFChars(
+    JNIEnv* env, jclass, jint reps, jstring s) {
+  jint sum = 0;
+  jsize length = env->GetStringUTFLength(s);
+  for (jint i = 0; i < reps; ++i) {
+    const char* utf = env->GetStringUTFChars(s, nullptr);
+    sum += Sum(utf, length);
+    env->ReleaseStringUTFChars(s, utf);
+  }
+  return sum;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfGetStringCriticalView(
+    JNIEnv* env, jclass, jint reps, jstring s) {
+  const ArtJniExtensions* ext = GetArtJniExtensions(env);
+  assert(ext != nullptr);
+  jint sum = 0;
+  for (jint i = 0; i < reps; ++i) {
+    jsize length = 0;
+    jboolean is_latin1 = JNI_FALSE;
+    const void* view = ext->GetStringCriticalView(env, s, &length, &is_latin1);
+    sum += (is_latin1 == JNI_TRUE) ? Sum(reinterpret_cast<const uint8_t*>(view), length)
+                                   : Sum(reinterpret_cast<const jchar*>(view), length);
+    ext->ReleaseStringCriticalView(env, s, view);
+  }
+  return sum;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfGetPrimitiveArrayCritical(
+    JNIEnv* env, jclass, jint reps, jbyteArray array) {
+  jint sum = 0;
+  jsize length = env->GetArrayLength(array);
+  for (jint i = 0; i < reps; ++i) {
+    void* elements = env->GetPrimitiveArrayCritical(array, nullptr);
+    sum += Sum(reinterpret_cast<const jbyte*>(elements), length);
+    env->ReleasePrimitiveArrayCritical(array, elements, JNI_ABORT);
+  }
+  return sum;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_JniPerfBenchmark_perfGetPrimitiveArrayCriticalView(
+    JNIEnv* env, jclass, jint reps, jbyteArray array) {
+  const ArtJniExtensions* ext = GetArtJniExtensions(env);
+  assert(ext != nullptr);
+  jint sum = 0;
+  for (jint i = 0; i < reps; ++i) {
+    jsize length = 0;
+    const void* view = ext->GetPrimitiveArrayCriticalView(env, array, &length);
+    sum += Sum(reinterpret_cast<const jbyte*>(view), length);
+    ext->ReleasePrimitiveArrayCriticalView(env, array, view);
+  }
+  return sum;
+}
+
 }  // namespace
 
 }  // namespace art
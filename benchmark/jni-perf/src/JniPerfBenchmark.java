@@ -21,6 +21,28 @@ public class JniPerfBenchmark {
   native void perfSOACall();
   native void perfSOAUncheckedCall();
 
+  static native int perfGetStringCritical(int reps, String s);
+  static native int perfGetStringUTFChars(int reps, String s);
+  static native int perfGetStringCriticalView(int reps, String s);
+  static native int perfGetPrimitiveArrayCritical(int reps, byte[] array);
+  static native int perfGetPrimitiveArrayCriticalView(int reps, byte[] array);
+
+  // Every rep of the bulk access benchmarks below reads PAYLOAD_SIZE characters or bytes, so
+  // their throughput in bytes/sec is PAYLOAD_SIZE divided by the reported time per rep.
+  private static final int PAYLOAD_SIZE = 64 * 1024;
+  // All-ASCII, so stored compressed when string compression is enabled.
+  private static final String ASCII_PAYLOAD = makePayload('a');
+  private static final String UTF16_PAYLOAD = makePayload('\u00e9');
+  private static final byte[] ARRAY_PAYLOAD = new byte[PAYLOAD_SIZE];
+
+  private static String makePayload(char c) {
+    StringBuilder sb = new StringBuilder(PAYLOAD_SIZE);
+    for (int i = 0; i < PAYLOAD_SIZE; ++i) {
+      sb.append((char) (c + (i % 26)));
+    }
+    return sb.toString();
+  }
+
   public void timeFastJNI(int N) {
     // TODO: This might be an intrinsic.
     for (long i = 0; i < N; i++) {
@@ -46,6 +68,34 @@ public class JniPerfBenchmark {
     }
   }
 
+  public void timeGetStringCriticalAscii(int N) {
+    perfGetStringCritical(N, ASCII_PAYLOAD);
+  }
+
+  public void timeGetStringUTFCharsAscii(int N) {
+    perfGetStringUTFChars(N, ASCII_PAYLOAD);
+  }
+
+  public void timeGetStringCriticalViewAscii(int N) {
+    perfGetStringCriticalView(N, ASCII_PAYLOAD);
+  }
+
+  public void timeGetStringCriticalUtf16(int N) {
+    perfGetStringCritical(N, UTF16_PAYLOAD);
+  }
+
+  public void timeGetStringCriticalViewUtf16(int N) {
+    perfGetStringCriticalView(N, UTF16_PAYLOAD);
+  }
+
+  public void timeGetPrimitiveArrayCritical(int N) {
+    perfGetPrimitiveArrayCritical(N, ARRAY_PAYLOAD);
+  }
+
+  public void timeGetPrimitiveArrayCriticalView(int N) {
+    perfGetPrimitiveArrayCriticalView(N, ARRAY_PAYLOAD);
+  }
+
   {
     System.loadLibrary("artbenchmark");
   }
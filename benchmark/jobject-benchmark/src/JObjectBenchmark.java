@@ -15,7 +15,7 @@
  */
 
 public class JObjectBenchmark {
-  public JObjectBenchmark() {
+  public JObjectBenchmark() throws InterruptedException {
     // Make sure to link methods before benchmark starts.
     System.loadLibrary("artbenchmark");
     timeAddRemoveLocal(1);
@@ -25,6 +25,39 @@ public class JObjectBenchmark {
     timeAddRemoveWeakGlobal(1);
     timeDecodeWeakGlobal(1);
     timeDecodeHandleScopeRef(1);
+    timeAddRemoveGlobalFromThreads(1);
+    timeAddRemoveWeakGlobalFromThreads(1);
+  }
+
+  private static final int NUM_THREADS = 4;
+
+  // Global reference churn from several threads at once, as done by native libraries
+  // that cache callbacks or objects across threads.
+  public void timeAddRemoveGlobalFromThreads(final int reps) throws InterruptedException {
+    runOnThreads(new Runnable() {
+      public void run() {
+        timeAddRemoveGlobal(reps);
+      }
+    });
+  }
+
+  public void timeAddRemoveWeakGlobalFromThreads(final int reps) throws InterruptedException {
+    runOnThreads(new Runnable() {
+      public void run() {
+        timeAddRemoveWeakGlobal(reps);
+      }
+    });
+  }
+
+  private static void runOnThreads(Runnable runnable) throws InterruptedException {
+    Thread[] threads = new Thread[NUM_THREADS];
+    for (int i = 0; i < NUM_THREADS; ++i) {
+      threads[i] = new Thread(runnable);
+      threads[i].start();
+    }
+    for (Thread thread : threads) {
+      thread.join();
+    }
   }
 
   public native void timeAddRemoveLocal(int reps);
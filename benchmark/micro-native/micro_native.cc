@@ -17,6 +17,8 @@
 #include <jni.h>
 #include <stdio.h>
 
+#include "jni/art_jni_extensions.h"
+
 #ifndef NATIVE_METHOD
 #define NATIVE_METHOD(className, functionName, signature) \
     { #functionName, signature, reinterpret_cast<void*>(className ## _ ## functionName) }
@@ -96,6 +98,87 @@ static JNINativeMethod gMethods_Critical[] = {
         reinterpret_cast<void*>(NAME_CRITICAL_JNI_METHOD(emptyJniStaticMethod6_1Critical)) }
 };
 
+// Reading the `value` of each Integer of an array, the way native code walks a Java collection,
+// with the local references of the elements released one by one, by local frame, or by mark.
+// The batch size is the number of elements whose local references are held at once.
+
+static jfieldID gIntegerValue = nullptr;
+static const ArtJniExtensions* gArtJniExtensions = nullptr;
+
+static jint NativeMethods_sumIntegersDeleteLocalRef(JNIEnv* env, jclass, jobjectArray array,
+                                                    jint) {
+  jint sum = 0;
+  jsize length = env->GetArrayLength(array);
+  for (jsize i = 0; i != length; ++i) {
+    jobject element = env->GetObjectArrayElement(array, i);
+    sum += env->GetIntField(element, gIntegerValue);
+    env->DeleteLocalRef(element);
+  }
+  return sum;
+}
+
+static jint NativeMethods_sumIntegersLocalFrame(JNIEnv* env, jclass, jobjectArray array,
+                                                jint batch) {
+  jint sum = 0;
+  jsize length = env->GetArrayLength(array);
+  for (jsize start = 0; start < length; start += batch) {
+    jsize end = (length - start < batch) ? length : start + batch;
+    env->PushLocalFrame(batch);
+    for (jsize i = start; i != end; ++i) {
+      sum += env->GetIntField(env->GetObjectArrayElement(array, i), gIntegerValue);
+    }
+    env->PopLocalFrame(nullptr);
+  }
+  return sum;
+}
+
+static jint NativeMethods_sumIntegersLocalRefMark(JNIEnv* env, jclass, jobjectArray array,
+                                                  jint batch) {
+  jint sum = 0;
+  jsize length = env->GetArrayLength(array);
+  jint mark = gArtJniExtensions->GetLocalRefMark(env);
+  for (jsize start = 0; start < length; start += batch) {
+    jsize end = (length - start < batch) ? length : start + batch;
+    for (jsize i = start; i != end; ++i) {
+      sum += env->GetIntField(env->GetObjectArrayElement(array, i), gIntegerValue);
+    }
+    gArtJniExtensions->ReleaseLocalRefsToMark(env, mark);
+  }
+  return sum;
+}
+
+static jint NativeMethods_sumIntegersBatched(JNIEnv* env, jclass, jobjectArray array,
+                                             jint batch) {
+  jobject elements[256];
+  jvalue values[256];
+  if (batch > 256) {
+    batch = 256;
+  }
+  jint sum = 0;
+  jsize length = env->GetArrayLength(array);
+  jint mark = gArtJniExtensions->GetLocalRefMark(env);
+  for (jsize start = 0; start < length; start += batch) {
+    jsize count = (length - start < batch) ? length - start : batch;
+    gArtJniExtensions->GetObjectArrayRegion(env, array, start, count, elements);
+    gArtJniExtensions->GetFieldOfObjects(env, gIntegerValue, count, elements, values);
+    for (jsize i = 0; i != count; ++i) {
+      sum += values[i].i;
+    }
+    gArtJniExtensions->ReleaseLocalRefsToMark(env, mark);
+  }
+  return sum;
+}
+
+static JNINativeMethod gMethods_LocalRefs[] = {
+  NATIVE_METHOD(NativeMethods, sumIntegersDeleteLocalRef, "([Ljava/lang/Integer;I)I"),
+  NATIVE_METHOD(NativeMethods, sumIntegersLocalFrame, "([Ljava/lang/Integer;I)I"),
+};
+
+static JNINativeMethod gMethods_ArtLocalRefs[] = {
+  NATIVE_METHOD(NativeMethods, sumIntegersLocalRefMark, "([Ljava/lang/Integer;I)I"),
+  NATIVE_METHOD(NativeMethods, sumIntegersBatched, "([Ljava/lang/Integer;I)I"),
+};
+
 void jniRegisterNativeMethods(JNIEnv* env,
                               const char* className,
                               const JNINativeMethod* methods,
@@ -143,4 +226,21 @@ void register_micro_native_methods(JNIEnv* env) {
     }
   }
   // else let them be registered implicitly.
+
+  // Only register the local reference benchmarks if the benchmark declares them.
+  jclass c = env->FindClass(CLASS_NAME);
+  if (env->GetStaticMethodID(c, "sumIntegersDeleteLocalRef", "([Ljava/lang/Integer;I)I") ==
+          nullptr) {
+    env->ExceptionClear();
+    return;
+  }
+  gIntegerValue = env->GetFieldID(env->FindClass("java/lang/Integer"), "value", "I");
+  jniRegisterNativeMethods(env, CLASS_NAME, gMethods_LocalRefs, NELEM(gMethods_LocalRefs));
+
+  JavaVM* vm;
+  env->GetJavaVM(&vm);
+  if (vm->GetEnv(reinterpret_cast<void**>(&gArtJniExtensions), ART_JNI_EXTENSIONS_VERSION) ==
+          JNI_OK) {
+    jniRegisterNativeMethods(env, CLASS_NAME, gMethods_ArtLocalRefs, NELEM(gMethods_ArtLocalRefs));
+  }
 }
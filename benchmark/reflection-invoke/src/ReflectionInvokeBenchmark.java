@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Constructor;
+import java.lang.reflect.Field;
+import java.lang.reflect.Method;
+
+public class ReflectionInvokeBenchmark {
+    public void timeDirectNoArgs(int count) {
+        Target target = this.target;
+        for (int i = 0; i < count; ++i) {
+            target.noArgs();
+        }
+    }
+
+    public void timeInvokeNoArgs(int count) throws Exception {
+        Target target = this.target;
+        Method method = noArgs;
+        for (int i = 0; i < count; ++i) {
+            method.invoke(target);
+        }
+    }
+
+    public void timeDirectInts(int count) {
+        Target target = this.target;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += target.sum(i, 1);
+        }
+        result = sum;
+    }
+
+    public void timeInvokeInts(int count) throws Exception {
+        Target target = this.target;
+        Method method = sum;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += (Integer) method.invoke(target, i, 1);
+        }
+        result = sum;
+    }
+
+    public void timeDirectWideningArgs(int count) {
+        double sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += Target.scale(i, (short) 2);
+        }
+        result = (int) sum;
+    }
+
+    public void timeInvokeWideningArgs(int count) throws Exception {
+        Method method = scale;
+        Short two = (short) 2;
+        double sum = 0;
+        for (int i = 0; i < count; ++i) {
+            // Integer to double and Short to long.
+            sum += (Double) method.invoke(null, i, two);
+        }
+        result = (int) sum;
+    }
+
+    public void timeDirectObjects(int count) {
+        Target target = this.target;
+        for (int i = 0; i < count; ++i) {
+            target.objects(target, "value");
+        }
+    }
+
+    public void timeInvokeObjects(int count) throws Exception {
+        Target target = this.target;
+        Method method = objects;
+        for (int i = 0; i < count; ++i) {
+            method.invoke(target, target, "value");
+        }
+    }
+
+    public void timeDirectPackagePrivate(int count) {
+        Target target = this.target;
+        for (int i = 0; i < count; ++i) {
+            target.packagePrivate();
+        }
+    }
+
+    public void timeInvokePackagePrivate(int count) throws Exception {
+        Target target = this.target;
+        Method method = packagePrivate;
+        for (int i = 0; i < count; ++i) {
+            method.invoke(target);
+        }
+    }
+
+    public void timeDirectNewInstance(int count) {
+        for (int i = 0; i < count; ++i) {
+            new Target("value");
+        }
+    }
+
+    public void timeNewInstance(int count) throws Exception {
+        Constructor<Target> constructor = init;
+        for (int i = 0; i < count; ++i) {
+            constructor.newInstance("value");
+        }
+    }
+
+    public void timeDirectFieldGet(int count) {
+        Target target = this.target;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += target.field;
+        }
+        result = sum;
+    }
+
+    public void timeFieldGet(int count) throws Exception {
+        Target target = this.target;
+        Field field = this.field;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += (Integer) field.get(target);
+        }
+        result = sum;
+    }
+
+    public void timeFieldGetInt(int count) throws Exception {
+        Target target = this.target;
+        Field field = this.field;
+        int sum = 0;
+        for (int i = 0; i < count; ++i) {
+            sum += field.getInt(target);
+        }
+        result = sum;
+    }
+
+    public void timeDirectFieldSet(int count) {
+        Target target = this.target;
+        for (int i = 0; i < count; ++i) {
+            target.field = i;
+        }
+    }
+
+    public void timeFieldSet(int count) throws Exception {
+        Target target = this.target;
+        Field field = this.field;
+        Integer value = 42;
+        for (int i = 0; i < count; ++i) {
+            field.set(target, value);
+        }
+    }
+
+    static class Target {
+        public int field;
+        public String name;
+
+        public Target(String name) {
+            this.name = name;
+        }
+
+        public void noArgs() {}
+
+        public int sum(int a, int b) {
+            return a + b;
+        }
+
+        public static double scale(double value, long factor) {
+            return value * factor;
+        }
+
+        public void objects(Object o, String s) {}
+
+        void packagePrivate() {}
+    }
+
+    Target target = new Target("target");
+    int result;
+
+    static final Method noArgs;
+    static final Method sum;
+    static final Method scale;
+    static final Method objects;
+    static final Method packagePrivate;
+    static final Constructor<Target> init;
+    static final Field field;
+
+    static {
+        try {
+            noArgs = Target.class.getDeclaredMethod("noArgs");
+            sum = Target.class.getDeclaredMethod("sum", int.class, int.class);
+            scale = Target.class.getDeclaredMethod("scale", double.class, long.class);
+            objects = Target.class.getDeclaredMethod("objects", Object.class, String.class);
+            packagePrivate = Target.class.getDeclaredMethod("packagePrivate");
+            init = Target.class.getDeclaredConstructor(String.class);
+            field = Target.class.getDeclaredField("field");
+        } catch (Exception e) {
+            throw new Error(e);
+        }
+    }
+}
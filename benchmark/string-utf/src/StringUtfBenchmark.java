@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Random;
+
+public class StringUtfBenchmark {
+  static native void measureAllocFromModifiedUtf8(int reps, String[] strings);
+  static native void measureToModifiedUtf8(int reps, String[] strings);
+  static native int measureComputeHashCode(int reps, String[] strings);
+  static native int measureHashFromModifiedUtf8(int reps, String[] strings);
+
+  private static final String ASCII =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_$/;.,: {}[]\"";
+  // Latin-1, CJK and a surrogate pair, the last two characters.
+  private static final String NON_ASCII = "\u00e9\u00fc\u00df\u4e2d\u6587\ud83d\ude00";
+
+  // Class, method and field names.
+  static String[] identifiers = makeStrings(64, 4, 32, 0);
+  // Log messages and short JSON values.
+  static String[] messages = makeStrings(32, 40, 200, 0);
+  // Large JSON or XML payloads.
+  static String[] documents = makeStrings(4, 1024, 8192, 0);
+  // Mostly-ASCII messages with about one non-ASCII character every 32 characters.
+  static String[] mixedMessages = makeStrings(32, 40, 200, 32);
+
+  private static String[] makeStrings(int count, int minLength, int maxLength, int nonAsciiEvery) {
+    Random random = new Random(42);
+    String[] strings = new String[count];
+    for (int i = 0; i < count; ++i) {
+      int length = minLength + random.nextInt(maxLength - minLength + 1);
+      StringBuilder sb = new StringBuilder(length);
+      while (sb.length() < length) {
+        if (nonAsciiEvery != 0 && random.nextInt(nonAsciiEvery) == 0) {
+          int index = random.nextInt(NON_ASCII.length() - 1);
+          if (Character.isHighSurrogate(NON_ASCII.charAt(index))) {
+            sb.append(NON_ASCII, index, index + 2);
+          } else {
+            sb.append(NON_ASCII.charAt(index));
+          }
+        } else {
+          sb.append(ASCII.charAt(random.nextInt(ASCII.length())));
+        }
+      }
+      strings[i] = sb.toString();
+    }
+    return strings;
+  }
+
+  public void timeAllocFromModifiedUtf8Identifiers(int reps) {
+    measureAllocFromModifiedUtf8(reps, identifiers);
+  }
+
+  public void timeAllocFromModifiedUtf8Messages(int reps) {
+    measureAllocFromModifiedUtf8(reps, messages);
+  }
+
+  public void timeAllocFromModifiedUtf8Documents(int reps) {
+    measureAllocFromModifiedUtf8(reps, documents);
+  }
+
+  public void timeAllocFromModifiedUtf8MixedMessages(int reps) {
+    measureAllocFromModifiedUtf8(reps, mixedMessages);
+  }
+
+  public void timeToModifiedUtf8Identifiers(int reps) {
+    measureToModifiedUtf8(reps, identifiers);
+  }
+
+  public void timeToModifiedUtf8Messages(int reps) {
+    measureToModifiedUtf8(reps, messages);
+  }
+
+  public void timeToModifiedUtf8Documents(int reps) {
+    measureToModifiedUtf8(reps, documents);
+  }
+
+  public void timeToModifiedUtf8MixedMessages(int reps) {
+    measureToModifiedUtf8(reps, mixedMessages);
+  }
+
+  public void timeComputeHashCodeIdentifiers(int reps) {
+    measureComputeHashCode(reps, identifiers);
+  }
+
+  public void timeComputeHashCodeMessages(int reps) {
+    measureComputeHashCode(reps, messages);
+  }
+
+  public void timeComputeHashCodeDocuments(int reps) {
+    measureComputeHashCode(reps, documents);
+  }
+
+  public void timeComputeHashCodeMixedMessages(int reps) {
+    measureComputeHashCode(reps, mixedMessages);
+  }
+
+  public void timeHashFromModifiedUtf8Identifiers(int reps) {
+    measureHashFromModifiedUtf8(reps, identifiers);
+  }
+
+  public void timeHashFromModifiedUtf8Messages(int reps) {
+    measureHashFromModifiedUtf8(reps, messages);
+  }
+
+  public void timeHashFromModifiedUtf8Documents(int reps) {
+    measureHashFromModifiedUtf8(reps, documents);
+  }
+
+  public void timeHashFromModifiedUtf8MixedMessages(int reps) {
+    measureHashFromModifiedUtf8(reps, mixedMessages);
+  }
+
+  {
+    System.loadLibrary("artbenchmark");
+  }
+}
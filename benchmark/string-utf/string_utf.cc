@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include "jni.h"
+
+#include "dex/utf.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+namespace {
+
+std::vector<std::string> ToModifiedUtf8(ScopedObjectAccess& soa, jobjectArray jstrings)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjPtr<mirror::ObjectArray<mirror::String>> strings =
+      soa.Decode<mirror::ObjectArray<mirror::String>>(jstrings);
+  std::vector<std::string> result;
+  for (int32_t i = 0; i < strings->GetLength(); ++i) {
+    result.push_back(strings->Get(i)->ToModifiedUtf8());
+  }
+  return result;
+}
+
+extern "C" JNIEXPORT void JNICALL Java_StringUtfBenchmark_measureAllocFromModifiedUtf8(
+    JNIEnv* env, jclass, jint reps, jobjectArray jstrings) {
+  ScopedObjectAccess soa(env);
+  std::vector<std::string> utf8_strings = ToModifiedUtf8(soa, jstrings);
+  for (jint i = 0; i < reps; ++i) {
+    for (const std::string& utf8 : utf8_strings) {
+      CHECK(mirror::String::AllocFromModifiedUtf8(soa.Self(), utf8.c_str()) != nullptr);
+    }
+  }
+}
+
+extern "C" JNIEXPORT void JNICALL Java_StringUtfBenchmark_measureToModifiedUtf8(
+    JNIEnv* env, jclass, jint reps, jobjectArray jstrings) {
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::ObjectArray<mirror::String>> strings =
+      soa.Decode<mirror::ObjectArray<mirror::String>>(jstrings);
+  size_t total = 0u;
+  for (jint i = 0; i < reps; ++i) {
+    for (int32_t j = 0; j < strings->GetLength(); ++j) {
+      total += strings->Get(j)->ToModifiedUtf8().size();
+    }
+  }
+  CHECK_NE(total, 0u);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_StringUtfBenchmark_measureComputeHashCode(
+    JNIEnv* env, jclass, jint reps, jobjectArray jstrings) {
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::ObjectArray<mirror::String>> strings =
+      soa.Decode<mirror::ObjectArray<mirror::String>>(jstrings);
+  int32_t result = 0;
+  for (jint i = 0; i < reps; ++i) {
+    for (int32_t j = 0; j < strings->GetLength(); ++j) {
+      result += strings->Get(j)->ComputeHashCode();
+    }
+  }
+  return result;
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_StringUtfBenchmark_measureHashFromModifiedUtf8(
+    JNIEnv* env, jclass, jint reps, jobjectArray jstrings) {
+  ScopedObjectAccess soa(env);
+  std::vector<std::string> utf8_strings = ToModifiedUtf8(soa, jstrings);
+  std::vector<size_t> utf16_lengths;
+  for (const std::string& utf8 : utf8_strings) {
+    utf16_lengths.push_back(CountModifiedUtf8Chars(utf8.c_str(), utf8.size()));
+  }
+  int32_t result = 0;
+  for (jint i = 0; i < reps; ++i) {
+    for (size_t j = 0; j != utf8_strings.size(); ++j) {
+      result += ComputeUtf16HashFromModifiedUtf8(utf8_strings[j].c_str(), utf16_lengths[j]);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+}  // namespace art
@@ -4476,6 +4476,11 @@ void CodeGeneratorARM64::MaybeGenerateInlineCacheCheck(HInstruction* instruction
     ProfilingInfo* info = GetGraph()->GetProfilingInfo();
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
+    if (cache == nullptr) {
+      // The runtime did not allocate an inline cache for a call site that cannot be
+      // polymorphic, see ProfilingInfo::Create.
+      return;
+    }
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
     vixl::aarch64::Label done;
     __ Mov(x8, address);
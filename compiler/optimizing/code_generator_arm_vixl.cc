@@ -3527,6 +3527,11 @@ void CodeGeneratorARMVIXL::MaybeGenerateInlineCacheCheck(HInstruction* instructi
     ProfilingInfo* info = GetGraph()->GetProfilingInfo();
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
+    if (cache == nullptr) {
+      // The runtime did not allocate an inline cache for a call site that cannot be
+      // polymorphic, see ProfilingInfo::Create.
+      return;
+    }
     uint32_t address = reinterpret_cast32<uint32_t>(cache);
     vixl32::Label done;
     UseScratchRegisterScope temps(GetVIXLAssembler());
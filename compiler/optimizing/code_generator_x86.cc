@@ -2659,6 +2659,11 @@ void CodeGeneratorX86::MaybeGenerateInlineCacheCheck(HInstruction* instruction,
     ProfilingInfo* info = GetGraph()->GetProfilingInfo();
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
+    if (cache == nullptr) {
+      // The runtime did not allocate an inline cache for a call site that cannot be
+      // polymorphic, see ProfilingInfo::Create.
+      return;
+    }
     uint32_t address = reinterpret_cast32<uint32_t>(cache);
     if (kIsDebugBuild) {
       uint32_t temp_index = instruction->GetLocations()->GetTempCount() - 1u;
@@ -2911,6 +2911,11 @@ void CodeGeneratorX86_64::MaybeGenerateInlineCacheCheck(HInstruction* instructio
     ProfilingInfo* info = GetGraph()->GetProfilingInfo();
     DCHECK(info != nullptr);
     InlineCache* cache = info->GetInlineCache(instruction->GetDexPc());
+    if (cache == nullptr) {
+      // The runtime did not allocate an inline cache for a call site that cannot be
+      // polymorphic, see ProfilingInfo::Create.
+      return;
+    }
     uint64_t address = reinterpret_cast64<uint64_t>(cache);
     NearLabel done;
     __ movq(CpuRegister(TMP), Immediate(address));
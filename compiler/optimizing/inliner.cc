@@ -168,6 +168,13 @@ bool HInliner::Run() {
     for (HInstruction* instruction = block->GetFirstInstruction(); instruction != nullptr;) {
       HInstruction* next = instruction->GetNext();
       HInvoke* call = instruction->AsInvoke();
+      if (call != nullptr && call->IsInvokePolymorphic()) {
+        HInvoke* replacement = nullptr;
+        if (TrySpecializeMethodHandleInvoke(call->AsInvokePolymorphic(), &replacement)) {
+          didInline = true;
+          call = replacement;
+        }
+      }
       // As long as the call is not intrinsified, it is worth trying to inline.
       if (call != nullptr && call->GetIntrinsic() == Intrinsics::kNone) {
         if (honor_noinline_directives) {
@@ -626,9 +633,12 @@ HInliner::InlineCacheType HInliner::GetInlineCacheJIT(
     return kInlineCacheNoData;
   }
 
-  Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(
-      *profiling_info->GetInlineCache(invoke_instruction->GetDexPc()),
-      classes);
+  InlineCache* cache = profiling_info->GetInlineCache(invoke_instruction->GetDexPc());
+  if (cache == nullptr) {
+    return kInlineCacheNoData;
+  }
+
+  Runtime::Current()->GetJit()->GetCodeCache()->CopyInlineCacheInto(*cache, classes);
   return GetInlineCacheType(*classes);
 }
 
@@ -1287,6 +1297,241 @@ bool HInliner::TryDevirtualize(HInvoke* invoke_instruction,
   return true;
 }
 
+// Returns whether a widening primitive conversion converts `from` to `to`.
+static bool IsWideningPrimitiveConversion(DataType::Type from, DataType::Type to) {
+  switch (from) {
+    case DataType::Type::kInt8:
+      return to == DataType::Type::kInt16 ||
+             IsWideningPrimitiveConversion(DataType::Type::kInt16, to);
+    case DataType::Type::kInt16:
+    case DataType::Type::kUint16:
+      return to == DataType::Type::kInt32 ||
+             IsWideningPrimitiveConversion(DataType::Type::kInt32, to);
+    case DataType::Type::kInt32:
+      return to == DataType::Type::kInt64 ||
+             IsWideningPrimitiveConversion(DataType::Type::kInt64, to);
+    case DataType::Type::kInt64:
+      return to == DataType::Type::kFloat32 || to == DataType::Type::kFloat64;
+    case DataType::Type::kFloat32:
+      return to == DataType::Type::kFloat64;
+    default:
+      return false;
+  }
+}
+
+bool HInliner::TrySpecializeMethodHandleInvoke(HInvokePolymorphic* invoke_instruction,
+                                               HInvoke** replacement) {
+  Intrinsics intrinsic = invoke_instruction->GetIntrinsic();
+  if (intrinsic != Intrinsics::kMethodHandleInvokeExact &&
+      intrinsic != Intrinsics::kMethodHandleInvoke) {
+    return false;
+  }
+  // The call must never go through the resolution trampoline, which would decode the
+  // invoke-polymorphic instruction at its dex pc. Only the JIT embeds ArtMethod addresses.
+  // Baseline code would also look for an inline cache for the call.
+  if (!codegen_->GetCompilerOptions().IsJitCompiler() || graph_->IsCompilingBaseline()) {
+    return false;
+  }
+  HInstruction* handle = invoke_instruction->InputAt(0);
+  if (!handle->IsLoadMethodHandle()) {
+    return false;
+  }
+  const DexFile& dex_file = *caller_compilation_unit_.GetDexFile();
+  if (!IsSameDexFile(handle->AsLoadMethodHandle()->GetDexFile(), dex_file) ||
+      !IsSameDexFile(*invoke_instruction->GetMethodReference().dex_file, dex_file)) {
+    return false;
+  }
+
+  const dex::MethodHandleItem& method_handle =
+      dex_file.GetMethodHandle(handle->AsLoadMethodHandle()->GetMethodHandleIndex());
+  InvokeType invoke_type;
+  switch (static_cast<DexFile::MethodHandleType>(method_handle.method_handle_type_)) {
+    case DexFile::MethodHandleType::kInvokeStatic:
+      invoke_type = kStatic;
+      break;
+    case DexFile::MethodHandleType::kInvokeInstance:
+      invoke_type = kVirtual;
+      break;
+    case DexFile::MethodHandleType::kInvokeDirect:
+      invoke_type = kDirect;
+      break;
+    default:
+      // Field accessors, constructors and interface methods keep the runtime call.
+      return false;
+  }
+
+  ScopedObjectAccess soa(Thread::Current());
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  ObjPtr<mirror::DexCache> dex_cache = caller_compilation_unit_.GetDexCache().Get();
+  ObjPtr<mirror::ClassLoader> class_loader = caller_compilation_unit_.GetClassLoader().Get();
+  // The call is made from the class of the method holding the invoke-polymorphic, and the
+  // handle was loaded from the class of the method holding the const-method-handle. These
+  // may be inlined methods, with another class than the one being compiled.
+  ObjPtr<mirror::Class> caller_class =
+      invoke_instruction->GetEnvironment()->GetMethod()->GetDeclaringClass();
+  ObjPtr<mirror::Class> handle_class =
+      handle->GetEnvironment()->GetMethod()->GetDeclaringClass();
+  uint32_t method_index = method_handle.field_or_method_idx_;
+  ArtMethod* method = class_linker->LookupResolvedMethod(method_index, dex_cache, class_loader);
+  if (method == nullptr ||
+      method->IsStatic() != (invoke_type == kStatic) ||
+      method->IsConstructor() ||
+      method->GetDeclaringClass()->IsInterface() ||
+      method->IsPrivate() != (invoke_type == kDirect) ||
+      !caller_class->CanAccessMember(method->GetDeclaringClass(), method->GetAccessFlags()) ||
+      !handle_class->CanAccessMember(method->GetDeclaringClass(), method->GetAccessFlags())) {
+    return false;
+  }
+  if (invoke_type == kStatic && !method->GetDeclaringClass()->IsVisiblyInitialized()) {
+    return false;
+  }
+
+  // The handle must have exactly the type of the call site for `invokeExact()`. For
+  // `invoke()`, we also handle the conversions that need no boxing, unboxing or cast. As
+  // all the types of the handle are resolved, loading the handle cannot throw.
+  bool is_exact = (intrinsic == Intrinsics::kMethodHandleInvokeExact);
+  auto is_resolved = [&](dex::TypeIndex type_index) REQUIRES_SHARED(Locks::mutator_lock_) {
+    return class_linker->LookupResolvedType(type_index, dex_cache, class_loader) != nullptr;
+  };
+  auto can_convert = [&](dex::TypeIndex from, dex::TypeIndex to)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (from == to) {
+      return true;
+    } else if (is_exact) {
+      return false;
+    }
+    DataType::Type from_type = DataType::FromShorty(dex_file.StringByTypeIdx(from)[0]);
+    DataType::Type to_type = DataType::FromShorty(dex_file.StringByTypeIdx(to)[0]);
+    if (from_type != DataType::Type::kReference && to_type != DataType::Type::kReference) {
+      return IsWideningPrimitiveConversion(from_type, to_type);
+    } else if (from_type == DataType::Type::kReference && to_type == DataType::Type::kReference) {
+      ObjPtr<mirror::Class> from_class =
+          class_linker->LookupResolvedType(from, dex_cache, class_loader);
+      ObjPtr<mirror::Class> to_class =
+          class_linker->LookupResolvedType(to, dex_cache, class_loader);
+      return from_class != nullptr && to_class != nullptr && to_class->IsAssignableFrom(from_class);
+    }
+    return false;
+  };
+
+  const dex::MethodId& method_id = dex_file.GetMethodId(method_index);
+  const dex::ProtoId& handle_proto = dex_file.GetProtoId(method_id.proto_idx_);
+  const dex::ProtoId& site_proto = dex_file.GetProtoId(invoke_instruction->GetProtoIndex());
+  size_t number_of_arguments = invoke_instruction->GetNumberOfArguments() - 1u;
+  // The type each argument must be converted to, or kVoid if it needs no conversion.
+  ArenaVector<DataType::Type> conversions(graph_->GetAllocator()->Adapter(kArenaAllocMisc));
+  DexFileParameterIterator site_it(dex_file, site_proto);
+  DexFileParameterIterator handle_it(dex_file, handle_proto);
+  if (invoke_type != kStatic) {
+    // The receiver is the first parameter of the handle type.
+    DCHECK(site_it.HasNext());
+    if (!is_resolved(method_id.class_idx_) ||
+        !can_convert(site_it.GetTypeIdx(), method_id.class_idx_)) {
+      return false;
+    }
+    conversions.push_back(DataType::Type::kVoid);
+    site_it.Next();
+  }
+  for (; handle_it.HasNext(); handle_it.Next(), site_it.Next()) {
+    if (!site_it.HasNext() ||
+        !is_resolved(handle_it.GetTypeIdx()) ||
+        !can_convert(site_it.GetTypeIdx(), handle_it.GetTypeIdx())) {
+      return false;
+    }
+    DataType::Type from_type = DataType::FromShorty(site_it.GetDescriptor()[0]);
+    DataType::Type to_type = DataType::FromShorty(handle_it.GetDescriptor()[0]);
+    bool is_implicit = (from_type == to_type) ||
+        (from_type != DataType::Type::kReference &&
+         DataType::IsTypeConversionImplicit(from_type, to_type));
+    conversions.push_back(is_implicit ? DataType::Type::kVoid : to_type);
+  }
+  if (site_it.HasNext() || !is_resolved(handle_proto.return_type_idx_)) {
+    return false;
+  }
+  DCHECK_EQ(conversions.size(), number_of_arguments);
+  // Conversions of the result, including dropping it, would need to be redone in the
+  // interpreter if the caller gets deoptimized.
+  if (handle_proto.return_type_idx_ != site_proto.return_type_idx_) {
+    return false;
+  }
+  DataType::Type return_type = DataType::FromShorty(dex_file.GetShorty(method_id.proto_idx_)[0]);
+  DCHECK_EQ(return_type, invoke_instruction->GetType());
+
+  MethodReference method_reference(&dex_file, method_index);
+  MethodReference resolved_method_reference(method->GetDexFile(), method->GetDexMethodIndex());
+  uint32_t dex_pc = invoke_instruction->GetDexPc();
+  HInvoke* new_invoke = nullptr;
+  HInvokeStaticOrDirect::DispatchInfo dispatch_info = {};
+  if (invoke_type == kVirtual) {
+    new_invoke = new (graph_->GetAllocator()) HInvokeVirtual(graph_->GetAllocator(),
+                                                             number_of_arguments,
+                                                             return_type,
+                                                             dex_pc,
+                                                             method_reference,
+                                                             method,
+                                                             resolved_method_reference,
+                                                             method->GetVtableIndex());
+  } else {
+    dispatch_info = HSharpening::SharpenLoadMethod(method,
+                                                   /* has_method_id= */ true,
+                                                   /* for_interface_call= */ false,
+                                                   codegen_);
+    if ((dispatch_info.method_load_kind != MethodLoadKind::kJitDirectAddress &&
+         dispatch_info.method_load_kind != MethodLoadKind::kRecursive) ||
+        dispatch_info.code_ptr_location == CodePtrLocation::kCallCriticalNative) {
+      return false;
+    }
+    new_invoke = new (graph_->GetAllocator()) HInvokeStaticOrDirect(
+        graph_->GetAllocator(),
+        number_of_arguments,
+        return_type,
+        dex_pc,
+        method_reference,
+        method,
+        dispatch_info,
+        invoke_type,
+        resolved_method_reference,
+        HInvokeStaticOrDirect::ClinitCheckRequirement::kNone);
+  }
+
+  HBasicBlock* block = invoke_instruction->GetBlock();
+  for (size_t index = 0; index != number_of_arguments; ++index) {
+    HInstruction* argument = invoke_instruction->InputAt(index + 1u);
+    if (index == 0u && invoke_type != kStatic) {
+      HNullCheck* null_check = new (graph_->GetAllocator()) HNullCheck(argument, dex_pc);
+      block->InsertInstructionBefore(null_check, invoke_instruction);
+      null_check->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+      argument = null_check;
+    } else if (conversions[index] != DataType::Type::kVoid) {
+      HTypeConversion* conversion =
+          new (graph_->GetAllocator()) HTypeConversion(conversions[index], argument, dex_pc);
+      block->InsertInstructionBefore(conversion, invoke_instruction);
+      argument = conversion;
+    }
+    new_invoke->SetArgumentAt(index, argument);
+  }
+  if (new_invoke->IsInvokeStaticOrDirect() &&
+      HInvokeStaticOrDirect::NeedsCurrentMethodInput(dispatch_info)) {
+    HInvokeStaticOrDirect* invoke_static_or_direct = new_invoke->AsInvokeStaticOrDirect();
+    invoke_static_or_direct->SetRawInputAt(
+        invoke_static_or_direct->GetCurrentMethodIndexUnchecked(), graph_->GetCurrentMethod());
+  }
+  block->InsertInstructionBefore(new_invoke, invoke_instruction);
+  new_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+  if (return_type == DataType::Type::kReference) {
+    ObjPtr<mirror::Class> cls = method->LookupResolvedReturnType();
+    ReferenceTypeInfo rti = ReferenceTypePropagation::IsAdmissible(cls)
+        ? ReferenceTypeInfo::Create(graph_->GetHandleCache()->NewHandle(cls))
+        : graph_->GetInexactObjectRti();
+    new_invoke->SetReferenceTypeInfo(rti);
+  }
+  LOG_SUCCESS() << "Replaced invoke of a constant method handle with a call to "
+                << method->PrettyMethod();
+  MaybeRecordStat(stats_, MethodCompilationStat::kReplacedMethodHandleInvoke);
+  *replacement = new_invoke;
+  MaybeReplaceAndRemove(new_invoke, invoke_instruction);
+  return true;
+}
 
 bool HInliner::TryInlineAndReplace(HInvoke* invoke_instruction,
                                    ArtMethod* method,
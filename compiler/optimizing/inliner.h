@@ -170,6 +170,11 @@ class HInliner : public HOptimization {
                        HInvoke** replacement)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to replace an invoke of `MethodHandle.invokeExact()` or `MethodHandle.invoke()`
+  // on a constant method handle with a call to the target method of the handle.
+  bool TrySpecializeMethodHandleInvoke(HInvokePolymorphic* invoke_instruction,
+                                       HInvoke** replacement);
+
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
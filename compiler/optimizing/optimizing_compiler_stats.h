@@ -39,6 +39,7 @@ enum class MethodCompilationStat {
   kInlinedInvoke,
   kInlinedLastInvoke,
   kReplacedInvokeWithSimplePattern,
+  kReplacedMethodHandleInvoke,
   kInstructionSimplifications,
   kInstructionSimplificationsArch,
   kUnresolvedMethod,
@@ -1564,7 +1564,7 @@ class ImageWriter::LayoutHelper::CollectClassesVisitor : public ClassVisitor {
       ClassTable* app_class_table = image_writer->GetAppClassLoader()->GetClassTable();
       ReaderMutexLock lock(self, app_class_table->lock_);
       DCHECK_EQ(app_class_table->classes_.size(), 1u);
-      const ClassTable::ClassSet& app_class_set = app_class_table->classes_[0];
+      const ClassTable::ClassSet& app_class_set = *app_class_table->classes_[0];
       DCHECK_GE(app_class_set.size(), image_info.class_table_size_);
       boot_image_classes.reserve(app_class_set.size() - image_info.class_table_size_);
       for (const ClassTable::TableSlot& slot : app_class_set) {
@@ -1894,17 +1894,19 @@ void ImageWriter::LayoutHelper::ProcessInterns(Thread* self) {
                        return bins[enum_cast<size_t>(Bin::kString)].empty();
                      }));
 
-  // There is only one non-boot image intern table and it's the last one.
+  // The intern table of dex2oat has a single shard and it holds the only non-boot image table.
   InternTable* const intern_table = Runtime::Current()->GetInternTable();
   MutexLock mu(self, *Locks::intern_table_lock_);
-  DCHECK_EQ(std::count_if(intern_table->strong_interns_.tables_.begin(),
-                          intern_table->strong_interns_.tables_.end(),
-                          [](const InternTable::Table::InternalTable& table) {
-                            return !table.IsBootImage();
-                          }),
-            1);
-  DCHECK(!intern_table->strong_interns_.tables_.back().IsBootImage());
-  const InternTable::UnorderedSet& intern_set = intern_table->strong_interns_.tables_.back().set_;
+  DCHECK_EQ(intern_table->num_shards_, 1u);
+  InternTable::Shard& shard = intern_table->shards_[0];
+  MutexLock shard_mu(self, shard.lock);
+  DCHECK_EQ(shard.strong_interns.tables_.size(), 1u);
+  DCHECK(std::all_of(intern_table->image_interns_.tables_.begin(),
+                     intern_table->image_interns_.tables_.end(),
+                     [](const InternTable::Table::InternalTable& table) {
+                       return table.IsBootImage() || table.Empty();
+                     }));
+  const InternTable::UnorderedSet& intern_set = shard.strong_interns.tables_.back().set_;
 
   // Assign bin slots to all interns with a corresponding StringId in one of the input dex files.
   ImageWriter* image_writer = image_writer_;
@@ -2775,9 +2777,9 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
 
     if (kIsDebugBuild) {
       MutexLock lock(Thread::Current(), *Locks::intern_table_lock_);
-      CHECK(!temp_intern_table.strong_interns_.tables_.empty());
+      CHECK(!temp_intern_table.image_interns_.tables_.empty());
       // The UnorderedSet was inserted at the beginning.
-      CHECK_EQ(temp_intern_table.strong_interns_.tables_[0].Size(), intern_table.size());
+      CHECK_EQ(temp_intern_table.image_interns_.tables_[0].Size(), intern_table.size());
     }
   }
 
@@ -2806,7 +2808,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       ReaderMutexLock lock(Thread::Current(), temp_class_table.lock_);
       CHECK(!temp_class_table.classes_.empty());
       // The ClassSet was inserted at the beginning.
-      CHECK_EQ(temp_class_table.classes_[0].size(), table.size());
+      CHECK_EQ(temp_class_table.classes_[0]->size(), table.size());
     }
   }
 }
@@ -50,12 +50,18 @@
   METRIC(FullGcTracingThroughputAvg, MetricsAverage)                    \
   METRIC(JitMethodCompileTotalTime, MetricsCounter)                     \
   METRIC(JitMethodCompileCount, MetricsCounter)                         \
+  METRIC(JitCompilationDeferredCount, MetricsCounter)                   \
+  METRIC(JitCpuBudgetUtilization, MetricsHistogram, 10, 0, 100)         \
   METRIC(YoungGcCollectionTime, MetricsHistogram, 15, 0, 60'000)        \
   METRIC(FullGcCollectionTime, MetricsHistogram, 15, 0, 60'000)         \
   METRIC(YoungGcThroughput, MetricsHistogram, 15, 0, 10'000)            \
   METRIC(FullGcThroughput, MetricsHistogram, 15, 0, 10'000)             \
   METRIC(YoungGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)     \
-  METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)
+  METRIC(FullGcTracingThroughput, MetricsHistogram, 15, 0, 10'000)      \
+  METRIC(CheckpointTime, MetricsHistogram, 15, 0, 10'000)               \
+  METRIC(EmptyCheckpointTime, MetricsHistogram, 15, 0, 10'000)          \
+  METRIC(TimeToSafepoint, MetricsHistogram, 15, 0, 10'000)              \
+  METRIC(SuspendAllTime, MetricsHistogram, 15, 0, 10'000)
 
 // A lot of the metrics implementation code is generated by passing one-off macros into ART_COUNTERS
 // and ART_HISTOGRAMS. This means metrics.h and metrics.cc are very #define-heavy, which can be
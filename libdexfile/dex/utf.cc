@@ -16,17 +16,68 @@
 
 #include "utf.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include <android-base/logging.h>
 #include <android-base/stringprintf.h>
 #include <android-base/strings.h>
 
-#include "base/casts.h"
 #include "utf-inl.h"
 
 namespace art {
 
 using android::base::StringAppendF;
 
+// Most strings are ASCII, or contain long runs of ASCII characters. The fast paths below
+// check eight bytes of modified UTF-8 or four UTF-16 characters at a time with plain
+// 64-bit loads. The ASCII-only conversion loops are simple enough for the compiler to
+// vectorize them with SSE2 or NEON, without any architecture specific code here.
+
+static constexpr size_t kAsciiWordBytes = sizeof(uint64_t);
+static constexpr size_t kAsciiWordChars = sizeof(uint64_t) / sizeof(uint16_t);
+
+ALWAYS_INLINE static inline uint64_t LoadAsciiWord(const void* ptr) {
+  uint64_t word;
+  memcpy(&word, ptr, sizeof(word));
+  return word;
+}
+
+// Returns true if all the bytes of `word` are one-byte encodings.
+ALWAYS_INLINE static inline bool IsAsciiUtf8Word(uint64_t word) {
+  return (word & UINT64_C(0x8080808080808080)) == 0u;
+}
+
+// Returns true if all the characters of `word` are encoded as one byte, i.e. are in the
+// range [1, 0x7f]; U+0000 needs two bytes in modified UTF-8.
+ALWAYS_INLINE static inline bool IsAsciiUtf16Word(uint64_t word) {
+  // With all characters below 0x80, subtracting one only sets the top bit of zeros.
+  return (word & UINT64_C(0xff80ff80ff80ff80)) == 0u &&
+         ((word - UINT64_C(0x0001000100010001)) & UINT64_C(0x8000800080008000)) == 0u;
+}
+
+// Returns the length of the run of one-byte encodings at the start of `utf8`, in whole
+// words, so the result is a multiple of kAsciiWordBytes.
+ALWAYS_INLINE static inline size_t CountAsciiUtf8Words(const char* utf8, size_t byte_count) {
+  size_t i = 0u;
+  while (byte_count - i >= kAsciiWordBytes && IsAsciiUtf8Word(LoadAsciiWord(utf8 + i))) {
+    i += kAsciiWordBytes;
+  }
+  return i;
+}
+
+// Returns the length of the run of characters encoded as one byte at the start of `utf16`,
+// in whole words, so the result is a multiple of kAsciiWordChars.
+ALWAYS_INLINE static inline size_t CountAsciiUtf16Words(const uint16_t* utf16,
+                                                        size_t char_count) {
+  size_t i = 0u;
+  while (char_count - i >= kAsciiWordChars && IsAsciiUtf16Word(LoadAsciiWord(utf16 + i))) {
+    i += kAsciiWordChars;
+  }
+  return i;
+}
+
 // This is used only from debugger and test code.
 size_t CountModifiedUtf8Chars(const char* utf8) {
   return CountModifiedUtf8Chars(utf8, strlen(utf8));
@@ -51,29 +102,36 @@ size_t CountModifiedUtf8Chars(const char* utf8, size_t byte_count) {
   DCHECK_LE(byte_count, strlen(utf8));
   size_t len = 0;
   const char* end = utf8 + byte_count;
-  for (; utf8 < end; ++utf8) {
-    int ic = *utf8;
-    len++;
-    if (LIKELY((ic & 0x80) == 0)) {
-      // One-byte encoding.
-      continue;
-    }
-    // Two- or three-byte encoding.
-    utf8++;
-    if ((ic & 0x20) == 0) {
-      // Two-byte encoding.
-      continue;
-    }
-    utf8++;
-    if ((ic & 0x10) == 0) {
-      // Three-byte encoding.
-      continue;
-    }
+  while (utf8 < end) {
+    size_t ascii_bytes = CountAsciiUtf8Words(utf8, end - utf8);
+    utf8 += ascii_bytes;
+    len += ascii_bytes;
+    // Count the characters that start in the next word one at a time.
+    const char* word_end = utf8 + std::min<size_t>(kAsciiWordBytes, end - utf8);
+    for (; utf8 < word_end; ++utf8) {
+      int ic = *utf8;
+      len++;
+      if (LIKELY((ic & 0x80) == 0)) {
+        // One-byte encoding.
+        continue;
+      }
+      // Two- or three-byte encoding.
+      utf8++;
+      if ((ic & 0x20) == 0) {
+        // Two-byte encoding.
+        continue;
+      }
+      utf8++;
+      if ((ic & 0x10) == 0) {
+        // Three-byte encoding.
+        continue;
+      }
 
-    // Four-byte encoding: needs to be converted into a surrogate
-    // pair.
-    utf8++;
-    len++;
+      // Four-byte encoding: needs to be converted into a surrogate
+      // pair.
+      utf8++;
+      len++;
+    }
   }
   return len;
 }
@@ -99,24 +157,35 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
   uint16_t *out_p = utf16_data_out;
 
   if (LIKELY(out_chars == in_bytes)) {
-    // Common case where all characters are ASCII.
-    for (const char *p = in_start; p < in_end;) {
-      // Safe even if char is signed because ASCII characters always have
-      // the high bit cleared.
-      *out_p++ = dchecked_integral_cast<uint16_t>(*p++);
+    // Common case where all characters are ASCII. A plain widening loop that the
+    // compiler vectorizes.
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(in_start);
+    for (size_t i = 0; i != in_bytes; ++i) {
+      out_p[i] = in[i];
     }
     return;
   }
 
   // String contains non-ASCII characters.
   for (const char *p = in_start; p < in_end;) {
-    const uint32_t ch = GetUtf16FromUtf8(&p);
-    const uint16_t leading = GetLeadingUtf16Char(ch);
-    const uint16_t trailing = GetTrailingUtf16Char(ch);
+    size_t ascii_bytes = CountAsciiUtf8Words(p, in_end - p);
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(p);
+    for (size_t i = 0; i != ascii_bytes; ++i) {
+      out_p[i] = in[i];
+    }
+    out_p += ascii_bytes;
+    p += ascii_bytes;
+    // Convert the characters that start in the next word one at a time.
+    const char* word_end = p + std::min<size_t>(kAsciiWordBytes, in_end - p);
+    while (p < word_end) {
+      const uint32_t ch = GetUtf16FromUtf8(&p);
+      const uint16_t leading = GetLeadingUtf16Char(ch);
+      const uint16_t trailing = GetTrailingUtf16Char(ch);
 
-    *out_p++ = leading;
-    if (trailing != 0) {
-      *out_p++ = trailing;
+      *out_p++ = leading;
+      if (trailing != 0) {
+        *out_p++ = trailing;
+      }
     }
   }
 }
@@ -124,51 +193,63 @@ void ConvertModifiedUtf8ToUtf16(uint16_t* utf16_data_out, size_t out_chars,
 void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
                                 const uint16_t* utf16_in, size_t char_count) {
   if (LIKELY(byte_count == char_count)) {
-    // Common case where all characters are ASCII.
-    const uint16_t *utf16_end = utf16_in + char_count;
-    for (const uint16_t *p = utf16_in; p < utf16_end;) {
-      *utf8_out++ = dchecked_integral_cast<char>(*p++);
+    // Common case where all characters are ASCII. A plain narrowing loop that the
+    // compiler vectorizes.
+    for (size_t i = 0; i != char_count; ++i) {
+      utf8_out[i] = static_cast<char>(utf16_in[i]);
     }
     return;
   }
 
   // String contains non-ASCII characters.
-  while (char_count--) {
-    const uint16_t ch = *utf16_in++;
-    if (ch > 0 && ch <= 0x7f) {
-      *utf8_out++ = ch;
-    } else {
-      // Char_count == 0 here implies we've encountered an unpaired
-      // surrogate and we have no choice but to encode it as 3-byte UTF
-      // sequence. Note that unpaired surrogates can occur as a part of
-      // "normal" operation.
-      if ((ch >= 0xd800 && ch <= 0xdbff) && (char_count > 0)) {
-        const uint16_t ch2 = *utf16_in;
-
-        // Check if the other half of the pair is within the expected
-        // range. If it isn't, we will have to emit both "halves" as
-        // separate 3 byte sequences.
-        if (ch2 >= 0xdc00 && ch2 <= 0xdfff) {
-          utf16_in++;
-          char_count--;
-          const uint32_t code_point = (ch << 10) + ch2 - 0x035fdc00;
-          *utf8_out++ = (code_point >> 18) | 0xf0;
-          *utf8_out++ = ((code_point >> 12) & 0x3f) | 0x80;
-          *utf8_out++ = ((code_point >> 6) & 0x3f) | 0x80;
-          *utf8_out++ = (code_point & 0x3f) | 0x80;
-          continue;
+  while (char_count != 0u) {
+    size_t ascii_chars = CountAsciiUtf16Words(utf16_in, char_count);
+    for (size_t i = 0; i != ascii_chars; ++i) {
+      utf8_out[i] = static_cast<char>(utf16_in[i]);
+    }
+    utf8_out += ascii_chars;
+    utf16_in += ascii_chars;
+    char_count -= ascii_chars;
+    // Convert the characters of the next word one at a time.
+    const size_t word_end = char_count - std::min(kAsciiWordChars, char_count);
+    while (char_count > word_end) {
+      --char_count;
+      const uint16_t ch = *utf16_in++;
+      if (ch > 0 && ch <= 0x7f) {
+        *utf8_out++ = ch;
+      } else {
+        // Char_count == 0 here implies we've encountered an unpaired
+        // surrogate and we have no choice but to encode it as 3-byte UTF
+        // sequence. Note that unpaired surrogates can occur as a part of
+        // "normal" operation.
+        if ((ch >= 0xd800 && ch <= 0xdbff) && (char_count > 0)) {
+          const uint16_t ch2 = *utf16_in;
+
+          // Check if the other half of the pair is within the expected
+          // range. If it isn't, we will have to emit both "halves" as
+          // separate 3 byte sequences.
+          if (ch2 >= 0xdc00 && ch2 <= 0xdfff) {
+            utf16_in++;
+            char_count--;
+            const uint32_t code_point = (ch << 10) + ch2 - 0x035fdc00;
+            *utf8_out++ = (code_point >> 18) | 0xf0;
+            *utf8_out++ = ((code_point >> 12) & 0x3f) | 0x80;
+            *utf8_out++ = ((code_point >> 6) & 0x3f) | 0x80;
+            *utf8_out++ = (code_point & 0x3f) | 0x80;
+            continue;
+          }
         }
-      }
 
-      if (ch > 0x07ff) {
-        // Three byte encoding.
-        *utf8_out++ = (ch >> 12) | 0xe0;
-        *utf8_out++ = ((ch >> 6) & 0x3f) | 0x80;
-        *utf8_out++ = (ch & 0x3f) | 0x80;
-      } else /*(ch > 0x7f || ch == 0)*/ {
-        // Two byte encoding.
-        *utf8_out++ = (ch >> 6) | 0xc0;
-        *utf8_out++ = (ch & 0x3f) | 0x80;
+        if (ch > 0x07ff) {
+          // Three byte encoding.
+          *utf8_out++ = (ch >> 12) | 0xe0;
+          *utf8_out++ = ((ch >> 6) & 0x3f) | 0x80;
+          *utf8_out++ = (ch & 0x3f) | 0x80;
+        } else /*(ch > 0x7f || ch == 0)*/ {
+          // Two byte encoding.
+          *utf8_out++ = (ch >> 6) | 0xc0;
+          *utf8_out++ = (ch & 0x3f) | 0x80;
+        }
       }
     }
   }
@@ -177,6 +258,18 @@ void ConvertUtf16ToModifiedUtf8(char* utf8_out, size_t byte_count,
 int32_t ComputeUtf16HashFromModifiedUtf8(const char* utf8, size_t utf16_length) {
   uint32_t hash = 0;
   while (utf16_length != 0u) {
+    if (utf16_length >= 4u) {
+      // With at least four characters left, there are at least four bytes left to read.
+      uint32_t word;
+      memcpy(&word, utf8, sizeof(word));
+      if ((word & 0x80808080u) == 0u) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(utf8);
+        hash = UpdateUtf16Hash4(hash, bytes[0], bytes[1], bytes[2], bytes[3]);
+        utf8 += 4u;
+        utf16_length -= 4u;
+        continue;
+      }
+    }
     const uint32_t pair = GetUtf16FromUtf8(&utf8);
     const uint16_t first = GetLeadingUtf16Char(pair);
     hash = hash * 31 + first;
@@ -244,29 +337,36 @@ size_t CountUtf8Bytes(const uint16_t* chars, size_t char_count) {
   size_t result = 0;
   const uint16_t *end = chars + char_count;
   while (chars < end) {
-    const uint16_t ch = *chars++;
-    if (LIKELY(ch != 0 && ch < 0x80)) {
-      result++;
-      continue;
-    }
-    if (ch < 0x800) {
-      result += 2;
-      continue;
-    }
-    if (ch >= 0xd800 && ch < 0xdc00) {
-      if (chars < end) {
-        const uint16_t ch2 = *chars;
-        // If we find a properly paired surrogate, we emit it as a 4 byte
-        // UTF sequence. If we find an unpaired leading or trailing surrogate,
-        // we emit it as a 3 byte sequence like would have done earlier.
-        if (ch2 >= 0xdc00 && ch2 < 0xe000) {
-          chars++;
-          result += 4;
-          continue;
+    size_t ascii_chars = CountAsciiUtf16Words(chars, end - chars);
+    chars += ascii_chars;
+    result += ascii_chars;
+    // Count the bytes of the characters of the next word one at a time.
+    const uint16_t* word_end = chars + std::min<size_t>(kAsciiWordChars, end - chars);
+    while (chars < word_end) {
+      const uint16_t ch = *chars++;
+      if (LIKELY(ch != 0 && ch < 0x80)) {
+        result++;
+        continue;
+      }
+      if (ch < 0x800) {
+        result += 2;
+        continue;
+      }
+      if (ch >= 0xd800 && ch < 0xdc00) {
+        if (chars < end) {
+          const uint16_t ch2 = *chars;
+          // If we find a properly paired surrogate, we emit it as a 4 byte
+          // UTF sequence. If we find an unpaired leading or trailing surrogate,
+          // we emit it as a 3 byte sequence like would have done earlier.
+          if (ch2 >= 0xdc00 && ch2 < 0xe000) {
+            chars++;
+            result += 4;
+            continue;
+          }
         }
       }
+      result += 3;
     }
-    result += 3;
   }
   return result;
 }
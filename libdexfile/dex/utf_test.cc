@@ -16,6 +16,7 @@
 
 #include "utf.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -380,6 +381,59 @@ TEST_F(UtfTest, ExhaustiveBidirectionalCodePointCheck) {
   }
 }
 
+static int32_t ComputeUtf16Hash_reference(const uint16_t* chars, size_t char_count) {
+  uint32_t hash = 0;
+  while (char_count--) {
+    hash = hash * 31 + *chars++;
+  }
+  return static_cast<int32_t>(hash);
+}
+
+// Check the word-at-a-time ASCII fast paths with non-ASCII characters at every position
+// of strings long enough to span several words, and at every alignment of the input.
+TEST_F(UtfTest, AsciiRunsAroundNonAscii) {
+  static const uint16_t kNonAscii[][2] = {
+      { 0x0000, 0 },       // Two byte encoding of U+0000.
+      { 0x0080, 0 },       // Two byte encoding.
+      { 0x0800, 0 },       // Three byte encoding.
+      { 0xdbff, 0 },       // Unpaired leading surrogate.
+      { 0xd801, 0xdc00 },  // Surrogate pair.
+  };
+  for (const uint16_t (&non_ascii)[2] : kNonAscii) {
+    size_t non_ascii_length = (non_ascii[1] != 0u) ? 2u : 1u;
+    for (size_t length = non_ascii_length; length != 40u; ++length) {
+      for (size_t pos = 0; pos + non_ascii_length <= length; ++pos) {
+        for (size_t offset = 0; offset != 2u; ++offset) {
+          std::vector<uint16_t> utf16(offset + length);
+          uint16_t* chars = utf16.data() + offset;
+          for (size_t i = 0; i != length; ++i) {
+            chars[i] = 'a' + i % 26;
+          }
+          std::copy_n(non_ascii, non_ascii_length, chars + pos);
+
+          size_t byte_count = CountUtf8Bytes(chars, length);
+          ASSERT_EQ(CountUtf8Bytes_reference(chars, length), byte_count);
+          std::vector<char> utf8(offset + byte_count + 1u);
+          std::vector<char> utf8_reference(byte_count + 1u);
+          char* bytes = utf8.data() + offset;
+          ConvertUtf16ToModifiedUtf8(bytes, byte_count, chars, length);
+          ConvertUtf16ToModifiedUtf8_reference(utf8_reference.data(), chars, length);
+          ASSERT_EQ(0, memcmp(utf8_reference.data(), bytes, byte_count));
+
+          ASSERT_EQ(length, CountModifiedUtf8Chars(bytes, byte_count));
+          std::vector<uint16_t> round_trip(length);
+          ConvertModifiedUtf8ToUtf16(round_trip.data(), length, bytes, byte_count);
+          ASSERT_TRUE(std::equal(round_trip.begin(), round_trip.end(), chars));
+
+          int32_t hash = ComputeUtf16Hash_reference(chars, length);
+          ASSERT_EQ(hash, ComputeUtf16Hash(chars, length));
+          ASSERT_EQ(hash, ComputeUtf16HashFromModifiedUtf8(bytes, length));
+        }
+      }
+    }
+  }
+}
+
 TEST_F(UtfTest, NonAscii) {
   const char kNonAsciiCharacter = '\x80';
   const char input[] = { kNonAsciiCharacter, '\0' };
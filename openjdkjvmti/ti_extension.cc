@@ -281,6 +281,26 @@ jvmtiError ExtensionUtil::GetExtensionFunctions(jvmtiEnv* env,
     return error;
   }
 
+  // Monitor contention samples
+  error = add_extension(
+      reinterpret_cast<jvmtiExtensionFunction>(MonitorUtil::GetContentionSamples),
+      "com.android.art.monitor.get_contention_samples",
+      "Fills the given 'samples' buffer with the most recent contended monitor acquisitions, one"
+      " per line with the class of the monitor, the method holding it, the method waiting for it"
+      " and the time waited. The runtime only records them when started with"
+      " -XX:MonitorContentionSamples=<n>, otherwise this returns JVMTI_ERROR_ABSENT_INFORMATION."
+      " The buffer must be deallocated by the caller.",
+      {
+          { "samples", JVMTI_KIND_ALLOC_BUF, JVMTI_TYPE_CCHAR, false },
+      },
+      {
+        ERR(NULL_POINTER),
+        ERR(ABSENT_INFORMATION),
+      });
+  if (error != ERR(NONE)) {
+    return error;
+  }
+
   // GetLastError extension
   error = add_extension(
       reinterpret_cast<jvmtiExtensionFunction>(LogUtil::GetLastError),
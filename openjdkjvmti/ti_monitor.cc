@@ -35,11 +35,14 @@
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <sstream>
 
 #include "art_jvmti.h"
+#include "base/strlcpy.h"
 #include "gc_root-inl.h"
 #include "mirror/object-inl.h"
 #include "monitor.h"
+#include "monitor_contention_profiler.h"
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -266,6 +269,32 @@ jvmtiError MonitorUtil::RawMonitorEnterNoSuspend(jvmtiEnv* env ATTRIBUTE_UNUSED,
   return ERR(NONE);
 }
 
+jvmtiError MonitorUtil::GetContentionSamples(jvmtiEnv* env, char** samples) {
+  if (env == nullptr) {
+    return ERR(INVALID_ENVIRONMENT);
+  }
+  if (samples == nullptr) {
+    return ERR(NULL_POINTER);
+  }
+  art::MonitorContentionProfiler* profiler =
+      art::Runtime::Current()->GetMonitorContentionProfiler();
+  if (profiler == nullptr) {
+    return ERR(ABSENT_INFORMATION);
+  }
+  std::ostringstream oss;
+  profiler->Dump(oss);
+  std::string text = oss.str();
+  const size_t size = text.size() + 1;
+  char* out;
+  jvmtiError err = env->Allocate(size, reinterpret_cast<unsigned char**>(&out));
+  if (err != OK) {
+    return err;
+  }
+  strlcpy(out, text.c_str(), size);
+  *samples = out;
+  return OK;
+}
+
 jvmtiError MonitorUtil::RawMonitorEnter(jvmtiEnv* env ATTRIBUTE_UNUSED, jrawMonitorID id) {
   if (id == nullptr) {
     return ERR(INVALID_MONITOR);
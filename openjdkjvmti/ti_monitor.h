@@ -56,6 +56,9 @@ class MonitorUtil {
   static jvmtiError RawMonitorNotifyAll(jvmtiEnv* env, jrawMonitorID monitor);
 
   static jvmtiError GetCurrentContendedMonitor(jvmtiEnv* env, jthread thr, jobject* monitor);
+
+  // Extension to get the recent contended monitor acquisitions, as text.
+  static jvmtiError GetContentionSamples(jvmtiEnv* env, char** samples);
 };
 
 }  // namespace openjdkjvmti
@@ -96,6 +96,7 @@
 #include "jit/jit_code_cache.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
+#include "jni/native_method_promotions.h"
 #include "linear_alloc.h"
 #include "mirror/array-alloc-inl.h"
 #include "mirror/array-inl.h"
@@ -128,6 +129,7 @@
 #include "mirror/string-inl.h"
 #include "mirror/throwable.h"
 #include "mirror/var_handle.h"
+#include "monitor_contention_profiler.h"
 #include "native/dalvik_system_DexFile.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "nterp_helpers.h"
@@ -1960,7 +1962,10 @@ bool ClassLinker::AddImageSpace(
 
   if (!runtime->IsAotCompiler()) {
     ScopedTrace trace("AppImage:UpdateCodeItemAndNterp");
-    bool can_use_nterp = interpreter::CanRuntimeUseNterp();
+    // Methods set to nterp here would bypass the entry/exit stubs, so keep them in the switch
+    // interpreter, which reports the method events itself, while stubs are installed.
+    bool can_use_nterp = interpreter::CanRuntimeUseNterp() &&
+        !runtime->GetInstrumentation()->EntryExitStubsInstalled();
     uint16_t hotness_threshold = runtime->GetJITOptions()->GetWarmupThreshold();
     header.VisitPackedArtMethods([&](ArtMethod& method) REQUIRES_SHARED(Locks::mutator_lock_) {
       // In the image, the `data` pointer field of the ArtMethod contains the code
@@ -1987,6 +1992,33 @@ bool ClassLinker::AddImageSpace(
     }, space->Begin(), image_pointer_size_);
   }
 
+  const NativeMethodPromotions* promotions = runtime->GetNativeMethodPromotions();
+  if (app_image && UNLIKELY(promotions != nullptr)) {
+    // The methods of app image classes are not loaded with LoadMethod(), apply the
+    // -XX:NativeMethodPromotionFile promotions to them here. Their precompiled JNI stubs were
+    // compiled for normal JNI, so promoted methods are moved to the generic JNI stub.
+    ScopedTrace trace("AppImage:PromoteNativeMethods");
+    instrumentation::Instrumentation* instrumentation = runtime->GetInstrumentation();
+    header.VisitPackedArtMethods([&](ArtMethod& method) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (method.IsRuntimeMethod() ||
+          !method.IsNative() ||
+          method.IsFastNative() ||
+          method.IsCriticalNative()) {
+        return;
+      }
+      uint32_t access_flags = method.GetAccessFlags();
+      uint32_t native_access_flags = promotions->GetAccessFlags(
+          *method.GetDexFile(), method.GetDexMethodIndex(), access_flags);
+      if (native_access_flags != 0u) {
+        method.SetAccessFlags(access_flags | native_access_flags);
+        if (method.IsCriticalNative()) {
+          method.SetEntryPointFromJni(GetJniDlsymLookupCriticalStub());
+        }
+        instrumentation->InitializeMethodsCode(&method, /*aot_code=*/ nullptr);
+      }
+    }, space->Begin(), image_pointer_size_);
+  }
+
   if (runtime->IsVerificationSoftFail()) {
     header.VisitPackedArtMethods([&](ArtMethod& method) REQUIRES_SHARED(Locks::mutator_lock_) {
       if (!method.IsNative() && method.IsInvokable()) {
@@ -2333,6 +2365,9 @@ void ClassLinker::DeleteClassLoader(Thread* self, const ClassLoaderData& data, b
     // If we don't have a JIT, we need to manually remove the CHA dependencies manually.
     cha_->RemoveDependenciesForLinearAlloc(data.allocator);
   }
+  if (runtime->GetMonitorContentionProfiler() != nullptr) {
+    runtime->GetMonitorContentionProfiler()->RemoveSamplesIn(*data.allocator);
+  }
   // Cleanup references to single implementation ArtMethods that will be deleted.
   if (cleanup_cha) {
     CHAOnDeleteUpdateClassVisitor visitor(data.allocator);
@@ -3670,8 +3705,14 @@ void ClassLinker::LoadMethod(const DexFile& dex_file,
   }
   if (UNLIKELY((access_flags & kAccNative) != 0u)) {
     // Check if the native method is annotated with @FastNative or @CriticalNative.
-    access_flags |= annotations::GetNativeMethodAnnotationAccessFlags(
+    uint32_t native_access_flags = annotations::GetNativeMethodAnnotationAccessFlags(
         dex_file, dst->GetClassDef(), dex_method_idx);
+    const NativeMethodPromotions* promotions = Runtime::Current()->GetNativeMethodPromotions();
+    if (native_access_flags == 0u && UNLIKELY(promotions != nullptr)) {
+      // Or if it is listed as such with -XX:NativeMethodPromotionFile.
+      native_access_flags = promotions->GetAccessFlags(dex_file, dex_method_idx, access_flags);
+    }
+    access_flags |= native_access_flags;
   }
   dst->SetAccessFlags(access_flags);
   // Must be done after SetAccessFlags since IsAbstract depends on it.
@@ -9720,6 +9761,14 @@ void ClassLinker::DumpForSigQuit(std::ostream& os) {
   Runtime* runtime = Runtime::Current();
   os << "Classes initialized: " << runtime->GetStat(KIND_GLOBAL_CLASS_INIT_COUNT) << " in "
      << PrettyDuration(runtime->GetStat(KIND_GLOBAL_CLASS_INIT_TIME)) << "\n";
+  if (runtime->AreDexCacheStatsEnabled()) {
+    for (const auto& entry : dex_caches_) {
+      ObjPtr<mirror::DexCache> dex_cache = DecodeDexCacheLocked(soa.Self(), &entry.second);
+      if (dex_cache != nullptr) {
+        dex_cache->DumpArrayStats(os);
+      }
+    }
+  }
 }
 
 class CountClassesVisitor : public ClassLoaderVisitor {
@@ -69,8 +69,8 @@ inline bool ClassTable::ClassDescriptorEquals::operator()(const TableSlot& a,
 template<class Visitor>
 void ClassTable::VisitRoots(Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (TableSlot& table_slot : class_set) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    for (TableSlot& table_slot : *class_set) {
       table_slot.VisitRoot(visitor);
     }
   }
@@ -87,8 +87,8 @@ void ClassTable::VisitRoots(Visitor& visitor) {
 template<class Visitor>
 void ClassTable::VisitRoots(const Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (TableSlot& table_slot : class_set) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    for (TableSlot& table_slot : *class_set) {
       table_slot.VisitRoot(visitor);
     }
   }
@@ -105,8 +105,8 @@ void ClassTable::VisitRoots(const Visitor& visitor) {
 template <typename Visitor, ReadBarrierOption kReadBarrierOption>
 bool ClassTable::Visit(Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (TableSlot& table_slot : class_set) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    for (TableSlot& table_slot : *class_set) {
       if (!visitor(table_slot.Read<kReadBarrierOption>())) {
         return false;
       }
@@ -118,8 +118,8 @@ bool ClassTable::Visit(Visitor& visitor) {
 template <typename Visitor, ReadBarrierOption kReadBarrierOption>
 bool ClassTable::Visit(const Visitor& visitor) {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    for (TableSlot& table_slot : class_set) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    for (TableSlot& table_slot : *class_set) {
       if (!visitor(table_slot.Read<kReadBarrierOption>())) {
         return false;
       }
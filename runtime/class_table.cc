@@ -22,15 +22,50 @@
 
 namespace art {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock),
+      published_classes_(nullptr),
+      removal_sequence_(0u) {
   Runtime* const runtime = Runtime::Current();
-  classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
-                              runtime->GetHashTableMaxLoadFactor()));
+  classes_.push_back(std::make_unique<ClassSet>(runtime->GetHashTableMinLoadFactor(),
+                                                runtime->GetHashTableMaxLoadFactor()));
+  published_classes_owner_.reset(new ClassSetList{classes_.back().get()});
+  published_classes_.store(published_classes_owner_.get(), std::memory_order_release);
+}
+
+void ClassTable::PublishClassSets() {
+  std::unique_ptr<ClassSetList> list(new ClassSetList());
+  list->reserve(classes_.size());
+  for (const std::unique_ptr<ClassSet>& class_set : classes_) {
+    list->push_back(class_set.get());
+  }
+  published_classes_.store(list.get(), std::memory_order_release);
+  if (published_classes_owner_ != nullptr) {
+    retired_class_lists_.push_back(std::move(published_classes_owner_));
+  }
+  published_classes_owner_ = std::move(list);
+}
+
+void ClassTable::GrowLatestClassSet() {
+  const ClassSet& latest = *classes_.back();
+  std::unique_ptr<ClassSet> grown(new ClassSet(latest.GetMinLoadFactor(),
+                                               latest.GetMaxLoadFactor(),
+                                               latest.get_allocator()));
+  // Same growth as HashSet::Expand, based on the minimum load factor.
+  size_t num_buckets = static_cast<size_t>((latest.size() + 1u) / latest.GetMinLoadFactor());
+  grown->reserve(static_cast<size_t>(num_buckets * latest.GetMaxLoadFactor()));
+  for (const TableSlot& slot : latest) {
+    grown->insert(slot);
+  }
+  retired_classes_.push_back(std::move(classes_.back()));
+  classes_.back() = std::move(grown);
+  PublishClassSets();
 }
 
 void ClassTable::FreezeSnapshot() {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.push_back(ClassSet());
+  classes_.push_back(std::make_unique<ClassSet>());
+  PublishClassSets();
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
@@ -39,10 +74,10 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
   WriterMutexLock mu(Thread::Current(), lock_);
   // Should only be updating latest table.
   DescriptorHashPair pair(descriptor, hash);
-  auto existing_it = classes_.back().FindWithHash(pair, hash);
-  if (existing_it == classes_.back().end()) {
-    for (const ClassSet& class_set : classes_) {
-      if (class_set.FindWithHash(pair, hash) != class_set.end()) {
+  auto existing_it = classes_.back()->FindWithHash(pair, hash);
+  if (existing_it == classes_.back()->end()) {
+    for (const std::unique_ptr<ClassSet>& class_set : classes_) {
+      if (class_set->FindWithHash(pair, hash) != class_set->end()) {
         LOG(FATAL) << "Updating class found in frozen table " << descriptor;
       }
     }
@@ -55,7 +90,7 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(const char* descriptor,
   CHECK(!klass->IsTemp()) << descriptor;
   VerifyObject(klass);
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
-  // doesn't change.
+  // doesn't change, and lock-free readers see either the old or the new class.
   *existing_it = TableSlot(klass, hash);
   return existing;
 }
@@ -75,36 +110,57 @@ size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader)
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
   for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
+    sum += CountDefiningLoaderClasses(defining_loader, *classes_[i]);
   }
   return sum;
 }
 
 size_t ClassTable::NumNonZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return CountDefiningLoaderClasses(defining_loader, classes_.back());
+  return CountDefiningLoaderClasses(defining_loader, *classes_.back());
 }
 
 size_t ClassTable::NumReferencedZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
   for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].size();
+    sum += classes_[i]->size();
   }
   return sum;
 }
 
 size_t ClassTable::NumReferencedNonZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
-  return classes_.back().size();
+  return classes_.back()->size();
 }
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
+  // Published sets are never resized in place, and inserting a class only
+  // fills an empty slot, so we can search them without the lock.
+  const uint32_t sequence = removal_sequence_.load(std::memory_order_acquire);
+  if (LIKELY((sequence & 1u) == 0u)) {
+    const ClassSetList* class_sets = published_classes_.load(std::memory_order_acquire);
+    for (const ClassSet* class_set : *class_sets) {
+      auto it = class_set->FindWithHash(pair, hash);
+      if (it != class_set->end()) {
+        return it->Read();
+      }
+    }
+    // A miss is only reliable if no class was moved by a removal meanwhile.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (removal_sequence_.load(std::memory_order_relaxed) == sequence) {
+      return nullptr;
+    }
+  }
   ReaderMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.FindWithHash(pair, hash);
-    if (it != class_set.end()) {
+  return LookupLocked(pair, hash);
+}
+
+ObjPtr<mirror::Class> ClassTable::LookupLocked(const DescriptorHashPair& pair, size_t hash) {
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    auto it = class_set->FindWithHash(pair, hash);
+    if (it != class_set->end()) {
       return it->Read();
     }
   }
@@ -117,16 +173,27 @@ void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  const ClassSet& latest = *classes_.back();
+  if (latest.size() >= static_cast<size_t>(latest.NumBuckets() * latest.GetMaxLoadFactor())) {
+    GrowLatestClassSet();
+  }
+  ClassSet* class_set = classes_.back().get();
+  const size_t num_buckets = class_set->NumBuckets();
+  class_set->InsertWithHash(TableSlot(klass, hash), hash);
+  DCHECK_EQ(num_buckets, class_set->NumBuckets()) << "Class set resized in place";
 }
 
 bool ClassTable::Remove(const char* descriptor) {
   DescriptorHashPair pair(descriptor, ComputeModifiedUtf8Hash(descriptor));
   WriterMutexLock mu(Thread::Current(), lock_);
-  for (ClassSet& class_set : classes_) {
-    auto it = class_set.find(pair);
-    if (it != class_set.end()) {
-      class_set.erase(it);
+  for (std::unique_ptr<ClassSet>& class_set : classes_) {
+    auto it = class_set->find(pair);
+    if (it != class_set->end()) {
+      // Erasing shifts classes of the set back, tell lock-free readers to check their misses.
+      removal_sequence_.fetch_add(1u, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      class_set->erase(it);
+      removal_sequence_.fetch_add(1u, std::memory_order_release);
       return true;
     }
   }
@@ -176,7 +243,8 @@ size_t ClassTable::ReadFromMemory(uint8_t* ptr) {
 
 void ClassTable::AddClassSet(ClassSet&& set) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.insert(classes_.begin(), std::move(set));
+  classes_.insert(classes_.begin(), std::make_unique<ClassSet>(std::move(set)));
+  PublishClassSets();
 }
 
 void ClassTable::ClearStrongRoots() {
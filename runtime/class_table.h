@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -59,8 +61,9 @@ class ClassTable {
 
     TableSlot(ObjPtr<mirror::Class> klass, uint32_t descriptor_hash);
 
+    // Release store so that lock-free readers of the table see the class the slot points to.
     TableSlot& operator=(const TableSlot& copy) {
-      data_.store(copy.data_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      data_.store(copy.data_.load(std::memory_order_relaxed), std::memory_order_release);
       return *this;
     }
 
@@ -199,6 +202,7 @@ class ClassTable {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Return the first class that matches the descriptor. Returns null if there are none.
+  // Does not take the lock, unless a class was removed while searching.
   ObjPtr<mirror::Class> Lookup(const char* descriptor, size_t hash)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -258,6 +262,19 @@ class ClassTable {
   }
 
  private:
+  using ClassSetList = std::vector<const ClassSet*>;
+
+  // Publish the current class sets to lock-free readers.
+  void PublishClassSets() REQUIRES(lock_);
+
+  // Replace the latest class set by a larger copy, instead of letting the
+  // insertion resize it under the feet of lock-free readers.
+  void GrowLatestClassSet() REQUIRES(lock_);
+
+  ObjPtr<mirror::Class> LookupLocked(const DescriptorHashPair& pair, size_t hash)
+      REQUIRES_SHARED(lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   size_t CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defining_loader,
                                     const ClassSet& set) const
       REQUIRES(lock_)
@@ -268,10 +285,23 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Lock to guard inserting and removing.
+  // Lock to guard inserting and removing. Lookups do not take it.
   mutable ReaderWriterMutex lock_;
   // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // Sets are allocated separately so that they do not move when the vector changes.
+  std::vector<std::unique_ptr<ClassSet>> classes_ GUARDED_BY(lock_);
+  // The sets of `classes_`, as seen by lock-free readers. Only inserting a
+  // class in the latest set and removing a class modify a published set.
+  std::atomic<const ClassSetList*> published_classes_;
+  std::unique_ptr<const ClassSetList> published_classes_owner_ GUARDED_BY(lock_);
+  // Sets and lists that readers may still be searching. Each replaced set is
+  // half the size of its replacement, so these use less memory than the live
+  // table. They are deleted with the table.
+  std::vector<std::unique_ptr<const ClassSet>> retired_classes_ GUARDED_BY(lock_);
+  std::vector<std::unique_ptr<const ClassSetList>> retired_class_lists_ GUARDED_BY(lock_);
+  // Odd while a class is being removed. Removing a class moves other classes of
+  // its set, so a lock-free reader may miss a class and must check this.
+  std::atomic<uint32_t> removal_sequence_;
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
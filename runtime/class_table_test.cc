@@ -16,6 +16,8 @@
 
 #include "class_table-inl.h"
 
+#include <atomic>
+
 #include "art_field-inl.h"
 #include "art_method-inl.h"
 #include "class_linker-inl.h"
@@ -27,6 +29,7 @@
 #include "mirror/class-alloc-inl.h"
 #include "obj_ptr.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace mirror {
@@ -66,6 +69,39 @@ class CollectRootVisitor {
 };
 
 
+using DescriptorList = std::vector<std::pair<std::string, uint32_t>>;
+
+class LookupTask : public Task {
+ public:
+  LookupTask(ClassTable* table,
+             const DescriptorList* descriptors,
+             size_t num_lookups,
+             std::atomic<size_t>* misses)
+      : table_(table), descriptors_(descriptors), num_lookups_(num_lookups), misses_(misses) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    size_t misses = 0;
+    for (size_t i = 0; i != num_lookups_; ++i) {
+      const std::pair<std::string, uint32_t>& entry = (*descriptors_)[i % descriptors_->size()];
+      if (table_->Lookup(entry.first.c_str(), entry.second) == nullptr) {
+        ++misses;
+      }
+    }
+    misses_->fetch_add(misses, std::memory_order_relaxed);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ClassTable* const table_;
+  const DescriptorList* const descriptors_;
+  const size_t num_lookups_;
+  std::atomic<size_t>* const misses_;
+};
+
 class ClassTableTest : public CommonRuntimeTest {};
 
 TEST_F(ClassTableTest, ClassTable) {
@@ -161,5 +197,66 @@ TEST_F(ClassTableTest, ClassTable) {
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
+// Look up all the boot classes from an increasing number of threads, while the
+// main thread keeps inserting and removing a class, and report the throughput.
+TEST_F(ClassTableTest, ConcurrentLookup) {
+  static constexpr size_t kLookupsPerThread = 1000000;
+  static constexpr size_t kMaxThreads = 8;
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<ClassLoader> class_loader(hs.NewHandle(soa.Decode<ClassLoader>(LoadDex("XandY"))));
+  const char* descriptor_x = "LX;";
+  Handle<mirror::Class> h_X(
+      hs.NewHandle(class_linker_->FindClass(soa.Self(), descriptor_x, class_loader)));
+  ASSERT_TRUE(h_X != nullptr);
+
+  ClassTable table;
+  DescriptorList descriptors;
+  std::vector<ObjPtr<mirror::Class>> classes;
+  ClassFuncVisitor visitor([&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+    if (klass->GetClassLoader() == nullptr) {
+      classes.push_back(klass);
+    }
+    return true;
+  });
+  class_linker_->VisitClasses(&visitor);
+  ASSERT_GT(classes.size(), 2u);
+  // Put half of the classes in a frozen snapshot, like a zygote would.
+  for (size_t i = 0; i != classes.size(); ++i) {
+    if (i == classes.size() / 2) {
+      table.FreezeSnapshot();
+    }
+    table.Insert(classes[i]);
+    std::string temp;
+    const char* descriptor = classes[i]->GetDescriptor(&temp);
+    descriptors.emplace_back(descriptor, ComputeModifiedUtf8Hash(descriptor));
+  }
+  classes.clear();
+
+  for (size_t num_threads = 1; num_threads <= kMaxThreads; num_threads *= 2) {
+    ThreadPool thread_pool("Class table test thread pool", num_threads);
+    std::atomic<size_t> misses(0);
+    for (size_t i = 0; i != num_threads; ++i) {
+      thread_pool.AddTask(
+          soa.Self(), new LookupTask(&table, &descriptors, kLookupsPerThread, &misses));
+    }
+    uint64_t start_ns = NanoTime();
+    thread_pool.StartWorkers(soa.Self());
+    // Make concurrent lookups fall back to the lock from time to time.
+    table.Insert(h_X.Get());
+    EXPECT_TRUE(table.Remove(descriptor_x));
+    {
+      ScopedThreadSuspension sts(soa.Self(), ThreadState::kNative);
+      thread_pool.Wait(soa.Self(), /* do_work= */ false, /* may_hold_locks= */ false);
+    }
+    uint64_t duration_ns = NanoTime() - start_ns;
+    EXPECT_EQ(misses.load(), 0u);
+    LOG(INFO) << num_threads << " threads: "
+              << static_cast<uint64_t>(
+                     static_cast<double>(num_threads * kLookupsPerThread) * 1e9 / duration_ns)
+              << " lookups/s";
+  }
+}
+
 }  // namespace mirror
 }  // namespace art
@@ -20,8 +20,11 @@
 #include "base/casts.h"
 #include "entrypoints/entrypoint_utils-inl.h"
 #include "indirect_reference_table.h"
+#include "jni/jni_transition_profiler.h"
+#include "jni/native_method_promotions.h"
 #include "mirror/object-inl.h"
 #include "palette/palette.h"
+#include "runtime.h"
 #include "thread-inl.h"
 #include "verify_object.h"
 
@@ -162,8 +165,19 @@ extern uint64_t GenericJniMethodEnd(Thread* self,
   } else if (fast_native) {
     // When we are in @FastNative, we are already Runnable.
     DCHECK(Locks::mutator_lock_->IsSharedHeld(self));
+    if (UNLIKELY(self->ReadFlag(ThreadFlag::kMonitorJniEntryExit))) {
+      JniTransitionProfiler* profiler = Runtime::Current()->GetJniTransitionProfiler();
+      if (profiler != nullptr) {
+        profiler->CountFastNativeCall(called);
+      }
+    }
+    if (UNLIKELY(NativeMethodPromotions::ShouldVerifyCall(self, called))) {
+      NativeMethodPromotions::EndVerifiedCall(self, called);
+    }
     // Only do a suspend check on the way out of JNI just like compiled stubs.
     self->CheckSuspend();
+  } else if (UNLIKELY(NativeMethodPromotions::ShouldVerifyCall(self, called))) {
+    NativeMethodPromotions::EndVerifiedCall(self, called);
   }
   // We need the mutator lock (i.e., calling `artJniMethodEnd()`) before accessing
   // the shorty or the locked object.
@@ -217,13 +231,29 @@ extern uint64_t GenericJniMethodEnd(Thread* self,
 }
 
 extern "C" void artJniMonitoredMethodStart(Thread* self) {
-  artJniMethodStart(self);
+  JniTransitionProfiler* profiler = Runtime::Current()->GetJniTransitionProfiler();
+  if (profiler != nullptr) {
+    ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+    JniTransitionProfiler::ScopedTransition transition(
+        profiler, self, native_method, JniTransitionProfiler::Transition::kToNative);
+    artJniMethodStart(self);
+  } else {
+    artJniMethodStart(self);
+  }
   MONITOR_JNI(PaletteNotifyBeginJniInvocation);
 }
 
 extern "C" void artJniMonitoredMethodEnd(Thread* self) {
   MONITOR_JNI(PaletteNotifyEndJniInvocation);
-  artJniMethodEnd(self);
+  JniTransitionProfiler* profiler = Runtime::Current()->GetJniTransitionProfiler();
+  if (profiler != nullptr) {
+    ArtMethod* native_method = *self->GetManagedStack()->GetTopQuickFrame();
+    JniTransitionProfiler::ScopedTransition transition(
+        profiler, self, native_method, JniTransitionProfiler::Transition::kToRunnable);
+    artJniMethodEnd(self);
+  } else {
+    artJniMethodEnd(self);
+  }
 }
 
 }  // namespace art
@@ -38,6 +38,7 @@
 #include "interpreter/shadow_frame-inl.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "jni/native_method_promotions.h"
 #include "linear_alloc.h"
 #include "method_handles.h"
 #include "mirror/class-inl.h"
@@ -2142,6 +2143,9 @@ extern "C" const void* artQuickGenericJniTrampoline(Thread* self,
   } else {
     DCHECK(!called->IsSynchronized())
         << "@FastNative/@CriticalNative and synchronize is not supported";
+    if (UNLIKELY(NativeMethodPromotions::ShouldVerifyCall(self, called))) {
+      NativeMethodPromotions::BeginVerifiedCall(self);
+    }
   }
 
   // Skip pushing IRT frame for @CriticalNative.
@@ -277,6 +277,11 @@ class ConcurrentCopying::ActivateReadBarrierEntrypointsCheckpoint : public Closu
     concurrent_copying_->GetBarrier().Pass(self);
   }
 
+  // Only updates `thread` and passes the barrier.
+  bool IsThreadSafe() const override {
+    return true;
+  }
+
  private:
   ConcurrentCopying* const concurrent_copying_;
 };
@@ -1737,6 +1742,11 @@ class ConcurrentCopying::DisableMarkingCheckpoint : public Closure {
     concurrent_copying_->GetBarrier().Pass(self);
   }
 
+  // Only updates `thread` and passes the barrier.
+  bool IsThreadSafe() const override {
+    return true;
+  }
+
  private:
   ConcurrentCopying* const concurrent_copying_;
 };
@@ -93,6 +93,7 @@
 #include "mirror/object_array-inl.h"
 #include "mirror/reference-inl.h"
 #include "mirror/var_handle.h"
+#include "monitor.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "obj_ptr-inl.h"
 #ifdef ART_TARGET_ANDROID
@@ -180,6 +181,15 @@ static constexpr double kMinFreeHeapAfterGcForAlloc = 0.01;
 
 // For deterministic compilation, we need the heap to be at a well-known address.
 static constexpr uint32_t kAllocSpaceBeginForDeterministicAoT = 0x40000000;
+
+// Minimum number of inflated monitors before we deflate idle ones in a process that cares about
+// pause times.
+static constexpr size_t kMinMonitorsForIdleDeflation = 256;
+
+// Minimum time between two idle monitor marking passes, and so time a monitor needs to stay unused
+// before it gets deflated in a process that cares about pause times.
+static constexpr uint64_t kIdleMonitorDeflationIntervalNs = MsToNs(10000);
+
 // Dump the rosalloc stats on SIGQUIT.
 static constexpr bool kDumpRosAllocStatsOnSigQuit = false;
 
@@ -385,6 +395,7 @@ Heap::Heap(size_t initial_size,
       min_interval_homogeneous_space_compaction_by_oom_(
           min_interval_homogeneous_space_compaction_by_oom),
       last_time_homogeneous_space_compaction_by_oom_(NanoTime()),
+      last_idle_monitor_marking_ns_(0u),
       gcs_completed_(0u),
       max_gc_requested_(0u),
       pending_collector_transition_(nullptr),
@@ -1516,17 +1527,30 @@ void Heap::DoPendingCollectorTransition() {
 
 void Heap::Trim(Thread* self) {
   Runtime* const runtime = Runtime::Current();
-  if (!CareAboutPauseTimes()) {
+  MonitorList* const monitor_list = runtime->GetMonitorList();
+  const bool care_about_pause_times = CareAboutPauseTimes();
+  bool deflate_monitors = !care_about_pause_times;
+  if (care_about_pause_times && monitor_list->Size() >= kMinMonitorsForIdleDeflation) {
+    // Only deflate the monitors that stayed unused for a whole interval, and only pause when the
+    // marking pass, which does not suspend mutators, finds some.
+    uint64_t now = NanoTime();
+    uint64_t last = last_idle_monitor_marking_ns_.load(std::memory_order_relaxed);
+    if (now - last >= kIdleMonitorDeflationIntervalNs &&
+        last_idle_monitor_marking_ns_.CompareAndSetStrongRelaxed(last, now)) {
+      deflate_monitors = monitor_list->MarkIdleMonitors() != 0u;
+    }
+  }
+  if (deflate_monitors) {
     // Deflate the monitors, this can cause a pause but shouldn't matter since we don't care
-    // about pauses.
+    // about pauses, or there are idle monitors to reclaim.
     ScopedTrace trace("Deflating monitors");
     // Avoid race conditions on the lock word for CC.
     ScopedGCCriticalSection gcs(self, kGcCauseTrim, kCollectorTypeHeapTrim);
     ScopedSuspendAll ssa(__FUNCTION__);
     uint64_t start_time = NanoTime();
-    size_t count = runtime->GetMonitorList()->DeflateMonitors();
-    VLOG(heap) << "Deflating " << count << " monitors took "
-        << PrettyDuration(NanoTime() - start_time);
+    size_t count = monitor_list->DeflateMonitors(/*only_idle=*/ care_about_pause_times);
+    VLOG(heap) << "Deflating " << count << " monitors (" << PrettySize(count * sizeof(Monitor))
+        << ") took " << PrettyDuration(NanoTime() - start_time);
   }
   TrimIndirectReferenceTables(self);
   TrimSpaces(self);
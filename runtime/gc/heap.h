@@ -1602,6 +1602,9 @@ class Heap {
   // Times of the last homogeneous space compaction caused by OOM.
   uint64_t last_time_homogeneous_space_compaction_by_oom_;
 
+  // Time of the last idle monitor marking pass, see Trim().
+  Atomic<uint64_t> last_idle_monitor_marking_ns_;
+
   // Saved OOMs by homogeneous space compaction.
   Atomic<size_t> count_delayed_oom_;
 
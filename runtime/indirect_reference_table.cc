@@ -116,10 +116,12 @@ void SmallIrtAllocator::Deallocate(IrtEntry* unneeded) {
 IndirectReferenceTable::IndirectReferenceTable(size_t max_count,
                                                IndirectRefKind desired_kind,
                                                ResizableCapacity resizable,
-                                               std::string* error_msg)
+                                               std::string* error_msg,
+                                               uint32_t index_base)
     : segment_state_(kIRTFirstSegment),
       table_(nullptr),
       kind_(desired_kind),
+      index_base_(index_base),
       max_entries_(max_count),
       current_num_holes_(0),
       resizable_(resizable) {
@@ -318,13 +320,20 @@ IndirectRef IndirectReferenceTable::Add(IRTSegmentState previous_state,
   VerifyObject(obj);
   DCHECK(table_ != nullptr);
 
-  if (top_index == max_entries_) {
+  RecoverHoles(previous_state);
+  CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
+
+  // A full table can still take the reference if it has a hole.
+  if (top_index == max_entries_ && current_num_holes_ == 0) {
     if (resizable_ == ResizableCapacity::kNo) {
-      std::ostringstream oss;
-      oss << "JNI ERROR (app bug): " << kind_ << " table overflow "
-          << "(max=" << max_entries_ << ")"
-          << MutatorLockedDumpable<IndirectReferenceTable>(*this);
-      *error_msg = oss.str();
+      // Without an `error_msg`, the caller only checks for space, skip the table dump.
+      if (error_msg != nullptr) {
+        std::ostringstream oss;
+        oss << "JNI ERROR (app bug): " << kind_ << " table overflow "
+            << "(max=" << max_entries_ << ")"
+            << MutatorLockedDumpable<IndirectReferenceTable>(*this);
+        *error_msg = oss.str();
+      }
       return nullptr;
     }
 
@@ -351,9 +360,6 @@ IndirectRef IndirectReferenceTable::Add(IRTSegmentState previous_state,
     }
   }
 
-  RecoverHoles(previous_state);
-  CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
-
   // We know there's enough room in the table.  Now we just need to find
   // the right spot.  If there's a hole, find it and fill it; otherwise,
   // add to the end of the list.
@@ -560,6 +566,32 @@ void IndirectReferenceTable::SetSegmentState(IRTSegmentState new_state) {
   segment_state_ = new_state;
 }
 
+void IndirectReferenceTable::Truncate(IRTSegmentState previous_state,
+                                      IRTSegmentState new_state) {
+  DCHECK_LE(previous_state.top_index, new_state.top_index);
+  DCHECK_LE(new_state.top_index, segment_state_.top_index);
+  RecoverHoles(previous_state);
+  CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
+
+  uint32_t top_index = new_state.top_index;
+  if (current_num_holes_ != 0) {
+    current_num_holes_ -= CountNullEntries(table_, top_index, segment_state_.top_index);
+    // As in Remove, also consume the holes right below the new top.
+    while (current_num_holes_ != 0 &&
+           top_index > previous_state.top_index &&
+           table_[top_index - 1].GetReference()->IsNull()) {
+      --top_index;
+      --current_num_holes_;
+    }
+  }
+  if (kDebugIRT) {
+    LOG(INFO) << "+++ truncated " << segment_state_.top_index << " -> " << top_index
+              << ", holes=" << current_num_holes_;
+  }
+  segment_state_.top_index = top_index;
+  CheckHoleCount(table_, current_num_holes_, previous_state, segment_state_);
+}
+
 bool IndirectReferenceTable::EnsureFreeCapacity(size_t free_capacity, std::string* error_msg) {
   size_t top_index = segment_state_.top_index;
   if (top_index < max_entries_ && top_index + free_capacity <= max_entries_) {
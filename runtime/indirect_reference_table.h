@@ -264,10 +264,14 @@ class IndirectReferenceTable {
   // state.
   // Max_count is the minimum initial capacity (resizable), or minimum total capacity
   // (not resizable). A value of 1 indicates an implementation-convenient small size.
+  // Index_base is added to the index of the entries encoded in the references handed out
+  // by the table, so that the references of tables with disjoint index ranges can be told
+  // apart with GetEncodedIndex.
   IndirectReferenceTable(size_t max_count,
                          IndirectRefKind kind,
                          ResizableCapacity resizable,
-                         std::string* error_msg);
+                         std::string* error_msg,
+                         uint32_t index_base = 0u);
 
   ~IndirectReferenceTable();
 
@@ -281,7 +285,9 @@ class IndirectReferenceTable {
   bool IsValid() const;
 
   // Add a new entry. "obj" must be a valid non-null object reference. This function will
-  // return null if an error happened (with an appropriate error message set).
+  // return null if an error happened (with an appropriate error message set). A full table
+  // still takes the entry if it has a hole. For tables that cannot be resized, "error_msg"
+  // may be null to try to add without formatting the overflow error.
   IndirectRef Add(IRTSegmentState previous_state,
                   ObjPtr<mirror::Object> obj,
                   std::string* error_msg)
@@ -360,6 +366,11 @@ class IndirectReferenceTable {
 
   void SetSegmentState(IRTSegmentState new_state);
 
+  // Remove all the entries at or above `new_state`, which must be within the segment that
+  // starts at `previous_state`. Unlike SetSegmentState, which pops whole segments, this keeps
+  // the hole count of the current segment right, so that the segment can keep growing.
+  void Truncate(IRTSegmentState previous_state, IRTSegmentState new_state);
+
   static Offset SegmentStateOffset(size_t pointer_size ATTRIBUTE_UNUSED) {
     // Note: Currently segment_state_ is at offset 0. We're testing the expected value in
     //       jni_internal_test to make sure it stays correct. It is not OFFSETOF_MEMBER, as that
@@ -375,6 +386,11 @@ class IndirectReferenceTable {
     return DecodeIndirectRefKind(reinterpret_cast<uintptr_t>(iref));
   }
 
+  // Return the index encoded in the reference, including the index base of its table.
+  ALWAYS_INLINE static inline uint32_t GetEncodedIndex(IndirectRef iref) {
+    return DecodeIndex(reinterpret_cast<uintptr_t>(iref));
+  }
+
   /* Reference validation for CheckJNI. */
   bool IsValidReference(IndirectRef, /*out*/std::string* error_msg) const
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -412,14 +428,16 @@ class IndirectReferenceTable {
 
   constexpr uintptr_t EncodeIndirectRef(uint32_t table_index, uint32_t serial) const {
     DCHECK_LT(table_index, max_entries_);
-    return EncodeIndex(table_index) | EncodeSerial(serial) | EncodeIndirectRefKind(kind_);
+    return EncodeIndex(index_base_ + table_index) |
+           EncodeSerial(serial) |
+           EncodeIndirectRefKind(kind_);
   }
 
   static void ConstexprChecks();
 
   // Extract the table index from an indirect reference.
-  ALWAYS_INLINE static uint32_t ExtractIndex(IndirectRef iref) {
-    return DecodeIndex(reinterpret_cast<uintptr_t>(iref));
+  ALWAYS_INLINE uint32_t ExtractIndex(IndirectRef iref) const {
+    return DecodeIndex(reinterpret_cast<uintptr_t>(iref)) - index_base_;
   }
 
   IndirectRef ToIndirectRef(uint32_t table_index) const {
@@ -452,6 +470,9 @@ class IndirectReferenceTable {
   // bit mask, ORed into all irefs.
   const IndirectRefKind kind_;
 
+  // Added to the table index of the entries in all irefs.
+  const uint32_t index_base_;
+
   // max #of entries allowed (modulo resizing).
   size_t max_entries_;
 
@@ -512,4 +512,151 @@ TEST_F(IndirectReferenceTableTest, Resize) {
   EXPECT_EQ(irt.Capacity(), kTableMax + 1);
 }
 
+TEST_F(IndirectReferenceTableTest, IndexBase) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 20;
+  static const uint32_t kIndexBase = 1000;
+
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> c = hs.NewHandle(
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+
+  std::string error_msg;
+  IndirectReferenceTable irt0(kTableMax,
+                              kGlobal,
+                              IndirectReferenceTable::ResizableCapacity::kNo,
+                              &error_msg);
+  ASSERT_TRUE(irt0.IsValid()) << error_msg;
+  IndirectReferenceTable irt1(kTableMax,
+                              kGlobal,
+                              IndirectReferenceTable::ResizableCapacity::kNo,
+                              &error_msg,
+                              kIndexBase);
+  ASSERT_TRUE(irt1.IsValid()) << error_msg;
+
+  const IRTSegmentState cookie = kIRTFirstSegment;
+  IndirectRef iref0 = irt0.Add(cookie, obj0.Get(), &error_msg);
+  EXPECT_TRUE(iref0 != nullptr);
+  IndirectRef iref1 = irt1.Add(cookie, obj0.Get(), &error_msg);
+  EXPECT_TRUE(iref1 != nullptr);
+
+  // The first entry of each table is encoded with the index base of the table.
+  EXPECT_EQ(0u, IndirectReferenceTable::GetEncodedIndex(iref0));
+  EXPECT_EQ(kIndexBase, IndirectReferenceTable::GetEncodedIndex(iref1));
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt1.Get(iref1));
+
+  // References of one table are not valid in the other.
+  EXPECT_TRUE(irt1.IsValidReference(iref1, &error_msg)) << error_msg;
+  EXPECT_FALSE(irt1.IsValidReference(iref0, &error_msg));
+  EXPECT_FALSE(irt0.IsValidReference(iref1, &error_msg));
+
+  EXPECT_TRUE(irt1.Remove(cookie, iref1));
+  EXPECT_EQ(0u, irt1.Capacity());
+}
+
+TEST_F(IndirectReferenceTableTest, FullTableWithHoles) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 20;
+
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::Class> c = hs.NewHandle(
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+
+  std::string error_msg;
+  IndirectReferenceTable irt(kTableMax,
+                             kGlobal,
+                             IndirectReferenceTable::ResizableCapacity::kNo,
+                             &error_msg);
+  ASSERT_TRUE(irt.IsValid()) << error_msg;
+  // The capacity is rounded up to whole pages.
+  const size_t max_entries = irt.FreeCapacity();
+
+  const IRTSegmentState cookie = kIRTFirstSegment;
+  std::vector<IndirectRef> refs;
+  for (size_t i = 0; i != max_entries; ++i) {
+    refs.push_back(irt.Add(cookie, obj0.Get(), &error_msg));
+    ASSERT_TRUE(refs.back() != nullptr) << "Failed adding " << i;
+  }
+  EXPECT_EQ(0u, irt.FreeCapacity());
+  EXPECT_TRUE(irt.Add(cookie, obj0.Get(), /*error_msg=*/ nullptr) == nullptr);
+  error_msg.clear();
+  EXPECT_TRUE(irt.Add(cookie, obj0.Get(), &error_msg) == nullptr);
+  EXPECT_NE(error_msg.find("table overflow"), std::string::npos) << error_msg;
+
+  // The hole left by the removal is reused.
+  ASSERT_TRUE(irt.Remove(cookie, refs[1]));
+  IndirectRef iref = irt.Add(cookie, obj0.Get(), &error_msg);
+  ASSERT_TRUE(iref != nullptr) << error_msg;
+  EXPECT_EQ(IndirectReferenceTable::GetEncodedIndex(refs[1]),
+            IndirectReferenceTable::GetEncodedIndex(iref));
+  EXPECT_TRUE(irt.Add(cookie, obj0.Get(), &error_msg) == nullptr);
+}
+
+
+TEST_F(IndirectReferenceTableTest, Truncate) {
+  ScopedObjectAccess soa(Thread::Current());
+  static const size_t kTableMax = 20;
+
+  StackHandleScope<4> hs(soa.Self());
+  Handle<mirror::Class> c = hs.NewHandle(
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(c != nullptr);
+  Handle<mirror::Object> obj0 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj0 != nullptr);
+  Handle<mirror::Object> obj1 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj1 != nullptr);
+  Handle<mirror::Object> obj2 = hs.NewHandle(c->AllocObject(soa.Self()));
+  ASSERT_TRUE(obj2 != nullptr);
+
+  std::string error_msg;
+  IndirectReferenceTable irt(kTableMax,
+                             kLocal,
+                             IndirectReferenceTable::ResizableCapacity::kNo,
+                             &error_msg);
+  ASSERT_TRUE(irt.IsValid()) << error_msg;
+
+  // An entry of the previous segment stays alive.
+  IndirectRef iref0 = irt.Add(kIRTFirstSegment, obj0.Get(), &error_msg);
+  const IRTSegmentState cookie = irt.GetSegmentState();
+
+  IndirectRef iref1 = irt.Add(cookie, obj1.Get(), &error_msg);
+  const IRTSegmentState mark = irt.GetSegmentState();
+  IndirectRef iref2 = irt.Add(cookie, obj2.Get(), &error_msg);
+  IndirectRef iref3 = irt.Add(cookie, obj2.Get(), &error_msg);
+  IndirectRef iref4 = irt.Add(cookie, obj2.Get(), &error_msg);
+  EXPECT_TRUE(irt.Remove(cookie, iref3));
+  EXPECT_EQ(5u, irt.Capacity());
+
+  // Removes the entries added after the mark, and the hole among them.
+  irt.Truncate(cookie, mark);
+  EXPECT_EQ(2u, irt.Capacity());
+  EXPECT_TRUE(irt.IsValidReference(iref0, &error_msg)) << error_msg;
+  EXPECT_TRUE(irt.IsValidReference(iref1, &error_msg)) << error_msg;
+  EXPECT_FALSE(irt.IsValidReference(iref2, &error_msg));
+  EXPECT_FALSE(irt.IsValidReference(iref4, &error_msg));
+
+  // Holes right below the mark are consumed, and the segment can keep growing.
+  IndirectRef iref5 = irt.Add(cookie, obj2.Get(), &error_msg);
+  const IRTSegmentState mark2 = irt.GetSegmentState();
+  IndirectRef iref6 = irt.Add(cookie, obj2.Get(), &error_msg);
+  EXPECT_TRUE(irt.Remove(cookie, iref5));
+  irt.Truncate(cookie, mark2);
+  EXPECT_EQ(2u, irt.Capacity());
+  EXPECT_FALSE(irt.IsValidReference(iref6, &error_msg));
+  IndirectRef iref7 = irt.Add(cookie, obj2.Get(), &error_msg);
+  EXPECT_EQ(3u, irt.Capacity());
+  EXPECT_OBJ_PTR_EQ(obj2.Get(), irt.Get(iref7));
+
+  // Truncating to the start of the segment leaves the previous segment as it was.
+  irt.Truncate(cookie, cookie);
+  EXPECT_EQ(1u, irt.Capacity());
+  EXPECT_OBJ_PTR_EQ(obj0.Get(), irt.Get(iref0));
+}
+
 }  // namespace art
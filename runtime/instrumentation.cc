@@ -40,6 +40,7 @@
 #include "interpreter/interpreter_common.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "jni/native_method_promotions.h"
 #include "jvalue-inl.h"
 #include "jvalue.h"
 #include "mirror/class-inl.h"
@@ -297,12 +298,15 @@ static bool CanUseAotCode(ArtMethod* method, const void* quick_code)
   if (quick_code == nullptr) {
     return false;
   }
+  Runtime* runtime = Runtime::Current();
   if (method->IsNative()) {
-    // AOT code for native methods can always be used.
-    return true;
+    // AOT code for native methods can always be used, unless the method was promoted to
+    // @FastNative or @CriticalNative and the code compiled for normal JNI. Such methods use
+    // the generic JNI stub until the JIT compiles one for them.
+    const NativeMethodPromotions* promotions = runtime->GetNativeMethodPromotions();
+    return LIKELY(promotions == nullptr) || !promotions->IsPromoted(method);
   }
 
-  Runtime* runtime = Runtime::Current();
   // For simplicity, we never use AOT code for debuggable.
   if (runtime->IsJavaDebuggable()) {
     return false;
@@ -1076,7 +1080,15 @@ void Instrumentation::UpdateMethodsCodeImpl(ArtMethod* method, const void* new_c
     DCHECK(method->GetEntryPointFromQuickCompiledCode() == GetQuickInstrumentationEntryPoint() ||
         class_linker->IsQuickToInterpreterBridge(method->GetEntryPointFromQuickCompiledCode()))
               << EntryPointString(method->GetEntryPointFromQuickCompiledCode());
-    // If the code we want to update the method with still needs entry/exit stub, just skip.
+    // A method that can now use nterp, typically after its class got verified, leaves the
+    // switch interpreter for the entry stub, which dispatches to nterp and reports the events.
+    if (new_code == interpreter::GetNterpEntryPoint() &&
+        class_linker->IsQuickToInterpreterBridge(method->GetEntryPointFromQuickCompiledCode()) &&
+        !InterpretOnly(method)) {
+      UpdateEntryPoints(method, GetQuickInstrumentationEntryPoint());
+    }
+    // Otherwise, if the code we want to update the method with still needs entry/exit stub,
+    // just skip.
     return;
   }
 
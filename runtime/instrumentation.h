@@ -390,6 +390,15 @@ class Instrumentation {
     return have_exception_handled_listeners_;
   }
 
+  // Whether listeners are installed for events that only the switch interpreter reports. Method
+  // entry, exit and unwind events are also reported by the entry/exit stubs, for compiled code
+  // and nterp frames alike.
+  bool HasListenersNeedingInterpreter() const REQUIRES_SHARED(Locks::mutator_lock_) {
+    return have_dex_pc_listeners_ || have_field_read_listeners_ || have_field_write_listeners_ ||
+        have_exception_thrown_listeners_ || have_branch_listeners_ ||
+        have_watched_frame_pop_listeners_ || have_exception_handled_listeners_;
+  }
+
   bool IsActive() const REQUIRES_SHARED(Locks::mutator_lock_) {
     return have_dex_pc_listeners_ || have_method_entry_listeners_ || have_method_exit_listeners_ ||
         have_field_read_listeners_ || have_field_write_listeners_ ||
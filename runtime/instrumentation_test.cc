@@ -744,6 +744,37 @@ TEST_F(InstrumentationTest, MethodTracing_InstrumentationEntryExitStubs) {
   EXPECT_FALSE(instr->AreAllMethodsDeoptimized());
 }
 
+TEST_F(InstrumentationTest, ListenersNeedingInterpreter) {
+  ScopedObjectAccess soa(Thread::Current());
+  instrumentation::Instrumentation* instr = Runtime::Current()->GetInstrumentation();
+  TestInstrumentationListener listener;
+  auto check_listener = [&](uint32_t events, bool needs_interpreter)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    {
+      ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+      ScopedSuspendAll ssa("Add instrumentation listener");
+      instr->AddListener(&listener, events);
+    }
+    EXPECT_TRUE(instr->IsActive());
+    EXPECT_EQ(needs_interpreter, instr->HasListenersNeedingInterpreter());
+    {
+      ScopedThreadSuspension sts(soa.Self(), ThreadState::kSuspended);
+      ScopedSuspendAll ssa("Remove instrumentation listener");
+      instr->RemoveListener(&listener, events);
+    }
+    EXPECT_FALSE(instr->IsActive());
+  };
+
+  // Method events are reported by the entry/exit stubs, so nterp can keep running.
+  check_listener(instrumentation::Instrumentation::kMethodEntered |
+                     instrumentation::Instrumentation::kMethodExited |
+                     instrumentation::Instrumentation::kMethodUnwind,
+                 /*needs_interpreter=*/ false);
+  check_listener(instrumentation::Instrumentation::kDexPcMoved, /*needs_interpreter=*/ true);
+  check_listener(instrumentation::Instrumentation::kFieldRead, /*needs_interpreter=*/ true);
+  check_listener(instrumentation::Instrumentation::kExceptionThrown, /*needs_interpreter=*/ true);
+}
+
 // We use a macro to print the line number where the test is failing.
 #define CHECK_INSTRUMENTATION(_level, _user_count)                                      \
   do {                                                                                  \
@@ -93,40 +93,66 @@ inline size_t InternTable::AddTableFromMemory(const uint8_t* ptr,
   size_t read_count = 0;
   UnorderedSet set(ptr, /*make copy*/false, &read_count);
   {
-    // Hold the lock while calling the visitor to prevent possible race
+    // Hold the lock and block the shards while calling the visitor to prevent possible race
     // conditions with another thread adding intern strings.
-    MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+    Thread* const self = Thread::Current();
+    MutexLock mu(self, *Locks::intern_table_lock_);
+    BlockShards(self);
     // Visit the unordered set, may remove elements.
     visitor(set);
     if (!set.empty()) {
-      strong_interns_.AddInternStrings(std::move(set), is_boot_image);
+      static constexpr bool kCheckDuplicates = kIsDebugBuild;
+      if (kCheckDuplicates) {
+        // Avoid doing read barriers since the space might not yet be added to the heap.
+        // See b/117803941
+        for (GcRoot<mirror::String>& string : set) {
+          CHECK(LookupStrongLocked(string.Read<kWithoutReadBarrier>()) == nullptr)
+              << "Already found " << string.Read<kWithoutReadBarrier>()->ToModifiedUtf8()
+              << " in the intern table";
+        }
+      }
+      image_interns_.AddInternStrings(std::move(set), is_boot_image);
     }
+    UnblockShards(self);
   }
   return read_count;
 }
 
 inline void InternTable::Table::AddInternStrings(UnorderedSet&& intern_strings,
                                                  bool is_boot_image) {
-  static constexpr bool kCheckDuplicates = kIsDebugBuild;
-  if (kCheckDuplicates) {
-    // Avoid doing read barriers since the space might not yet be added to the heap.
-    // See b/117803941
-    for (GcRoot<mirror::String>& string : intern_strings) {
-      CHECK(Find(string.Read<kWithoutReadBarrier>()) == nullptr)
-          << "Already found " << string.Read<kWithoutReadBarrier>()->ToModifiedUtf8()
-          << " in the intern table";
+  // Insert at the front since we add new interns into the back.
+  tables_.push_front(InternalTable(std::move(intern_strings), is_boot_image));
+  // Publish the image tables for lookups without the lock. The sets do not move: the deque keeps
+  // references to its elements when inserting at either end.
+  std::unique_ptr<ImageTableList> image_tables(new ImageTableList());
+  for (const InternalTable& table : tables_) {
+    if (table.is_image_) {
+      image_tables->push_back(&table.set_);
     }
   }
-  // Insert at the front since we add new interns into the back.
-  tables_.insert(tables_.begin(),
-                 InternalTable(std::move(intern_strings), is_boot_image));
+  image_tables_.store(image_tables.get(), std::memory_order_release);
+  image_table_lists_.push_back(std::move(image_tables));
+}
+
+template <typename Key>
+inline ObjPtr<mirror::String> InternTable::Table::FindInImages(const Key& key) const {
+  const ImageTableList* image_tables = image_tables_.load(std::memory_order_acquire);
+  for (const UnorderedSet* set : *image_tables) {
+    auto it = set->find(key);
+    if (it != set->end()) {
+      return it->Read();
+    }
+  }
+  return nullptr;
 }
 
+// Reads the shards without their locks, see LookupStrongLocked().
 template <typename Visitor>
 inline void InternTable::VisitInterns(const Visitor& visitor,
                                       bool visit_boot_images,
-                                      bool visit_non_boot_images) {
-  auto visit_tables = [&](std::vector<Table::InternalTable>& tables)
+                                      bool visit_non_boot_images)
+    NO_THREAD_SAFETY_ANALYSIS {
+  auto visit_tables = [&](std::deque<Table::InternalTable>& tables)
       NO_THREAD_SAFETY_ANALYSIS {
     for (Table::InternalTable& table : tables) {
       // Determine if we want to visit the table based on the flags..
@@ -140,14 +166,19 @@ inline void InternTable::VisitInterns(const Visitor& visitor,
       }
     }
   };
-  visit_tables(strong_interns_.tables_);
-  visit_tables(weak_interns_.tables_);
+  visit_tables(image_interns_.tables_);
+  for (size_t i = 0; i != num_shards_; ++i) {
+    visit_tables(shards_[i].strong_interns.tables_);
+    visit_tables(shards_[i].weak_interns.tables_);
+  }
 }
 
+// Reads the shards without their locks, see LookupStrongLocked().
 inline size_t InternTable::CountInterns(bool visit_boot_images,
-                                        bool visit_non_boot_images) const {
+                                        bool visit_non_boot_images) const
+    NO_THREAD_SAFETY_ANALYSIS {
   size_t ret = 0u;
-  auto visit_tables = [&](const std::vector<Table::InternalTable>& tables)
+  auto visit_tables = [&](const std::deque<Table::InternalTable>& tables)
       NO_THREAD_SAFETY_ANALYSIS {
     for (const Table::InternalTable& table : tables) {
       // Determine if we want to visit the table based on the flags..
@@ -159,8 +190,11 @@ inline size_t InternTable::CountInterns(bool visit_boot_images,
       }
     }
   };
-  visit_tables(strong_interns_.tables_);
-  visit_tables(weak_interns_.tables_);
+  visit_tables(image_interns_.tables_);
+  for (size_t i = 0; i != num_shards_; ++i) {
+    visit_tables(shards_[i].strong_interns.tables_);
+    visit_tables(shards_[i].weak_interns.tables_);
+  }
   return ret;
 }
 
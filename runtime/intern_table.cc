@@ -35,68 +35,175 @@
 
 namespace art {
 
+// Number of shards of the runtime interns. A power of two is not required.
+static constexpr size_t kNumShards = 16u;
+
+// Count the lookups answered by the image tables. Off by default, as the counter is shared by all
+// threads and these lookups do not take a lock otherwise.
+static constexpr bool kCountImageHits = false;
+
+// Scoped lock of a shard that counts the acquisitions which had to wait for another thread.
+class SCOPED_CAPABILITY InternTable::ShardMutexLock {
+ public:
+  ShardMutexLock(Thread* self, Shard& shard) ACQUIRE(shard.lock) NO_THREAD_SAFETY_ANALYSIS
+      : self_(self), shard_(shard) {
+    if (!shard.lock.ExclusiveTryLock(self)) {
+      shard.lock.ExclusiveLock(self);
+      ++shard.stats.lock_contentions;
+    }
+  }
+
+  ~ShardMutexLock() RELEASE() NO_THREAD_SAFETY_ANALYSIS {
+    shard_.lock.ExclusiveUnlock(self_);
+  }
+
+ private:
+  Thread* const self_;
+  Shard& shard_;
+  DISALLOW_COPY_AND_ASSIGN(ShardMutexLock);
+};
+
+static ObjPtr<mirror::String> CountHit(ObjPtr<mirror::String> s, uint64_t* hits) {
+  if (s != nullptr) {
+    ++*hits;
+  }
+  return s;
+}
+
+static ObjPtr<mirror::String> CountImageHit(ObjPtr<mirror::String> s,
+                                            std::atomic<uint64_t>* hits) {
+  if (kCountImageHits) {
+    hits->fetch_add(1u, std::memory_order_relaxed);
+  }
+  return s;
+}
+
+InternTable::Shard::Shard()
+    : lock("InternTable shard lock", kInternTableShardLock),
+      condition("InternTable shard condition", lock),
+      blocked(false),
+      log_new_roots(false),
+      weak_root_state(gc::kWeakRootStateNormal) {
+}
+
 InternTable::InternTable()
-    : log_new_roots_(false),
-      weak_intern_condition_("New intern condition", *Locks::intern_table_lock_),
-      weak_root_state_(gc::kWeakRootStateNormal) {
+    : num_shards_(Runtime::Current()->IsCompiler() ? 1u : kNumShards),
+      shards_(new Shard[num_shards_]),
+      image_hits_(0u) {
+}
+
+InternTable::Shard& InternTable::GetShard(ObjPtr<mirror::String> s) const {
+  return GetShard(s->GetHashCode());
+}
+
+InternTable::Shard& InternTable::GetShard(int32_t hash) const {
+  // The hash sets use the low bits of the hash, mix it so that the shards use other bits.
+  uint32_t mixed = static_cast<uint32_t>(hash) * 0x9e3779b9u;
+  return shards_[(mixed >> 16) % num_shards_];
 }
 
 size_t InternTable::Size() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.Size() + weak_interns_.Size();
+  return StrongSize() + WeakSize();
 }
 
 size_t InternTable::StrongSize() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return strong_interns_.Size();
+  Thread* const self = Thread::Current();
+  size_t size;
+  {
+    MutexLock mu(self, *Locks::intern_table_lock_);
+    size = image_interns_.Size();
+  }
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock mu(self, shards_[i].lock);
+    size += shards_[i].strong_interns.Size();
+  }
+  return size;
 }
 
 size_t InternTable::WeakSize() const {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  return weak_interns_.Size();
+  Thread* const self = Thread::Current();
+  size_t size = 0u;
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock mu(self, shards_[i].lock);
+    size += shards_[i].weak_interns.Size();
+  }
+  return size;
 }
 
 void InternTable::DumpForSigQuit(std::ostream& os) const {
+  Thread* const self = Thread::Current();
+  Stats stats;
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock mu(self, shards_[i].lock);
+    stats.locked_lookups += shards_[i].stats.locked_lookups;
+    stats.locked_hits += shards_[i].stats.locked_hits;
+    stats.lock_contentions += shards_[i].stats.lock_contentions;
+    stats.waits += shards_[i].stats.waits;
+  }
   os << "Intern table: " << StrongSize() << " strong; " << WeakSize() << " weak\n";
+  os << "Intern table lookups: ";
+  if (kCountImageHits) {
+    os << image_hits_.load(std::memory_order_relaxed) << " image hits; ";
+  }
+  os << stats.locked_lookups << " locked (" << stats.locked_hits << " hits); "
+     << stats.lock_contentions << " contended; " << stats.waits << " waits; "
+     << num_shards_ << " shards\n";
 }
 
 void InternTable::VisitRoots(RootVisitor* visitor, VisitRootFlags flags) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+  Thread* const self = Thread::Current();
+  // Exclude the operations on the whole table, which read the shards without their locks.
+  MutexLock mu(self, *Locks::intern_table_lock_);
   if ((flags & kVisitRootFlagAllRoots) != 0) {
-    strong_interns_.VisitRoots(visitor);
-  } else if ((flags & kVisitRootFlagNewRoots) != 0) {
-    for (auto& root : new_strong_intern_roots_) {
-      ObjPtr<mirror::String> old_ref = root.Read<kWithoutReadBarrier>();
-      root.VisitRoot(visitor, RootInfo(kRootInternedString));
-      ObjPtr<mirror::String> new_ref = root.Read<kWithoutReadBarrier>();
-      if (new_ref != old_ref) {
-        // The GC moved a root in the log. Need to search the strong interns and update the
-        // corresponding object. This is slow, but luckily for us, this may only happen with a
-        // concurrent moving GC.
-        strong_interns_.Remove(old_ref);
-        strong_interns_.Insert(new_ref);
+    image_interns_.VisitRoots(visitor);
+  }
+  for (size_t i = 0; i != num_shards_; ++i) {
+    Shard& shard = shards_[i];
+    MutexLock shard_mu(self, shard.lock);
+    if ((flags & kVisitRootFlagAllRoots) != 0) {
+      shard.strong_interns.VisitRoots(visitor);
+    } else if ((flags & kVisitRootFlagNewRoots) != 0) {
+      for (auto& root : shard.new_strong_intern_roots) {
+        ObjPtr<mirror::String> old_ref = root.Read<kWithoutReadBarrier>();
+        root.VisitRoot(visitor, RootInfo(kRootInternedString));
+        ObjPtr<mirror::String> new_ref = root.Read<kWithoutReadBarrier>();
+        if (new_ref != old_ref) {
+          // The GC moved a root in the log. Need to search the strong interns and update the
+          // corresponding object. This is slow, but luckily for us, this may only happen with a
+          // concurrent moving GC. The hash does not change when the string moves.
+          shard.strong_interns.Remove(old_ref);
+          shard.strong_interns.Insert(new_ref);
+        }
       }
     }
+    if ((flags & kVisitRootFlagClearRootLog) != 0) {
+      shard.new_strong_intern_roots.clear();
+    }
+    if ((flags & kVisitRootFlagStartLoggingNewRoots) != 0) {
+      shard.log_new_roots = true;
+    } else if ((flags & kVisitRootFlagStopLoggingNewRoots) != 0) {
+      shard.log_new_roots = false;
+    }
   }
-  if ((flags & kVisitRootFlagClearRootLog) != 0) {
-    new_strong_intern_roots_.clear();
-  }
-  if ((flags & kVisitRootFlagStartLoggingNewRoots) != 0) {
-    log_new_roots_ = true;
-  } else if ((flags & kVisitRootFlagStopLoggingNewRoots) != 0) {
-    log_new_roots_ = false;
-  }
-  // Note: we deliberately don't visit the weak_interns_ table and the immutable image roots.
+  // Note: we deliberately don't visit the weak_interns tables.
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeak(Thread* self, ObjPtr<mirror::String> s) {
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return LookupWeakLocked(s);
+  Shard& shard = GetShard(s);
+  ShardMutexLock mu(self, shard);
+  ++shard.stats.locked_lookups;
+  return CountHit(shard.weak_interns.Find(s), &shard.stats.locked_hits);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::String> s) {
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return LookupStrongLocked(s);
+  ObjPtr<mirror::String> image_string = image_interns_.FindInImages(GcRoot<mirror::String>(s));
+  if (image_string != nullptr) {
+    return CountImageHit(image_string, &image_hits_);
+  }
+  Shard& shard = GetShard(s);
+  ShardMutexLock mu(self, shard);
+  ++shard.stats.locked_lookups;
+  return CountHit(shard.strong_interns.Find(s), &shard.stats.locked_hits);
 }
 
 ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
@@ -106,95 +213,143 @@ ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
   Utf8String string(utf16_length,
                     utf8_data,
                     ComputeUtf16HashFromModifiedUtf8(utf8_data, utf16_length));
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(string);
+  ObjPtr<mirror::String> image_string = image_interns_.FindInImages(string);
+  if (image_string != nullptr) {
+    return CountImageHit(image_string, &image_hits_);
+  }
+  Shard& shard = GetShard(string.GetHash());
+  ShardMutexLock mu(self, shard);
+  ++shard.stats.locked_lookups;
+  return CountHit(shard.strong_interns.Find(string), &shard.stats.locked_hits);
 }
 
-ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
-  return weak_interns_.Find(s);
+ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s)
+    NO_THREAD_SAFETY_ANALYSIS {
+  return GetShard(s).weak_interns.Find(s);
 }
 
-ObjPtr<mirror::String> InternTable::LookupStrongLocked(ObjPtr<mirror::String> s) {
-  return strong_interns_.Find(s);
+ObjPtr<mirror::String> InternTable::LookupStrongLocked(ObjPtr<mirror::String> s)
+    NO_THREAD_SAFETY_ANALYSIS {
+  ObjPtr<mirror::String> image_string = image_interns_.Find(s);
+  if (image_string != nullptr) {
+    return image_string;
+  }
+  return GetShard(s).strong_interns.Find(s);
 }
 
 void InternTable::AddNewTable() {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  weak_interns_.AddNewTable();
-  strong_interns_.AddNewTable();
+  Thread* const self = Thread::Current();
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock mu(self, shards_[i].lock);
+    shards_[i].weak_interns.AddNewTable();
+    shards_[i].strong_interns.AddNewTable();
+  }
+}
+
+void InternTable::BlockShards(Thread* self) {
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock mu(self, shards_[i].lock);
+    DCHECK(!shards_[i].blocked);
+    shards_[i].blocked = true;
+  }
+}
+
+void InternTable::UnblockShards(Thread* self) {
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock mu(self, shards_[i].lock);
+    shards_[i].blocked = false;
+    shards_[i].condition.Broadcast(self);
+  }
 }
 
-ObjPtr<mirror::String> InternTable::InsertStrong(ObjPtr<mirror::String> s) {
+ObjPtr<mirror::String> InternTable::InsertStrong(Shard& shard, ObjPtr<mirror::String> s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
     runtime->RecordStrongStringInsertion(s);
   }
-  if (log_new_roots_) {
-    new_strong_intern_roots_.push_back(GcRoot<mirror::String>(s));
+  if (shard.log_new_roots) {
+    shard.new_strong_intern_roots.push_back(GcRoot<mirror::String>(s));
   }
-  strong_interns_.Insert(s);
+  shard.strong_interns.Insert(s);
   return s;
 }
 
-ObjPtr<mirror::String> InternTable::InsertWeak(ObjPtr<mirror::String> s) {
+ObjPtr<mirror::String> InternTable::InsertWeak(Shard& shard, ObjPtr<mirror::String> s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
     runtime->RecordWeakStringInsertion(s);
   }
-  weak_interns_.Insert(s);
+  shard.weak_interns.Insert(s);
   return s;
 }
 
-void InternTable::RemoveStrong(ObjPtr<mirror::String> s) {
-  strong_interns_.Remove(s);
+void InternTable::RemoveStrong(Shard& shard, ObjPtr<mirror::String> s) {
+  shard.strong_interns.Remove(s);
 }
 
-void InternTable::RemoveWeak(ObjPtr<mirror::String> s) {
+void InternTable::RemoveWeak(Shard& shard, ObjPtr<mirror::String> s) {
   Runtime* runtime = Runtime::Current();
   if (runtime->IsActiveTransaction()) {
     runtime->RecordWeakStringRemoval(s);
   }
-  weak_interns_.Remove(s);
+  shard.weak_interns.Remove(s);
 }
 
 // Insert/remove methods used to undo changes made during an aborted transaction.
 ObjPtr<mirror::String> InternTable::InsertStrongFromTransaction(ObjPtr<mirror::String> s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  return InsertStrong(s);
+  Shard& shard = GetShard(s);
+  MutexLock mu(Thread::Current(), shard.lock);
+  return InsertStrong(shard, s);
 }
 
 ObjPtr<mirror::String> InternTable::InsertWeakFromTransaction(ObjPtr<mirror::String> s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  return InsertWeak(s);
+  Shard& shard = GetShard(s);
+  MutexLock mu(Thread::Current(), shard.lock);
+  return InsertWeak(shard, s);
 }
 
 void InternTable::RemoveStrongFromTransaction(ObjPtr<mirror::String> s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  RemoveStrong(s);
+  Shard& shard = GetShard(s);
+  MutexLock mu(Thread::Current(), shard.lock);
+  RemoveStrong(shard, s);
 }
 
 void InternTable::RemoveWeakFromTransaction(ObjPtr<mirror::String> s) {
   DCHECK(!Runtime::Current()->IsActiveTransaction());
-  RemoveWeak(s);
+  Shard& shard = GetShard(s);
+  MutexLock mu(Thread::Current(), shard.lock);
+  RemoveWeak(shard, s);
 }
 
 void InternTable::BroadcastForNewInterns() {
   Thread* self = Thread::Current();
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  weak_intern_condition_.Broadcast(self);
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock mu(self, shards_[i].lock);
+    shards_[i].condition.Broadcast(self);
+  }
+}
+
+bool InternTable::CanInsert(Thread* self, Shard& shard) {
+  bool weak_access_allowed = kUseReadBarrier
+      ? self->GetWeakRefAccessEnabled()
+      : shard.weak_root_state != gc::kWeakRootStateNoReadsOrWrites;
+  return weak_access_allowed && !shard.blocked;
 }
 
-void InternTable::WaitUntilAccessible(Thread* self) {
-  Locks::intern_table_lock_->ExclusiveUnlock(self);
+void InternTable::WaitUntilAccessible(Thread* self, Shard& shard) {
+  ++shard.stats.waits;
+  shard.lock.ExclusiveUnlock(self);
   {
     ScopedThreadSuspension sts(self, ThreadState::kWaitingWeakGcRootRead);
-    MutexLock mu(self, *Locks::intern_table_lock_);
-    while ((!kUseReadBarrier && weak_root_state_ == gc::kWeakRootStateNoReadsOrWrites) ||
-           (kUseReadBarrier && !self->GetWeakRefAccessEnabled())) {
-      weak_intern_condition_.Wait(self);
+    MutexLock mu(self, shard.lock);
+    while (!CanInsert(self, shard)) {
+      shard.condition.Wait(self);
     }
   }
-  Locks::intern_table_lock_->ExclusiveLock(self);
+  shard.lock.ExclusiveLock(self);
 }
 
 ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
@@ -203,8 +358,16 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   if (s == nullptr) {
     return nullptr;
   }
+  // Strings of the images are strong interns which are never removed, look for them first
+  // without a lock.
+  ObjPtr<mirror::String> image_string = image_interns_.FindInImages(GcRoot<mirror::String>(s));
+  if (image_string != nullptr) {
+    return CountImageHit(image_string, &image_hits_);
+  }
   Thread* const self = Thread::Current();
-  MutexLock mu(self, *Locks::intern_table_lock_);
+  Shard& shard = GetShard(s);
+  ShardMutexLock mu(self, shard);
+  ++shard.stats.locked_lookups;
   if (kDebugLocking && !holding_locks) {
     Locks::mutator_lock_->AssertSharedHeld(self);
     CHECK_EQ(2u, self->NumberOfHeldMutexes()) << "may only safely hold the mutator lock";
@@ -212,45 +375,46 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   while (true) {
     if (holding_locks) {
       if (!kUseReadBarrier) {
-        CHECK_EQ(weak_root_state_, gc::kWeakRootStateNormal);
+        CHECK_EQ(shard.weak_root_state, gc::kWeakRootStateNormal);
       } else {
         CHECK(self->GetWeakRefAccessEnabled());
       }
+      CHECK(!shard.blocked);
     }
     // Check the strong table for a match.
-    ObjPtr<mirror::String> strong = LookupStrongLocked(s);
+    ObjPtr<mirror::String> strong = shard.strong_interns.Find(s);
     if (strong != nullptr) {
-      return strong;
+      return CountHit(strong, &shard.stats.locked_hits);
     }
-    if ((!kUseReadBarrier && weak_root_state_ != gc::kWeakRootStateNoReadsOrWrites) ||
-        (kUseReadBarrier && self->GetWeakRefAccessEnabled())) {
+    if (CanInsert(self, shard)) {
       break;
     }
-    // weak_root_state_ is set to gc::kWeakRootStateNoReadsOrWrites in the GC pause but is only
+    // weak_root_state is set to gc::kWeakRootStateNoReadsOrWrites in the GC pause but is only
     // cleared after SweepSystemWeaks has completed. This is why we need to wait until it is
     // cleared.
     CHECK(!holding_locks);
     StackHandleScope<1> hs(self);
     auto h = hs.NewHandleWrapper(&s);
-    WaitUntilAccessible(self);
+    WaitUntilAccessible(self, shard);
   }
   if (!kUseReadBarrier) {
-    CHECK_EQ(weak_root_state_, gc::kWeakRootStateNormal);
+    CHECK_EQ(shard.weak_root_state, gc::kWeakRootStateNormal);
   } else {
     CHECK(self->GetWeakRefAccessEnabled());
   }
   // There is no match in the strong table, check the weak table.
-  ObjPtr<mirror::String> weak = LookupWeakLocked(s);
+  ObjPtr<mirror::String> weak = shard.weak_interns.Find(s);
   if (weak != nullptr) {
+    ++shard.stats.locked_hits;
     if (is_strong) {
       // A match was found in the weak table. Promote to the strong table.
-      RemoveWeak(weak);
-      return InsertStrong(weak);
+      RemoveWeak(shard, weak);
+      return InsertStrong(shard, weak);
     }
     return weak;
   }
   // No match in the strong table or the weak table. Insert into the strong / weak table.
-  return is_strong ? InsertStrong(s) : InsertWeak(s);
+  return is_strong ? InsertStrong(shard, s) : InsertWeak(shard, s);
 }
 
 ObjPtr<mirror::String> InternTable::InternStrong(int32_t utf16_length, const char* utf8_data) {
@@ -276,13 +440,17 @@ ObjPtr<mirror::String> InternTable::InternStrongImageString(ObjPtr<mirror::Strin
 }
 
 void InternTable::PromoteWeakToStrong() {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  DCHECK_EQ(weak_interns_.tables_.size(), 1u);
-  for (GcRoot<mirror::String>& entry : weak_interns_.tables_.front().set_) {
-    DCHECK(LookupStrongLocked(entry.Read()) == nullptr);
-    InsertStrong(entry.Read());
+  Thread* const self = Thread::Current();
+  for (size_t i = 0; i != num_shards_; ++i) {
+    Shard& shard = shards_[i];
+    MutexLock mu(self, shard.lock);
+    DCHECK_EQ(shard.weak_interns.tables_.size(), 1u);
+    for (GcRoot<mirror::String>& entry : shard.weak_interns.tables_.front().set_) {
+      DCHECK(shard.strong_interns.Find(entry.Read()) == nullptr);
+      InsertStrong(shard, entry.Read());
+    }
+    shard.weak_interns.tables_.front().set_.clear();
   }
-  weak_interns_.tables_.front().set_.clear();
 }
 
 ObjPtr<mirror::String> InternTable::InternStrong(ObjPtr<mirror::String> s) {
@@ -303,8 +471,12 @@ bool InternTable::ContainsWeak(ObjPtr<mirror::String> s) {
 }
 
 void InternTable::SweepInternTableWeaks(IsMarkedVisitor* visitor) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  weak_interns_.SweepWeaks(visitor);
+  Thread* const self = Thread::Current();
+  MutexLock mu(self, *Locks::intern_table_lock_);
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock shard_mu(self, shards_[i].lock);
+    shards_[i].weak_interns.SweepWeaks(visitor);
+  }
 }
 
 void InternTable::Table::Remove(ObjPtr<mirror::String> s) {
@@ -319,7 +491,6 @@ void InternTable::Table::Remove(ObjPtr<mirror::String> s) {
 }
 
 ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s) {
-  Locks::intern_table_lock_->AssertHeld(Thread::Current());
   for (InternalTable& table : tables_) {
     auto it = table.set_.find(GcRoot<mirror::String>(s));
     if (it != table.set_.end()) {
@@ -330,7 +501,6 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s) {
 }
 
 ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string) {
-  Locks::intern_table_lock_->AssertHeld(Thread::Current());
   for (InternalTable& table : tables_) {
     auto it = table.set_.find(string);
     if (it != table.set_.end()) {
@@ -391,19 +561,21 @@ size_t InternTable::Table::Size() const {
 }
 
 void InternTable::ChangeWeakRootState(gc::WeakRootState new_state) {
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  ChangeWeakRootStateLocked(new_state);
-}
-
-void InternTable::ChangeWeakRootStateLocked(gc::WeakRootState new_state) {
   CHECK(!kUseReadBarrier);
-  weak_root_state_ = new_state;
-  if (new_state != gc::kWeakRootStateNoReadsOrWrites) {
-    weak_intern_condition_.Broadcast(Thread::Current());
+  Thread* const self = Thread::Current();
+  for (size_t i = 0; i != num_shards_; ++i) {
+    MutexLock mu(self, shards_[i].lock);
+    shards_[i].weak_root_state = new_state;
+    if (new_state != gc::kWeakRootStateNoReadsOrWrites) {
+      shards_[i].condition.Broadcast(self);
+    }
   }
 }
 
-InternTable::Table::Table() {
+InternTable::Table::Table() : image_tables_(nullptr) {
+  std::unique_ptr<ImageTableList> image_tables(new ImageTableList());
+  image_tables_.store(image_tables.get(), std::memory_order_relaxed);
+  image_table_lists_.push_back(std::move(image_tables));
   Runtime* const runtime = Runtime::Current();
   InternalTable initial_table;
   initial_table.set_.SetLoadFactor(runtime->GetHashTableMinLoadFactor(),
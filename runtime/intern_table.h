@@ -17,6 +17,10 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <atomic>
+#include <deque>
+#include <memory>
+
 #include "base/allocator.h"
 #include "base/hash_set.h"
 #include "base/mutex.h"
@@ -53,6 +57,12 @@ class Transaction;
  * String.intern. Some code (XML parsers being a prime example) relies on being able to intern
  * arbitrarily many strings for the duration of a parse without permanently increasing the memory
  * footprint.
+ *
+ * The strings of the boot and app images are in tables that are never modified once added, so
+ * they are searched without taking a lock. The other strings are split by hash into shards with
+ * their own lock, so that threads interning different strings rarely contend. The
+ * Locks::intern_table_lock_ is only taken by operations on the whole table: adding the table of an
+ * image, the GC root visiting and sweeping, and transaction rollbacks.
  */
 class InternTable {
  public:
@@ -154,6 +164,9 @@ class InternTable {
   ObjPtr<mirror::String> LookupStrong(Thread* self, uint32_t utf16_length, const char* utf8_data)
       REQUIRES(!Locks::intern_table_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
+  // The *Locked() lookups, VisitInterns() and CountInterns() do not take the shard locks. They
+  // are for the visitor of AddImageStringsToTable(), which runs with insertions blocked, and for
+  // callers that know no other thread interns strings.
   ObjPtr<mirror::String> LookupStrongLocked(ObjPtr<mirror::String> s)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
 
@@ -210,14 +223,15 @@ class InternTable {
 
  private:
   // Table which holds pre zygote and post zygote interned strings. There is one instance for
-  // weak interns and strong interns.
+  // weak interns and strong interns in each shard, and one for the image interns. Each is guarded
+  // by the lock of its owner.
   class Table {
    public:
     class InternalTable {
      public:
       InternalTable() = default;
       InternalTable(UnorderedSet&& set, bool is_boot_image)
-          : set_(std::move(set)), is_boot_image_(is_boot_image) {}
+          : set_(std::move(set)), is_boot_image_(is_boot_image), is_image_(true) {}
 
       bool Empty() const {
         return set_.empty();
@@ -234,6 +248,8 @@ class InternTable {
      private:
       UnorderedSet set_;
       bool is_boot_image_ = false;
+      // Whether the table was read from an image. Image tables are not modified at runtime.
+      bool is_image_ = false;
 
       friend class InternTable;
       friend class linker::ImageWriter;
@@ -242,21 +258,19 @@ class InternTable {
     };
 
     Table();
-    ObjPtr<mirror::String> Find(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_)
-        REQUIRES(Locks::intern_table_lock_);
-    ObjPtr<mirror::String> Find(const Utf8String& string) REQUIRES_SHARED(Locks::mutator_lock_)
-        REQUIRES(Locks::intern_table_lock_);
-    void Insert(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_)
-        REQUIRES(Locks::intern_table_lock_);
-    void Remove(ObjPtr<mirror::String> s)
-        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    void VisitRoots(RootVisitor* visitor)
-        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-    void SweepWeaks(IsMarkedVisitor* visitor)
-        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+    ObjPtr<mirror::String> Find(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_);
+    ObjPtr<mirror::String> Find(const Utf8String& string) REQUIRES_SHARED(Locks::mutator_lock_);
+    // Search the image tables only. Does not need the intern table lock.
+    template <typename Key>
+    ObjPtr<mirror::String> FindInImages(const Key& key) const
+        REQUIRES_SHARED(Locks::mutator_lock_);
+    void Insert(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_);
+    void Remove(ObjPtr<mirror::String> s) REQUIRES_SHARED(Locks::mutator_lock_);
+    void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+    void SweepWeaks(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
     // Add a new intern table that will only be inserted into from now on.
-    void AddNewTable() REQUIRES(Locks::intern_table_lock_);
-    size_t Size() const REQUIRES(Locks::intern_table_lock_);
+    void AddNewTable();
+    size_t Size() const;
     // Read and add an intern table from ptr.
     // Tables read are inserted at the front of the table array. Only checks for conflicts in
     // debug builds. Returns how many bytes were read.
@@ -266,8 +280,10 @@ class InternTable {
         REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
    private:
+    using ImageTableList = std::vector<const UnorderedSet*>;
+
     void SweepWeaks(UnorderedSet* set, IsMarkedVisitor* visitor)
-        REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+        REQUIRES_SHARED(Locks::mutator_lock_);
 
     // Add a table to the front of the tables vector.
     void AddInternStrings(UnorderedSet&& intern_strings, bool is_boot_image)
@@ -275,32 +291,89 @@ class InternTable {
 
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
-    std::vector<InternalTable> tables_;
+    // A deque so that the image tables do not move when tables are added at either end.
+    std::deque<InternalTable> tables_;
+
+    // The tables read from images, for lookups without the lock. Replaced by a new list when an
+    // image table is added. Readers may still use old lists, so they are only freed with the
+    // table; there are only as many as there are images.
+    std::atomic<const ImageTableList*> image_tables_;
+    std::vector<std::unique_ptr<const ImageTableList>> image_table_lists_
+        GUARDED_BY(Locks::intern_table_lock_);
 
     friend class InternTable;
     friend class linker::ImageWriter;
     ART_FRIEND_TEST(InternTableTest, CrossHash);
   };
 
+  // Lookup counters of a shard, dumped on SIGQUIT.
+  struct Stats {
+    // Lookups and insertions that took the shard lock, and how many of them found the string.
+    uint64_t locked_lookups = 0u;
+    uint64_t locked_hits = 0u;
+    // Acquisitions of the shard lock that had to wait for another thread.
+    uint64_t lock_contentions = 0u;
+    // Times an insertion waited for the GC to allow weak root accesses, or for BlockShards().
+    uint64_t waits = 0u;
+  };
+
+  // The interns that are not in an image and whose hash selects this shard.
+  struct Shard {
+    Shard();
+
+    Mutex lock;
+    ConditionVariable condition GUARDED_BY(lock);
+    // Whether an operation on the whole table reads the tables, see BlockShards(). Insertions
+    // wait until it is done.
+    bool blocked GUARDED_BY(lock);
+    bool log_new_roots GUARDED_BY(lock);
+    // Since this contains (strong) roots, they need a read barrier to
+    // enable concurrent intern table (strong) root scan. Do not
+    // directly access the strings in it. Use functions that contain
+    // read barriers.
+    Table strong_interns GUARDED_BY(lock);
+    std::vector<GcRoot<mirror::String>> new_strong_intern_roots GUARDED_BY(lock);
+    // Since this contains (weak) roots, they need a read barrier. Do
+    // not directly access the strings in it. Use functions that contain
+    // read barriers.
+    Table weak_interns GUARDED_BY(lock);
+    // Weak root state, used for concurrent system weak processing and more.
+    gc::WeakRootState weak_root_state GUARDED_BY(lock);
+    Stats stats GUARDED_BY(lock);
+
+    DISALLOW_COPY_AND_ASSIGN(Shard);
+  };
+
+  class ShardMutexLock;
+
+  Shard& GetShard(ObjPtr<mirror::String> s) const REQUIRES_SHARED(Locks::mutator_lock_);
+  Shard& GetShard(int32_t hash) const;
+
   // Insert if non null, otherwise return null. Must be called holding the mutator lock.
   // If holding_locks is true, then we may also hold other locks. If holding_locks is true, then we
   // require GC is not running since it is not safe to wait while holding locks.
   ObjPtr<mirror::String> Insert(ObjPtr<mirror::String> s, bool is_strong, bool holding_locks)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Add a table from memory to the strong interns.
+  // Add a table from memory to the image interns.
   template <typename Visitor>
   size_t AddTableFromMemory(const uint8_t* ptr, const Visitor& visitor, bool is_boot_image)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
-  ObjPtr<mirror::String> InsertStrong(ObjPtr<mirror::String> s)
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  ObjPtr<mirror::String> InsertWeak(ObjPtr<mirror::String> s)
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  void RemoveStrong(ObjPtr<mirror::String> s)
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
-  void RemoveWeak(ObjPtr<mirror::String> s)
-      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+  // Make the insertions into the shards wait, so that the caller can read the tables of all
+  // shards without their locks. The GC does not modify them either, it takes
+  // Locks::intern_table_lock_ before the shard locks.
+  void BlockShards(Thread* self) REQUIRES(Locks::intern_table_lock_);
+  void UnblockShards(Thread* self) REQUIRES(Locks::intern_table_lock_);
+
+  ObjPtr<mirror::String> InsertStrong(Shard& shard, ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(shard.lock);
+  ObjPtr<mirror::String> InsertWeak(Shard& shard, ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(shard.lock);
+  void RemoveStrong(Shard& shard, ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(shard.lock);
+  void RemoveWeak(Shard& shard, ObjPtr<mirror::String> s)
+      REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(shard.lock);
 
   // Transaction rollback access.
   ObjPtr<mirror::String> InsertStrongFromTransaction(ObjPtr<mirror::String> s)
@@ -312,34 +385,30 @@ class InternTable {
   void RemoveWeakFromTransaction(ObjPtr<mirror::String> s)
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
 
-  // Change the weak root state. May broadcast to waiters.
-  void ChangeWeakRootStateLocked(gc::WeakRootState new_state)
-      REQUIRES(Locks::intern_table_lock_);
-
-  // Wait until we can read weak roots.
-  void WaitUntilAccessible(Thread* self)
-      REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
-
-  bool log_new_roots_ GUARDED_BY(Locks::intern_table_lock_);
-  ConditionVariable weak_intern_condition_ GUARDED_BY(Locks::intern_table_lock_);
-  // Since this contains (strong) roots, they need a read barrier to
-  // enable concurrent intern table (strong) root scan. Do not
-  // directly access the strings in it. Use functions that contain
-  // read barriers.
-  Table strong_interns_ GUARDED_BY(Locks::intern_table_lock_);
-  std::vector<GcRoot<mirror::String>> new_strong_intern_roots_
-      GUARDED_BY(Locks::intern_table_lock_);
-  // Since this contains (weak) roots, they need a read barrier. Do
-  // not directly access the strings in it. Use functions that contain
-  // read barriers.
-  Table weak_interns_ GUARDED_BY(Locks::intern_table_lock_);
-  // Weak root state, used for concurrent system weak processing and more.
-  gc::WeakRootState weak_root_state_ GUARDED_BY(Locks::intern_table_lock_);
+  // Whether insertions into `shard` can proceed.
+  bool CanInsert(Thread* self, Shard& shard) REQUIRES(shard.lock);
+
+  // Wait until we can read weak roots and the shard is not blocked.
+  void WaitUntilAccessible(Thread* self, Shard& shard)
+      REQUIRES(shard.lock) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // The interns of the boot and app images. The tables are only added with
+  // Locks::intern_table_lock_ held and are searched without a lock through FindInImages().
+  Table image_interns_;
+
+  // One shard in dex2oat, where the image writer expects a single table of runtime interns.
+  const size_t num_shards_;
+  std::unique_ptr<Shard[]> shards_;
+
+  // Lookups answered by the image tables, only counted with kCountImageHits as all threads would
+  // update the same counter.
+  mutable std::atomic<uint64_t> image_hits_;
 
   friend class gc::space::ImageSpace;
   friend class linker::ImageWriter;
   friend class Transaction;
   ART_FRIEND_TEST(InternTableTest, CrossHash);
+  ART_FRIEND_TEST(InternTableTest, Shards);
   DISALLOW_COPY_AND_ASSIGN(InternTable);
 };
 
@@ -16,6 +16,9 @@
 
 #include "intern_table-inl.h"
 
+#include <set>
+#include <sstream>
+
 #include "base/hash_set.h"
 #include "common_runtime_test.h"
 #include "dex/utf.h"
@@ -27,7 +30,14 @@
 
 namespace art {
 
-class InternTableTest : public CommonRuntimeTest {};
+class InternTableTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    // Run without compiler callbacks, as an app runtime, so that the intern tables are sharded.
+    callbacks_.reset();
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+  }
+};
 
 TEST_F(InternTableTest, Intern) {
   ScopedObjectAccess soa(Thread::Current());
@@ -77,13 +87,44 @@ TEST_F(InternTableTest, CrossHash) {
   // A string that has a negative hash value.
   GcRoot<mirror::String> str(mirror::String::AllocFromModifiedUtf8(soa.Self(), "00000000"));
 
-  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
-  for (InternTable::Table::InternalTable& table : t.strong_interns_.tables_) {
+  InternTable::Shard& shard = t.GetShard(str.Read());
+  MutexLock mu(Thread::Current(), shard.lock);
+  for (InternTable::Table::InternalTable& table : shard.strong_interns.tables_) {
     // The negative hash value shall be 32-bit wide on every host.
     ASSERT_TRUE(IsUint<32>(table.set_.hashfn_(str)));
   }
 }
 
+TEST_F(InternTableTest, Shards) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable t;
+  ASSERT_GT(t.num_shards_, 1u);
+
+  static constexpr size_t kNumStrings = 64u;
+  std::set<const InternTable::Shard*> strong_shards;
+  for (size_t i = 0; i != kNumStrings; ++i) {
+    std::string name = "strong" + std::to_string(i);
+    ObjPtr<mirror::String> s = t.InternStrong(name.c_str());
+    ASSERT_TRUE(s != nullptr);
+    EXPECT_OBJ_PTR_EQ(t.LookupStrong(soa.Self(), s), s);
+    EXPECT_OBJ_PTR_EQ(t.LookupStrong(soa.Self(), s->GetLength(), name.c_str()), s);
+    strong_shards.insert(&t.GetShard(s));
+  }
+  // Different strings use different shards, and so different locks.
+  EXPECT_GT(strong_shards.size(), 1u);
+
+  for (size_t i = 0; i != kNumStrings; ++i) {
+    std::string name = "weak" + std::to_string(i);
+    ObjPtr<mirror::String> s = t.InternWeak(name.c_str());
+    ASSERT_TRUE(s != nullptr);
+    EXPECT_TRUE(t.ContainsWeak(s));
+    EXPECT_TRUE(t.LookupStrong(soa.Self(), s) == nullptr);
+  }
+  EXPECT_EQ(t.StrongSize(), kNumStrings);
+  EXPECT_EQ(t.WeakSize(), kNumStrings);
+  EXPECT_EQ(t.Size(), 2u * kNumStrings);
+}
+
 class TestPredicate : public IsMarkedVisitor {
  public:
   mirror::Object* IsMarked(mirror::Object* s) override REQUIRES_SHARED(Locks::mutator_lock_) {
@@ -234,4 +275,42 @@ TEST_F(InternTableTest, LookupStrong) {
   EXPECT_TRUE(lookup_foobbS == nullptr);
 }
 
+TEST_F(InternTableTest, LookupImageString) {
+  ScopedObjectAccess soa(Thread::Current());
+  InternTable* intern_table = Runtime::Current()->GetInternTable();
+  StackHandleScope<2> hs(soa.Self());
+  MutableHandle<mirror::String> image_string(hs.NewHandle<mirror::String>(nullptr));
+  {
+    MutexLock mu(soa.Self(), *Locks::intern_table_lock_);
+    intern_table->VisitInterns([&](const GcRoot<mirror::String>& root)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (image_string == nullptr) {
+        image_string.Assign(root.Read());
+      }
+    }, /*visit_boot_images=*/ true, /*visit_non_boot_images=*/ false);
+  }
+  ASSERT_TRUE(image_string != nullptr);
+  std::string utf8 = image_string->ToModifiedUtf8();
+
+  // Image strings are found without the lock, through both lookup forms.
+  EXPECT_OBJ_PTR_EQ(intern_table->LookupStrong(soa.Self(), image_string.Get()),
+                    image_string.Get());
+  EXPECT_OBJ_PTR_EQ(
+      intern_table->LookupStrong(soa.Self(), image_string->GetLength(), utf8.c_str()),
+      image_string.Get());
+
+  // Interning a copy returns the image string, both weakly and strongly.
+  Handle<mirror::String> copy(
+      hs.NewHandle(mirror::String::AllocFromModifiedUtf8(soa.Self(), utf8.c_str())));
+  ASSERT_TRUE(copy != nullptr);
+  ASSERT_NE(copy.Get(), image_string.Get());
+  EXPECT_OBJ_PTR_EQ(intern_table->InternWeak(copy.Get()), image_string.Get());
+  EXPECT_OBJ_PTR_EQ(intern_table->InternStrong(copy.Get()), image_string.Get());
+  EXPECT_FALSE(intern_table->ContainsWeak(copy.Get()));
+
+  std::ostringstream oss;
+  intern_table->DumpForSigQuit(oss);
+  EXPECT_NE(oss.str().find(" shards"), std::string::npos) << oss.str();
+}
+
 }  // namespace art
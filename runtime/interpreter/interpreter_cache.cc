@@ -15,14 +15,83 @@
  */
 
 #include "interpreter_cache.h"
+
+#include <algorithm>
+#include <ostream>
+
 #include "thread-inl.h"
 
 namespace art {
 
+void InterpreterCache::SetSecondLevelSize(size_t size) {
+  if (size == 0u) {
+    second_level_.reset();
+    second_level_size_ = 0u;
+    return;
+  }
+  second_level_size_ = RoundUpToPowerOfTwo(std::max(size, kSecondLevelWays));
+  second_level_.reset(new Entry[second_level_size_]);
+  std::fill_n(second_level_.get(), second_level_size_, Entry{});
+}
+
 void InterpreterCache::Clear(Thread* owning_thread) {
   DCHECK(owning_thread->GetInterpreterCache() == this);
   DCHECK(owning_thread == Thread::Current() || owning_thread->IsSuspended());
   data_.fill(Entry{});
+  std::fill_n(second_level_.get(), second_level_size_, Entry{});
+  ++stats_.clears;
+}
+
+bool InterpreterCache::GetFromSecondLevel(Thread* self, const void* key, size_t* value) {
+  DCHECK(IsCalledFromOwningThread());
+  ++stats_.misses;
+  if (second_level_ == nullptr) {
+    return false;
+  }
+  Entry* set = SecondLevelSetOf(key);
+  for (size_t way = 0; way < kSecondLevelWays; ++way) {
+    if (set[way].first == key) {
+      ++stats_.second_level_hits;
+      *value = set[way].second;
+      // Like nterp, only update the cache if weak ref accesses are enabled. If
+      // they are disabled, the GC may be sweeping the cache concurrently.
+      if (self->GetWeakRefAccessEnabled()) {
+        Entry& entry = data_[IndexOf(key)];
+        Entry evicted = entry;
+        set[way] = Entry{};
+        entry = Entry{key, *value};
+        if (evicted.first != nullptr) {
+          Evict(evicted);
+        }
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void InterpreterCache::Evict(const Entry& entry) {
+  ++stats_.evictions;
+  Entry* set = SecondLevelSetOf(entry.first);
+  // Keep the most recently evicted entries first in the set, and drop the
+  // last one if the set has no empty entry.
+  size_t way = 0u;
+  while (way != kSecondLevelWays - 1u && set[way].first != nullptr) {
+    ++way;
+  }
+  for (; way != 0u; --way) {
+    set[way] = set[way - 1u];
+  }
+  set[0] = entry;
+}
+
+void InterpreterCache::DumpStats(std::ostream& os) const {
+  os << "hits=" << stats_.hits
+     << " second_level_hits=" << stats_.second_level_hits
+     << " misses=" << stats_.misses
+     << " evictions=" << stats_.evictions
+     << " clears=" << stats_.clears
+     << " second_level_size=" << second_level_size_;
 }
 
 bool InterpreterCache::IsCalledFromOwningThread() {
@@ -19,7 +19,10 @@
 
 #include <array>
 #include <atomic>
+#include <iosfwd>
+#include <memory>
 
+#include "base/array_ref.h"
 #include "base/bit_utils.h"
 #include "base/macros.h"
 
@@ -42,6 +45,13 @@ class Thread;
 // We ensure consistency of the cache by clearing it
 // whenever any dex file is unloaded.
 //
+// Nterp probes the fixed size first level inline from assembly. Optionally,
+// entries evicted from the first level are kept in a larger two-way set
+// associative second level, which is only probed from the slow paths, so that
+// large methods with conflicting instructions do not have to go back to the
+// class linker on every miss. A hit in the second level swaps the entry back
+// into the first level.
+//
 // Aligned to 16-bytes to make it easier to get the address of the cache
 // from assembly (it ensures that the offset is valid immediate value).
 class ALIGNED(16) InterpreterCache {
@@ -53,37 +63,87 @@ class ALIGNED(16) InterpreterCache {
   // Value of 256 has around 75% cache hit rate.
   static constexpr size_t kSize = 256;
 
+  // Number of entries of a set in the second level.
+  static constexpr size_t kSecondLevelWays = 2;
+
+  // Counters of the owning thread. Hits in the first level are only counted
+  // for lookups done from C++, not for the ones nterp does inline.
+  struct Stats {
+    uint64_t hits = 0u;
+    uint64_t second_level_hits = 0u;
+    uint64_t misses = 0u;
+    uint64_t evictions = 0u;
+    uint64_t clears = 0u;
+  };
+
   InterpreterCache() {
     // We can not use the Clear() method since the constructor will not
     // be called from the owning thread.
     data_.fill(Entry{});
   }
 
+  // Allocate a second level of `size` entries, or none if `size` is 0. The
+  // size is rounded up to a power of two. Must be called before the owning
+  // thread is registered with the thread list.
+  void SetSecondLevelSize(size_t size);
+
   // Clear the whole cache. It requires the owning thread for DCHECKs.
   void Clear(Thread* owning_thread);
 
-  ALWAYS_INLINE bool Get(const void* key, /* out */ size_t* value) {
+  ALWAYS_INLINE bool Get(Thread* self, const void* key, /* out */ size_t* value) {
     DCHECK(IsCalledFromOwningThread());
     Entry& entry = data_[IndexOf(key)];
     if (LIKELY(entry.first == key)) {
+      ++stats_.hits;
       *value = entry.second;
       return true;
     }
-    return false;
+    return GetFromSecondLevel(self, key, value);
   }
 
+  // Look up `key` in the second level only, after a miss in the first level.
+  // A hit is moved to the first level if `self` may update the cache.
+  bool GetFromSecondLevel(Thread* self, const void* key, /* out */ size_t* value);
+
   ALWAYS_INLINE void Set(const void* key, size_t value) {
     DCHECK(IsCalledFromOwningThread());
-    data_[IndexOf(key)] = Entry{key, value};
+    Entry& entry = data_[IndexOf(key)];
+    if (second_level_ != nullptr && entry.first != nullptr && entry.first != key) {
+      Evict(entry);
+    }
+    entry = Entry{key, value};
   }
 
   std::array<Entry, kSize>& GetArray() {
     return data_;
   }
 
+  ArrayRef<Entry> GetSecondLevelArray() {
+    return ArrayRef<Entry>(second_level_.get(), second_level_size_);
+  }
+
+  const Stats& GetStats() const {
+    return stats_;
+  }
+
+  void DumpStats(std::ostream& os) const;
+
  private:
   bool IsCalledFromOwningThread();
 
+  // Move `entry` of the first level into its set of the second level.
+  void Evict(const Entry& entry);
+
+  // Return the first entry of the set of `key` in the second level. The set
+  // index also uses the key bits above the ones of the first level index, so
+  // that keys conflicting in the first level spread over different sets.
+  Entry* SecondLevelSetOf(const void* key) {
+    size_t index = reinterpret_cast<uintptr_t>(key) >> 2;
+    index ^= index >> WhichPowerOf2(kSize);
+    size_t num_sets = second_level_size_ / kSecondLevelWays;
+    return &second_level_[(index & (num_sets - 1u)) * kSecondLevelWays];
+  }
+
   static ALWAYS_INLINE size_t IndexOf(const void* key) {
     static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
     size_t index = (reinterpret_cast<uintptr_t>(key) >> 2) & (kSize - 1);
@@ -92,6 +152,11 @@ class ALIGNED(16) InterpreterCache {
   }
 
   std::array<Entry, kSize> data_;
+
+  std::unique_ptr<Entry[]> second_level_;
+  size_t second_level_size_ = 0u;
+
+  Stats stats_;
 };
 
 }  // namespace art
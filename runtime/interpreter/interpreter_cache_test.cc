@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "interpreter_cache.h"
+
+#include "common_runtime_test.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+class InterpreterCacheTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    CommonRuntimeTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:InterpreterCacheSecondLevelSize=16", nullptr));
+  }
+
+  // Return keys which all map to the same entry of the first level.
+  const void* ConflictingKey(size_t i) {
+    static_assert(sizeof(code_) >= kNumKeys * kConflictStride);
+    return reinterpret_cast<const uint8_t*>(code_) + i * kConflictStride;
+  }
+
+  static constexpr size_t kNumKeys = 3;
+  static constexpr size_t kConflictStride = 4 * InterpreterCache::kSize;
+
+  // The cache never reads the instructions outside of GC sweeps.
+  uint16_t code_[kNumKeys * kConflictStride / sizeof(uint16_t)];
+};
+
+TEST_F(InterpreterCacheTest, SecondLevel) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  InterpreterCache* cache = self->GetInterpreterCache();
+  ASSERT_EQ(cache->GetSecondLevelArray().size(), 16u);
+  cache->Clear(self);
+  InterpreterCache::Stats stats = cache->GetStats();
+
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    cache->Set(ConflictingKey(i), i + 1u);
+  }
+  EXPECT_EQ(cache->GetStats().evictions, stats.evictions + kNumKeys - 1u);
+
+  // The last key is in the first level, the others were moved to the second level.
+  size_t value = 0u;
+  EXPECT_TRUE(cache->Get(self, ConflictingKey(kNumKeys - 1u), &value));
+  EXPECT_EQ(value, kNumKeys);
+  EXPECT_EQ(cache->GetStats().hits, stats.hits + 1u);
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    EXPECT_TRUE(cache->Get(self, ConflictingKey(i), &value));
+    EXPECT_EQ(value, i + 1u);
+  }
+  EXPECT_EQ(cache->GetStats().second_level_hits, stats.second_level_hits + kNumKeys);
+  EXPECT_EQ(cache->GetStats().misses, stats.misses + kNumKeys);
+
+  // A hit in the second level moves the entry to the first level.
+  EXPECT_TRUE(cache->Get(self, ConflictingKey(kNumKeys - 1u), &value));
+  EXPECT_EQ(cache->GetStats().hits, stats.hits + 2u);
+
+  cache->Clear(self);
+  EXPECT_EQ(cache->GetStats().clears, stats.clears + 1u);
+  for (size_t i = 0; i < kNumKeys; ++i) {
+    EXPECT_FALSE(cache->Get(self, ConflictingKey(i), &value));
+  }
+}
+
+}  // namespace art
@@ -29,6 +29,7 @@
 #include "interpreter/shadow_frame-inl.h"
 #include "mirror/string-alloc-inl.h"
 #include "nterp_helpers.h"
+#include "read_barrier-inl.h"
 
 namespace art {
 namespace interpreter {
@@ -46,7 +47,11 @@ bool CanRuntimeUseNterp() REQUIRES_SHARED(Locks::mutator_lock_) {
   return IsNterpSupported() &&
       !instr->InterpretOnly() &&
       !runtime->IsAotCompiler() &&
-      !runtime->GetInstrumentation()->IsActive() &&
+      // nterp does not report instrumentation events itself. Method entry, exit and unwind
+      // events can still be reported by the entry/exit stubs, which dispatch to nterp like
+      // to compiled code, so method tracing does not need the switch interpreter.
+      !instr->HasListenersNeedingInterpreter() &&
+      (!instr->IsActive() || instr->EntryExitStubsInstalled()) &&
       // nterp only knows how to deal with the normal exits. It cannot handle any of the
       // non-standard force-returns.
       !runtime->AreNonStandardExitsEnabled() &&
@@ -106,6 +111,29 @@ inline void UpdateCache(Thread* self, uint16_t* dex_pc_ptr, T* value) {
   UpdateCache(self, dex_pc_ptr, reinterpret_cast<size_t>(value));
 }
 
+// Nterp calls the slow paths below after missing in the first level of the
+// cache. Entries evicted from it may still be in the second level.
+inline bool GetFromSecondLevelCache(Thread* self, uint16_t* dex_pc_ptr, size_t* value) {
+  return self->GetInterpreterCache()->GetFromSecondLevel(self, dex_pc_ptr, value);
+}
+
+// Classes and strings in the cache are only swept by the GC, and nterp reads
+// them with a read barrier in its fast paths. Do the same for the ones found in
+// the second level, and put the marked reference in the first level.
+template <typename MirrorType>
+inline MirrorType* GetObjectFromSecondLevelCache(Thread* self, uint16_t* dex_pc_ptr)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  size_t cached_value;
+  if (!GetFromSecondLevelCache(self, dex_pc_ptr, &cached_value)) {
+    return nullptr;
+  }
+  MirrorType* object = reinterpret_cast<MirrorType*>(cached_value);
+  DCHECK(object != nullptr);
+  object = ReadBarrier::BarrierForRoot<MirrorType, kWithReadBarrier>(&object);
+  UpdateCache(self, dex_pc_ptr, object);
+  return object;
+}
+
 #ifdef __arm__
 
 extern "C" void NterpStoreArm32Fprs(const char* shorty,
@@ -255,6 +283,10 @@ FLATTEN
 extern "C" size_t NterpGetMethod(Thread* self, ArtMethod* caller, uint16_t* dex_pc_ptr)
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (GetFromSecondLevelCache(self, dex_pc_ptr, &cached_value)) {
+    return cached_value;
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   InvokeType invoke_type = kStatic;
   uint16_t method_index = 0;
@@ -465,6 +497,10 @@ extern "C" size_t NterpGetStaticField(Thread* self,
                                       size_t resolve_field_type)  // Resolve if not zero
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (GetFromSecondLevelCache(self, dex_pc_ptr, &cached_value)) {
+    return cached_value;
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   uint16_t field_index = inst->VRegB_21c();
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
@@ -508,6 +544,10 @@ extern "C" uint32_t NterpGetInstanceFieldOffset(Thread* self,
                                                 size_t resolve_field_type)  // Resolve if not zero
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
+  size_t cached_value;
+  if (GetFromSecondLevelCache(self, dex_pc_ptr, &cached_value)) {
+    return static_cast<uint32_t>(cached_value);
+  }
   const Instruction* inst = Instruction::At(dex_pc_ptr);
   uint16_t field_index = inst->VRegC_22c();
   ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
@@ -538,6 +578,14 @@ extern "C" mirror::Object* NterpGetClassOrAllocateObject(Thread* self,
     REQUIRES_SHARED(Locks::mutator_lock_) {
   UpdateHotness(caller);
   const Instruction* inst = Instruction::At(dex_pc_ptr);
+  ObjPtr<mirror::Class> cls = GetObjectFromSecondLevelCache<mirror::Class>(self, dex_pc_ptr);
+  if (cls != nullptr) {
+    if (inst->Opcode() == Instruction::NEW_INSTANCE) {
+      gc::AllocatorType allocator_type = Runtime::Current()->GetHeap()->GetCurrentAllocator();
+      return AllocObjectFromCode(cls, self, allocator_type).Ptr();
+    }
+    return cls.Ptr();
+  }
   dex::TypeIndex index;
   switch (inst->Opcode()) {
     case Instruction::NEW_INSTANCE:
@@ -597,6 +645,11 @@ extern "C" mirror::Object* NterpLoadObject(Thread* self, ArtMethod* caller, uint
     case Instruction::CONST_STRING:
     case Instruction::CONST_STRING_JUMBO: {
       UpdateHotness(caller);
+      mirror::String* cached_str =
+          GetObjectFromSecondLevelCache<mirror::String>(self, dex_pc_ptr);
+      if (cached_str != nullptr) {
+        return cached_str;
+      }
       dex::StringIndex string_index(
           (inst->Opcode() == Instruction::CONST_STRING)
               ? inst->VRegB_21c()
@@ -742,6 +795,11 @@ extern "C" jit::OsrData* NterpHotMethod(ArtMethod* method, uint16_t* dex_pc_ptr,
       if (osr_data != nullptr) {
         return osr_data;
       }
+      // Count the loop, and ask for OSR code directly if it is hot.
+      if (jit->EnqueueLoopOsrCompilation(
+              method->GetInterfaceMethodIfProxy(kRuntimePointerSize), dex_pc, Thread::Current())) {
+        return nullptr;
+      }
     }
     jit->EnqueueCompilation(method, Thread::Current());
   }
@@ -18,6 +18,9 @@
 
 #include <dlfcn.h>
 
+#include <map>
+#include <thread>
+
 #include "art_method-inl.h"
 #include "base/enums.h"
 #include "base/file_utils.h"
@@ -30,6 +33,7 @@
 #include "class_root-inl.h"
 #include "compilation_kind.h"
 #include "debugger.h"
+#include "dex/dex_file_loader.h"
 #include "dex/type_lookup_table.h"
 #include "gc/space/image_space.h"
 #include "entrypoints/entrypoint_utils-inl.h"
@@ -39,6 +43,7 @@
 #include "jit-inl.h"
 #include "jit_code_cache.h"
 #include "jni/java_vm_ext.h"
+#include "jni/native_method_promotions.h"
 #include "mirror/method_handle_impl.h"
 #include "mirror/var_handle.h"
 #include "oat_file.h"
@@ -78,6 +83,14 @@ static constexpr uint32_t kJitStressDefaultWarmupThreshold = kJitDefaultWarmupTh
 static constexpr uint32_t kJitSlowStressDefaultWarmupThreshold =
     kJitStressDefaultWarmupThreshold / 2;
 
+// Percentage of the available CPU time above which we consider the process saturated, and
+// start metering JIT compilation against its budget.
+static constexpr uint64_t kJitSaturatedProcessLoadPercent = 90;
+
+// Number of methods from the primary profile compiled before giving other
+// compilation requests a chance to run.
+static constexpr size_t kJitStartupProfileBatchSize = 16;
+
 DEFINE_RUNTIME_DEBUG_FLAG(Jit, kSlowMode);
 
 // JIT compiler
@@ -103,6 +116,14 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
       options.GetOrDefault(RuntimeArgumentMap::JITPoolThreadPthreadPriority);
   jit_options->zygote_thread_pool_pthread_priority_ =
       options.GetOrDefault(RuntimeArgumentMap::JITZygotePoolThreadPthreadPriority);
+  jit_options->cpu_budget_percent_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITCpuBudgetPercent);
+  jit_options->cpu_budget_window_ns_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITCpuBudgetWindow);
+  jit_options->compile_startup_profile_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITCompileStartupProfile);
+  jit_options->startup_profile_max_size_ =
+      options.GetOrDefault(RuntimeArgumentMap::JITStartupProfileMaxSize);
 
   // Set default optimize threshold to aid with checking defaults.
   jit_options->optimize_threshold_ =
@@ -160,8 +181,97 @@ JitOptions* JitOptions::CreateFromRuntimeArguments(const RuntimeArgumentMap& opt
   return jit_options;
 }
 
+JitCompilationGovernor::JitCompilationGovernor(uint32_t budget_percent, uint64_t window_ns)
+    : JitCompilationGovernor(budget_percent,
+                             window_ns,
+                             std::max(std::thread::hardware_concurrency(), 1u),
+                             NanoTime,
+                             ProcessCpuNanoTime) {}
+
+JitCompilationGovernor::JitCompilationGovernor(uint32_t budget_percent,
+                                               uint64_t window_ns,
+                                               uint32_t number_of_cpus,
+                                               ClockFn clock,
+                                               ClockFn process_cpu_clock)
+    : window_ns_(window_ns),
+      budget_ns_(window_ns * budget_percent / 100),
+      number_of_cpus_(number_of_cpus),
+      clock_(clock),
+      process_cpu_clock_(process_cpu_clock),
+      lock_("JIT compilation governor lock"),
+      window_start_ns_(clock()),
+      window_start_process_cpu_ns_(process_cpu_clock()),
+      window_compilation_ns_(0),
+      saturated_(false),
+      saturated_windows_(0),
+      exhausted_windows_(0),
+      deferred_compilations_(0) {}
+
+void JitCompilationGovernor::MaybeStartNewWindow(uint64_t now_ns) {
+  uint64_t elapsed_ns = now_ns - window_start_ns_;
+  if (elapsed_ns < window_ns_) {
+    return;
+  }
+  uint64_t process_cpu_ns = process_cpu_clock_();
+  uint64_t used_cpu_ns = process_cpu_ns - window_start_process_cpu_ns_;
+  uint64_t available_cpu_ns = elapsed_ns * number_of_cpus_;
+  // The JIT threads are part of the process, so a busy JIT alone may look like a
+  // saturated process. Only count the time spent outside compilation.
+  used_cpu_ns -= std::min(used_cpu_ns, window_compilation_ns_);
+  saturated_ = used_cpu_ns * 100 >= available_cpu_ns * kJitSaturatedProcessLoadPercent;
+  if (saturated_) {
+    ++saturated_windows_;
+  }
+  if (window_compilation_ns_ >= budget_ns_) {
+    ++exhausted_windows_;
+  }
+  GetMetrics()->JitCpuBudgetUtilization()->Add(
+      static_cast<int64_t>(std::min<uint64_t>(window_compilation_ns_ * 100 / budget_ns_, 100)));
+  window_start_ns_ = now_ns;
+  window_start_process_cpu_ns_ = process_cpu_ns;
+  window_compilation_ns_ = 0;
+}
+
+bool JitCompilationGovernor::ShouldDefer(Thread* self, CompilationKind compilation_kind) {
+  if (!IsEnabled() || compilation_kind == CompilationKind::kOsr) {
+    return false;
+  }
+  MutexLock mu(self, lock_);
+  MaybeStartNewWindow(clock_());
+  if (!saturated_ || window_compilation_ns_ < budget_ns_) {
+    return false;
+  }
+  ++deferred_compilations_;
+  GetMetrics()->JitCompilationDeferredCount()->AddOne();
+  return true;
+}
+
+void JitCompilationGovernor::AddCompilationTime(Thread* self, uint64_t cpu_ns) {
+  if (!IsEnabled()) {
+    return;
+  }
+  MutexLock mu(self, lock_);
+  MaybeStartNewWindow(clock_());
+  window_compilation_ns_ += cpu_ns;
+}
+
+void JitCompilationGovernor::Dump(std::ostream& os) {
+  if (!IsEnabled()) {
+    return;
+  }
+  MutexLock mu(Thread::Current(), lock_);
+  os << "JIT CPU budget=" << PrettyDuration(budget_ns_)
+     << " per " << PrettyDuration(window_ns_) << " window\n"
+     << "Current window compilation time=" << PrettyDuration(window_compilation_ns_)
+     << " (" << (window_compilation_ns_ * 100 / budget_ns_) << "% of budget)\n"
+     << "Saturated windows=" << saturated_windows_ << "\n"
+     << "Budget exhausted windows=" << exhausted_windows_ << "\n"
+     << "Deferred compilations=" << deferred_compilations_ << "\n";
+}
+
 void Jit::DumpInfo(std::ostream& os) {
   code_cache_->Dump(os);
+  governor_.Dump(os);
   cumulative_timings_.Dump(os);
   MutexLock mu(Thread::Current(), lock_);
   memory_use_.PrintMemoryUse(os);
@@ -180,6 +290,7 @@ Jit::Jit(JitCodeCache* code_cache, JitOptions* options)
     : code_cache_(code_cache),
       options_(options),
       boot_completed_lock_("Jit::boot_completed_lock_"),
+      governor_(options->GetCpuBudgetPercent(), options->GetCpuBudgetWindowNs()),
       cumulative_timings_("JIT timings"),
       memory_use_("Memory used for compilation", 16),
       lock_("JIT memory use lock"),
@@ -217,6 +328,7 @@ Jit* Jit::Create(JitCodeCache* code_cache, JitOptions* options) {
       << ", max_capacity=" << PrettySize(options->GetCodeCacheMaxCapacity())
       << ", warmup_threshold=" << options->GetWarmupThreshold()
       << ", optimize_threshold=" << options->GetOptimizeThreshold()
+      << ", cpu_budget=" << options->GetCpuBudgetPercent() << "%"
       << ", profile_saver_options=" << options->GetProfileSaverOptions();
 
   // We want to know whether the compiler is compiling baseline, as this
@@ -322,7 +434,9 @@ bool Jit::CompileMethod(ArtMethod* method,
   VLOG(jit) << "Compiling method "
             << ArtMethod::PrettyMethod(method_to_compile)
             << " kind=" << compilation_kind;
+  uint64_t start_cpu_ns = ThreadCpuNanoTime();
   bool success = jit_compiler_->CompileMethod(self, region, method_to_compile, compilation_kind);
+  governor_.AddCompilationTime(self, ThreadCpuNanoTime() - start_cpu_ns);
   code_cache_->DoneCompiling(method_to_compile, self, compilation_kind);
   if (!success) {
     VLOG(jit) << "Failed to compile method "
@@ -358,6 +472,9 @@ void Jit::DeleteThreadPool() {
       pool = std::move(thread_pool_);
     }
 
+    // Tasks that re-enqueue themselves, like the startup profile compilation, must stop doing
+    // so for the pool to drain.
+    pool->SetFinishing(self);
     // When running sanitized, let all tasks finish to not leak. Otherwise just clear the queue.
     if (!kRunningOnMemoryTool) {
       pool->StopWorkers(self);
@@ -380,6 +497,17 @@ void Jit::StartProfileSaver(const std::string& profile_filename,
                         code_paths,
                         ref_profile_filename);
   }
+  if (options_->CompileStartupProfile() &&
+      UseJitCompilation() &&
+      thread_pool_ != nullptr &&
+      !Runtime::Current()->IsJavaDebuggable()) {
+    thread_pool_->AddTask(
+        Thread::Current(),
+        new JitStartupProfileTask(thread_pool_.get(),
+                                  profile_filename,
+                                  code_paths,
+                                  options_->GetStartupProfileMaxSize()));
+  }
 }
 
 void Jit::StopProfileSaver() {
@@ -1016,6 +1144,219 @@ class JitProfileTask final : public Task {
   DISALLOW_COPY_AND_ASSIGN(JitProfileTask);
 };
 
+/**
+ * A JIT task to compile the hot methods of an application's primary profile at
+ * startup, so that they do not have to become hot again. Methods are compiled
+ * in batches at background priority, and the task re-enqueues itself between
+ * batches so that compilation requests for methods that are hot right now are
+ * not delayed. The task is cancelled if the profile does not match the dex
+ * files of the application anymore.
+ */
+class JitStartupProfileTask final : public Task {
+ public:
+  JitStartupProfileTask(ThreadPool* thread_pool,
+                        const std::string& profile_file,
+                        const std::vector<std::string>& code_paths,
+                        size_t max_size)
+      : thread_pool_(thread_pool),
+        profile_file_(profile_file),
+        code_paths_(code_paths.begin(), code_paths.end()),
+        max_size_(max_size),
+        next_method_(0),
+        compiled_size_(0),
+        unresolved_methods_(0),
+        loaded_(false),
+        done_(false) {}
+
+  void Run(Thread* self) override {
+    Jit* jit = Runtime::Current()->GetJit();
+    if (!loaded_ && !LoadProfile(self)) {
+      done_ = true;
+      return;
+    }
+    loaded_ = true;
+    // Only lower the priority of this worker, other workers may be compiling methods that
+    // are hot right now.
+    ThreadPoolWorker* worker = thread_pool_->GetWorker(self);
+    if (worker != nullptr) {
+      worker->SetPthreadPriority(jit->options_->GetZygoteThreadPoolPthreadPriority());
+    }
+    CompileBatch(self, jit);
+    if (worker != nullptr) {
+      worker->SetPthreadPriority(jit->GetThreadPoolPthreadPriority());
+    }
+  }
+
+  void Finalize() override {
+    // The JIT clears its pool pointer before waiting for the pool at shutdown, so use the
+    // pool we were created for, and stop re-enqueueing once it is finishing so that it drains.
+    Thread* self = Thread::Current();
+    if (done_ || thread_pool_->IsFinishing(self)) {
+      delete this;
+    } else {
+      thread_pool_->AddTask(self, this);
+    }
+  }
+
+  ~JitStartupProfileTask() {
+    if (!class_loaders_.empty()) {
+      ScopedObjectAccess soa(Thread::Current());
+      for (jobject class_loader : class_loaders_) {
+        soa.Vm()->DeleteGlobalRef(soa.Self(), class_loader);
+      }
+    }
+  }
+
+ private:
+  // Load the hot methods of the profile for the dex files of `code_paths_`.
+  // Return false if there is nothing to compile or if the profile is stale.
+  bool LoadProfile(Thread* self) {
+    ProfileCompilationInfo profile_info(/* for_boot_image= */ false);
+    if (!profile_info.Load(profile_file_, /* clear_if_invalid= */ false)) {
+      VLOG(jit) << "Could not load startup profile " << profile_file_;
+      return false;
+    }
+    if (profile_info.IsEmpty()) {
+      return false;
+    }
+    ScopedObjectAccess soa(self);
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    // The application may open its own code paths again in other class loaders. For each dex
+    // location, take the dex file registered first, which is the one of the application class
+    // loader, and remember the class loader that owns it.
+    std::map<std::string, std::pair<uint64_t, const DexFile*>> dex_files_by_location;
+    std::vector<ObjPtr<mirror::ClassLoader>> class_loaders;
+    {
+      ReaderMutexLock mu(self, *Locks::dex_lock_);
+      for (const auto& entry : class_linker->GetDexCachesData()) {
+        const DexFile* dex_file = entry.first;
+        if (code_paths_.find(DexFileLoader::GetBaseLocation(dex_file->GetLocation())) ==
+                code_paths_.end()) {
+          continue;
+        }
+        if (self->IsJWeakCleared(entry.second.weak_root)) {
+          continue;
+        }
+        auto it = dex_files_by_location.find(dex_file->GetLocation());
+        if (it == dex_files_by_location.end()) {
+          dex_files_by_location.emplace(dex_file->GetLocation(),
+                                        std::make_pair(entry.second.registration_index, dex_file));
+        } else if (entry.second.registration_index < it->second.first) {
+          it->second = std::make_pair(entry.second.registration_index, dex_file);
+        }
+      }
+      for (const auto& entry : dex_files_by_location) {
+        const DexFile* dex_file = entry.second.second;
+        ObjPtr<mirror::DexCache> dex_cache = ObjPtr<mirror::DexCache>::DownCast(
+            self->DecodeJObject(class_linker->GetDexCachesData().at(dex_file).weak_root));
+        if (dex_cache == nullptr) {
+          continue;
+        }
+        dex_files_.push_back(dex_file);
+        class_loaders.push_back(dex_cache->GetClassLoader());
+      }
+    }
+    if (dex_files_.empty()) {
+      VLOG(jit) << "No dex file loaded for startup profile " << profile_file_;
+      return false;
+    }
+    if (!profile_info.VerifyProfileData(dex_files_)) {
+      LOG(WARNING) << "Not compiling stale startup profile " << profile_file_;
+      return false;
+    }
+    for (size_t i = 0; i < dex_files_.size(); ++i) {
+      std::set<dex::TypeIndex> class_types;
+      std::set<uint16_t> hot_methods;
+      std::set<uint16_t> startup_methods;
+      std::set<uint16_t> post_startup_methods;
+      if (!profile_info.GetClassesAndMethods(*dex_files_[i],
+                                             &class_types,
+                                             &hot_methods,
+                                             &startup_methods,
+                                             &post_startup_methods)) {
+        // Either the dex file is not in the profile or its checksum does not match.
+        continue;
+      }
+      for (uint16_t method_idx : hot_methods) {
+        methods_.emplace_back(i, method_idx);
+      }
+    }
+    if (methods_.empty()) {
+      return false;
+    }
+    for (ObjPtr<mirror::ClassLoader> class_loader : class_loaders) {
+      class_loaders_.push_back(soa.Vm()->AddGlobalRef(self, class_loader));
+    }
+    VLOG(jit) << "Compiling " << methods_.size() << " hot methods from " << profile_file_;
+    return true;
+  }
+
+  void CompileBatch(Thread* self, Jit* jit) {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<2> hs(self);
+    MutableHandle<mirror::ClassLoader> class_loader = hs.NewHandle<mirror::ClassLoader>(nullptr);
+    MutableHandle<mirror::DexCache> dex_cache = hs.NewHandle<mirror::DexCache>(nullptr);
+    ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
+    size_t end = std::min(next_method_ + kJitStartupProfileBatchSize, methods_.size());
+    for (; next_method_ < end; ++next_method_) {
+      size_t dex_file_index = methods_[next_method_].first;
+      uint32_t method_idx = methods_[next_method_].second;
+      class_loader.Assign(soa.Decode<mirror::ClassLoader>(class_loaders_[dex_file_index]));
+      dex_cache.Assign(class_linker->FindDexCache(self, *dex_files_[dex_file_index]));
+      ArtMethod* method =
+          class_linker->ResolveMethodWithoutInvokeType(method_idx, dex_cache, class_loader);
+      if (method == nullptr) {
+        self->ClearException();
+        ++unresolved_methods_;
+        continue;
+      }
+      size_t size = method->DexInstructions().InsnsSizeInBytes();
+      if (compiled_size_ + size > max_size_) {
+        VLOG(jit) << "Reached the startup profile compilation cap after "
+                  << next_method_ << " methods";
+        done_ = true;
+        return;
+      }
+      // Only charge the cap for code actually compiled, not for methods that were already
+      // compiled or that cannot be.
+      if (jit->CompileMethodFromProfile(self,
+                                        class_linker,
+                                        method_idx,
+                                        dex_cache,
+                                        class_loader,
+                                        /* add_to_queue= */ false,
+                                        /* compile_after_boot= */ false)) {
+        compiled_size_ += size;
+      }
+    }
+    // A profile whose methods mostly do not resolve anymore describes an older
+    // version of the application.
+    if (unresolved_methods_ * 2 > next_method_) {
+      LOG(WARNING) << "Cancelling compilation of stale startup profile " << profile_file_;
+      done_ = true;
+      return;
+    }
+    done_ = (next_method_ == methods_.size());
+  }
+
+  ThreadPool* const thread_pool_;
+  const std::string profile_file_;
+  const std::set<std::string> code_paths_;
+  const size_t max_size_;
+  std::vector<const DexFile*> dex_files_;
+  // The class loaders owning `dex_files_`, at the same index.
+  std::vector<jobject> class_loaders_;
+  // Pairs of index in `dex_files_` and method index.
+  std::vector<std::pair<size_t, uint32_t>> methods_;
+  size_t next_method_;
+  size_t compiled_size_;
+  size_t unresolved_methods_;
+  bool loaded_;
+  bool done_;
+
+  DISALLOW_COPY_AND_ASSIGN(JitStartupProfileTask);
+};
+
 static void CopyIfDifferent(void* s1, const void* s2, size_t n) {
   if (memcmp(s1, s2, n) != 0) {
     memcpy(s1, s2, n);
@@ -1315,7 +1656,7 @@ bool Jit::CompileMethodFromProfile(Thread* self,
       (entry_point == GetQuickResolutionStub())) {
     method->SetPreCompiled();
     if (!add_to_queue) {
-      CompileMethod(method, self, CompilationKind::kOptimized, /* prejit= */ true);
+      return CompileMethod(method, self, CompilationKind::kOptimized, /* prejit= */ true);
     } else {
       Task* task = new JitCompileTask(
           method, JitCompileTask::TaskKind::kPreCompile, CompilationKind::kOptimized);
@@ -1469,6 +1810,14 @@ bool Jit::IgnoreSamplesForMethod(ArtMethod* method) REQUIRES_SHARED(Locks::mutat
       // walking (b/78151261).
       return true;
     }
+    Runtime* runtime = Runtime::Current();
+    const NativeMethodPromotions* promotions = runtime->GetNativeMethodPromotions();
+    if (UNLIKELY(promotions != nullptr) &&
+        runtime->GetJavaVM()->IsCheckJniEnabled() &&
+        promotions->IsPromoted(method)) {
+      // With CheckJNI, keep promoted methods on the generic JNI stub, which times their calls.
+      return true;
+    }
   }
   return false;
 }
@@ -1483,8 +1832,10 @@ void Jit::EnqueueOptimizedCompilation(ArtMethod* method, Thread* self) {
   }
   // We arrive here after a baseline compiled code has reached its baseline
   // hotness threshold. If we're not only using the baseline compiler, enqueue a compilation
-  // task that will compile optimize the method.
-  if (!options_->UseBaselineCompiler()) {
+  // task that will compile optimize the method. If the governor defers it, the baseline code
+  // will call us again once the counter reaches the threshold again.
+  if (!options_->UseBaselineCompiler() &&
+      !governor_.ShouldDefer(self, CompilationKind::kOptimized)) {
     thread_pool_->AddTask(
         self,
         new JitCompileTask(method,
@@ -1764,17 +2115,46 @@ void Jit::EnqueueCompilation(ArtMethod* method, Thread* self) {
     return;
   }
 
-  if (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo()) {
-    thread_pool_->AddTask(
-        self,
-        new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, CompilationKind::kBaseline));
-  } else {
-    thread_pool_->AddTask(
-        self,
-        new JitCompileTask(method,
-                           JitCompileTask::TaskKind::kCompile,
-                           CompilationKind::kOptimized));
+  CompilationKind compilation_kind =
+      (!method->IsNative() && GetCodeCache()->CanAllocateProfilingInfo())
+          ? CompilationKind::kBaseline
+          : CompilationKind::kOptimized;
+  if (governor_.ShouldDefer(self, compilation_kind)) {
+    // The hotness counter has been reset by the caller, the method will be
+    // enqueued again once it is hot again.
+    return;
+  }
+
+  thread_pool_->AddTask(
+      self, new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, compilation_kind));
+}
+
+bool Jit::EnqueueLoopOsrCompilation(ArtMethod* method, uint32_t dex_pc, Thread* self) {
+  if (thread_pool_ == nullptr || JitAtFirstUse() || !UseJitCompilation()) {
+    return false;
   }
+
+  if (method->IsNative() || IgnoreSamplesForMethod(method)) {
+    return false;
+  }
+
+  // Loop counts live in the ProfilingInfo, which is created by the first call
+  // for the method if the baseline compilation has not created it yet.
+  if (code_cache_->IncrementLoopCount(method, dex_pc, self) < kJitLoopOsrThreshold) {
+    return false;
+  }
+
+  if (code_cache_->IsOsrCompiled(method) ||
+      governor_.ShouldDefer(self, CompilationKind::kOsr)) {
+    return false;
+  }
+
+  VLOG(jit) << "Enqueuing OSR compilation of " << method->PrettyMethod()
+            << " for hot loop at dex pc " << dex_pc;
+  code_cache_->ResetLoopCount(method, dex_pc, self);
+  thread_pool_->AddTask(
+      self, new JitCompileTask(method, JitCompileTask::TaskKind::kCompile, CompilationKind::kOsr));
+  return true;
 }
 
 }  // namespace jit
@@ -19,10 +19,12 @@
 
 #include <android-base/unique_fd.h>
 
+#include "base/globals.h"
 #include "base/histogram-inl.h"
 #include "base/macros.h"
 #include "base/mutex.h"
 #include "base/runtime_debug.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "compilation_kind.h"
 #include "handle.h"
@@ -65,6 +67,10 @@ static constexpr int kJitPoolThreadPthreadDefaultPriority = 9;
 // 19 is the lowest background priority on device.
 // See android/os/Process.java.
 static constexpr int kJitZygotePoolThreadPthreadDefaultPriority = 19;
+// Default wall-clock window over which the JIT CPU budget is metered.
+static constexpr uint64_t kJitDefaultCpuBudgetWindowNs = MsToNs(1000);
+// Default cap on the dex code size of methods compiled from the primary profile at startup.
+static constexpr size_t kJitDefaultStartupProfileMaxSize = 256 * KB;
 
 class JitOptions {
  public:
@@ -114,6 +120,22 @@ class JitOptions {
     return zygote_thread_pool_pthread_priority_;
   }
 
+  uint32_t GetCpuBudgetPercent() const {
+    return cpu_budget_percent_;
+  }
+
+  uint64_t GetCpuBudgetWindowNs() const {
+    return cpu_budget_window_ns_;
+  }
+
+  bool CompileStartupProfile() const {
+    return compile_startup_profile_;
+  }
+
+  size_t GetStartupProfileMaxSize() const {
+    return startup_profile_max_size_;
+  }
+
   bool UseJitCompilation() const {
     return use_jit_compilation_;
   }
@@ -164,6 +186,10 @@ class JitOptions {
   bool dump_info_on_shutdown_;
   int thread_pool_pthread_priority_;
   int zygote_thread_pool_pthread_priority_;
+  uint32_t cpu_budget_percent_;
+  uint64_t cpu_budget_window_ns_;
+  bool compile_startup_profile_;
+  size_t startup_profile_max_size_;
   ProfileSaverOptions profile_saver_options_;
 
   JitOptions()
@@ -178,7 +204,11 @@ class JitOptions {
         invoke_transition_weight_(0),
         dump_info_on_shutdown_(false),
         thread_pool_pthread_priority_(kJitPoolThreadPthreadDefaultPriority),
-        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority) {}
+        zygote_thread_pool_pthread_priority_(kJitZygotePoolThreadPthreadDefaultPriority),
+        cpu_budget_percent_(0),
+        cpu_budget_window_ns_(kJitDefaultCpuBudgetWindowNs),
+        compile_startup_profile_(false),
+        startup_profile_max_size_(kJitDefaultStartupProfileMaxSize) {}
 
   DISALLOW_COPY_AND_ASSIGN(JitOptions);
 };
@@ -226,12 +256,70 @@ struct OsrData {
   }
 };
 
+// Meters the CPU time spent compiling against a budget per wall-clock window.
+//
+// The budget only applies while the process is saturated, that is when it used
+// nearly all available cores during the previous window. In that state, once
+// the JIT has spent its share of the current window, non-OSR compilation
+// requests are deferred: the hotness counter of the method has already been
+// reset, so the method will ask again the next time it gets hot. OSR requests
+// are never deferred, as the interpreter is stuck in a loop waiting for them.
+class JitCompilationGovernor {
+ public:
+  JitCompilationGovernor(uint32_t budget_percent, uint64_t window_ns);
+
+  // Clocks returning nanoseconds; overridden by tests to drive the windows.
+  using ClockFn = uint64_t (*)();
+  JitCompilationGovernor(uint32_t budget_percent,
+                         uint64_t window_ns,
+                         uint32_t number_of_cpus,
+                         ClockFn clock,
+                         ClockFn process_cpu_clock);
+
+  bool IsEnabled() const {
+    return budget_ns_ != 0u;
+  }
+
+  // Return whether a compilation of the given kind should be deferred. Counts
+  // the request as deferred if so.
+  bool ShouldDefer(Thread* self, CompilationKind compilation_kind) REQUIRES(!lock_);
+
+  // Charge `cpu_ns` of compilation time to the current window.
+  void AddCompilationTime(Thread* self, uint64_t cpu_ns) REQUIRES(!lock_);
+
+  void Dump(std::ostream& os) REQUIRES(!lock_);
+
+ private:
+  // Close the current window if it has elapsed, reporting its budget utilization.
+  void MaybeStartNewWindow(uint64_t now_ns) REQUIRES(lock_);
+
+  const uint64_t window_ns_;
+  const uint64_t budget_ns_;
+  const uint32_t number_of_cpus_;
+  const ClockFn clock_;
+  const ClockFn process_cpu_clock_;
+
+  Mutex lock_;
+  uint64_t window_start_ns_ GUARDED_BY(lock_);
+  uint64_t window_start_process_cpu_ns_ GUARDED_BY(lock_);
+  uint64_t window_compilation_ns_ GUARDED_BY(lock_);
+  bool saturated_ GUARDED_BY(lock_);
+  uint64_t saturated_windows_ GUARDED_BY(lock_);
+  uint64_t exhausted_windows_ GUARDED_BY(lock_);
+  uint64_t deferred_compilations_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(JitCompilationGovernor);
+};
+
 class Jit {
  public:
   static constexpr size_t kDefaultPriorityThreadWeightRatio = 1000;
   static constexpr size_t kDefaultInvokeTransitionWeightRatio = 500;
   // How frequently should the interpreter check to see if OSR compilation is ready.
   static constexpr int16_t kJitRecheckOSRThreshold = 101;  // Prime number to avoid patterns.
+  // How many times the hotness counter of a method must run out on back edges
+  // to the same loop before nterp requests an OSR compilation for it.
+  static constexpr uint32_t kJitLoopOsrThreshold = 2;
 
   DECLARE_RUNTIME_DEBUG_FLAG(kSlowMode);
 
@@ -322,6 +410,9 @@ class Jit {
   // The `ref_profile_filename` denotes the path to the reference profile which
   // might be queried to determine if an initial save should be done earlier.
   // It can be empty indicating there is no reference profile.
+  //
+  // If enabled, this also schedules the background compilation of the hot
+  // methods already present in `profile_filename`.
   void StartProfileSaver(const std::string& profile_filename,
                          const std::vector<std::string>& code_paths,
                          const std::string& ref_profile_filename);
@@ -434,6 +525,13 @@ class Jit {
   void EnqueueCompilation(ArtMethod* method, Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Called by nterp when the hotness counter of `method` runs out on a back
+  // edge to the loop header at `dex_pc`. Enqueues an OSR compilation of the
+  // method once that loop is hot, without waiting for its baseline code.
+  // Returns whether a compilation was enqueued.
+  bool EnqueueLoopOsrCompilation(ArtMethod* method, uint32_t dex_pc, Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
  private:
   Jit(JitCodeCache* code_cache, JitOptions* options);
 
@@ -442,7 +540,8 @@ class Jit {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Compile an individual method listed in a profile. If `add_to_queue` is
-  // true and the method was resolved, return true. Otherwise return false.
+  // true and the method was resolved, return true. If `add_to_queue` is false,
+  // return whether the method was compiled.
   bool CompileMethodFromProfile(Thread* self,
                                 ClassLinker* linker,
                                 uint32_t method_idx,
@@ -454,6 +553,8 @@ class Jit {
 
   static bool BindCompilerMethods(std::string* error_msg);
 
+  friend class JitStartupProfileTask;
+
   // JIT compiler
   static void* jit_library_handle_;
   static JitCompilerInterface* jit_compiler_;
@@ -471,6 +572,9 @@ class Jit {
   bool boot_completed_ GUARDED_BY(boot_completed_lock_) = false;
   std::deque<Task*> tasks_after_boot_ GUARDED_BY(boot_completed_lock_);
 
+  // Budget for the CPU time spent compiling while the process is saturated.
+  JitCompilationGovernor governor_;
+
   // Performance monitoring.
   CumulativeLogger cumulative_timings_;
   Histogram<uint64_t> memory_use_ GUARDED_BY(lock_);
@@ -535,6 +535,7 @@ void JitCodeCache::RemoveMethodsIn(Thread* self, const LinearAlloc& alloc) {
           ++it;
         }
       }
+      PublishMethodCodeMap();
     }
     for (auto it = osr_code_map_.begin(); it != osr_code_map_.end();) {
       if (alloc.ContainsUnsafe(it->first)) {
@@ -738,6 +739,7 @@ bool JitCodeCache::Commit(Thread* self,
         zygote_map_.Put(code_ptr, method);
       } else {
         method_code_map_.Put(code_ptr, method);
+        method_code_map_snapshot_.Add(code_ptr, method, method_code_map_);
       }
       if (compilation_kind == CompilationKind::kOsr) {
         osr_code_map_.Put(method, code_ptr);
@@ -839,6 +841,7 @@ bool JitCodeCache::RemoveMethodLocked(ArtMethod* method, bool release_memory) {
         ++it;
       }
     }
+    PublishMethodCodeMap();
 
     auto osr_it = osr_code_map_.find(method);
     if (osr_it != osr_code_map_.end()) {
@@ -879,6 +882,7 @@ void JitCodeCache::MoveObsoleteMethod(ArtMethod* old_method, ArtMethod* new_meth
       it.second = new_method;
     }
   }
+  PublishMethodCodeMap();
   // Update osr_code_map_ to point to the new method.
   auto code_map = osr_code_map_.find(old_method);
   if (code_map != osr_code_map_.end()) {
@@ -1217,6 +1221,7 @@ void JitCodeCache::RemoveUnmarkedCode(Thread* self) {
         it = method_code_map_.erase(it);
       }
     }
+    PublishMethodCodeMap();
     FreeAllMethodHeaders(method_headers);
   }
 }
@@ -1389,6 +1394,29 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
     CHECK(method != nullptr);
   }
 
+  if (method != nullptr && LIKELY(!method->IsNative())) {
+    // Neither the zygote map nor the snapshot of the code map need the lock,
+    // so that stack walks do not contend with compiler threads.
+    if (shared_region_.IsInExecSpace(reinterpret_cast<const void*>(pc))) {
+      const void* code_ptr = zygote_map_.GetCodeFor(method, pc);
+      if (code_ptr != nullptr) {
+        return OatQuickMethodHeader::FromCodePointer(code_ptr);
+      }
+    }
+    JitCodeMap::Entry entry = method_code_map_snapshot_.Lookup(pc);
+    if (entry.code_ptr == nullptr ||
+        !OatQuickMethodHeader::FromCodePointer(entry.code_ptr)->Contains(pc)) {
+      return nullptr;
+    }
+    if (kIsDebugBuild) {
+      DCHECK_EQ(entry.method, method)
+          << ArtMethod::PrettyMethod(method) << " "
+          << ArtMethod::PrettyMethod(entry.method) << " "
+          << std::hex << pc;
+    }
+    return OatQuickMethodHeader::FromCodePointer(entry.code_ptr);
+  }
+
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   OatQuickMethodHeader* method_header = nullptr;
   ArtMethod* found_method = nullptr;  // Only for DCHECK(), not for JNI stubs.
@@ -1443,6 +1471,10 @@ OatQuickMethodHeader* JitCodeCache::LookupMethodHeader(uintptr_t pc, ArtMethod*
   return method_header;
 }
 
+void JitCodeCache::PublishMethodCodeMap() {
+  method_code_map_snapshot_.Publish(method_code_map_);
+}
+
 OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
   MutexLock mu(Thread::Current(), *Locks::jit_lock_);
   auto it = osr_code_map_.find(method);
@@ -1454,25 +1486,32 @@ OatQuickMethodHeader* JitCodeCache::LookupOsrMethodHeader(ArtMethod* method) {
 
 ProfilingInfo* JitCodeCache::AddProfilingInfo(Thread* self,
                                               ArtMethod* method,
-                                              const std::vector<uint32_t>& entries) {
+                                              const std::vector<uint32_t>& entries,
+                                              uint32_t number_of_skipped_inline_caches,
+                                              const std::vector<uint32_t>& loop_headers,
+                                              bool retry_allocation) {
   DCHECK(CanAllocateProfilingInfo());
   ProfilingInfo* info = nullptr;
   {
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, entries);
+    info = AddProfilingInfoInternal(
+        self, method, entries, number_of_skipped_inline_caches, loop_headers);
   }
 
-  if (info == nullptr) {
+  if (info == nullptr && retry_allocation) {
     GarbageCollectCache(self);
     MutexLock mu(self, *Locks::jit_lock_);
-    info = AddProfilingInfoInternal(self, method, entries);
+    info = AddProfilingInfoInternal(
+        self, method, entries, number_of_skipped_inline_caches, loop_headers);
   }
   return info;
 }
 
 ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNUSED,
                                                       ArtMethod* method,
-                                                      const std::vector<uint32_t>& entries) {
+                                                      const std::vector<uint32_t>& entries,
+                                                      uint32_t number_of_skipped_inline_caches,
+                                                      const std::vector<uint32_t>& loop_headers) {
   // Check whether some other thread has concurrently created it.
   auto it = profiling_infos_.find(method);
   if (it != profiling_infos_.end()) {
@@ -1480,21 +1519,51 @@ ProfilingInfo* JitCodeCache::AddProfilingInfoInternal(Thread* self ATTRIBUTE_UNU
   }
 
   size_t profile_info_size = RoundUp(
-      sizeof(ProfilingInfo) + sizeof(InlineCache) * entries.size(),
-      sizeof(void*));
+      ProfilingInfo::ComputeSize(entries.size(), loop_headers.size()), sizeof(void*));
 
   const uint8_t* data = private_region_.AllocateData(profile_info_size);
   if (data == nullptr) {
     return nullptr;
   }
   uint8_t* writable_data = private_region_.GetWritableDataAddress(data);
-  ProfilingInfo* info = new (writable_data) ProfilingInfo(method, entries);
+  ProfilingInfo* info = new (writable_data) ProfilingInfo(
+      method, entries, number_of_skipped_inline_caches, loop_headers);
 
   profiling_infos_.Put(method, info);
   histogram_profiling_info_memory_use_.AddValue(profile_info_size);
   return info;
 }
 
+uint32_t JitCodeCache::IncrementLoopCount(ArtMethod* method, uint32_t dex_pc, Thread* self) {
+  {
+    MutexLock mu(self, *Locks::jit_lock_);
+    auto it = profiling_infos_.find(method);
+    if (it != profiling_infos_.end()) {
+      return it->second->IncrementLoopCount(dex_pc);
+    }
+  }
+  // Allocate the loop counters on the first hot back edge instead of waiting for the baseline
+  // compilation to create the ProfilingInfo, which would leave the loops of the method uncounted
+  // while it is interpreted. Nterp cannot suspend here, so do not collect the cache for room.
+  if (!CanAllocateProfilingInfo()) {
+    return 0u;
+  }
+  ProfilingInfo* info = ProfilingInfo::Create(self, method, /*retry_allocation=*/ false);
+  if (info == nullptr) {
+    return 0u;
+  }
+  MutexLock mu(self, *Locks::jit_lock_);
+  return info->IncrementLoopCount(dex_pc);
+}
+
+void JitCodeCache::ResetLoopCount(ArtMethod* method, uint32_t dex_pc, Thread* self) {
+  MutexLock mu(self, *Locks::jit_lock_);
+  auto it = profiling_infos_.find(method);
+  if (it != profiling_infos_.end()) {
+    it->second->ResetLoopCount(dex_pc);
+  }
+}
+
 void* JitCodeCache::MoreCore(const void* mspace, intptr_t increment) {
   return shared_region_.OwnsSpace(mspace)
       ? shared_region_.MoreCore(mspace, increment)
@@ -1678,7 +1747,7 @@ bool JitCodeCache::NotifyCompilationOf(ArtMethod* method,
         has_profiling_info = (profiling_infos_.find(method) != profiling_infos_.end());
       }
       if (!has_profiling_info) {
-        if (ProfilingInfo::Create(self, method) == nullptr) {
+        if (ProfilingInfo::Create(self, method, /*retry_allocation=*/ true) == nullptr) {
           VLOG(jit) << method->PrettyMethod() << " needs a ProfilingInfo to be compiled baseline";
           ClearMethodCounter(method, /*was_warm=*/ false);
           return false;
@@ -1804,7 +1873,25 @@ void JitCodeCache::Dump(std::ostream& os) {
      << "Total number of JIT optimized compilations: " << number_of_optimized_compilations_ << "\n"
      << "Total number of JIT compilations for on stack replacement: "
         << number_of_osr_compilations_ << "\n"
-     << "Total number of JIT code cache collections: " << number_of_collections_ << std::endl;
+     << "Total number of JIT code cache collections: " << number_of_collections_ << "\n";
+  // Report the part of the data cache used by profiling infos separately from
+  // the one used by the metadata of compiled code.
+  size_t profiling_info_size = 0;
+  size_t number_of_inline_caches = 0;
+  size_t number_of_skipped_inline_caches = 0;
+  for (const auto& entry : profiling_infos_) {
+    ProfilingInfo* info = entry.second;
+    profiling_info_size += RoundUp(
+        ProfilingInfo::ComputeSize(info->GetNumberOfInlineCaches(), info->GetNumberOfLoops()),
+        sizeof(void*));
+    number_of_inline_caches += info->GetNumberOfInlineCaches();
+    number_of_skipped_inline_caches += info->GetNumberOfSkippedInlineCaches();
+  }
+  os << "Current JIT profiling info size: " << PrettySize(profiling_info_size)
+     << " for " << profiling_infos_.size() << " methods and "
+     << number_of_inline_caches << " inline caches, "
+     << PrettySize(number_of_skipped_inline_caches * sizeof(InlineCache)) << " saved by "
+     << number_of_skipped_inline_caches << " call sites without inline cache" << std::endl;
   histogram_stack_map_memory_use_.PrintMemoryUse(os);
   histogram_code_memory_use_.PrintMemoryUse(os);
   histogram_profiling_info_memory_use_.PrintMemoryUse(os);
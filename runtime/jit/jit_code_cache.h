@@ -33,6 +33,7 @@
 #include "base/mutex.h"
 #include "base/safe_map.h"
 #include "compilation_kind.h"
+#include "jit_code_map.h"
 #include "jit_memory_region.h"
 #include "profiling_info.h"
 
@@ -311,13 +312,28 @@ class JitCodeCache {
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Create a 'ProfileInfo' for 'method'.
+  // Create a 'ProfileInfo' for 'method'. `number_of_skipped_inline_caches` is the number of
+  // call sites that were not given an inline cache, see ProfilingInfo::Create.
   ProfilingInfo* AddProfilingInfo(Thread* self,
                                   ArtMethod* method,
-                                  const std::vector<uint32_t>& entries)
+                                  const std::vector<uint32_t>& entries,
+                                  uint32_t number_of_skipped_inline_caches,
+                                  const std::vector<uint32_t>& loop_headers,
+                                  bool retry_allocation)
       REQUIRES(!Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Record in the ProfilingInfo of `method` that its hotness counter ran out
+  // on a back edge to the loop header at `dex_pc`, creating the ProfilingInfo
+  // if needed. Returns how many times it did for that loop, or 0 if there is
+  // no room for the ProfilingInfo.
+  uint32_t IncrementLoopCount(ArtMethod* method, uint32_t dex_pc, Thread* self)
+      REQUIRES(!Locks::jit_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  void ResetLoopCount(ArtMethod* method, uint32_t dex_pc, Thread* self)
+      REQUIRES(!Locks::jit_lock_);
+
   bool OwnsSpace(const void* mspace) const NO_THREAD_SAFETY_ANALYSIS {
     return private_region_.OwnsSpace(mspace) || shared_region_.OwnsSpace(mspace);
   }
@@ -407,7 +423,9 @@ class JitCodeCache {
 
   ProfilingInfo* AddProfilingInfoInternal(Thread* self,
                                           ArtMethod* method,
-                                          const std::vector<uint32_t>& entries)
+                                          const std::vector<uint32_t>& entries,
+                                          uint32_t number_of_skipped_inline_caches,
+                                          const std::vector<uint32_t>& loop_headers)
       REQUIRES(Locks::jit_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -506,6 +524,9 @@ class JitCodeCache {
   // Return whether `method` is being compiled in any mode.
   bool IsMethodBeingCompiled(ArtMethod* method) REQUIRES(Locks::jit_lock_);
 
+  // Make the current contents of `method_code_map_` visible to lock-free lookups.
+  void PublishMethodCodeMap() REQUIRES(Locks::jit_lock_);
+
   class JniStubKey;
   class JniStubData;
 
@@ -533,6 +554,10 @@ class JitCodeCache {
   // Holds compiled code associated to the ArtMethod.
   SafeMap<const void*, ArtMethod*> method_code_map_ GUARDED_BY(Locks::jit_lock_);
 
+  // Copy of `method_code_map_` for lookups that do not take the lock. Updated
+  // through `PublishMethodCodeMap()` whenever `method_code_map_` changes.
+  JitCodeMap method_code_map_snapshot_;
+
   // Holds compiled code associated to the ArtMethod. Used when pre-jitting
   // methods whose entrypoints have the resolution stub.
   SafeMap<ArtMethod*, const void*> saved_compiled_methods_map_ GUARDED_BY(Locks::jit_lock_);
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit_code_map.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace art {
+namespace jit {
+
+JitCodeMap::JitCodeMap()
+    : snapshot_(new Snapshot(kMinimumCapacity)),
+      reader_phase_(0u),
+      grace_period_flips_(0u),
+      draining_phase_(0u) {
+  for (ReaderSlot& slot : reader_slots_) {
+    slot.readers[0].store(0u, std::memory_order_relaxed);
+    slot.readers[1].store(0u, std::memory_order_relaxed);
+  }
+}
+
+JitCodeMap::~JitCodeMap() {
+  delete snapshot_.load(std::memory_order_relaxed);
+  for (Snapshot* snapshot : retired_) {
+    delete snapshot;
+  }
+  for (Snapshot* snapshot : grace_period_snapshots_) {
+    delete snapshot;
+  }
+}
+
+JitCodeMap::ReaderSlot* JitCodeMap::GetReaderSlot() const {
+  // Use pthread_self() rather than a thread_local, which is not async-signal-safe
+  // to access from a shared library.
+  uint64_t hash = static_cast<uint64_t>(pthread_self()) * UINT64_C(0x9e3779b97f4a7c15);
+  return &reader_slots_[(hash >> 32) % kNumberOfReaderSlots];
+}
+
+JitCodeMap::Entry JitCodeMap::Lookup(uintptr_t pc) const {
+  ReaderSlot* slot = GetReaderSlot();
+  uint32_t phase = reader_phase_.load(std::memory_order_seq_cst) & 1u;
+  slot->readers[phase].fetch_add(1u, std::memory_order_seq_cst);
+  const Snapshot* snapshot = snapshot_.load(std::memory_order_seq_cst);
+  const Entry* begin = snapshot->entries.get();
+  const Entry* end = begin + snapshot->size.load(std::memory_order_acquire);
+  const Entry* it = std::lower_bound(begin,
+                                     end,
+                                     pc,
+                                     [](const Entry& entry, uintptr_t value) {
+                                       return reinterpret_cast<uintptr_t>(entry.code_ptr) < value;
+                                     });
+  Entry result = { nullptr, nullptr };
+  if (it != begin) {
+    result = *(--it);
+  }
+  slot->readers[phase].fetch_sub(1u, std::memory_order_release);
+  return result;
+}
+
+void JitCodeMap::Publish(const SafeMap<const void*, ArtMethod*>& code_map) {
+  // Leave room for the code compiled next, which can then be added in place.
+  Snapshot* snapshot = new Snapshot(std::max(2u * code_map.size(), kMinimumCapacity));
+  Entry* entries = snapshot->entries.get();
+  for (const auto& it : code_map) {
+    *entries++ = { it.first, it.second };
+  }
+  snapshot->size.store(code_map.size(), std::memory_order_relaxed);
+  Snapshot* old_snapshot = snapshot_.exchange(snapshot, std::memory_order_seq_cst);
+  retired_.push_back(old_snapshot);
+  TryReclaim();
+}
+
+void JitCodeMap::Add(const void* code_ptr,
+                     ArtMethod* method,
+                     const SafeMap<const void*, ArtMethod*>& code_map) {
+  Snapshot* snapshot = snapshot_.load(std::memory_order_relaxed);
+  size_t size = snapshot->size.load(std::memory_order_relaxed);
+  DCHECK_EQ(size + 1u, code_map.size());
+  if (size != snapshot->capacity &&
+      (size == 0u ||
+       reinterpret_cast<uintptr_t>(snapshot->entries[size - 1u].code_ptr) <
+           reinterpret_cast<uintptr_t>(code_ptr))) {
+    snapshot->entries[size] = { code_ptr, method };
+    snapshot->size.store(size + 1u, std::memory_order_release);
+    TryReclaim();
+  } else {
+    Publish(code_map);
+  }
+}
+
+void JitCodeMap::TryReclaim() {
+  while (true) {
+    if (grace_period_snapshots_.empty()) {
+      if (retired_.empty()) {
+        return;
+      }
+      grace_period_snapshots_.swap(retired_);
+      grace_period_flips_ = 0u;
+      draining_phase_ = FlipReaderPhase();
+    }
+    if (HasReaders(draining_phase_)) {
+      return;  // Try again at the next update.
+    }
+    // A reader may have read the phase just before a flip, and registered with
+    // it only after we checked its counter. Flipping twice guarantees we wait for
+    // such a reader, while readers arriving after a flip use the other counter
+    // and cannot delay the grace period indefinitely.
+    if (++grace_period_flips_ != 2u) {
+      draining_phase_ = FlipReaderPhase();
+      continue;
+    }
+    for (Snapshot* snapshot : grace_period_snapshots_) {
+      delete snapshot;
+    }
+    grace_period_snapshots_.clear();
+  }
+}
+
+uint32_t JitCodeMap::FlipReaderPhase() {
+  return reader_phase_.fetch_add(1u, std::memory_order_seq_cst) & 1u;
+}
+
+bool JitCodeMap::HasReaders(uint32_t phase) const {
+  for (const ReaderSlot& slot : reader_slots_) {
+    if (slot.readers[phase].load(std::memory_order_acquire) != 0u) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace jit
+}  // namespace art
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JIT_JIT_CODE_MAP_H_
+#define ART_RUNTIME_JIT_JIT_CODE_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/safe_map.h"
+
+namespace art {
+
+class ArtMethod;
+
+namespace jit {
+
+// A sorted map from JIT code pointers to their methods, which can be searched
+// without holding Locks::jit_lock_.
+//
+// Writers must be serialized by the caller. Each update publishes a new
+// immutable snapshot of the map, except for additions at the end of the map,
+// which are appended in place to the spare capacity of the current snapshot.
+// Readers register in one of a fixed number of cache-line sized slots, picked
+// from the identity of the reading thread, and replaced snapshots are only
+// deleted once all readers that could have observed them have left. This is
+// the grace period scheme of userspace RCU with two reader counters per slot,
+// flipped by the writer. The writer never waits for readers: it advances the
+// grace period at each update and reclaims replaced snapshots lazily.
+class JitCodeMap {
+ public:
+  struct Entry {
+    const void* code_ptr;
+    ArtMethod* method;
+  };
+
+  JitCodeMap();
+  ~JitCodeMap();
+
+  // Replace the contents of the map with `code_map`.
+  void Publish(const SafeMap<const void*, ArtMethod*>& code_map);
+
+  // Add the entry for `code_ptr`, which has just been added to `code_map`.
+  // Cheaper than `Publish` when `code_ptr` is above all the other entries.
+  void Add(const void* code_ptr,
+           ArtMethod* method,
+           const SafeMap<const void*, ArtMethod*>& code_map);
+
+  // Return the entry with the greatest code pointer lower than `pc`, or an
+  // entry with null `code_ptr` if there is none. The caller is responsible for
+  // checking that the code of the entry contains `pc`.
+  // Safe to call concurrently with `Publish`, and from signal handlers.
+  Entry Lookup(uintptr_t pc) const;
+
+  // Number of replaced snapshots which have not been deleted yet.
+  size_t GetNumberOfRetiredSnapshots() const {
+    return retired_.size() + grace_period_snapshots_.size();
+  }
+
+ private:
+  struct Snapshot {
+    explicit Snapshot(size_t capacity_in)
+        : entries(new Entry[capacity_in]), capacity(capacity_in), size(0u) {}
+
+    std::unique_ptr<Entry[]> entries;
+    const size_t capacity;
+    // Readers only look at the first `size` entries, so the writer can append
+    // an entry past them and then release the new size.
+    std::atomic<size_t> size;
+  };
+
+  static constexpr size_t kMinimumCapacity = 64;
+  static constexpr size_t kNumberOfReaderSlots = 64;
+  static constexpr size_t kReaderSlotAlignment = 64;
+
+  struct alignas(kReaderSlotAlignment) ReaderSlot {
+    std::atomic<uint32_t> readers[2];
+  };
+
+  ReaderSlot* GetReaderSlot() const;
+
+  // Advance the grace period as far as possible without waiting, and delete
+  // the snapshots replaced before it started once it has ended.
+  void TryReclaim();
+
+  // Flip the phase of new readers and return the previous one.
+  uint32_t FlipReaderPhase();
+
+  bool HasReaders(uint32_t phase) const;
+
+  std::atomic<Snapshot*> snapshot_;
+
+  // Phase that new readers register with, in its lowest bit.
+  std::atomic<uint32_t> reader_phase_;
+
+  // Replaced snapshots waiting for the next grace period.
+  std::vector<Snapshot*> retired_;
+
+  // Replaced snapshots waiting for the end of the current grace period, which
+  // is made of two phase flips, each followed by the exit of the readers
+  // registered with the previous phase.
+  std::vector<Snapshot*> grace_period_snapshots_;
+  size_t grace_period_flips_;
+  uint32_t draining_phase_;
+
+  mutable ReaderSlot reader_slots_[kNumberOfReaderSlots];
+
+  DISALLOW_COPY_AND_ASSIGN(JitCodeMap);
+};
+
+}  // namespace jit
+}  // namespace art
+
+#endif  // ART_RUNTIME_JIT_JIT_CODE_MAP_H_
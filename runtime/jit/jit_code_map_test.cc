@@ -0,0 +1,193 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jit/jit_code_map.h"
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "android-base/logging.h"
+#include "base/safe_map.h"
+#include "base/time_utils.h"
+
+namespace art {
+namespace jit {
+
+// Size of the fake code allocations.
+static constexpr uintptr_t kCodeSize = 64;
+// Start of the fake code region.
+static constexpr uintptr_t kCodeBegin = 0x10000;
+
+static const void* CodeAt(size_t index) {
+  return reinterpret_cast<const void*>(kCodeBegin + index * kCodeSize);
+}
+
+static ArtMethod* MethodFor(size_t index) {
+  return reinterpret_cast<ArtMethod*>(0x1000 + index);
+}
+
+class JitCodeMapTest : public testing::Test {
+ protected:
+  // Run `num_readers` threads looking up the pc of stable entries through
+  // `lookup`, while a writer thread keeps adding and removing other entries
+  // through `publish`. Returns the number of lookups per second.
+  template <typename LookupFn, typename PublishFn>
+  static double RunStress(size_t num_readers, LookupFn lookup, PublishFn publish) {
+    static constexpr size_t kStableEntries = 1024;
+    static constexpr uint64_t kDurationNs = MsToNs(200);
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> total_lookups(0);
+    std::atomic<size_t> errors(0);
+
+    SafeMap<const void*, ArtMethod*> map;
+    // Stable entries use even indices, the writer churns odd ones.
+    for (size_t i = 0; i < kStableEntries; ++i) {
+      map.Put(CodeAt(2 * i), MethodFor(2 * i));
+    }
+    publish(map);
+
+    std::vector<std::thread> readers;
+    for (size_t r = 0; r < num_readers; ++r) {
+      readers.emplace_back([&, r]() {
+        uint64_t lookups = 0;
+        size_t i = r;
+        while (!done.load(std::memory_order_relaxed)) {
+          size_t index = 2 * (i++ % kStableEntries);
+          uintptr_t pc = reinterpret_cast<uintptr_t>(CodeAt(index)) + kCodeSize / 2;
+          if (lookup(pc) != MethodFor(index)) {
+            errors.fetch_add(1u, std::memory_order_relaxed);
+          }
+          ++lookups;
+        }
+        total_lookups.fetch_add(lookups, std::memory_order_relaxed);
+      });
+    }
+
+    uint64_t start_ns = NanoTime();
+    size_t churn = 0;
+    while (NanoTime() - start_ns < kDurationNs) {
+      size_t index = 2 * (churn++ % kStableEntries) + 1;
+      map.Put(CodeAt(index), MethodFor(index));
+      publish(map);
+      map.erase(CodeAt(index));
+      publish(map);
+    }
+    done.store(true, std::memory_order_relaxed);
+    for (std::thread& reader : readers) {
+      reader.join();
+    }
+    uint64_t duration_ns = NanoTime() - start_ns;
+    EXPECT_EQ(errors.load(), 0u);
+    return static_cast<double>(total_lookups.load()) * 1e9 / static_cast<double>(duration_ns);
+  }
+};
+
+TEST_F(JitCodeMapTest, Lookup) {
+  JitCodeMap code_map;
+  EXPECT_EQ(code_map.Lookup(kCodeBegin).code_ptr, nullptr);
+
+  SafeMap<const void*, ArtMethod*> map;
+  map.Put(CodeAt(1), MethodFor(1));
+  map.Put(CodeAt(3), MethodFor(3));
+  code_map.Publish(map);
+
+  uintptr_t code1 = reinterpret_cast<uintptr_t>(CodeAt(1));
+  uintptr_t code3 = reinterpret_cast<uintptr_t>(CodeAt(3));
+  EXPECT_EQ(code_map.Lookup(code1).code_ptr, nullptr);
+  EXPECT_EQ(code_map.Lookup(code1 + 1).code_ptr, CodeAt(1));
+  EXPECT_EQ(code_map.Lookup(code1 + 1).method, MethodFor(1));
+  // The caller checks whether the code contains the pc, the map only returns the closest entry.
+  EXPECT_EQ(code_map.Lookup(code3).code_ptr, CodeAt(1));
+  EXPECT_EQ(code_map.Lookup(code3 + 1).method, MethodFor(3));
+
+  map.erase(CodeAt(3));
+  code_map.Publish(map);
+  EXPECT_EQ(code_map.Lookup(code3 + 1).code_ptr, CodeAt(1));
+}
+
+TEST_F(JitCodeMapTest, Add) {
+  JitCodeMap code_map;
+  SafeMap<const void*, ArtMethod*> map;
+  // Entries above the others are appended in place, the others republish the map.
+  for (size_t index : { 2u, 4u, 3u, 5u, 1u }) {
+    map.Put(CodeAt(index), MethodFor(index));
+    code_map.Add(CodeAt(index), MethodFor(index), map);
+  }
+  for (size_t index = 1u; index <= 5u; ++index) {
+    uintptr_t pc = reinterpret_cast<uintptr_t>(CodeAt(index)) + 1u;
+    EXPECT_EQ(code_map.Lookup(pc).code_ptr, CodeAt(index));
+    EXPECT_EQ(code_map.Lookup(pc).method, MethodFor(index));
+  }
+
+  // Add more entries than the initial capacity.
+  for (size_t index = 6u; index != 1000u; ++index) {
+    map.Put(CodeAt(index), MethodFor(index));
+    code_map.Add(CodeAt(index), MethodFor(index), map);
+  }
+  for (size_t index = 1u; index != 1000u; ++index) {
+    uintptr_t pc = reinterpret_cast<uintptr_t>(CodeAt(index)) + 1u;
+    EXPECT_EQ(code_map.Lookup(pc).method, MethodFor(index));
+  }
+}
+
+TEST_F(JitCodeMapTest, Reclaim) {
+  JitCodeMap code_map;
+  SafeMap<const void*, ArtMethod*> map;
+  map.Put(CodeAt(1), MethodFor(1));
+  // Without readers, replaced snapshots are deleted right away.
+  code_map.Publish(map);
+  EXPECT_EQ(code_map.GetNumberOfRetiredSnapshots(), 0u);
+  code_map.Publish(map);
+  EXPECT_EQ(code_map.GetNumberOfRetiredSnapshots(), 0u);
+}
+
+// Compares the throughput of lookups in the lock-free map against lookups in
+// a map protected by a single lock, as the code cache used to do with
+// Locks::jit_lock_, while a writer keeps updating the map.
+TEST_F(JitCodeMapTest, ConcurrentLookupStress) {
+  size_t num_readers = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+
+  std::mutex lock;
+  SafeMap<const void*, ArtMethod*> locked_map;
+  double locked_rate = RunStress(
+      num_readers,
+      [&](uintptr_t pc) {
+        std::lock_guard<std::mutex> mu(lock);
+        auto it = locked_map.lower_bound(reinterpret_cast<const void*>(pc));
+        return (it == locked_map.begin()) ? nullptr : (--it)->second;
+      },
+      [&](const SafeMap<const void*, ArtMethod*>& map) {
+        std::lock_guard<std::mutex> mu(lock);
+        locked_map = map;
+      });
+
+  JitCodeMap code_map;
+  double lock_free_rate = RunStress(
+      num_readers,
+      [&](uintptr_t pc) { return code_map.Lookup(pc).method; },
+      [&](const SafeMap<const void*, ArtMethod*>& map) { code_map.Publish(map); });
+
+  LOG(INFO) << num_readers << " readers: "
+            << static_cast<uint64_t>(locked_rate) << " locked lookups/s, "
+            << static_cast<uint64_t>(lock_free_rate) << " lock-free lookups/s";
+}
+
+}  // namespace jit
+}  // namespace art
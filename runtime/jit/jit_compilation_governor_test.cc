@@ -0,0 +1,143 @@
+/*
+ * Copyright 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "common_runtime_test.h"
+#include "compilation_kind.h"
+#include "jit/jit.h"
+#include "thread-current-inl.h"
+
+namespace art {
+namespace jit {
+
+static constexpr uint32_t kBudgetPercent = 10;
+static constexpr uint64_t kWindowNs = MsToNs(100);
+static constexpr uint64_t kBudgetNs = kWindowNs * kBudgetPercent / 100;
+static constexpr uint32_t kNumberOfCpus = 2;
+
+// Fake clocks, advanced by the tests.
+static uint64_t gNowNs = 0;
+static uint64_t gProcessCpuNs = 0;
+
+static uint64_t FakeClock() {
+  return gNowNs;
+}
+
+static uint64_t FakeProcessCpuClock() {
+  return gProcessCpuNs;
+}
+
+class JitCompilationGovernorTest : public CommonRuntimeTest {
+ protected:
+  void SetUp() override {
+    CommonRuntimeTest::SetUp();
+    gNowNs = 0;
+    gProcessCpuNs = 0;
+  }
+
+  // Advance the wall clock by `elapsed_ns`, with the process using `load_percent`
+  // of all CPUs outside of JIT compilation.
+  static void Advance(uint64_t elapsed_ns, uint32_t load_percent) {
+    gNowNs += elapsed_ns;
+    gProcessCpuNs += elapsed_ns * kNumberOfCpus * load_percent / 100;
+  }
+
+  // Charge compilation time to both the governor and the process.
+  static void Compile(JitCompilationGovernor* governor, uint64_t cpu_ns) {
+    gProcessCpuNs += cpu_ns;
+    governor->AddCompilationTime(Thread::Current(), cpu_ns);
+  }
+
+  static std::string Dump(JitCompilationGovernor* governor) {
+    std::ostringstream oss;
+    governor->Dump(oss);
+    return oss.str();
+  }
+};
+
+TEST_F(JitCompilationGovernorTest, Disabled) {
+  Thread* self = Thread::Current();
+  JitCompilationGovernor governor(
+      /*budget_percent=*/ 0u, kWindowNs, kNumberOfCpus, FakeClock, FakeProcessCpuClock);
+  EXPECT_FALSE(governor.IsEnabled());
+
+  Advance(kWindowNs, /*load_percent=*/ 100);
+  Compile(&governor, kWindowNs);
+  Advance(kWindowNs, /*load_percent=*/ 100);
+  Compile(&governor, kWindowNs);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+  EXPECT_EQ("", Dump(&governor));
+}
+
+TEST_F(JitCompilationGovernorTest, DeferOnlyWhenSaturatedAndExhausted) {
+  Thread* self = Thread::Current();
+  JitCompilationGovernor governor(
+      kBudgetPercent, kWindowNs, kNumberOfCpus, FakeClock, FakeProcessCpuClock);
+  ASSERT_TRUE(governor.IsEnabled());
+
+  // First window: the process is idle, so spending over the budget defers nothing.
+  Advance(kWindowNs / 2, /*load_percent=*/ 10);
+  Compile(&governor, 2 * kBudgetNs);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kBaseline));
+
+  // Second window: the first one was idle, so the budget still does not apply.
+  // Saturate the process, the compilation time itself does not count as load.
+  Advance(kWindowNs / 2, /*load_percent=*/ 10);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+  Advance(kWindowNs / 2, /*load_percent=*/ 95);
+  Compile(&governor, 2 * kBudgetNs);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+
+  // Third window: the process was saturated. Compilation is allowed until the budget is spent.
+  Advance(kWindowNs / 2, /*load_percent=*/ 95);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+  Compile(&governor, kBudgetNs - 1);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+  Compile(&governor, 1);
+  EXPECT_TRUE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+  EXPECT_TRUE(governor.ShouldDefer(self, CompilationKind::kBaseline));
+  // OSR requests are never deferred.
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOsr));
+  // Still deferring until the window elapses.
+  Advance(kWindowNs - 1, /*load_percent=*/ 95);
+  EXPECT_TRUE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+
+  // Fourth window: the process stayed saturated, so the budget applies again,
+  // but it is fresh and compilation resumes.
+  Advance(1, /*load_percent=*/ 95);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+  Compile(&governor, kBudgetNs);
+  EXPECT_TRUE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+
+  // Fifth window: the load dropped, compilation resumes even with the budget spent.
+  Advance(kWindowNs, /*load_percent=*/ 50);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+  Compile(&governor, 2 * kBudgetNs);
+  EXPECT_FALSE(governor.ShouldDefer(self, CompilationKind::kOptimized));
+
+  std::string dump = Dump(&governor);
+  EXPECT_NE(std::string::npos, dump.find("Saturated windows=2\n")) << dump;
+  EXPECT_NE(std::string::npos, dump.find("Budget exhausted windows=4\n")) << dump;
+  EXPECT_NE(std::string::npos, dump.find("Deferred compilations=4\n")) << dump;
+}
+
+}  // namespace jit
+}  // namespace art
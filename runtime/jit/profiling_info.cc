@@ -16,40 +16,81 @@
 
 #include "profiling_info.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
 #include "dex/dex_instruction.h"
 #include "jit/jit.h"
 #include "jit/jit_code_cache.h"
+#include "mirror/dex_cache-inl.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
 
 namespace art {
 
-ProfilingInfo::ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries)
+ProfilingInfo::ProfilingInfo(ArtMethod* method,
+                             const std::vector<uint32_t>& entries,
+                             uint32_t number_of_skipped_inline_caches,
+                             const std::vector<uint32_t>& loop_headers)
       : baseline_hotness_count_(GetOptimizeThreshold()),
         method_(method),
         number_of_inline_caches_(entries.size()),
-        current_inline_uses_(0) {
+        number_of_loops_(loop_headers.size()),
+        current_inline_uses_(0),
+        number_of_skipped_inline_caches_(std::min<uint32_t>(
+            number_of_skipped_inline_caches, std::numeric_limits<uint16_t>::max())) {
   memset(&cache_, 0, number_of_inline_caches_ * sizeof(InlineCache));
   for (size_t i = 0; i < number_of_inline_caches_; ++i) {
+    DCHECK(i == 0 || entries[i - 1] < entries[i]);
     cache_[i].dex_pc_ = entries[i];
   }
+  LoopCounter* loops = GetLoopCounters();
+  for (size_t i = 0; i < number_of_loops_; ++i) {
+    DCHECK(i == 0 || loop_headers[i - 1] < loop_headers[i]);
+    loops[i].dex_pc_ = loop_headers[i];
+    loops[i].count_ = 0u;
+  }
 }
 
 uint16_t ProfilingInfo::GetOptimizeThreshold() {
   return Runtime::Current()->GetJITOptions()->GetOptimizeThreshold();
 }
 
-ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
+bool ProfilingInfo::IsMonomorphicCallSite(ArtMethod* method, uint32_t method_idx) {
+  // Only look at the dex cache: we do not want to resolve methods here, and
+  // call sites that have been executed by the interpreter are resolved already.
+  ArtMethod* resolved_method = method->GetDexCache()->GetResolvedMethod(method_idx);
+  if (resolved_method == nullptr) {
+    return false;
+  }
+  // A final method, or a method of a final class, is the only possible target
+  // of the call, so the compiler can devirtualize it without an inline cache.
+  return resolved_method->IsFinal() ||
+      resolved_method->IsPrivate() ||
+      resolved_method->GetDeclaringClass()->IsFinal();
+}
+
+ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method, bool retry_allocation) {
   // Walk over the dex instructions of the method and keep track of
   // instructions we are interested in profiling.
   DCHECK(!method->IsNative());
 
   std::vector<uint32_t> entries;
+  uint32_t number_of_skipped_inline_caches = 0u;
+  std::vector<uint32_t> loop_headers;
   for (const DexInstructionPcPair& inst : method->DexInstructions()) {
+    if (inst->IsBranch() && inst->GetTargetOffset() <= 0) {
+      // The target of a back edge is a loop header.
+      loop_headers.push_back(inst.DexPc() + inst->GetTargetOffset());
+    }
     switch (inst->Opcode()) {
       case Instruction::INVOKE_VIRTUAL:
       case Instruction::INVOKE_VIRTUAL_RANGE:
+        if (IsMonomorphicCallSite(method, inst->VRegB())) {
+          ++number_of_skipped_inline_caches;
+          break;
+        }
+        FALLTHROUGH_INTENDED;
       case Instruction::INVOKE_INTERFACE:
       case Instruction::INVOKE_INTERFACE_RANGE:
         entries.push_back(inst.DexPc());
@@ -63,25 +104,60 @@ ProfilingInfo* ProfilingInfo::Create(Thread* self, ArtMethod* method) {
   // We always create a `ProfilingInfo` object, even if there is no instruction we are
   // interested in. The JIT code cache internally uses it.
 
+  std::sort(loop_headers.begin(), loop_headers.end());
+  loop_headers.erase(std::unique(loop_headers.begin(), loop_headers.end()), loop_headers.end());
+
   // Allocate the `ProfilingInfo` object int the JIT's data space.
   jit::JitCodeCache* code_cache = Runtime::Current()->GetJit()->GetCodeCache();
-  return code_cache->AddProfilingInfo(self, method, entries);
+  return code_cache->AddProfilingInfo(
+      self, method, entries, number_of_skipped_inline_caches, loop_headers, retry_allocation);
 }
 
 InlineCache* ProfilingInfo::GetInlineCache(uint32_t dex_pc) {
-  // TODO: binary search if array is too long.
-  for (size_t i = 0; i < number_of_inline_caches_; ++i) {
-    if (cache_[i].dex_pc_ == dex_pc) {
-      return &cache_[i];
-    }
+  // Inline caches are sorted by dex pc, see ProfilingInfo::Create.
+  InlineCache* end = cache_ + number_of_inline_caches_;
+  InlineCache* it = std::lower_bound(
+      cache_, end, dex_pc, [](const InlineCache& cache, uint32_t pc) {
+        return cache.dex_pc_ < pc;
+      });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
+LoopCounter* ProfilingInfo::GetLoopCounter(uint32_t dex_pc) {
+  LoopCounter* begin = GetLoopCounters();
+  LoopCounter* end = begin + number_of_loops_;
+  LoopCounter* it = std::lower_bound(
+      begin, end, dex_pc, [](const LoopCounter& counter, uint32_t pc) {
+        return counter.dex_pc_ < pc;
+      });
+  return (it != end && it->dex_pc_ == dex_pc) ? it : nullptr;
+}
+
+uint32_t ProfilingInfo::IncrementLoopCount(uint32_t dex_pc) {
+  LoopCounter* counter = GetLoopCounter(dex_pc);
+  if (counter == nullptr) {
+    return 0u;
+  }
+  // Racy update, like the other hotness counters.
+  if (counter->count_ != std::numeric_limits<uint32_t>::max()) {
+    ++counter->count_;
+  }
+  return counter->count_;
+}
+
+void ProfilingInfo::ResetLoopCount(uint32_t dex_pc) {
+  LoopCounter* counter = GetLoopCounter(dex_pc);
+  if (counter != nullptr) {
+    counter->count_ = 0u;
   }
-  ScopedObjectAccess soa(Thread::Current());
-  LOG(FATAL) << "No inline cache found for "  << ArtMethod::PrettyMethod(method_) << "@" << dex_pc;
-  UNREACHABLE();
 }
 
 void ProfilingInfo::AddInvokeInfo(uint32_t dex_pc, mirror::Class* cls) {
   InlineCache* cache = GetInlineCache(dex_pc);
+  if (cache == nullptr) {
+    // No inline cache for call sites that cannot be polymorphic.
+    return;
+  }
   for (size_t i = 0; i < InlineCache::kIndividualCacheSize; ++i) {
     mirror::Class* existing = cache->classes_[i].Read<kWithoutReadBarrier>();
     mirror::Class* marked = ReadBarrier::IsMarked(existing);
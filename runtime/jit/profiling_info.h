@@ -41,6 +41,10 @@ class Class;
 
 // Structure to store the classes seen at runtime for a specific instruction.
 // Once the classes_ array is full, we consider the INVOKE to be megamorphic.
+//
+// The slots are allocated with the ProfilingInfo, for every call site that may be polymorphic:
+// baseline code passes the address of the cache to art_quick_update_inline_cache, which fills
+// the fixed array. Call sites that can only have one target get no cache at all.
 class InlineCache {
  public:
   // This is hard coded in the assembly stub art_quick_update_inline_cache.
@@ -60,14 +64,27 @@ class InlineCache {
   DISALLOW_COPY_AND_ASSIGN(InlineCache);
 };
 
+// Number of times the hotness counter of a method ran out on back edges to a
+// given loop header, while the method was executed by nterp.
+class LoopCounter {
+ private:
+  uint32_t dex_pc_;
+  uint32_t count_;
+
+  friend class ProfilingInfo;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopCounter);
+};
+
 /**
  * Profiling info for a method, created and filled by the interpreter once the
  * method is warm, and used by the compiler to drive optimizations.
  */
 class ProfilingInfo {
  public:
-  // Create a ProfilingInfo for 'method'.
-  static ProfilingInfo* Create(Thread* self, ArtMethod* method)
+  // Create a ProfilingInfo for 'method'. If `retry_allocation` is false, the code cache is not
+  // collected to make room, for callers that cannot suspend.
+  static ProfilingInfo* Create(Thread* self, ArtMethod* method, bool retry_allocation)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Add information from an executed INVOKE instruction to the profile.
@@ -81,8 +98,38 @@ class ProfilingInfo {
     return method_;
   }
 
+  // Returns the inline cache of the INVOKE at `dex_pc`, or null if the
+  // call site cannot be polymorphic and has no inline cache.
   InlineCache* GetInlineCache(uint32_t dex_pc);
 
+  size_t GetNumberOfInlineCaches() const {
+    return number_of_inline_caches_;
+  }
+
+  // Number of virtual call sites that have a single possible target, and no inline cache.
+  size_t GetNumberOfSkippedInlineCaches() const {
+    return number_of_skipped_inline_caches_;
+  }
+
+  size_t GetNumberOfLoops() const {
+    return number_of_loops_;
+  }
+
+  // Record that the hotness counter of the method ran out on a back edge to
+  // the loop header at `dex_pc`. Returns how many times it did for that loop,
+  // or 0 if `dex_pc` is not a loop header.
+  uint32_t IncrementLoopCount(uint32_t dex_pc);
+
+  void ResetLoopCount(uint32_t dex_pc);
+
+  // Size of a ProfilingInfo holding `number_of_inline_caches` inline caches
+  // and `number_of_loops` loop counters.
+  static size_t ComputeSize(size_t number_of_inline_caches, size_t number_of_loops) {
+    return sizeof(ProfilingInfo) +
+        sizeof(InlineCache) * number_of_inline_caches +
+        sizeof(LoopCounter) * number_of_loops;
+  }
+
   // Increments the number of times this method is currently being inlined.
   // Returns whether it was successful, that is it could increment without
   // overflowing.
@@ -120,10 +167,24 @@ class ProfilingInfo {
   }
 
  private:
-  ProfilingInfo(ArtMethod* method, const std::vector<uint32_t>& entries);
+  ProfilingInfo(ArtMethod* method,
+                const std::vector<uint32_t>& entries,
+                uint32_t number_of_skipped_inline_caches,
+                const std::vector<uint32_t>& loop_headers);
 
   static uint16_t GetOptimizeThreshold();
 
+  // Returns whether the virtual call to `method_idx` in `method` has a single
+  // possible target, in which case we do not allocate an inline cache for it.
+  static bool IsMonomorphicCallSite(ArtMethod* method, uint32_t method_idx)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  LoopCounter* GetLoopCounters() {
+    return reinterpret_cast<LoopCounter*>(cache_ + number_of_inline_caches_);
+  }
+
+  LoopCounter* GetLoopCounter(uint32_t dex_pc);
+
   // Hotness count for methods compiled with the JIT baseline compiler. Once
   // a threshold is hit (currentily the maximum value of uint16_t), we will
   // JIT compile optimized the method.
@@ -137,11 +198,18 @@ class ProfilingInfo {
   // Number of instructions we are profiling in the ArtMethod.
   const uint32_t number_of_inline_caches_;
 
+  // Number of loop headers in the ArtMethod.
+  const uint32_t number_of_loops_;
+
   // When the compiler inlines the method associated to this ProfilingInfo,
   // it updates this counter so that the GC does not try to clear the inline caches.
   uint16_t current_inline_uses_;
 
-  // Dynamically allocated array of size `number_of_inline_caches_`.
+  // Saturated at the maximum of uint16_t, it is only reported by JitCodeCache::Dump.
+  const uint16_t number_of_skipped_inline_caches_;
+
+  // Dynamically allocated array of size `number_of_inline_caches_`, followed
+  // by an array of `number_of_loops_` LoopCounters.
   InlineCache cache_[0];
 
   friend class jit::JitCodeCache;
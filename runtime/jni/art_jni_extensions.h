@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JNI_ART_JNI_EXTENSIONS_H_
+#define ART_RUNTIME_JNI_ART_JNI_EXTENSIONS_H_
+
+#include <jni.h>
+
+/*
+ * ART specific JNI extensions, returned by `JavaVM::GetEnv()` for the version
+ * ART_JNI_EXTENSIONS_VERSION. Runtimes without these extensions return JNI_EVERSION.
+ *
+ *   const ArtJniExtensions* ext;
+ *   if (vm->GetEnv(reinterpret_cast<void**>(&ext), ART_JNI_EXTENSIONS_VERSION) == JNI_OK) ...
+ *
+ * The critical views give direct read-only access to the contents of strings and primitive
+ * arrays, without copying or converting them. Like GetStringCritical() and
+ * GetPrimitiveArrayCritical(), a view must be released with the matching release function,
+ * and the calling thread must not make JNI calls or block while it holds a view. Writing
+ * through a view is undefined behavior.
+ */
+#define ART_JNI_EXTENSIONS_VERSION (JNI_VERSION_1_6 | 0x40000000)
+
+typedef struct ArtJniExtensions {
+  /*
+   * Returns a view of the characters of `string` and sets `*length` to its number of
+   * characters. If `*is_latin1` is set to JNI_TRUE, the view holds one byte per character.
+   * ART only stores strings of ASCII characters U+0001 to U+007F that way, so the bytes are
+   * also valid Modified UTF-8, but not null-terminated. Otherwise the view holds
+   * UTF-16 characters. Returns null if `string` is null.
+   */
+  const void* (*GetStringCriticalView)(JNIEnv* env,
+                                       jstring string,
+                                       jsize* length,
+                                       jboolean* is_latin1);
+  void (*ReleaseStringCriticalView)(JNIEnv* env, jstring string, const void* view);
+
+  /*
+   * Returns a view of the elements of the primitive array `array` and sets `*length` to its
+   * number of elements. Unlike GetPrimitiveArrayCritical(), the elements are never copied,
+   * not even with -Xjniopts:forcecopy. Returns null if `array` is null.
+   */
+  const void* (*GetPrimitiveArrayCriticalView)(JNIEnv* env, jarray array, jsize* length);
+  void (*ReleasePrimitiveArrayCriticalView)(JNIEnv* env, jarray array, const void* view);
+
+  /*
+   * Returns a mark of the local references of the current thread, without entering the
+   * runtime. ReleaseLocalRefsToMark() then deletes all the local references created since
+   * the mark was taken in a single call, like PopLocalFrame() but without the need for a
+   * PushLocalFrame() call. The mark must have been taken in the current native method, and
+   * after its last PushLocalFrame(), if any.
+   *
+   * A mark is the top of the local reference table. New local references reuse the slots
+   * freed by DeleteLocalRef() first, so the mark only covers them if no local reference
+   * created before the mark was deleted, before or after the mark was taken. Otherwise,
+   * ReleaseLocalRefsToMark() may keep some of the references created since the mark, or
+   * abort if the table shrank below the mark. Use PushLocalFrame() and PopLocalFrame() in
+   * native methods that delete local references individually.
+   */
+  jint (*GetLocalRefMark)(JNIEnv* env);
+  void (*ReleaseLocalRefsToMark)(JNIEnv* env, jint mark);
+
+  /*
+   * Stores local references to the `length` elements of `array` starting at `start` into
+   * `buf`, as `length` GetObjectArrayElement() calls would. Throws
+   * ArrayIndexOutOfBoundsException if the region is out of bounds.
+   */
+  void (*GetObjectArrayRegion)(JNIEnv* env,
+                               jobjectArray array,
+                               jsize start,
+                               jsize length,
+                               jobject* buf);
+
+  /*
+   * Stores the value of the instance field `field` of each of the `count` objects of
+   * `objects` into the member of `values` that matches the type of the field. Object values
+   * are returned as local references. Throws NullPointerException, and stops, at the first
+   * null object. Like CheckJNI for Get<Type>Field(), aborts if `field` is static or if an
+   * object is not an instance of the class declaring it.
+   */
+  void (*GetFieldOfObjects)(JNIEnv* env,
+                            jfieldID field,
+                            jsize count,
+                            const jobject* objects,
+                            jvalue* values);
+} ArtJniExtensions;
+
+#endif  // ART_RUNTIME_JNI_ART_JNI_EXTENSIONS_H_
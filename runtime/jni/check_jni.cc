@@ -54,13 +54,16 @@ namespace art {
 
 // This helper cannot be in the anonymous namespace because it needs to be
 // declared as a friend by JniVmExt and JniEnvExt.
+// The table of global references depends on `ref`, see JavaVMExt::GetGlobalsShard.
 inline IndirectReferenceTable* GetIndirectReferenceTable(ScopedObjectAccess& soa,
-                                                         IndirectRefKind kind) {
+                                                         IndirectRefKind kind,
+                                                         IndirectRef ref) {
   DCHECK_NE(kind, kJniTransitionOrInvalid);
   JNIEnvExt* env = soa.Env();
   IndirectReferenceTable* irt =
       (kind == kLocal) ? &env->locals_
-                       : ((kind == kGlobal) ? &env->vm_->globals_ : &env->vm_->weak_globals_);
+                       : ((kind == kGlobal) ? &env->vm_->GetGlobalsShard(ref)->table
+                                            : &env->vm_->weak_globals_);
   DCHECK_EQ(irt->GetKind(), kind);
   return irt;
 }
@@ -874,7 +877,7 @@ class ScopedCheck {
         obj = soa.Decode<mirror::Object>(java_object);
       }
     } else {
-      IndirectReferenceTable* irt = GetIndirectReferenceTable(soa, ref_kind);
+      IndirectReferenceTable* irt = GetIndirectReferenceTable(soa, ref_kind, ref);
       okay = irt->IsValidReference(java_object, &error_msg);
       DCHECK_EQ(okay, error_msg.empty());
       if (okay) {
@@ -17,6 +17,8 @@
 #include "java_vm_ext.h"
 
 #include <dlfcn.h>
+
+#include <algorithm>
 #include <string_view>
 
 #include "android-base/stringprintf.h"
@@ -498,7 +500,6 @@ JavaVMExt::JavaVMExt(Runtime* runtime,
       tracing_enabled_(runtime_options.Exists(RuntimeArgumentMap::JniTrace)
                        || VLOG_IS_ON(third_party_jni)),
       trace_(runtime_options.GetOrDefault(RuntimeArgumentMap::JniTrace)),
-      globals_(kGlobalsMax, kGlobal, IndirectReferenceTable::ResizableCapacity::kNo, error_msg),
       libraries_(new Libraries),
       unchecked_functions_(&gJniInvokeInterface),
       weak_globals_(kWeakGlobalsMax,
@@ -517,6 +518,37 @@ JavaVMExt::JavaVMExt(Runtime* runtime,
       old_allocation_tracking_state_(false) {
   functions = unchecked_functions_;
   SetCheckJniEnabled(runtime_options.Exists(RuntimeArgumentMap::CheckJni));
+  for (size_t i = 0; i != kGlobalsShards; ++i) {
+    // Index ranges are kGlobalsMax apart, which is more than the capacity of any shard.
+    globals_[i].reset(new GlobalsShard(kGlobalsMax / kGlobalsShards, i * kGlobalsMax, error_msg));
+  }
+}
+
+JavaVMExt::GlobalsShard::GlobalsShard(size_t max_count,
+                                      uint32_t index_base,
+                                      std::string* error_msg)
+    : lock("JNI global reference table lock", kJniGlobalsLock),
+      table(max_count,
+            kGlobal,
+            IndirectReferenceTable::ResizableCapacity::kNo,
+            error_msg,
+            index_base),
+      report_counter(kGlobalRefReportInterval) {}
+
+JavaVMExt::GlobalsShard* JavaVMExt::GetGlobalsShard(IndirectRef ref) const {
+  // Invalid references map to the last shard, whose table rejects them.
+  size_t index = IndirectReferenceTable::GetEncodedIndex(ref) / kGlobalsMax;
+  return globals_[std::min(index, kGlobalsShards - 1u)].get();
+}
+
+size_t JavaVMExt::GlobalsFreeCapacity() const {
+  // Rounding the capacity of each shard up to whole pages leaves a few more entries in
+  // total than kGlobalsMax. Only count kGlobalsMax, as a single table would have.
+  size_t used = 0u;
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    used += shard->table.Capacity();
+  }
+  return kGlobalsMax - std::min(used, kGlobalsMax);
 }
 
 JavaVMExt::~JavaVMExt() {
@@ -530,10 +562,15 @@ std::unique_ptr<JavaVMExt> JavaVMExt::Create(Runtime* runtime,
                                              const RuntimeArgumentMap& runtime_options,
                                              std::string* error_msg) NO_THREAD_SAFETY_ANALYSIS {
   std::unique_ptr<JavaVMExt> java_vm(new JavaVMExt(runtime, runtime_options, error_msg));
-  if (java_vm && java_vm->globals_.IsValid() && java_vm->weak_globals_.IsValid()) {
-    return java_vm;
+  if (java_vm == nullptr || !java_vm->weak_globals_.IsValid()) {
+    return nullptr;
   }
-  return nullptr;
+  for (const std::unique_ptr<GlobalsShard>& shard : java_vm->globals_) {
+    if (shard == nullptr || !shard->table.IsValid()) {
+      return nullptr;
+    }
+  }
+  return java_vm;
 }
 
 jint JavaVMExt::HandleGetEnv(/*out*/void** env, jint version) {
@@ -638,7 +675,7 @@ void JavaVMExt::CheckGlobalRefAllocationTracking() {
   if (LIKELY(enable_allocation_tracking_delta_ == 0)) {
     return;
   }
-  size_t simple_free_capacity = globals_.FreeCapacity();
+  size_t simple_free_capacity = GlobalsFreeCapacity();
   if (UNLIKELY(simple_free_capacity <= enable_allocation_tracking_delta_)) {
     if (!allocation_tracking_enabled_) {
       LOG(WARNING) << "Global reference storage appears close to exhaustion, program termination "
@@ -667,10 +704,17 @@ void JavaVMExt::CheckGlobalRefAllocationTracking() {
   }
 }
 
-void JavaVMExt::MaybeTraceGlobals() {
-  if (global_ref_report_counter_++ == kGlobalRefReportInterval) {
-    global_ref_report_counter_ = 1;
-    ATraceIntegerValue("JNI Global Refs", globals_.NEntriesForGlobal());
+void JavaVMExt::MaybeTraceGlobals(GlobalsShard* shard) {
+  if (shard->report_counter++ == kGlobalRefReportInterval) {
+    shard->report_counter = 1;
+    if (ATraceEnabled()) {
+      // Racy read of the other shards, this is only a trace counter.
+      int32_t count = 0;
+      for (const std::unique_ptr<GlobalsShard>& other : globals_) {
+        count += other->table.NEntriesForGlobal();
+      }
+      ATraceIntegerValue("JNI Global Refs", count);
+    }
   }
 }
 
@@ -686,12 +730,27 @@ jobject JavaVMExt::AddGlobalRef(Thread* self, ObjPtr<mirror::Object> obj) {
   if (obj == nullptr) {
     return nullptr;
   }
-  IndirectRef ref;
+  IndirectRef ref = nullptr;
   std::string error_msg;
-  {
-    WriterMutexLock mu(self, *Locks::jni_globals_lock_);
-    ref = globals_.Add(kIRTFirstSegment, obj, &error_msg);
-    MaybeTraceGlobals();
+  size_t first_shard = self->GetThreadId() % kGlobalsShards;
+  // Move on to the next shard only when the table of this one is full, holes included. Full
+  // shards are skipped without formatting the overflow error, which dumps the table.
+  for (size_t i = 0; i != kGlobalsShards && ref == nullptr; ++i) {
+    GlobalsShard* shard = globals_[(first_shard + i) % kGlobalsShards].get();
+    MutexLock mu(self, shard->lock);
+    ref = shard->table.Add(kIRTFirstSegment, obj, /*error_msg=*/ nullptr);
+    if (ref != nullptr) {
+      MaybeTraceGlobals(shard);
+    }
+  }
+  if (UNLIKELY(ref == nullptr)) {
+    // All the shards are full. Try the first one again for the error, it may have room by now.
+    GlobalsShard* shard = globals_[first_shard].get();
+    MutexLock mu(self, shard->lock);
+    ref = shard->table.Add(kIRTFirstSegment, obj, &error_msg);
+    if (ref != nullptr) {
+      MaybeTraceGlobals(shard);
+    }
   }
   if (UNLIKELY(ref == nullptr)) {
     LOG(FATAL) << error_msg;
@@ -740,12 +799,13 @@ void JavaVMExt::DeleteGlobalRef(Thread* self, jobject obj) {
     return;
   }
   {
-    WriterMutexLock mu(self, *Locks::jni_globals_lock_);
-    if (!globals_.Remove(kIRTFirstSegment, obj)) {
+    GlobalsShard* shard = GetGlobalsShard(obj);
+    MutexLock mu(self, shard->lock);
+    if (!shard->table.Remove(kIRTFirstSegment, obj)) {
       LOG(WARNING) << "JNI WARNING: DeleteGlobalRef(" << obj << ") "
                    << "failed to find entry";
     }
-    MaybeTraceGlobals();
+    MaybeTraceGlobals(shard);
   }
   CheckGlobalRefAllocationTracking();
 }
@@ -782,10 +842,12 @@ void JavaVMExt::DumpForSigQuit(std::ostream& os) {
     os << " (with forcecopy)";
   }
   Thread* self = Thread::Current();
-  {
-    ReaderMutexLock mu(self, *Locks::jni_globals_lock_);
-    os << "; globals=" << globals_.Capacity();
+  size_t globals = 0u;
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    MutexLock mu(self, shard->lock);
+    globals += shard->table.Capacity();
   }
+  os << "; globals=" << globals;
   {
     MutexLock mu(self, *Locks::jni_weak_globals_lock_);
     if (weak_globals_.Capacity() > 0) {
@@ -826,12 +888,13 @@ void JavaVMExt::BroadcastForNewWeakGlobals() {
 }
 
 ObjPtr<mirror::Object> JavaVMExt::DecodeGlobal(IndirectRef ref) {
-  return globals_.SynchronizedGet(ref);
+  return GetGlobalsShard(ref)->table.SynchronizedGet(ref);
 }
 
 void JavaVMExt::UpdateGlobal(Thread* self, IndirectRef ref, ObjPtr<mirror::Object> result) {
-  WriterMutexLock mu(self, *Locks::jni_globals_lock_);
-  globals_.Update(ref, result);
+  GlobalsShard* shard = GetGlobalsShard(ref);
+  MutexLock mu(self, shard->lock);
+  shard->table.Update(ref, result);
 }
 
 inline bool JavaVMExt::MayAccessWeakGlobals(Thread* self) const {
@@ -899,9 +962,9 @@ void JavaVMExt::UpdateWeakGlobal(Thread* self, IndirectRef ref, ObjPtr<mirror::O
 
 void JavaVMExt::DumpReferenceTables(std::ostream& os) {
   Thread* self = Thread::Current();
-  {
-    ReaderMutexLock mu(self, *Locks::jni_globals_lock_);
-    globals_.Dump(os);
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    MutexLock mu(self, shard->lock);
+    shard->table.Dump(os);
   }
   {
     MutexLock mu(self, *Locks::jni_weak_globals_lock_);
@@ -1194,14 +1257,19 @@ void JavaVMExt::SweepJniWeakGlobals(IsMarkedVisitor* visitor) {
 }
 
 void JavaVMExt::TrimGlobals() {
-  WriterMutexLock mu(Thread::Current(), *Locks::jni_globals_lock_);
-  globals_.Trim();
+  Thread* self = Thread::Current();
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    MutexLock mu(self, shard->lock);
+    shard->table.Trim();
+  }
 }
 
 void JavaVMExt::VisitRoots(RootVisitor* visitor) {
   Thread* self = Thread::Current();
-  ReaderMutexLock mu(self, *Locks::jni_globals_lock_);
-  globals_.VisitRoots(visitor, RootInfo(kRootJNIGlobal));
+  for (const std::unique_ptr<GlobalsShard>& shard : globals_) {
+    MutexLock mu(self, shard->lock);
+    shard->table.VisitRoots(visitor, RootInfo(kRootJNIGlobal));
+  }
   // The weak_globals table is visited by the GC itself (because it mutates the table).
 }
 
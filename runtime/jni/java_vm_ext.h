@@ -124,19 +124,16 @@ class JavaVMExt : public JavaVM {
 
   void DumpForSigQuit(std::ostream& os)
       REQUIRES(!Locks::jni_libraries_lock_,
-               !Locks::jni_globals_lock_,
                !Locks::jni_weak_globals_lock_);
 
   void DumpReferenceTables(std::ostream& os)
       REQUIRES_SHARED(Locks::mutator_lock_)
-      REQUIRES(!Locks::jni_globals_lock_,
-               !Locks::jni_weak_globals_lock_,
+      REQUIRES(!Locks::jni_weak_globals_lock_,
                !Locks::alloc_tracker_lock_);
 
   bool SetCheckJniEnabled(bool enabled);
 
-  void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_)
-      REQUIRES(!Locks::jni_globals_lock_);
+  void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
 
   void DisallowNewWeakGlobals()
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -148,14 +145,13 @@ class JavaVMExt : public JavaVM {
       REQUIRES(!Locks::jni_weak_globals_lock_);
 
   jobject AddGlobalRef(Thread* self, ObjPtr<mirror::Object> obj)
-      REQUIRES_SHARED(Locks::mutator_lock_)
-      REQUIRES(!Locks::jni_globals_lock_);
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   jweak AddWeakGlobalRef(Thread* self, ObjPtr<mirror::Object> obj)
       REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::jni_weak_globals_lock_);
 
-  void DeleteGlobalRef(Thread* self, jobject obj) REQUIRES(!Locks::jni_globals_lock_);
+  void DeleteGlobalRef(Thread* self, jobject obj);
 
   void DeleteWeakGlobalRef(Thread* self, jweak obj) REQUIRES(!Locks::jni_weak_globals_lock_);
 
@@ -167,8 +163,7 @@ class JavaVMExt : public JavaVM {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   void UpdateGlobal(Thread* self, IndirectRef ref, ObjPtr<mirror::Object> result)
-      REQUIRES_SHARED(Locks::mutator_lock_)
-      REQUIRES(!Locks::jni_globals_lock_);
+      REQUIRES_SHARED(Locks::mutator_lock_);
 
   ObjPtr<mirror::Object> DecodeWeakGlobal(Thread* self, IndirectRef ref)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -197,8 +192,7 @@ class JavaVMExt : public JavaVM {
     return unchecked_functions_;
   }
 
-  void TrimGlobals() REQUIRES_SHARED(Locks::mutator_lock_)
-      REQUIRES(!Locks::jni_globals_lock_);
+  void TrimGlobals() REQUIRES_SHARED(Locks::mutator_lock_);
 
   jint HandleGetEnv(/*out*/void** env, jint version)
       REQUIRES(!env_hooks_lock_);
@@ -214,10 +208,32 @@ class JavaVMExt : public JavaVM {
   static jstring GetLibrarySearchPath(JNIEnv* env, jobject class_loader);
 
  private:
+  // Global references are spread over a few tables, each with its own lock, so that threads
+  // creating and deleting global references concurrently do not serialize on a single lock.
+  // A thread adds to the table picked by its thread id, and only falls back to the other
+  // tables when its own is full. Each table hands out references in a distinct index range,
+  // so the table of a reference is known without locking.
+  static constexpr size_t kGlobalsShards = 8;
+
+  struct GlobalsShard {
+    GlobalsShard(size_t max_count, uint32_t index_base, std::string* error_msg);
+
+    Mutex lock;
+    // Not guarded by lock since we sometimes use SynchronizedGet in Thread::DecodeJObject.
+    IndirectReferenceTable table;
+    uint32_t report_counter GUARDED_BY(lock);
+  };
+
   // The constructor should not be called directly. It may leave the object in
   // an erroneous state, and the result needs to be checked.
   JavaVMExt(Runtime* runtime, const RuntimeArgumentMap& runtime_options, std::string* error_msg);
 
+  // Return the shard whose table holds the global reference `ref`.
+  GlobalsShard* GetGlobalsShard(IndirectRef ref) const;
+
+  // Return the number of global references that can still be added, ignoring holes.
+  size_t GlobalsFreeCapacity() const;
+
   // Return true if self can currently access weak globals.
   bool MayAccessWeakGlobalsUnlocked(Thread* self) const REQUIRES_SHARED(Locks::mutator_lock_);
   bool MayAccessWeakGlobals(Thread* self) const
@@ -230,7 +246,7 @@ class JavaVMExt : public JavaVM {
 
   void CheckGlobalRefAllocationTracking();
 
-  inline void MaybeTraceGlobals() REQUIRES(Locks::jni_globals_lock_);
+  inline void MaybeTraceGlobals(GlobalsShard* shard) REQUIRES(shard->lock);
   inline void MaybeTraceWeakGlobals() REQUIRES(Locks::jni_weak_globals_lock_);
 
   Runtime* const runtime_;
@@ -247,8 +263,7 @@ class JavaVMExt : public JavaVM {
   // Extra diagnostics.
   const std::string trace_;
 
-  // Not guarded by globals_lock since we sometimes use SynchronizedGet in Thread::DecodeJObject.
-  IndirectReferenceTable globals_;
+  std::unique_ptr<GlobalsShard> globals_[kGlobalsShards];
 
   // No lock annotation since UnloadNativeLibraries is called on libraries_ but locks the
   // jni_libraries_lock_ internally.
@@ -278,12 +293,10 @@ class JavaVMExt : public JavaVM {
   static constexpr uint32_t kGlobalRefReportInterval = 17;
   uint32_t weak_global_ref_report_counter_ GUARDED_BY(Locks::jni_weak_globals_lock_)
       = kGlobalRefReportInterval;
-  uint32_t global_ref_report_counter_ GUARDED_BY(Locks::jni_globals_lock_)
-      = kGlobalRefReportInterval;
-
 
   friend IndirectReferenceTable* GetIndirectReferenceTable(ScopedObjectAccess& soa,
-                                                           IndirectRefKind kind);
+                                                           IndirectRefKind kind,
+                                                           IndirectRef ref);
 
   DISALLOW_COPY_AND_ASSIGN(JavaVMExt);
 };
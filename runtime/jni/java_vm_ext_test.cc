@@ -140,6 +140,47 @@ TEST_F(JavaVmExtTest, DetachCurrentThread) {
   EXPECT_EQ(JNI_ERR, err);
 }
 
+static void* global_ref_churn_callback(void* arg) {
+  JavaVM* vm = reinterpret_cast<JavaVM*>(arg);
+  JNIEnv* env;
+  jint ok = vm->AttachCurrentThread(&env, nullptr);
+  EXPECT_EQ(JNI_OK, ok);
+  if (ok == JNI_OK) {
+    static constexpr size_t kRefsPerRound = 64;
+    jobject local_ref = env->NewStringUTF("Hello");
+    jobject global_refs[kRefsPerRound];
+    for (size_t round = 0; round != 100; ++round) {
+      for (size_t i = 0; i != kRefsPerRound; ++i) {
+        global_refs[i] = env->NewGlobalRef(local_ref);
+      }
+      for (size_t i = 0; i != kRefsPerRound; ++i) {
+        EXPECT_EQ(JNIGlobalRefType, env->GetObjectRefType(global_refs[i]));
+        EXPECT_TRUE(env->IsSameObject(local_ref, global_refs[i]));
+        env->DeleteGlobalRef(global_refs[i]);
+      }
+    }
+    env->DeleteLocalRef(local_ref);
+    ok = vm->DetachCurrentThread();
+    EXPECT_EQ(JNI_OK, ok);
+  }
+  return nullptr;
+}
+
+TEST_F(JavaVmExtTest, GlobalRefsFromManyThreads) {
+  static constexpr size_t kNumThreads = 8;
+  const char* reason = __PRETTY_FUNCTION__;
+  pthread_t pthreads[kNumThreads];
+  for (pthread_t& pthread : pthreads) {
+    CHECK_PTHREAD_CALL(pthread_create, (&pthread, nullptr, global_ref_churn_callback,
+        static_cast<JavaVM*>(vm_)), reason);
+  }
+  for (pthread_t& pthread : pthreads) {
+    void* ret_val;
+    CHECK_PTHREAD_CALL(pthread_join, (pthread, &ret_val), reason);
+    EXPECT_EQ(ret_val, nullptr);
+  }
+}
+
 class JavaVmExtStackTraceTest : public JavaVmExtTest {
  protected:
   void SetUpRuntimeOptions(RuntimeOptions* options) override {
@@ -80,6 +80,7 @@ JNIEnvExt::JNIEnvExt(Thread* self_in, JavaVMExt* vm_in, std::string* error_msg)
       locals_(1, kLocal, IndirectReferenceTable::ResizableCapacity::kYes, error_msg),
       monitors_("monitors", kMonitorsInitial, kMonitorsMax),
       critical_(0),
+      promoted_call_depth_(0),
       check_jni_(false),
       runtime_deleted_(false) {
   MutexLock mu(Thread::Current(), *Locks::jni_function_table_lock_);
@@ -142,6 +143,15 @@ void JNIEnvExt::PopFrame() {
   stacked_local_ref_cookies_.pop_back();
 }
 
+bool JNIEnvExt::ReleaseLocalsToMark(IRTSegmentState mark) {
+  if (mark.top_index < local_ref_cookie_.top_index ||
+      mark.top_index > locals_.GetSegmentState().top_index) {
+    return false;
+  }
+  locals_.Truncate(local_ref_cookie_, mark);
+  return true;
+}
+
 // Note: the offset code is brittle, as we can't use OFFSETOF_MEMBER or offsetof easily. Thus, there
 //       are tests in jni_internal_test to match the results against the actual values.
 
@@ -58,6 +58,17 @@ class JNIEnvExt : public JNIEnv {
   void PushFrame(int capacity) REQUIRES_SHARED(Locks::mutator_lock_);
   void PopFrame() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Returns the current top of the local reference table, to release the references added
+  // after it with ReleaseLocalsToMark. Only the owning thread moves the top, so this does not
+  // need the mutator lock.
+  IRTSegmentState GetLocalsMark() const {
+    return locals_.GetSegmentState();
+  }
+  // Deletes all the local references added since `mark` was taken, like a PopFrame() without
+  // the matching PushFrame(). Returns false, and deletes nothing, if `mark` does not belong to
+  // the current frame.
+  bool ReleaseLocalsToMark(IRTSegmentState mark) REQUIRES_SHARED(Locks::mutator_lock_);
+
   template<typename T>
   T AddLocalReference(ObjPtr<mirror::Object> obj)
       REQUIRES_SHARED(Locks::mutator_lock_)
@@ -102,6 +113,10 @@ class JNIEnvExt : public JNIEnv {
   void SetCriticalStartUs(uint64_t new_critical_start_us) {
     critical_start_us_ = new_critical_start_us;
   }
+  uint32_t GetPromotedCallDepth() const { return promoted_call_depth_; }
+  void SetPromotedCallDepth(uint32_t new_depth) { promoted_call_depth_ = new_depth; }
+  uint64_t GetPromotedCallStartNs() const { return promoted_call_start_ns_; }
+  void SetPromotedCallStartNs(uint64_t new_start_ns) { promoted_call_start_ns_ = new_start_ns; }
   const JNINativeInterface* GetUncheckedFunctions() const {
     return unchecked_functions_;
   }
@@ -200,6 +215,11 @@ class JNIEnvExt : public JNIEnv {
   // How many nested "critical" JNI calls are we in? Used by CheckJNI to ensure that criticals are
   uint32_t critical_;
 
+  // Start time of the outermost call of a promoted @FastNative or @CriticalNative method, and
+  // the number of nested ones. Used by CheckJNI, see NativeMethodPromotions.
+  uint64_t promoted_call_start_ns_;
+  uint32_t promoted_call_depth_;
+
   // Frequently-accessed fields cached from JavaVM.
   bool check_jni_;
 
@@ -210,7 +230,8 @@ class JNIEnvExt : public JNIEnv {
   friend class ScopedJniEnvLocalRefState;
   friend class Thread;
   friend IndirectReferenceTable* GetIndirectReferenceTable(ScopedObjectAccess& soa,
-                                                           IndirectRefKind kind);
+                                                           IndirectRefKind kind,
+                                                           IndirectRef ref);
   friend void ThreadResetFunctionTable(Thread* thread, void* arg);
   ART_FRIEND_TEST(JniInternalTest, JNIEnvExtOffsets);
 };
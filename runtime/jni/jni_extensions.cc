@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni_extensions.h"
+
+#include "art_field-inl.h"
+#include "art_jni_extensions.h"
+#include "gc/heap.h"
+#include "java_vm_ext.h"
+#include "jni_env_ext.h"
+#include "jni_internal.h"
+#include "mirror/array-inl.h"
+#include "mirror/class-inl.h"
+#include "mirror/object_array-inl.h"
+#include "mirror/string-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-inl.h"
+
+namespace art {
+
+namespace {
+
+// Keep CheckJNI's count of critical regions, so that it reports JNI calls made while a view
+// is held, as for GetStringCritical() and GetPrimitiveArrayCritical().
+void EnterCriticalView(JNIEnvExt* env) {
+  if (env->IsCheckJniEnabled()) {
+    if (env->GetCritical() == 0u) {
+      env->SetCriticalStartUs(env->GetSelf()->GetCpuMicroTime());
+    }
+    env->SetCritical(env->GetCritical() + 1u);
+  }
+}
+
+void ExitCriticalView(JNIEnvExt* env, const char* function_name) {
+  if (env->IsCheckJniEnabled()) {
+    if (env->GetCritical() == 0u) {
+      env->GetVm()->JniAbortF(function_name, "called too many critical releases");
+      return;
+    }
+    env->SetCritical(env->GetCritical() - 1u);
+  }
+}
+
+// Keep the object of `java_object` from moving until UnpinObject, the same way as
+// GetPrimitiveArrayCritical() does, and return it.
+template <typename T>
+ObjPtr<T> PinObject(ScopedObjectAccess& soa, jobject java_object)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ObjPtr<T> obj = soa.Decode<T>(java_object);
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->IsMovableObject(obj)) {
+    if (!kUseReadBarrier) {
+      heap->IncrementDisableMovingGC(soa.Self());
+    } else {
+      // For the CC collector, we only need to wait for the thread flip rather than the whole GC
+      // to occur thanks to the to-space invariant.
+      heap->IncrementDisableThreadFlip(soa.Self());
+    }
+    // Re-decode in case the object moved since IncrementDisableGC waits for GC to complete.
+    obj = soa.Decode<T>(java_object);
+  }
+  return obj;
+}
+
+void UnpinObject(ScopedObjectAccess& soa, ObjPtr<mirror::Object> obj)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  if (heap->IsMovableObject(obj)) {
+    if (!kUseReadBarrier) {
+      heap->DecrementDisableMovingGC(soa.Self());
+    } else {
+      heap->DecrementDisableThreadFlip(soa.Self());
+    }
+  }
+}
+
+const void* GetStringCriticalView(JNIEnv* env,
+                                  jstring java_string,
+                                  jsize* length,
+                                  jboolean* is_latin1) {
+  if (java_string == nullptr) {
+    return nullptr;
+  }
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::String> s = PinObject<mirror::String>(soa, java_string);
+  EnterCriticalView(soa.Env());
+  *length = s->GetLength();
+  if (s->IsCompressed()) {
+    *is_latin1 = JNI_TRUE;
+    return s->GetValueCompressed();
+  }
+  *is_latin1 = JNI_FALSE;
+  return s->GetValue();
+}
+
+void ReleaseStringCriticalView(JNIEnv* env, jstring java_string, const void* view) {
+  if (java_string == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::String> s = soa.Decode<mirror::String>(java_string);
+  DCHECK(view == (s->IsCompressed() ? static_cast<const void*>(s->GetValueCompressed())
+                                    : static_cast<const void*>(s->GetValue())));
+  UNUSED(view);
+  ExitCriticalView(soa.Env(), "ReleaseStringCriticalView");
+  UnpinObject(soa, s);
+}
+
+const void* GetPrimitiveArrayCriticalView(JNIEnv* env, jarray java_array, jsize* length) {
+  if (java_array == nullptr) {
+    return nullptr;
+  }
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::Array> array = soa.Decode<mirror::Array>(java_array);
+  if (UNLIKELY(!array->GetClass()->IsPrimitiveArray())) {
+    soa.Vm()->JniAbortF("GetPrimitiveArrayCriticalView", "expected primitive array, given %s",
+                        array->GetClass()->PrettyDescriptor().c_str());
+    return nullptr;
+  }
+  array = PinObject<mirror::Array>(soa, java_array);
+  EnterCriticalView(soa.Env());
+  *length = array->GetLength();
+  return array->GetRawData(array->GetClass()->GetComponentSize(), 0);
+}
+
+void ReleasePrimitiveArrayCriticalView(JNIEnv* env, jarray java_array, const void* view) {
+  if (java_array == nullptr) {
+    return;
+  }
+  ScopedObjectAccess soa(env);
+  ObjPtr<mirror::Array> array = soa.Decode<mirror::Array>(java_array);
+  if (UNLIKELY(!array->GetClass()->IsPrimitiveArray())) {
+    soa.Vm()->JniAbortF("ReleasePrimitiveArrayCriticalView", "expected primitive array, given %s",
+                        array->GetClass()->PrettyDescriptor().c_str());
+    return;
+  }
+  DCHECK_EQ(view, array->GetRawData(array->GetClass()->GetComponentSize(), 0));
+  UNUSED(view);
+  ExitCriticalView(soa.Env(), "ReleasePrimitiveArrayCriticalView");
+  UnpinObject(soa, array);
+}
+
+jint GetLocalRefMark(JNIEnv* env) {
+  return static_cast<jint>(down_cast<JNIEnvExt*>(env)->GetLocalsMark().top_index);
+}
+
+void ReleaseLocalRefsToMark(JNIEnv* env, jint mark) {
+  ScopedObjectAccess soa(env);
+  if (UNLIKELY(!soa.Env()->ReleaseLocalsToMark(IRTSegmentState{static_cast<uint32_t>(mark)}))) {
+    soa.Vm()->JniAbortF("ReleaseLocalRefsToMark", "mark %d is not in the current local frame",
+                        mark);
+  }
+}
+
+void GetObjectArrayRegion(JNIEnv* env,
+                          jobjectArray java_array,
+                          jsize start,
+                          jsize length,
+                          jobject* buf) {
+  ScopedObjectAccess soa(env);
+  if (UNLIKELY(java_array == nullptr)) {
+    soa.Vm()->JniAbortF("GetObjectArrayRegion", "array == null");
+    return;
+  }
+  ObjPtr<mirror::ObjectArray<mirror::Object>> array =
+      soa.Decode<mirror::ObjectArray<mirror::Object>>(java_array);
+  if (UNLIKELY(start < 0 || length < 0 || length > array->GetLength() - start)) {
+    std::string type(array->PrettyTypeOf());
+    soa.Self()->ThrowNewExceptionF("Ljava/lang/ArrayIndexOutOfBoundsException;",
+                                   "%s offset=%d length=%d src.length=%d",
+                                   type.c_str(), start, length, array->GetLength());
+    return;
+  }
+  if (UNLIKELY(length != 0 && buf == nullptr)) {
+    soa.Vm()->JniAbortF("GetObjectArrayRegion", "buf == null");
+    return;
+  }
+  // Adding the references cannot cause a GC, so the array stays valid.
+  for (jsize i = 0; i != length; ++i) {
+    buf[i] = soa.AddLocalReference<jobject>(array->GetWithoutChecks(start + i));
+  }
+}
+
+void GetFieldOfObjects(JNIEnv* env,
+                       jfieldID fid,
+                       jsize count,
+                       const jobject* objects,
+                       jvalue* values) {
+  ScopedObjectAccess soa(env);
+  if (UNLIKELY(fid == nullptr)) {
+    soa.Vm()->JniAbortF("GetFieldOfObjects", "fid == null");
+    return;
+  }
+  if (UNLIKELY(count < 0)) {
+    soa.Vm()->JniAbortF("GetFieldOfObjects", "count < 0: %d", count);
+    return;
+  }
+  if (UNLIKELY(count != 0 && objects == nullptr)) {
+    soa.Vm()->JniAbortF("GetFieldOfObjects", "objects == null");
+    return;
+  }
+  if (UNLIKELY(count != 0 && values == nullptr)) {
+    soa.Vm()->JniAbortF("GetFieldOfObjects", "values == null");
+    return;
+  }
+  ArtField* f = jni::DecodeArtField(fid);
+  if (UNLIKELY(f->IsStatic())) {
+    soa.Vm()->JniAbortF("GetFieldOfObjects", "static jfieldID %s", f->PrettyField().c_str());
+    return;
+  }
+  Primitive::Type type = f->GetTypeAsPrimitiveType();
+  for (jsize i = 0; i < count; ++i) {
+    if (UNLIKELY(objects[i] == nullptr)) {
+      soa.Self()->ThrowNewExceptionF("Ljava/lang/NullPointerException;",
+                                     "Attempt to read field %s of a null object at index %d",
+                                     f->PrettyField().c_str(), i);
+      return;
+    }
+    ObjPtr<mirror::Object> o = soa.Decode<mirror::Object>(objects[i]);
+    if (UNLIKELY(!o->InstanceOf(f->GetDeclaringClass()))) {
+      soa.Vm()->JniAbortF("GetFieldOfObjects",
+                          "jfieldID %s not valid for the object of class %s at index %d",
+                          f->PrettyField().c_str(), o->PrettyTypeOf().c_str(), i);
+      return;
+    }
+    NotifyGetField(f, objects[i]);
+    // The field access listeners may have suspended.
+    o = soa.Decode<mirror::Object>(objects[i]);
+    switch (type) {
+      case Primitive::kPrimNot:
+        values[i].l = soa.AddLocalReference<jobject>(f->GetObject(o));
+        break;
+      case Primitive::kPrimBoolean:
+        values[i].z = f->GetBoolean(o);
+        break;
+      case Primitive::kPrimByte:
+        values[i].b = f->GetByte(o);
+        break;
+      case Primitive::kPrimChar:
+        values[i].c = f->GetChar(o);
+        break;
+      case Primitive::kPrimShort:
+        values[i].s = f->GetShort(o);
+        break;
+      case Primitive::kPrimInt:
+        values[i].i = f->GetInt(o);
+        break;
+      case Primitive::kPrimLong:
+        values[i].j = f->GetLong(o);
+        break;
+      case Primitive::kPrimFloat:
+        values[i].f = f->GetFloat(o);
+        break;
+      case Primitive::kPrimDouble:
+        values[i].d = f->GetDouble(o);
+        break;
+      case Primitive::kPrimVoid:
+        LOG(FATAL) << "Unexpected void field " << f->PrettyField();
+        UNREACHABLE();
+    }
+  }
+}
+
+const ArtJniExtensions gArtJniExtensions = {
+  GetStringCriticalView,
+  ReleaseStringCriticalView,
+  GetPrimitiveArrayCriticalView,
+  ReleasePrimitiveArrayCriticalView,
+  GetLocalRefMark,
+  ReleaseLocalRefsToMark,
+  GetObjectArrayRegion,
+  GetFieldOfObjects,
+};
+
+}  // namespace
+
+jint GetJniExtensionsEnvHandler(JavaVMExt* vm ATTRIBUTE_UNUSED, void** env, jint version) {
+  if (version != ART_JNI_EXTENSIONS_VERSION) {
+    return JNI_EVERSION;
+  }
+  *env = const_cast<ArtJniExtensions*>(&gArtJniExtensions);
+  return JNI_OK;
+}
+
+}  // namespace art
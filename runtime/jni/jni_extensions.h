@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JNI_JNI_EXTENSIONS_H_
+#define ART_RUNTIME_JNI_JNI_EXTENSIONS_H_
+
+#include <jni.h>
+
+namespace art {
+
+class JavaVMExt;
+
+// GetEnv hook returning the ArtJniExtensions table for ART_JNI_EXTENSIONS_VERSION, see
+// art_jni_extensions.h.
+jint GetJniExtensionsEnvHandler(JavaVMExt* vm, /*out*/void** env, jint version);
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_JNI_JNI_EXTENSIONS_H_
@@ -318,8 +318,7 @@ static void NotifySetPrimitiveField(ArtField* field, jobject obj, JValue val)
   }
 }
 
-static void NotifyGetField(ArtField* field, jobject obj)
-    REQUIRES_SHARED(Locks::mutator_lock_) {
+void NotifyGetField(ArtField* field, jobject obj) {
   instrumentation::Instrumentation* instrumentation = Runtime::Current()->GetInstrumentation();
   if (UNLIKELY(instrumentation->HasFieldReadListeners())) {
     Thread* self = Thread::Current();
@@ -61,6 +61,9 @@ ArtField* FindFieldJNI(const ScopedObjectAccess& soa,
                        const char* sig,
                        bool is_static) REQUIRES_SHARED(Locks::mutator_lock_);
 
+// Reports a JNI read of `field` of `obj` to the field read listeners, if there are any.
+void NotifyGetField(ArtField* field, jobject obj) REQUIRES_SHARED(Locks::mutator_lock_);
+
 namespace jni {
 
 // We want to maintain a branchless fast-path for performance reasons. The JniIdManager is the
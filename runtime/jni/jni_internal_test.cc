@@ -18,6 +18,7 @@
 
 #include "android-base/stringprintf.h"
 
+#include "art_jni_extensions.h"
 #include "art_method-inl.h"
 #include "base/mem_map.h"
 #include "common_runtime_test.h"
@@ -1881,6 +1882,173 @@ TEST_F(JniInternalTest, GetStringCritical_ReleaseStringCritical) {
   }
 }
 
+TEST_F(JniInternalTest, ArtJniExtensions_CriticalViews) {
+  const ArtJniExtensions* ext = nullptr;
+  ASSERT_EQ(JNI_OK, vm_->GetEnv(reinterpret_cast<void**>(&ext), ART_JNI_EXTENSIONS_VERSION));
+  ASSERT_TRUE(ext != nullptr);
+
+  jstring s = env_->NewStringUTF("hello");
+  ASSERT_TRUE(s != nullptr);
+  jsize length = 0;
+  jboolean is_latin1 = JNI_FALSE;
+  const void* view = ext->GetStringCriticalView(env_, s, &length, &is_latin1);
+  ASSERT_TRUE(view != nullptr);
+  EXPECT_EQ(5, length);
+  if (mirror::kUseStringCompression) {
+    // "hello" is all-ASCII, so the view is its compressed bytes, which are also Modified UTF-8.
+    EXPECT_EQ(JNI_TRUE, is_latin1);
+    EXPECT_EQ(0, memcmp("hello", view, 5));
+  } else {
+    EXPECT_EQ(JNI_FALSE, is_latin1);
+    jchar expected[] = { 'h', 'e', 'l', 'l', 'o' };
+    EXPECT_EQ(0, memcmp(expected, view, sizeof(expected)));
+  }
+  ext->ReleaseStringCriticalView(env_, s, view);
+
+  jstring s_16 = env_->NewStringUTF("\xed\xa0\x81\xed\xb0\x80");
+  ASSERT_TRUE(s_16 != nullptr);
+  is_latin1 = JNI_TRUE;
+  view = ext->GetStringCriticalView(env_, s_16, &length, &is_latin1);
+  ASSERT_TRUE(view != nullptr);
+  EXPECT_EQ(2, length);
+  EXPECT_EQ(JNI_FALSE, is_latin1);
+  EXPECT_EQ(0xd801, reinterpret_cast<const uint16_t*>(view)[0]);
+  EXPECT_EQ(0xdc00, reinterpret_cast<const uint16_t*>(view)[1]);
+  ext->ReleaseStringCriticalView(env_, s_16, view);
+
+  jintArray array = env_->NewIntArray(3);
+  ASSERT_TRUE(array != nullptr);
+  jint elements[] = { 1, 2, 3 };
+  env_->SetIntArrayRegion(array, 0, 3, elements);
+  // Views are never copies, whatever the CheckJNI mode.
+  for (bool check_jni : { false, true }) {
+    bool old_check_jni = vm_->SetCheckJniEnabled(check_jni);
+    view = ext->GetPrimitiveArrayCriticalView(env_, array, &length);
+    ASSERT_TRUE(view != nullptr);
+    EXPECT_EQ(3, length);
+    EXPECT_EQ(0, memcmp(elements, view, sizeof(elements)));
+    ext->ReleasePrimitiveArrayCriticalView(env_, array, view);
+    EXPECT_EQ(check_jni, vm_->SetCheckJniEnabled(old_check_jni));
+  }
+
+  EXPECT_EQ(nullptr, ext->GetStringCriticalView(env_, nullptr, &length, &is_latin1));
+  EXPECT_EQ(nullptr, ext->GetPrimitiveArrayCriticalView(env_, nullptr, &length));
+
+  CheckJniAbortCatcher jni_abort_catcher;
+  jobjectArray object_array = env_->NewObjectArray(1, env_->FindClass("java/lang/Object"), nullptr);
+  EXPECT_EQ(nullptr, ext->GetPrimitiveArrayCriticalView(env_, object_array, &length));
+  jni_abort_catcher.Check("expected primitive array, given java.lang.Object[]");
+}
+
+TEST_F(JniInternalTest, ArtJniExtensions_LocalRefMarks) {
+  const ArtJniExtensions* ext = nullptr;
+  ASSERT_EQ(JNI_OK, vm_->GetEnv(reinterpret_cast<void**>(&ext), ART_JNI_EXTENSIONS_VERSION));
+  JNIEnvExt* env = down_cast<JNIEnvExt*>(env_);
+  size_t initial_capacity;
+  {
+    ScopedObjectAccess soa(env_);
+    initial_capacity = env->GetLocalsCapacity();
+  }
+
+  jstring outer = env_->NewStringUTF("outer");
+  jint mark = ext->GetLocalRefMark(env_);
+  env_->NewStringUTF("inner");
+  jobject hole = env_->NewStringUTF("hole");
+  for (int i = 0; i != 100; ++i) {
+    env_->NewStringUTF("loop");
+  }
+  env_->DeleteLocalRef(hole);
+  ext->ReleaseLocalRefsToMark(env_, mark);
+  {
+    ScopedObjectAccess soa(env_);
+    EXPECT_EQ(initial_capacity + 1u, env->GetLocalsCapacity());
+  }
+  EXPECT_EQ(5, env_->GetStringUTFLength(outer));
+
+  // The segment keeps growing from the mark.
+  env_->NewStringUTF("after");
+  {
+    ScopedObjectAccess soa(env_);
+    EXPECT_EQ(initial_capacity + 2u, env->GetLocalsCapacity());
+  }
+  ext->ReleaseLocalRefsToMark(env_, mark);
+
+  // Marks taken before a PushLocalFrame() do not belong to the new frame.
+  ASSERT_EQ(JNI_OK, env_->PushLocalFrame(4));
+  {
+    CheckJniAbortCatcher jni_abort_catcher;
+    ext->ReleaseLocalRefsToMark(env_, mark);
+    jni_abort_catcher.Check("is not in the current local frame");
+  }
+  env_->PopLocalFrame(nullptr);
+  EXPECT_EQ(5, env_->GetStringUTFLength(outer));
+  env_->DeleteLocalRef(outer);
+}
+
+TEST_F(JniInternalTest, ArtJniExtensions_BatchedReads) {
+  const ArtJniExtensions* ext = nullptr;
+  ASSERT_EQ(JNI_OK, vm_->GetEnv(reinterpret_cast<void**>(&ext), ART_JNI_EXTENSIONS_VERSION));
+
+  jclass c = env_->FindClass("java/lang/Integer");
+  ASSERT_NE(c, nullptr);
+  jmethodID value_of = env_->GetStaticMethodID(c, "valueOf", "(I)Ljava/lang/Integer;");
+  ASSERT_NE(value_of, nullptr);
+  jfieldID value = env_->GetFieldID(c, "value", "I");
+  ASSERT_NE(value, nullptr);
+
+  static constexpr jsize kLength = 5;
+  jobjectArray array = env_->NewObjectArray(kLength, c, nullptr);
+  ASSERT_NE(array, nullptr);
+  for (jsize i = 0; i != kLength; ++i) {
+    if (i != 3) {
+      env_->SetObjectArrayElement(array, i, env_->CallStaticObjectMethod(c, value_of, i * 10));
+    }
+  }
+
+  jobject elements[kLength];
+  ext->GetObjectArrayRegion(env_, array, 1, 3, elements);
+  EXPECT_FALSE(env_->ExceptionCheck());
+  EXPECT_TRUE(env_->IsSameObject(env_->GetObjectArrayElement(array, 1), elements[0]));
+  EXPECT_TRUE(env_->IsSameObject(env_->GetObjectArrayElement(array, 2), elements[1]));
+  EXPECT_EQ(nullptr, elements[2]);
+
+  ext->GetObjectArrayRegion(env_, array, 3, 3, elements);
+  ExpectException(aioobe_);
+  ext->GetObjectArrayRegion(env_, array, -1, 1, elements);
+  ExpectException(aioobe_);
+
+  jvalue values[2];
+  ext->GetFieldOfObjects(env_, value, 2, elements, values);
+  EXPECT_FALSE(env_->ExceptionCheck());
+  EXPECT_EQ(10, values[0].i);
+  EXPECT_EQ(20, values[1].i);
+
+  ext->GetFieldOfObjects(env_, value, 3, elements, values);
+  EXPECT_TRUE(env_->ExceptionCheck());
+  jclass npe = env_->FindClass("java/lang/NullPointerException");
+  ExpectException(npe);
+
+  // Invalid arguments abort, except for null buffers with no objects to read.
+  ext->GetFieldOfObjects(env_, value, 0, nullptr, nullptr);
+  EXPECT_FALSE(env_->ExceptionCheck());
+  CheckJniAbortCatcher jni_abort_catcher;
+  ext->GetFieldOfObjects(env_, value, -1, elements, values);
+  jni_abort_catcher.Check("count < 0: -1");
+  ext->GetFieldOfObjects(env_, value, 1, nullptr, values);
+  jni_abort_catcher.Check("objects == null");
+  ext->GetFieldOfObjects(env_, value, 1, elements, nullptr);
+  jni_abort_catcher.Check("values == null");
+
+  // The field must be an instance field of the class of each object.
+  jfieldID max_value = env_->GetStaticFieldID(c, "MAX_VALUE", "I");
+  ASSERT_NE(max_value, nullptr);
+  ext->GetFieldOfObjects(env_, max_value, 1, elements, values);
+  jni_abort_catcher.Check("static jfieldID int java.lang.Integer.MAX_VALUE");
+  jobject objects[] = { elements[0], env_->NewStringUTF("not an Integer") };
+  ext->GetFieldOfObjects(env_, value, 2, objects, values);
+  jni_abort_catcher.Check("not valid for the object of class java.lang.String at index 1");
+}
+
 TEST_F(JniInternalTest, GetObjectArrayElement_SetObjectArrayElement) {
   jclass java_lang_Class = env_->FindClass("java/lang/Class");
   ASSERT_TRUE(java_lang_Class != nullptr);
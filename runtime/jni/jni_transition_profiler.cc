@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni_transition_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include "art_method-inl.h"
+#include "base/bit_utils.h"
+#include "base/time_utils.h"
+#include "object_callbacks.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+// Marks the entries of swept methods. They are never reused, so that the entries after them
+// stay reachable.
+static ArtMethod* const kSweptMethod = reinterpret_cast<ArtMethod*>(1u);
+
+// Number of entries looked at for a method before giving up and using the overflow entry.
+static constexpr size_t kMaxProbes = 16u;
+
+JniTransitionProfiler::JniTransitionProfiler(uint32_t sample_interval)
+    : sample_interval_(sample_interval),
+      entries_(new Entry[kCapacity]),
+      overflow_(new Entry()) {
+  DCHECK_NE(sample_interval, 0u);
+}
+
+JniTransitionProfiler::~JniTransitionProfiler() {}
+
+void JniTransitionProfiler::Counters::AddSample(uint64_t ns) {
+  samples.fetch_add(1u, std::memory_order_relaxed);
+  total_ns.fetch_add(ns, std::memory_order_relaxed);
+  uint64_t max = max_ns.load(std::memory_order_relaxed);
+  while (ns > max && !max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+  }
+}
+
+JniTransitionProfiler::TransitionStats JniTransitionProfiler::Counters::Get() const {
+  TransitionStats stats;
+  stats.count = count.load(std::memory_order_relaxed);
+  stats.samples = samples.load(std::memory_order_relaxed);
+  stats.total_ns = total_ns.load(std::memory_order_relaxed);
+  stats.max_ns = max_ns.load(std::memory_order_relaxed);
+  return stats;
+}
+
+JniTransitionProfiler::Entry* JniTransitionProfiler::GetEntry(ArtMethod* method) {
+  static_assert(IsPowerOfTwo(kCapacity), "Capacity must be power of two");
+  // ArtMethods are at least 16 bytes apart.
+  size_t index = reinterpret_cast<uintptr_t>(method) >> 4;
+  for (size_t i = 0; i != kMaxProbes; ++i) {
+    Entry* entry = &entries_[(index + i) & (kCapacity - 1u)];
+    ArtMethod* entry_method = entry->method.load(std::memory_order_relaxed);
+    if (entry_method == method) {
+      return entry;
+    }
+    if (entry_method == nullptr) {
+      if (entry->method.compare_exchange_strong(entry_method, method, std::memory_order_relaxed) ||
+          entry_method == method) {
+        return entry;
+      }
+    }
+  }
+  return overflow_.get();
+}
+
+JniTransitionProfiler::ScopedTransition::ScopedTransition(JniTransitionProfiler* profiler,
+                                                          Thread* self,
+                                                          ArtMethod* method,
+                                                          Transition transition) {
+  Entry* entry = profiler->GetEntry(method);
+  bool slow = false;
+  if (transition == Transition::kToNative) {
+    counters_ = &entry->to_native;
+  } else if (self->ReadFlag(ThreadFlag::kSuspendRequest) ||
+             self->ReadFlag(ThreadFlag::kActiveSuspendBarrier) ||
+             self->ReadFlag(ThreadFlag::kPendingFlipFunction)) {
+    counters_ = &entry->slow_to_runnable;
+    slow = true;
+  } else {
+    counters_ = &entry->to_runnable;
+  }
+  uint64_t count = counters_->count.fetch_add(1u, std::memory_order_relaxed);
+  start_ns_ = (slow || count % profiler->sample_interval_ == 0u) ? NanoTime() : 0u;
+}
+
+JniTransitionProfiler::ScopedTransition::~ScopedTransition() {
+  if (start_ns_ != 0u) {
+    counters_->AddSample(NanoTime() - start_ns_);
+  }
+}
+
+void JniTransitionProfiler::CountFastNativeCall(ArtMethod* method) {
+  GetEntry(method)->to_native.count.fetch_add(1u, std::memory_order_relaxed);
+}
+
+JniTransitionProfiler::MethodStats JniTransitionProfiler::GetStats(const Entry& entry) {
+  MethodStats stats;
+  stats.method = entry.method.load(std::memory_order_relaxed);
+  stats.to_native = entry.to_native.Get();
+  stats.to_runnable = entry.to_runnable.Get();
+  stats.slow_to_runnable = entry.slow_to_runnable.Get();
+  return stats;
+}
+
+std::vector<JniTransitionProfiler::MethodStats> JniTransitionProfiler::GetStats() const {
+  std::vector<MethodStats> stats;
+  for (size_t i = 0; i != kCapacity; ++i) {
+    ArtMethod* method = entries_[i].method.load(std::memory_order_relaxed);
+    if (method != nullptr && method != kSweptMethod) {
+      stats.push_back(GetStats(entries_[i]));
+    }
+  }
+  if (overflow_->to_native.count.load(std::memory_order_relaxed) != 0u) {
+    stats.push_back(GetStats(*overflow_));
+  }
+  std::sort(stats.begin(), stats.end(), [](const MethodStats& lhs, const MethodStats& rhs) {
+    uint64_t lhs_ns = lhs.EstimatedTotalNs();
+    uint64_t rhs_ns = rhs.EstimatedTotalNs();
+    return (lhs_ns != rhs_ns) ? lhs_ns > rhs_ns : lhs.to_native.count > rhs.to_native.count;
+  });
+  return stats;
+}
+
+static void DumpTransition(std::ostream& os, const JniTransitionProfiler::TransitionStats& stats) {
+  os << std::setw(10) << stats.count
+     << std::setw(9) << ((stats.samples == 0u) ? 0u : stats.total_ns / stats.samples)
+     << std::setw(11) << stats.max_ns;
+}
+
+void JniTransitionProfiler::Dump(std::ostream& os, size_t max_methods) const {
+  // Keep the methods from being swept while we print them.
+  ScopedObjectAccess soa(Thread::Current());
+  std::vector<MethodStats> stats = GetStats();
+  uint64_t total_calls = 0u;
+  uint64_t total_ns = 0u;
+  for (const MethodStats& method_stats : stats) {
+    total_calls += method_stats.to_native.count;
+    total_ns += method_stats.EstimatedTotalNs();
+  }
+  os << "JNI transitions: " << total_calls << " calls of " << stats.size()
+     << " native methods, an estimated " << PrettyDuration(total_ns)
+     << " in transitions (1 in " << sample_interval_ << " timed)\n";
+  if (stats.empty()) {
+    return;
+  }
+  os << "  " << std::setw(30) << "to native" << std::setw(30) << "to runnable"
+     << std::setw(30) << "slow to runnable" << "\n"
+     << "  " << std::setw(10) << "count" << std::setw(9) << "avg ns" << std::setw(11) << "max ns"
+     << std::setw(10) << "count" << std::setw(9) << "avg ns" << std::setw(11) << "max ns"
+     << std::setw(10) << "count" << std::setw(9) << "avg ns" << std::setw(11) << "max ns"
+     << "  method\n";
+  for (size_t i = 0; i != std::min(max_methods, stats.size()); ++i) {
+    const MethodStats& method_stats = stats[i];
+    os << "  ";
+    DumpTransition(os, method_stats.to_native);
+    DumpTransition(os, method_stats.to_runnable);
+    DumpTransition(os, method_stats.slow_to_runnable);
+    os << "  ";
+    if (method_stats.method == nullptr) {
+      os << "<other methods>";
+    } else {
+      if (method_stats.method->IsFastNative()) {
+        os << "@FastNative ";
+      }
+      os << method_stats.method->PrettyMethod();
+    }
+    os << "\n";
+  }
+  if (stats.size() > max_methods) {
+    os << "  ... " << (stats.size() - max_methods) << " more\n";
+  }
+}
+
+void JniTransitionProfiler::Sweep(IsMarkedVisitor* visitor) {
+  for (size_t i = 0; i != kCapacity; ++i) {
+    ArtMethod* method = entries_[i].method.load(std::memory_order_relaxed);
+    if (method == nullptr || method == kSweptMethod) {
+      continue;
+    }
+    mirror::Class* klass = method->GetDeclaringClassUnchecked<kWithoutReadBarrier>().Ptr();
+    if (visitor->IsMarked(klass) == nullptr) {
+      // The class is being unloaded and its methods may be reused for other classes.
+      entries_[i].method.store(kSweptMethod, std::memory_order_relaxed);
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JNI_JNI_TRANSITION_PROFILER_H_
+#define ART_RUNTIME_JNI_JNI_TRANSITION_PROFILER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+class IsMarkedVisitor;
+class Thread;
+
+// Counts the JNI transitions of each native method and the time they take, for SIGQUIT dumps
+// and VMDebug. When enabled, threads take the monitored JNI entrypoints, see
+// ThreadFlag::kMonitorJniEntryExit, which report to this profiler.
+//
+// Every transition is counted, but only one in `sample_interval` transitions is timed, to keep
+// the overhead low enough to leave the profiler on. Transitions back to Runnable that have to
+// wait for a suspension or a flip function are always timed, as they are the ones that stall.
+//
+// @FastNative methods do not change the thread state. Their calls are only counted when they go
+// through the generic JNI stub, and @CriticalNative calls are not seen at all.
+//
+// The table has a fixed capacity and is updated without locks. Methods that do not fit in it
+// are accounted to an overflow entry, with a null method.
+class JniTransitionProfiler {
+ private:
+  struct Counters;
+
+ public:
+  enum class Transition : uint8_t {
+    kToNative,
+    kToRunnable,
+  };
+
+  struct TransitionStats {
+    uint64_t count;
+    uint64_t samples;
+    uint64_t total_ns;
+    uint64_t max_ns;
+
+    // The time of all the transitions, extrapolated from the sampled ones.
+    uint64_t EstimatedTotalNs() const {
+      return (samples == 0u) ? 0u : static_cast<uint64_t>(
+          static_cast<double>(total_ns) * static_cast<double>(count) / samples);
+    }
+  };
+
+  struct MethodStats {
+    ArtMethod* method;
+    TransitionStats to_native;
+    // Transitions back to Runnable that did not have to wait.
+    TransitionStats to_runnable;
+    // Transitions back to Runnable that had to wait for a suspension or a flip function.
+    TransitionStats slow_to_runnable;
+
+    uint64_t EstimatedTotalNs() const {
+      return to_native.EstimatedTotalNs() +
+             to_runnable.EstimatedTotalNs() +
+             slow_to_runnable.EstimatedTotalNs();
+    }
+  };
+
+  // Times one transition of `self` for `method`, from its construction to its destruction.
+  class ScopedTransition {
+   public:
+    ScopedTransition(JniTransitionProfiler* profiler,
+                     Thread* self,
+                     ArtMethod* method,
+                     Transition transition);
+    ~ScopedTransition();
+
+   private:
+    Counters* counters_;
+    // Zero if this transition is not timed.
+    uint64_t start_ns_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedTransition);
+  };
+
+  static constexpr size_t kCapacity = 4096;
+
+  explicit JniTransitionProfiler(uint32_t sample_interval);
+  ~JniTransitionProfiler();
+
+  // Counts a call of a @FastNative method.
+  void CountFastNativeCall(ArtMethod* method);
+
+  // Return the statistics of all the methods, the ones with the most time in transitions first.
+  std::vector<MethodStats> GetStats() const;
+
+  // Dump the `max_methods` methods with the most time in transitions.
+  void Dump(std::ostream& os, size_t max_methods = 50u) const
+      REQUIRES(!Locks::mutator_lock_);
+
+  // Forget the methods of classes that are no longer marked.
+  void Sweep(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  struct Counters {
+    std::atomic<uint64_t> count{0u};
+    std::atomic<uint64_t> samples{0u};
+    std::atomic<uint64_t> total_ns{0u};
+    std::atomic<uint64_t> max_ns{0u};
+
+    void AddSample(uint64_t ns);
+    TransitionStats Get() const;
+  };
+
+  struct Entry {
+    std::atomic<ArtMethod*> method{nullptr};
+    Counters to_native;
+    Counters to_runnable;
+    Counters slow_to_runnable;
+  };
+
+  Entry* GetEntry(ArtMethod* method);
+  static MethodStats GetStats(const Entry& entry);
+
+  const uint32_t sample_interval_;
+  std::unique_ptr<Entry[]> entries_;
+  // For methods that do not fit in `entries_`.
+  std::unique_ptr<Entry> overflow_;
+
+  DISALLOW_COPY_AND_ASSIGN(JniTransitionProfiler);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_JNI_JNI_TRANSITION_PROFILER_H_
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "jni_transition_profiler.h"
+
+#include <sstream>
+
+#include "art_method-inl.h"
+#include "class_root-inl.h"
+#include "common_runtime_test.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+class JniTransitionProfilerTest : public CommonRuntimeTest {};
+
+TEST_F(JniTransitionProfilerTest, CountsAndSamples) {
+  Thread* self = Thread::Current();
+  ArtMethod* to_string;
+  ArtMethod* hash_code;
+  {
+    ScopedObjectAccess soa(self);
+    ObjPtr<mirror::Class> object_class = GetClassRoot<mirror::Object>();
+    to_string = object_class->FindClassMethod(
+        "toString", "()Ljava/lang/String;", kRuntimePointerSize);
+    hash_code = object_class->FindClassMethod("hashCode", "()I", kRuntimePointerSize);
+  }
+  ASSERT_TRUE(to_string != nullptr);
+  ASSERT_TRUE(hash_code != nullptr);
+
+  JniTransitionProfiler profiler(/* sample_interval= */ 2u);
+  for (size_t i = 0; i != 5u; ++i) {
+    {
+      JniTransitionProfiler::ScopedTransition transition(
+          &profiler, self, to_string, JniTransitionProfiler::Transition::kToNative);
+    }
+    {
+      JniTransitionProfiler::ScopedTransition transition(
+          &profiler, self, to_string, JniTransitionProfiler::Transition::kToRunnable);
+    }
+  }
+  profiler.CountFastNativeCall(hash_code);
+
+  std::vector<JniTransitionProfiler::MethodStats> stats = profiler.GetStats();
+  ASSERT_EQ(stats.size(), 2u);
+  // Only `toString` has timed transitions, so it comes first.
+  EXPECT_EQ(stats[0].method, to_string);
+  EXPECT_EQ(stats[0].to_native.count, 5u);
+  // The first of every two transitions is timed.
+  EXPECT_EQ(stats[0].to_native.samples, 3u);
+  EXPECT_GE(stats[0].to_native.max_ns * 3u, stats[0].to_native.total_ns);
+  EXPECT_EQ(stats[0].to_runnable.count + stats[0].slow_to_runnable.count, 5u);
+  EXPECT_EQ(stats[1].method, hash_code);
+  EXPECT_EQ(stats[1].to_native.count, 1u);
+  EXPECT_EQ(stats[1].to_native.samples, 0u);
+  EXPECT_EQ(stats[1].EstimatedTotalNs(), 0u);
+
+  std::ostringstream oss;
+  profiler.Dump(oss);
+  EXPECT_NE(oss.str().find("6 calls of 2 native methods"), std::string::npos) << oss.str();
+  EXPECT_NE(oss.str().find("java.lang.String java.lang.Object.toString()"), std::string::npos)
+      << oss.str();
+
+  std::ostringstream oss_one;
+  profiler.Dump(oss_one, /* max_methods= */ 1u);
+  EXPECT_NE(oss_one.str().find("... 1 more"), std::string::npos) << oss_one.str();
+}
+
+}  // namespace art
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "native_method_promotions.h"
+
+#include <sstream>
+
+#include "android-base/file.h"
+#include "android-base/stringprintf.h"
+#include "android-base/strings.h"
+
+#include "art_method-inl.h"
+#include "base/time_utils.h"
+#include "dex/dex_file-inl.h"
+#include "dex/dex_file_annotations.h"
+#include "dex/modifiers.h"
+#include "jni_env_ext.h"
+#include "runtime.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+// Warn if a promoted method runs for longer than 16ms, as for JNI critical regions in CheckJNI.
+static constexpr uint64_t kPromotedCallWarnTimeNs = MsToNs(16);
+
+static std::string GetMethodDescriptor(const DexFile& dex_file, const dex::MethodId& method_id) {
+  return std::string(dex_file.GetMethodDeclaringClassDescriptor(method_id)) + "->" +
+         dex_file.GetMethodName(method_id) + dex_file.GetMethodSignature(method_id).ToString();
+}
+
+// Check the shape of "Lpkg/Cls;->name(args)ret". The parts are not validated further, an entry
+// with a malformed descriptor simply never matches.
+static bool IsValidMethodDescriptor(const std::string& descriptor) {
+  size_t arrow = descriptor.find(";->");
+  size_t open = descriptor.find('(', arrow);
+  size_t close = descriptor.find(')', open);
+  return descriptor[0] == 'L' &&
+         arrow != std::string::npos &&
+         open != std::string::npos &&
+         open > arrow + 3u &&
+         close != std::string::npos &&
+         close + 1u < descriptor.size();
+}
+
+std::unique_ptr<NativeMethodPromotions> NativeMethodPromotions::Create(const std::string& path,
+                                                                       std::string* error_msg) {
+  std::string contents;
+  if (!android::base::ReadFileToString(path, &contents)) {
+    *error_msg = StringPrintf("Failed to read %s: %s", path.c_str(), strerror(errno));
+    return nullptr;
+  }
+  return CreateFromString(contents, path, error_msg);
+}
+
+std::unique_ptr<NativeMethodPromotions> NativeMethodPromotions::CreateFromString(
+    const std::string& contents, const std::string& location, std::string* error_msg) {
+  std::unique_ptr<NativeMethodPromotions> promotions(new NativeMethodPromotions());
+  std::vector<std::string> lines = android::base::Split(contents, "\n");
+  for (size_t i = 0; i != lines.size(); ++i) {
+    std::string line = lines[i].substr(0u, lines[i].find('#'));
+    std::istringstream iss(line);
+    std::string kind;
+    std::string descriptor;
+    std::string extra;
+    if (!(iss >> kind)) {
+      continue;  // Empty line or comment.
+    }
+    uint32_t flags;
+    if (kind == "fast") {
+      flags = kAccFastNative;
+    } else if (kind == "critical") {
+      flags = kAccCriticalNative;
+    } else {
+      *error_msg = StringPrintf("%s:%zu: expected 'fast' or 'critical', found '%s'",
+                                location.c_str(), i + 1u, kind.c_str());
+      return nullptr;
+    }
+    if (!(iss >> descriptor) || (iss >> extra) || !IsValidMethodDescriptor(descriptor)) {
+      *error_msg = StringPrintf("%s:%zu: expected a method like 'Lpkg/Cls;->name(I)V' after '%s'",
+                                location.c_str(), i + 1u, kind.c_str());
+      return nullptr;
+    }
+    auto it = promotions->methods_.emplace(descriptor, flags).first;
+    if (it->second != flags) {
+      *error_msg = StringPrintf("%s:%zu: %s is listed as both fast and critical",
+                                location.c_str(), i + 1u, descriptor.c_str());
+      return nullptr;
+    }
+  }
+  return promotions;
+}
+
+uint32_t NativeMethodPromotions::GetAccessFlags(const DexFile& dex_file,
+                                                uint32_t method_index,
+                                                uint32_t access_flags) const {
+  DCHECK_NE(access_flags & kAccNative, 0u);
+  const dex::MethodId& method_id = dex_file.GetMethodId(method_index);
+  std::string descriptor = GetMethodDescriptor(dex_file, method_id);
+  auto it = methods_.find(descriptor);
+  if (it == methods_.end()) {
+    return 0u;
+  }
+  // Apply the same rules as the verifier does for the annotations.
+  if ((access_flags & kAccSynchronized) != 0u) {
+    LOG(WARNING) << "Not promoting " << descriptor << ": synchronized native methods cannot be "
+                 << "fast or critical";
+    return 0u;
+  }
+  if (it->second == kAccCriticalNative) {
+    if ((access_flags & kAccStatic) == 0u) {
+      LOG(WARNING) << "Not promoting " << descriptor << ": critical native methods must be static";
+      return 0u;
+    }
+    if (strchr(dex_file.GetMethodShorty(method_id), 'L') != nullptr) {
+      LOG(WARNING) << "Not promoting " << descriptor << ": critical native methods cannot take "
+                   << "or return references";
+      return 0u;
+    }
+  }
+  VLOG(jni) << "Promoting " << descriptor << " to "
+            << ((it->second == kAccCriticalNative) ? "@CriticalNative" : "@FastNative");
+  return it->second;
+}
+
+bool NativeMethodPromotions::IsPromoted(ArtMethod* method) const {
+  if (!method->IsFastNative() && !method->IsCriticalNative()) {
+    return false;
+  }
+  const DexFile* dex_file = method->GetDexFile();
+  uint32_t method_index = method->GetDexMethodIndex();
+  if (methods_.find(GetMethodDescriptor(*dex_file, dex_file->GetMethodId(method_index))) ==
+          methods_.end()) {
+    return false;
+  }
+  // Annotated methods are not promoted, even if they are also listed.
+  return annotations::GetNativeMethodAnnotationAccessFlags(
+      *dex_file, method->GetClassDef(), method_index) == 0u;
+}
+
+bool NativeMethodPromotions::ShouldVerifyCall(Thread* self, ArtMethod* method) {
+  const NativeMethodPromotions* promotions = Runtime::Current()->GetNativeMethodPromotions();
+  return UNLIKELY(promotions != nullptr) &&
+         self->GetJniEnv()->IsCheckJniEnabled() &&
+         promotions->IsPromoted(method);
+}
+
+void NativeMethodPromotions::BeginVerifiedCall(Thread* self) {
+  // Promoted @FastNative methods may call back into Java and other promoted methods. Only the
+  // outermost call is timed.
+  JNIEnvExt* env = self->GetJniEnv();
+  if (env->GetPromotedCallDepth() == 0u) {
+    env->SetPromotedCallStartNs(NanoTime());
+  }
+  env->SetPromotedCallDepth(env->GetPromotedCallDepth() + 1u);
+}
+
+void NativeMethodPromotions::EndVerifiedCall(Thread* self, ArtMethod* method) {
+  JNIEnvExt* env = self->GetJniEnv();
+  if (env->GetPromotedCallDepth() == 0u) {
+    return;  // CheckJNI was enabled during the call.
+  }
+  env->SetPromotedCallDepth(env->GetPromotedCallDepth() - 1u);
+  if (env->GetPromotedCallDepth() == 0u) {
+    uint64_t duration_ns = NanoTime() - env->GetPromotedCallStartNs();
+    if (duration_ns > kPromotedCallWarnTimeNs) {
+      const char* kind = method->IsCriticalNative() ? "@CriticalNative" : "@FastNative";
+      LOG(WARNING) << "Promoted " << kind << " method " << method->PrettyMethod() << " ran for "
+                   << PrettyDuration(duration_ns) << " without a thread state transition on "
+                   << *self << ", remove it from the promotion file if it can block";
+    }
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_JNI_NATIVE_METHOD_PROMOTIONS_H_
+#define ART_RUNTIME_JNI_NATIVE_METHOD_PROMOTIONS_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+class DexFile;
+class Thread;
+
+// Native methods to treat as if they were annotated with @FastNative or @CriticalNative, read
+// from the file given with -XX:NativeMethodPromotionFile. Each line of the file holds a kind and
+// a method, for example:
+//
+//   # Comments start with '#'.
+//   fast Lcom/example/Codec;->checksum([BII)I
+//   critical Lcom/example/Codec;->mix(JJ)J
+//
+// "fast" methods keep the normal JNI signature. "critical" methods must be implemented with the
+// @CriticalNative signature, without the JNIEnv* and jclass arguments. Candidates can be listed
+// with `dexanalyze -analyze-native-methods`.
+//
+// The rules of the annotations are enforced: synchronized methods cannot be promoted, and
+// "critical" methods must also be static and only take and return primitive values, that is
+// have no 'L' in their shorty. Listed methods that break them are not promoted, with a warning.
+//
+// Promotions only apply to methods that are not annotated, in classes loaded at runtime or from
+// an app image, not to the ones in the boot image. App image classes do not go through
+// ClassLinker::LoadMethod(), so their methods are promoted when the image is added. Precompiled
+// JNI stubs of promoted methods are not used, as they were compiled for normal JNI.
+//
+// With CheckJNI, promoted methods are kept on the generic JNI stub, which warns about calls that
+// run long enough to delay a GC, as they run without a thread state transition.
+class NativeMethodPromotions {
+ public:
+  // Parse the file at `path`. Return null and set `error_msg` if it cannot be read or parsed.
+  static std::unique_ptr<NativeMethodPromotions> Create(const std::string& path,
+                                                        std::string* error_msg);
+
+  // Parse the `contents` of a promotion file, named `location` in error messages.
+  static std::unique_ptr<NativeMethodPromotions> CreateFromString(const std::string& contents,
+                                                                  const std::string& location,
+                                                                  std::string* error_msg);
+
+  // Return kAccFastNative or kAccCriticalNative for the unannotated native method `method_index`
+  // with `access_flags`, or 0 if it is not promoted or cannot be.
+  uint32_t GetAccessFlags(const DexFile& dex_file,
+                          uint32_t method_index,
+                          uint32_t access_flags) const;
+
+  // Whether `method` is @FastNative or @CriticalNative because of this list.
+  bool IsPromoted(ArtMethod* method) const REQUIRES_SHARED(Locks::mutator_lock_);
+
+  size_t Size() const {
+    return methods_.size();
+  }
+
+  // CheckJNI timing of the calls of promoted methods by the generic JNI stub.
+  static bool ShouldVerifyCall(Thread* self, ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+  static void BeginVerifiedCall(Thread* self);
+  static void EndVerifiedCall(Thread* self, ArtMethod* method)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  NativeMethodPromotions() {}
+
+  // Method descriptor, as in "Lpkg/Cls;->name(I)V", to kAccFastNative or kAccCriticalNative.
+  std::unordered_map<std::string, uint32_t> methods_;
+
+  DISALLOW_COPY_AND_ASSIGN(NativeMethodPromotions);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_JNI_NATIVE_METHOD_PROMOTIONS_H_
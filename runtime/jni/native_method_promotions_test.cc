@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "native_method_promotions.h"
+
+#include "common_runtime_test.h"
+#include "dex/class_accessor-inl.h"
+#include "dex/dex_file-inl.h"
+#include "dex/modifiers.h"
+
+namespace art {
+
+class NativeMethodPromotionsTest : public CommonRuntimeTest {
+ protected:
+  // Return the access flags that `promotions` add to the native method `name` of MyClassNatives.
+  uint32_t GetAccessFlags(const NativeMethodPromotions& promotions,
+                          const DexFile& dex_file,
+                          const char* name) {
+    const dex::TypeId* type_id = dex_file.FindTypeId("LMyClassNatives;");
+    CHECK(type_id != nullptr);
+    const dex::ClassDef* class_def = dex_file.FindClassDef(dex_file.GetIndexForTypeId(*type_id));
+    CHECK(class_def != nullptr);
+    ClassAccessor accessor(dex_file, *class_def);
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      if (strcmp(dex_file.GetMethodName(method.GetIndex()), name) == 0) {
+        return promotions.GetAccessFlags(dex_file, method.GetIndex(), method.GetAccessFlags());
+      }
+    }
+    ADD_FAILURE() << "No method " << name;
+    return 0u;
+  }
+};
+
+TEST_F(NativeMethodPromotionsTest, Parse) {
+  std::string error_msg;
+  std::unique_ptr<NativeMethodPromotions> promotions = NativeMethodPromotions::CreateFromString(
+      "# Comment\n"
+      "\n"
+      "fast LFoo;->bar(I)I  # Trailing comment\n"
+      "  critical   LFoo;->baz(JJ)J\n"
+      "fast LFoo;->bar(I)I\n",
+      "promotions.txt",
+      &error_msg);
+  ASSERT_TRUE(promotions != nullptr) << error_msg;
+  EXPECT_EQ(promotions->Size(), 2u);
+
+  promotions = NativeMethodPromotions::CreateFromString(
+      "fast LFoo;->bar(I)I\nslow LFoo;->baz()V\n", "promotions.txt", &error_msg);
+  EXPECT_TRUE(promotions == nullptr);
+  EXPECT_EQ(error_msg, "promotions.txt:2: expected 'fast' or 'critical', found 'slow'");
+
+  for (const char* line : { "fast", "fast Foo.bar(int)", "fast LFoo;->()V", "fast LFoo;->bar(",
+                            "fast LFoo;->bar()", "fast LFoo;->bar()V extra" }) {
+    promotions = NativeMethodPromotions::CreateFromString(line, "promotions.txt", &error_msg);
+    EXPECT_TRUE(promotions == nullptr) << line;
+    EXPECT_EQ(error_msg,
+              "promotions.txt:1: expected a method like 'Lpkg/Cls;->name(I)V' after 'fast'")
+        << line;
+  }
+
+  promotions = NativeMethodPromotions::CreateFromString(
+      "fast LFoo;->bar(I)I\ncritical LFoo;->bar(I)I\n", "promotions.txt", &error_msg);
+  EXPECT_TRUE(promotions == nullptr);
+  EXPECT_EQ(error_msg, "promotions.txt:2: LFoo;->bar(I)I is listed as both fast and critical");
+
+  promotions = NativeMethodPromotions::Create("/non/existent/promotions.txt", &error_msg);
+  EXPECT_TRUE(promotions == nullptr);
+}
+
+TEST_F(NativeMethodPromotionsTest, GetAccessFlags) {
+  std::unique_ptr<const DexFile> dex_file(OpenTestDexFile("MyClassNatives"));
+  std::string error_msg;
+  std::unique_ptr<NativeMethodPromotions> promotions = NativeMethodPromotions::CreateFromString(
+      "fast LMyClassNatives;->bar(I)I\n"
+      "critical LMyClassNatives;->fooSII(II)I\n"
+      "critical LMyClassNatives;->fooSDD(DD)D\n"
+      "fast LMyClassNatives;->fooJJ_synchronized(JJ)J\n"
+      "critical LMyClassNatives;->fooII(II)I\n"
+      "critical LMyClassNatives;->fooSIOO(ILjava/lang/Object;Ljava/lang/Object;)"
+          "Ljava/lang/Object;\n",
+      "promotions.txt",
+      &error_msg);
+  ASSERT_TRUE(promotions != nullptr) << error_msg;
+
+  EXPECT_EQ(GetAccessFlags(*promotions, *dex_file, "bar"), kAccFastNative);
+  EXPECT_EQ(GetAccessFlags(*promotions, *dex_file, "fooSII"), kAccCriticalNative);
+  EXPECT_EQ(GetAccessFlags(*promotions, *dex_file, "fooSDD"), kAccCriticalNative);
+  // Not listed.
+  EXPECT_EQ(GetAccessFlags(*promotions, *dex_file, "foo"), 0u);
+  // Listed methods that break the rules of the annotations are not promoted.
+  // Synchronized.
+  EXPECT_EQ(GetAccessFlags(*promotions, *dex_file, "fooJJ_synchronized"), 0u);
+  // Critical but not static.
+  EXPECT_EQ(GetAccessFlags(*promotions, *dex_file, "fooII"), 0u);
+  // Critical with references.
+  EXPECT_EQ(GetAccessFlags(*promotions, *dex_file, "fooSIOO"), 0u);
+}
+
+}  // namespace art
@@ -106,6 +106,13 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kFullGcTracingThroughputAvg:
       return std::make_optional(
           statsd::ART_DATUM_REPORTED__KIND__ART_DATUM_GC_FULL_HEAP_TRACING_THROUGHPUT_AVG_MB_PER_SEC);
+    case DatumId::kJitCompilationDeferredCount:
+    case DatumId::kJitCpuBudgetUtilization:
+    case DatumId::kCheckpointTime:
+    case DatumId::kEmptyCheckpointTime:
+    case DatumId::kTimeToSafepoint:
+    case DatumId::kSuspendAllTime:
+      return std::nullopt;
   }
 }
 
@@ -54,7 +54,9 @@ static void InitializeArray(GcRoot<T>*) {
 
 template<typename T, size_t kMaxCacheSize>
 T* DexCache::AllocArray(MemberOffset obj_offset, MemberOffset num_offset, size_t num) {
-  num = std::min<size_t>(num, kMaxCacheSize);
+  if (num > kMaxCacheSize && num > Runtime::Current()->GetFullDexCacheArrayLimit()) {
+    num = kMaxCacheSize;
+  }
   if (num == 0) {
     return nullptr;
   }
@@ -73,7 +75,9 @@ T* DexCache::AllocArray(MemberOffset obj_offset, MemberOffset num_offset, size_t
     DCHECK(alloc->Contains(array));
     return array;  // Other thread just allocated the array.
   }
-  array = reinterpret_cast<T*>(alloc->AllocAlign16(self, RoundUp(num * sizeof(T), 16)));
+  size_t size = sizeof(DexCacheArrayStats) + RoundUp(num * sizeof(T), 16);
+  uint8_t* data = reinterpret_cast<uint8_t*>(alloc->AllocAlign16(self, size));
+  array = reinterpret_cast<T*>(data + sizeof(DexCacheArrayStats));
   InitializeArray(array);  // Ensure other threads see the array initialized.
   dex_cache->SetField32Volatile<false, false>(num_offset, num);
   dex_cache->SetField64Volatile<false, false>(obj_offset, reinterpret_cast64<uint64_t>(array));
@@ -109,6 +113,28 @@ inline void NativeDexCachePair<T>::Initialize(std::atomic<NativeDexCachePair<T>>
   DexCache::SetNativePair(dex_cache, 0, first_elem);
 }
 
+inline bool DexCache::AreStatsEnabled() {
+  return Runtime::Current()->AreDexCacheStatsEnabled();
+}
+
+inline void DexCache::RecordLookup(const void* array, bool hit) {
+  if (UNLIKELY(AreStatsEnabled())) {
+    DexCacheArrayStats* stats = GetArrayStats(array);
+    (hit ? stats->hits : stats->misses).fetch_add(1u, std::memory_order_relaxed);
+  }
+}
+
+template <typename Pair>
+inline void DexCache::RecordStore(const void* array,
+                                  uint32_t slot_idx,
+                                  size_t old_index,
+                                  uint32_t new_index) {
+  DCHECK(AreStatsEnabled());
+  if (old_index != new_index && old_index != Pair::InvalidIndexForSlot(slot_idx)) {
+    GetArrayStats(array)->evictions.fetch_add(1u, std::memory_order_relaxed);
+  }
+}
+
 inline uint32_t DexCache::ClassSize(PointerSize pointer_size) {
   const uint32_t vtable_entries = Object::kVTableLength;
   return Class::ComputeClassSize(true, vtable_entries, 0, 0, 0, 0, 0, pointer_size);
@@ -116,7 +142,7 @@ inline uint32_t DexCache::ClassSize(PointerSize pointer_size) {
 
 inline uint32_t DexCache::StringSlotIndex(dex::StringIndex string_idx) {
   DCHECK_LT(string_idx.index_, GetDexFile()->NumStringIds());
-  const uint32_t slot_idx = string_idx.index_ % kDexCacheStringCacheSize;
+  const uint32_t slot_idx = SlotIndex<kDexCacheStringCacheSize>(string_idx.index_, NumStrings());
   DCHECK_LT(slot_idx, NumStrings());
   return slot_idx;
 }
@@ -126,8 +152,10 @@ inline String* DexCache::GetResolvedString(dex::StringIndex string_idx) {
   if (UNLIKELY(strings == nullptr)) {
     return nullptr;
   }
-  return strings[StringSlotIndex(string_idx)].load(
+  String* string = strings[StringSlotIndex(string_idx)].load(
       std::memory_order_relaxed).GetObjectForIndex(string_idx.index_);
+  RecordLookup(strings, string != nullptr);
+  return string;
 }
 
 inline void DexCache::SetResolvedString(dex::StringIndex string_idx, ObjPtr<String> resolved) {
@@ -137,7 +165,14 @@ inline void DexCache::SetResolvedString(dex::StringIndex string_idx, ObjPtr<Stri
     strings = AllocArray<StringDexCacheType, kDexCacheStringCacheSize>(
         StringsOffset(), NumStringsOffset(), GetDexFile()->NumStringIds());
   }
-  strings[StringSlotIndex(string_idx)].store(
+  const uint32_t slot_idx = StringSlotIndex(string_idx);
+  if (UNLIKELY(AreStatsEnabled())) {
+    RecordStore<StringDexCachePair>(strings,
+                                    slot_idx,
+                                    strings[slot_idx].load(std::memory_order_relaxed).index,
+                                    string_idx.index_);
+  }
+  strings[slot_idx].store(
       StringDexCachePair(resolved, string_idx.index_), std::memory_order_relaxed);
   Runtime* const runtime = Runtime::Current();
   if (UNLIKELY(runtime->IsActiveTransaction())) {
@@ -165,7 +200,7 @@ inline void DexCache::ClearString(dex::StringIndex string_idx) {
 
 inline uint32_t DexCache::TypeSlotIndex(dex::TypeIndex type_idx) {
   DCHECK_LT(type_idx.index_, GetDexFile()->NumTypeIds());
-  const uint32_t slot_idx = type_idx.index_ % kDexCacheTypeCacheSize;
+  const uint32_t slot_idx = SlotIndex<kDexCacheTypeCacheSize>(type_idx.index_, NumResolvedTypes());
   DCHECK_LT(slot_idx, NumResolvedTypes());
   return slot_idx;
 }
@@ -177,8 +212,10 @@ inline Class* DexCache::GetResolvedType(dex::TypeIndex type_idx) {
   if (UNLIKELY(resolved_types == nullptr)) {
     return nullptr;
   }
-  return resolved_types[TypeSlotIndex(type_idx)].load(
+  Class* type = resolved_types[TypeSlotIndex(type_idx)].load(
       std::memory_order_relaxed).GetObjectForIndex(type_idx.index_);
+  RecordLookup(resolved_types, type != nullptr);
+  return type;
 }
 
 inline void DexCache::SetResolvedType(dex::TypeIndex type_idx, ObjPtr<Class> resolved) {
@@ -189,11 +226,18 @@ inline void DexCache::SetResolvedType(dex::TypeIndex type_idx, ObjPtr<Class> res
     resolved_types = AllocArray<TypeDexCacheType, kDexCacheTypeCacheSize>(
         ResolvedTypesOffset(), NumResolvedTypesOffset(), GetDexFile()->NumTypeIds());
   }
+  const uint32_t slot_idx = TypeSlotIndex(type_idx);
+  if (UNLIKELY(AreStatsEnabled())) {
+    RecordStore<TypeDexCachePair>(resolved_types,
+                                  slot_idx,
+                                  resolved_types[slot_idx].load(std::memory_order_relaxed).index,
+                                  type_idx.index_);
+  }
   // TODO default transaction support.
   // Use a release store for SetResolvedType. This is done to prevent other threads from seeing a
   // class but not necessarily seeing the loaded members like the static fields array.
   // See b/32075261.
-  resolved_types[TypeSlotIndex(type_idx)].store(
+  resolved_types[slot_idx].store(
       TypeDexCachePair(resolved, type_idx.index_), std::memory_order_release);
   // TODO: Fine-grained marking, so that we don't need to go through all arrays in full.
   WriteBarrier::ForEveryFieldWrite(this);
@@ -217,7 +261,8 @@ inline void DexCache::ClearResolvedType(dex::TypeIndex type_idx) {
 inline uint32_t DexCache::MethodTypeSlotIndex(dex::ProtoIndex proto_idx) {
   DCHECK(Runtime::Current()->IsMethodHandlesEnabled());
   DCHECK_LT(proto_idx.index_, GetDexFile()->NumProtoIds());
-  const uint32_t slot_idx = proto_idx.index_ % kDexCacheMethodTypeCacheSize;
+  const uint32_t slot_idx =
+      SlotIndex<kDexCacheMethodTypeCacheSize>(proto_idx.index_, NumResolvedMethodTypes());
   DCHECK_LT(slot_idx, NumResolvedMethodTypes());
   return slot_idx;
 }
@@ -302,7 +347,7 @@ inline ObjPtr<CallSite> DexCache::SetResolvedCallSite(uint32_t call_site_idx,
 
 inline uint32_t DexCache::FieldSlotIndex(uint32_t field_idx) {
   DCHECK_LT(field_idx, GetDexFile()->NumFieldIds());
-  const uint32_t slot_idx = field_idx % kDexCacheFieldCacheSize;
+  const uint32_t slot_idx = SlotIndex<kDexCacheFieldCacheSize>(field_idx, NumResolvedFields());
   DCHECK_LT(slot_idx, NumResolvedFields());
   return slot_idx;
 }
@@ -313,7 +358,9 @@ inline ArtField* DexCache::GetResolvedField(uint32_t field_idx) {
     return nullptr;
   }
   auto pair = GetNativePair(fields, FieldSlotIndex(field_idx));
-  return pair.GetObjectForIndex(field_idx);
+  ArtField* field = pair.GetObjectForIndex(field_idx);
+  RecordLookup(fields, field != nullptr);
+  return field;
 }
 
 inline void DexCache::SetResolvedField(uint32_t field_idx, ArtField* field) {
@@ -324,12 +371,17 @@ inline void DexCache::SetResolvedField(uint32_t field_idx, ArtField* field) {
     fields = AllocArray<FieldDexCacheType, kDexCacheFieldCacheSize>(
         ResolvedFieldsOffset(), NumResolvedFieldsOffset(), GetDexFile()->NumFieldIds());
   }
-  SetNativePair(fields, FieldSlotIndex(field_idx), pair);
+  const uint32_t slot_idx = FieldSlotIndex(field_idx);
+  if (UNLIKELY(AreStatsEnabled())) {
+    RecordStore<FieldDexCachePair>(
+        fields, slot_idx, GetNativePair(fields, slot_idx).index, field_idx);
+  }
+  SetNativePair(fields, slot_idx, pair);
 }
 
 inline uint32_t DexCache::MethodSlotIndex(uint32_t method_idx) {
   DCHECK_LT(method_idx, GetDexFile()->NumMethodIds());
-  const uint32_t slot_idx = method_idx % kDexCacheMethodCacheSize;
+  const uint32_t slot_idx = SlotIndex<kDexCacheMethodCacheSize>(method_idx, NumResolvedMethods());
   DCHECK_LT(slot_idx, NumResolvedMethods());
   return slot_idx;
 }
@@ -340,7 +392,9 @@ inline ArtMethod* DexCache::GetResolvedMethod(uint32_t method_idx) {
     return nullptr;
   }
   auto pair = GetNativePair(methods, MethodSlotIndex(method_idx));
-  return pair.GetObjectForIndex(method_idx);
+  ArtMethod* method = pair.GetObjectForIndex(method_idx);
+  RecordLookup(methods, method != nullptr);
+  return method;
 }
 
 inline void DexCache::SetResolvedMethod(uint32_t method_idx, ArtMethod* method) {
@@ -351,7 +405,12 @@ inline void DexCache::SetResolvedMethod(uint32_t method_idx, ArtMethod* method)
     methods = AllocArray<MethodDexCacheType, kDexCacheMethodCacheSize>(
         ResolvedMethodsOffset(), NumResolvedMethodsOffset(), GetDexFile()->NumMethodIds());
   }
-  SetNativePair(methods, MethodSlotIndex(method_idx), pair);
+  const uint32_t slot_idx = MethodSlotIndex(method_idx);
+  if (UNLIKELY(AreStatsEnabled())) {
+    RecordStore<MethodDexCachePair>(
+        methods, slot_idx, GetNativePair(methods, slot_idx).index, method_idx);
+  }
+  SetNativePair(methods, slot_idx, pair);
 }
 
 template <typename T>
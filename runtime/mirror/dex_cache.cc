@@ -114,6 +114,25 @@ void DexCache::ResetNativeArrays() {
   SetField32<false>(NumResolvedCallSitesOffset(), 0);
 }
 
+void DexCache::DumpArrayStats(std::ostream& os) {
+  auto dump_array = [&os](const char* kind, const void* array, size_t num_slots, size_t num_ids) {
+    if (array == nullptr) {
+      return;
+    }
+    DexCacheArrayStats* stats = GetArrayStats(array);
+    os << "  " << kind << ": " << num_slots << " slots for " << num_ids << " ids"
+       << " hits=" << stats->hits.load(std::memory_order_relaxed)
+       << " misses=" << stats->misses.load(std::memory_order_relaxed)
+       << " evictions=" << stats->evictions.load(std::memory_order_relaxed) << "\n";
+  };
+  const DexFile* dex_file = GetDexFile();
+  os << "Dex cache " << dex_file->GetLocation() << "\n";
+  dump_array("strings", GetStrings(), NumStrings(), dex_file->NumStringIds());
+  dump_array("types", GetResolvedTypes(), NumResolvedTypes(), dex_file->NumTypeIds());
+  dump_array("fields", GetResolvedFields(), NumResolvedFields(), dex_file->NumFieldIds());
+  dump_array("methods", GetResolvedMethods(), NumResolvedMethods(), dex_file->NumMethodIds());
+}
+
 void DexCache::SetLocation(ObjPtr<mirror::String> location) {
   SetFieldObject<false>(OFFSET_OF_OBJECT_MEMBER(DexCache, location_), location);
 }
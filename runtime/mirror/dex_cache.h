@@ -130,6 +130,17 @@ using MethodDexCacheType = std::atomic<MethodDexCachePair>;
 using MethodTypeDexCachePair = DexCachePair<MethodType>;
 using MethodTypeDexCacheType = std::atomic<MethodTypeDexCachePair>;
 
+// Lookup counters of a native dex cache array, allocated right in front of the array.
+// They are only updated when Runtime::AreDexCacheStatsEnabled().
+struct DexCacheArrayStats {
+  std::atomic<uint32_t> hits;
+  std::atomic<uint32_t> misses;
+  // Stores that replaced the entry of another index sharing the slot.
+  std::atomic<uint32_t> evictions;
+  uint32_t padding;
+};
+static_assert(sizeof(DexCacheArrayStats) == 16u, "Dex cache arrays must stay 16-byte aligned");
+
 // C++ mirror of java.lang.DexCache.
 class MANAGED DexCache final : public Object {
  public:
@@ -138,6 +149,10 @@ class MANAGED DexCache final : public Object {
   // Size of java.lang.DexCache.class.
   static uint32_t ClassSize(PointerSize pointer_size);
 
+  // The sizes below are for hashed arrays, where an index uses the slot given by its value
+  // modulo the size. Arrays of dex files with few enough ids have one slot per index instead,
+  // either because all ids fit or with -XX:FullDexCacheArrayLimit, see AllocArray().
+
   // Size of type dex cache. Needs to be a power of 2 for entrypoint assumptions to hold.
   static constexpr size_t kDexCacheTypeCacheSize = 1024;
   static_assert(IsPowerOfTwo(kDexCacheTypeCacheSize),
@@ -438,16 +453,46 @@ class MANAGED DexCache final : public Object {
 
   void VisitReflectiveTargets(ReflectiveValueVisitor* visitor) REQUIRES(Locks::mutator_lock_);
 
+  // Return the lookup counters of a native array allocated for a dex cache.
+  static DexCacheArrayStats* GetArrayStats(const void* array) {
+    return reinterpret_cast<DexCacheArrayStats*>(const_cast<void*>(array)) - 1;
+  }
+
+  // Dump the sizes and lookup counters of the allocated native arrays.
+  void DumpArrayStats(std::ostream& os) REQUIRES_SHARED(Locks::mutator_lock_);
+
   void SetClassLoader(ObjPtr<ClassLoader> class_loader) REQUIRES_SHARED(Locks::mutator_lock_);
 
   ObjPtr<ClassLoader> GetClassLoader() REQUIRES_SHARED(Locks::mutator_lock_);
 
  private:
-  // Allocate new array in linear alloc and save it in the given fields.
+  // Allocate new array in linear alloc and save it in the given fields. The array is hashed
+  // into kMaxCacheSize slots if `num` is larger, unless `num` is within the full array limit.
   template<typename T, size_t kMaxCacheSize>
   T* AllocArray(MemberOffset obj_offset, MemberOffset num_offset, size_t num)
      REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Return the slot of `idx` in an array of `num_slots` slots, hashed into kCacheSize slots
+  // unless it has one slot per index. Either way, the slot is in bounds even if `num_slots`
+  // is read before the array size is published.
+  template <size_t kCacheSize>
+  static uint32_t SlotIndex(uint32_t idx, size_t num_slots) {
+    return LIKELY(idx < num_slots) ? idx : idx % kCacheSize;
+  }
+
+  static bool AreStatsEnabled();
+
+  // Count a hit or miss of a lookup in `array`, if stats are enabled.
+  static void RecordLookup(const void* array, bool hit);
+
+  // Count a store replacing the entry of `old_index` with `new_index`. The caller checks that
+  // stats are enabled.
+  template <typename Pair>
+  static void RecordStore(const void* array,
+                          uint32_t slot_idx,
+                          size_t old_index,
+                          uint32_t new_index);
+
   // std::pair<> is not trivially copyable and as such it is unsuitable for atomic operations,
   // so we use a custom pair class for loading and storing the NativeDexCachePair<>.
   template <typename IntType>
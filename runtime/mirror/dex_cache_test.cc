@@ -44,6 +44,22 @@ class DexCacheMethodHandlesTest : public DexCacheTest {
   }
 };
 
+class DexCacheStatsTest : public DexCacheTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    DexCacheTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:DexCacheStats=true", nullptr));
+  }
+};
+
+class DexCacheFullArraysTest : public DexCacheStatsTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    DexCacheStatsTest::SetUpRuntimeOptions(options);
+    options->push_back(std::make_pair("-XX:FullDexCacheArrayLimit=65536", nullptr));
+  }
+};
+
 TEST_F(DexCacheTest, Open) {
   ScopedObjectAccess soa(Thread::Current());
   StackHandleScope<1> hs(soa.Self());
@@ -72,6 +88,62 @@ TEST_F(DexCacheMethodHandlesTest, Open) {
   EXPECT_EQ(0u, dex_cache->NumResolvedMethodTypes());
 }
 
+TEST_F(DexCacheStatsTest, HashedArrays) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocAndInitializeDexCache(
+          soa.Self(), *java_lang_dex_file_, /*class_loader=*/nullptr)));
+  ASSERT_TRUE(dex_cache != nullptr);
+  ASSERT_GT(java_lang_dex_file_->NumTypeIds(), DexCache::kDexCacheTypeCacheSize);
+  Handle<Class> klass =
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(klass != nullptr);
+
+  // Indexes that share a slot evict each other.
+  dex::TypeIndex index1(1u);
+  dex::TypeIndex index2(1u + DexCache::kDexCacheTypeCacheSize);
+  dex_cache->SetResolvedType(index1, klass.Get());
+  EXPECT_EQ(DexCache::kDexCacheTypeCacheSize, dex_cache->NumResolvedTypes());
+  dex_cache->SetResolvedType(index2, klass.Get());
+  EXPECT_TRUE(dex_cache->GetResolvedType(index1) == nullptr);
+  EXPECT_EQ(klass.Get(), dex_cache->GetResolvedType(index2));
+
+  DexCacheArrayStats* stats = DexCache::GetArrayStats(dex_cache->GetResolvedTypes());
+  EXPECT_EQ(1u, stats->hits.load());
+  EXPECT_EQ(1u, stats->misses.load());
+  EXPECT_EQ(1u, stats->evictions.load());
+}
+
+TEST_F(DexCacheFullArraysTest, FullArrays) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocAndInitializeDexCache(
+          soa.Self(), *java_lang_dex_file_, /*class_loader=*/nullptr)));
+  ASSERT_TRUE(dex_cache != nullptr);
+  ASSERT_GT(java_lang_dex_file_->NumTypeIds(), DexCache::kDexCacheTypeCacheSize);
+  Handle<Class> klass =
+      hs.NewHandle(class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;"));
+  ASSERT_TRUE(klass != nullptr);
+
+  // The array has a slot for each type, so indexes that would share a slot in a hashed array
+  // are both kept.
+  dex::TypeIndex index1(1u);
+  dex::TypeIndex index2(1u + DexCache::kDexCacheTypeCacheSize);
+  dex_cache->SetResolvedType(index1, klass.Get());
+  EXPECT_EQ(java_lang_dex_file_->NumTypeIds(), dex_cache->NumResolvedTypes());
+  dex_cache->SetResolvedType(index2, klass.Get());
+  EXPECT_EQ(klass.Get(), dex_cache->GetResolvedType(index1));
+  EXPECT_EQ(klass.Get(), dex_cache->GetResolvedType(index2));
+  EXPECT_TRUE(dex_cache->GetResolvedType(dex::TypeIndex(2u)) == nullptr);
+
+  DexCacheArrayStats* stats = DexCache::GetArrayStats(dex_cache->GetResolvedTypes());
+  EXPECT_EQ(2u, stats->hits.load());
+  EXPECT_EQ(1u, stats->misses.load());
+  EXPECT_EQ(0u, stats->evictions.load());
+}
+
 TEST_F(DexCacheTest, TestResolvedFieldAccess) {
   ScopedObjectAccess soa(Thread::Current());
   jobject jclass_loader(LoadDex("Packages"));
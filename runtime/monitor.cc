@@ -23,6 +23,7 @@
 #include "art_method-inl.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex.h"
+#include "base/utils.h"
 #include "base/quasi_atomic.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -35,6 +36,7 @@
 #include "lock_word-inl.h"
 #include "mirror/class-inl.h"
 #include "mirror/object-inl.h"
+#include "monitor_contention_profiler.h"
 #include "object_callbacks.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
@@ -97,6 +99,8 @@ void Monitor::Init(uint32_t lock_profiling_threshold,
 Monitor::Monitor(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_t hash_code)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      spin_failures_(0u),
+      idle_state_(IdleState::kUsed),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -131,6 +135,8 @@ Monitor::Monitor(Thread* self,
                  MonitorId id)
     : monitor_lock_("a monitor lock", kMonitorLock),
       num_waiters_(0),
+      spin_failures_(0u),
+      idle_state_(IdleState::kUsed),
       owner_(owner),
       lock_count_(0),
       obj_(GcRoot<mirror::Object>(obj)),
@@ -443,10 +449,33 @@ bool Monitor::TryLock(Thread* self, bool spin) {
   return true;
 }
 
+void Monitor::RecordSpinOutcome(bool acquired, bool spun) {
+  uint32_t failures = spin_failures_.load(std::memory_order_relaxed);
+  if (spun && acquired) {
+    if (failures != 0u) {
+      spin_failures_.store(0u, std::memory_order_relaxed);
+    }
+    return;
+  }
+  ++failures;
+  if (failures == kMaxSpinFailures + kSpinRetryPeriod) {
+    // Let the next contended acquisition spin again.
+    failures = kMaxSpinFailures - 1u;
+  }
+  spin_failures_.store(failures, std::memory_order_relaxed);
+}
+
 template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   bool called_monitors_callback = false;
-  if (TryLock(self, /*spin=*/ true)) {
+  // Recursive acquisitions never spin, and say nothing about the contention on the monitor.
+  const bool recursive = owner_.load(std::memory_order_relaxed) == self;
+  const bool spin = ShouldSpin();
+  const bool acquired = TryLock(self, spin);
+  if (!recursive) {
+    RecordSpinOutcome(acquired, spin);
+  }
+  if (acquired) {
     // TODO: This preserves original behavior. Correct?
     if (called_monitors_callback) {
       CHECK(reason == LockReason::kForLock);
@@ -457,10 +486,14 @@ void Monitor::Lock(Thread* self) {
   // Contended; not reentrant. We hold no locks, so tread carefully.
   const bool log_contention = (lock_profiling_threshold_ != 0);
   uint64_t wait_start_ms = log_contention ? MilliTime() : 0;
+  MonitorContentionProfiler* const contention_profiler =
+      (reason == LockReason::kForLock) ? Runtime::Current()->GetMonitorContentionProfiler()
+                                       : nullptr;
+  uint64_t wait_start_ns = (contention_profiler != nullptr) ? NanoTime() : 0u;
 
   Thread *orig_owner = nullptr;
-  ArtMethod* owners_method;
-  uint32_t owners_dex_pc;
+  ArtMethod* owners_method = nullptr;
+  uint32_t owners_dex_pc = 0u;
 
   // Do this before releasing the mutator lock so that we don't get deflated.
   size_t num_waiters = num_waiters_.fetch_add(1, std::memory_order_relaxed);
@@ -498,7 +531,7 @@ void Monitor::Lock(Thread* self) {
       Locks::thread_list_lock_->ExclusiveUnlock(self);
     }
   }
-  if (log_contention) {
+  if (log_contention || contention_profiler != nullptr) {
     // Request the current holder to set lock_owner_info.
     // Do this even if tracing is enabled, so we semi-consistently get the information
     // corresponding to MonitorExit.
@@ -507,6 +540,12 @@ void Monitor::Lock(Thread* self) {
     orig_owner = owner_.load(std::memory_order_relaxed);
     lock_owner_request_.store(orig_owner, std::memory_order_relaxed);
   }
+  ArtMethod* waiter_method = nullptr;
+  uint32_t waiter_dex_pc = 0u;
+  if (contention_profiler != nullptr) {
+    // Walk the stack before blocking rather than once we hold the monitor.
+    waiter_method = self->GetCurrentMethod(&waiter_dex_pc);
+  }
   // Call the contended locking cb once and only once. Also only call it if we are locking for
   // the first time, not during a Wait wakeup.
   if (reason == LockReason::kForLock && !called_monitors_callback) {
@@ -523,6 +562,14 @@ void Monitor::Lock(Thread* self) {
     // touching monitors shortly after we suspend, so don't spin again here.
     monitor_lock_.ExclusiveLock(self);
 
+    if (orig_owner != nullptr && (log_contention || contention_profiler != nullptr)) {
+      // Read what the owner recorded when releasing the monitor once, for both the contention
+      // log and the contention profiler. It's possible another thread snuck in in the middle,
+      // and tracing was enabled. In that case, we may get its MonitorEnter information. We can
+      // live with that.
+      GetLockOwnerInfo(&owners_method, &owners_dex_pc, orig_owner);
+    }
+
     if (log_contention && orig_owner != nullptr) {
       // Woken from contention.
       uint64_t wait_ms = MilliTime() - wait_start_ms;
@@ -533,11 +580,6 @@ void Monitor::Lock(Thread* self) {
         sample_percent = 100 * wait_ms / lock_profiling_threshold_;
       }
       if (sample_percent != 0 && (static_cast<uint32_t>(rand() % 100) < sample_percent)) {
-        // Do this unconditionally for consistency. It's possible another thread
-        // snuck in in the middle, and tracing was enabled. In that case, we may get its
-        // MonitorEnter information. We can live with that.
-        GetLockOwnerInfo(&owners_method, &owners_dex_pc, orig_owner);
-
         // Reacquire mutator_lock_ for logging.
         ScopedObjectAccess soa(self);
 
@@ -634,6 +676,15 @@ void Monitor::Lock(Thread* self) {
   if (started_trace) {
     ATraceEnd();
   }
+  if (contention_profiler != nullptr) {
+    // The owner info was read when acquiring monitor_lock_.
+    contention_profiler->AddSample(GetObject()->GetClass(),
+                                   orig_owner != nullptr ? owners_method : nullptr,
+                                   orig_owner != nullptr ? owners_dex_pc : 0u,
+                                   waiter_method,
+                                   waiter_dex_pc,
+                                   NanoTime() - wait_start_ns);
+  }
   self->SetMonitorEnterObject(nullptr);
   num_waiters_.fetch_sub(1, std::memory_order_relaxed);
   DCHECK(monitor_lock_.IsExclusiveHeld(self));
@@ -752,6 +803,7 @@ bool Monitor::Unlock(Thread* self) {
     AtraceMonitorUnlock();
     if (lock_count_ == 0) {
       owner_.store(nullptr, std::memory_order_relaxed);
+      idle_state_.store(IdleState::kUsed, std::memory_order_relaxed);
       SignalWaiterAndReleaseMonitorLock(self);
     } else {
       --lock_count_;
@@ -993,7 +1045,22 @@ void Monitor::NotifyAll(Thread* self) {
   }
 }
 
-bool Monitor::Deflate(Thread* self, ObjPtr<mirror::Object> obj) {
+bool Monitor::MarkIdle() {
+  // Unlock() may concurrently reset the state, in which case the monitor stays in use.
+  IdleState state = idle_state_.load(std::memory_order_relaxed);
+  if (state == IdleState::kUsed) {
+    idle_state_.compare_exchange_strong(state, IdleState::kMarked, std::memory_order_relaxed);
+    return false;
+  }
+  if (state == IdleState::kMarked &&
+      !idle_state_.compare_exchange_strong(state, IdleState::kIdle, std::memory_order_relaxed)) {
+    return false;
+  }
+  return owner_.load(std::memory_order_relaxed) == nullptr &&
+         num_waiters_.load(std::memory_order_relaxed) == 0u;
+}
+
+bool Monitor::Deflate(Thread* self, ObjPtr<mirror::Object> obj, bool only_idle) {
   DCHECK(obj != nullptr);
   // Don't need volatile since we only deflate with mutators suspended.
   LockWord lw(obj->GetLockWord(false));
@@ -1005,6 +1072,9 @@ bool Monitor::Deflate(Thread* self, ObjPtr<mirror::Object> obj) {
     if (monitor->num_waiters_.load(std::memory_order_relaxed) > 0) {
       return false;
     }
+    if (only_idle && monitor->idle_state_.load(std::memory_order_relaxed) != IdleState::kIdle) {
+      return false;
+    }
     if (!monitor->monitor_lock_.ExclusiveTryLock(self)) {
       // We cannot deflate a monitor that's currently held. It's unclear whether we should if
       // we could.
@@ -1094,6 +1164,23 @@ static ObjPtr<mirror::Object> FakeLock(ObjPtr<mirror::Object> obj)
   return obj;
 }
 
+// Whether the thread owning a thin lock is running Java code, and so likely to release the lock
+// soon. Spinning on a lock held by a thread that is blocked, waiting, suspended or in native code
+// only delays the inflation. The owner may exit as soon as it releases the lock, so it can only be
+// looked at under the thread list lock. Spinning threads never wait for that global lock: if it
+// is held, assume the owner is running and let the spin bound apply.
+static bool IsThinLockOwnerRunnable(Thread* self, uint32_t owner_thread_id)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (!Locks::thread_list_lock_->ExclusiveTryLock(self)) {
+    return true;
+  }
+  Thread* owner = Runtime::Current()->GetThreadList()->FindThreadByThreadId(owner_thread_id);
+  // A missing owner means we read a stale lock word, retry as if the owner was running.
+  bool runnable = owner == nullptr || owner->GetState() == ThreadState::kRunnable;
+  Locks::thread_list_lock_->ExclusiveUnlock(self);
+  return runnable;
+}
+
 // Fool annotalysis into thinking that the lock on obj is release.
 static ObjPtr<mirror::Object> FakeUnlock(ObjPtr<mirror::Object> obj)
     UNLOCK_FUNCTION(obj.Ptr()) NO_THREAD_SAFETY_ANALYSIS {
@@ -1110,6 +1197,8 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
   uint32_t thread_id = self->GetThreadId();
   size_t contention_count = 0;
   constexpr size_t kExtraSpinIters = 100;
+  // The owner whose state was last checked while spinning.
+  uint32_t checked_owner_thread_id = ThreadList::kInvalidThreadId;
   StackHandleScope<1> hs(self);
   Handle<mirror::Object> h_obj(hs.NewHandle(obj));
   while (true) {
@@ -1165,8 +1254,17 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
           // Contention.
           contention_count++;
           Runtime* runtime = Runtime::Current();
-          if (contention_count
-              <= kExtraSpinIters + runtime->GetMaxSpinsBeforeThinLockInflation()) {
+          const size_t max_spins = kExtraSpinIters + runtime->GetMaxSpinsBeforeThinLockInflation();
+          // Check the state of the owner when we start spinning on it, and once more before we
+          // start yielding.
+          if ((owner_thread_id != checked_owner_thread_id ||
+               contention_count == kExtraSpinIters) &&
+              !IsThinLockOwnerRunnable(self, owner_thread_id)) {
+            // Do not spin for an owner which is not running, inflate right away.
+            contention_count = max_spins + 1u;
+          }
+          checked_owner_thread_id = owner_thread_id;
+          if (contention_count <= max_spins) {
             // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
             // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much longer
             // than the parameter you pass in. This can cause thread suspension to take excessively
@@ -1600,7 +1698,9 @@ uint32_t Monitor::GetOwnerThreadId() {
 
 MonitorList::MonitorList()
     : allow_new_monitors_(true), monitor_list_lock_("MonitorList lock", kMonitorListLock),
-      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_) {
+      monitor_add_condition_("MonitorList disallow condition", monitor_list_lock_),
+      deflation_passes_(0),
+      deflated_monitors_(0) {
 }
 
 MonitorList::~MonitorList() {
@@ -1674,13 +1774,25 @@ size_t MonitorList::Size() {
   return list_.size();
 }
 
+size_t MonitorList::MarkIdleMonitors() {
+  MutexLock mu(Thread::Current(), monitor_list_lock_);
+  size_t idle_count = 0;
+  for (Monitor* monitor : list_) {
+    if (monitor->MarkIdle()) {
+      ++idle_count;
+    }
+  }
+  return idle_count;
+}
+
 class MonitorDeflateVisitor : public IsMarkedVisitor {
  public:
-  MonitorDeflateVisitor() : self_(Thread::Current()), deflate_count_(0) {}
+  explicit MonitorDeflateVisitor(bool only_idle)
+      : self_(Thread::Current()), only_idle_(only_idle), deflate_count_(0) {}
 
   mirror::Object* IsMarked(mirror::Object* object) override
       REQUIRES_SHARED(Locks::mutator_lock_) {
-    if (Monitor::Deflate(self_, object)) {
+    if (Monitor::Deflate(self_, object, only_idle_)) {
       DCHECK_NE(object->GetLockWord(true).GetState(), LockWord::kFatLocked);
       ++deflate_count_;
       // If we deflated, return null so that the monitor gets removed from the array.
@@ -1690,16 +1802,28 @@ class MonitorDeflateVisitor : public IsMarkedVisitor {
   }
 
   Thread* const self_;
+  const bool only_idle_;
   size_t deflate_count_;
 };
 
-size_t MonitorList::DeflateMonitors() {
-  MonitorDeflateVisitor visitor;
+size_t MonitorList::DeflateMonitors(bool only_idle) {
+  MonitorDeflateVisitor visitor(only_idle);
   Locks::mutator_lock_->AssertExclusiveHeld(visitor.self_);
   SweepMonitorList(&visitor);
+  MutexLock mu(visitor.self_, monitor_list_lock_);
+  ++deflation_passes_;
+  deflated_monitors_ += visitor.deflate_count_;
   return visitor.deflate_count_;
 }
 
+void MonitorList::DumpForSigQuit(std::ostream& os) {
+  MutexLock mu(Thread::Current(), monitor_list_lock_);
+  // Deflated monitors go back to the MonitorPool free list, they are not returned to the system.
+  os << "Monitors: " << list_.size() << " inflated, " << deflated_monitors_ << " deflated in "
+     << deflation_passes_ << " passes, " << PrettySize(deflated_monitors_ * sizeof(Monitor))
+     << " reclaimed\n";
+}
+
 MonitorInfo::MonitorInfo(ObjPtr<mirror::Object> obj) : owner_(nullptr), entry_count_(0) {
   DCHECK(obj != nullptr);
   LockWord lock_word = obj->GetLockWord(true);
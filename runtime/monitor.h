@@ -161,7 +161,8 @@ class Monitor {
   // Not exclusive because ImageWriter calls this during a Heap::VisitObjects() that
   // does not allow a thread suspension in the middle. TODO: maybe make this exclusive.
   // NO_THREAD_SAFETY_ANALYSIS for monitor->monitor_lock_.
-  static bool Deflate(Thread* self, ObjPtr<mirror::Object> obj)
+  // If only_idle is true, only deflate monitors that MonitorList::MarkIdleMonitors() found idle.
+  static bool Deflate(Thread* self, ObjPtr<mirror::Object> obj, bool only_idle = false)
       REQUIRES_SHARED(Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS;
 
 #ifndef __LP64__
@@ -225,6 +226,16 @@ class Monitor {
       REQUIRES(!Locks::thread_list_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Whether to spin before blocking on the monitor lock. Spinning only pays off when the owner
+  // releases the lock quickly, so we stop spinning on monitors where it keeps failing, and only
+  // try again once in a while in case the behavior of the owner changed.
+  bool ShouldSpin() const {
+    return spin_failures_.load(std::memory_order_relaxed) < kMaxSpinFailures;
+  }
+
+  // Record whether the last spinning attempt acquired the lock. Racy, this is only a hint.
+  void RecordSpinOutcome(bool acquired, bool spun);
+
   // Try to lock without blocking, returns true if we acquired the lock.
   // If spin is true, then we spin for a short period before failing.
   bool TryLock(Thread* self, bool spin = false)
@@ -324,6 +335,20 @@ class Monitor {
   // monitor acquisition. Prevents deflation.
   std::atomic<size_t> num_waiters_;
 
+  // Number of consecutive contended acquisitions where spinning did not get the lock, see
+  // ShouldSpin().
+  static constexpr uint32_t kMaxSpinFailures = 4u;
+  static constexpr uint32_t kSpinRetryPeriod = 16u;
+  std::atomic<uint32_t> spin_failures_;
+
+  // Whether the monitor has been unlocked since the previous idle marking passes, see MarkIdle().
+  enum class IdleState : uint8_t {
+    kUsed,    // Unlocked since the last pass.
+    kMarked,  // Not unlocked since the last pass.
+    kIdle,    // Not unlocked during a whole interval between two passes.
+  };
+  std::atomic<IdleState> idle_state_;
+
   // Which thread currently owns the lock? monitor_lock_ only keeps the tid.
   // Only set while holding monitor_lock_. Non-locking readers only use it to
   // compare to self or for debugging.
@@ -421,6 +446,10 @@ class Monitor {
 
   void MaybeEnableTimeout() REQUIRES(Locks::mutator_lock_);
 
+  // Advance the idle state of the monitor, without suspending mutators. Returns whether the
+  // monitor stayed unused for a whole interval between two calls and could be deflated.
+  bool MarkIdle();
+
   // The denser encoded version of this monitor as stored in the lock word.
   MonitorId monitor_id_;
 
@@ -448,9 +477,15 @@ class MonitorList {
   void DisallowNewMonitors() REQUIRES(!monitor_list_lock_);
   void AllowNewMonitors() REQUIRES(!monitor_list_lock_);
   void BroadcastForNewMonitors() REQUIRES(!monitor_list_lock_);
-  // Returns how many monitors were deflated.
-  size_t DeflateMonitors() REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
+  // Returns how many monitors were deflated. If only_idle is true, only deflate the monitors
+  // that MarkIdleMonitors() found idle.
+  size_t DeflateMonitors(bool only_idle = false)
+      REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
+  // Advance the idle state of the monitors without suspending mutators, see Monitor::MarkIdle().
+  // Returns how many monitors are idle, as a cheap estimate of what an idle deflation would free.
+  size_t MarkIdleMonitors() REQUIRES(!monitor_list_lock_);
   size_t Size() REQUIRES(!monitor_list_lock_);
+  void DumpForSigQuit(std::ostream& os) REQUIRES(!monitor_list_lock_);
 
   using Monitors = std::list<Monitor*, TrackingAllocator<Monitor*, kAllocatorTagMonitorList>>;
 
@@ -464,6 +499,10 @@ class MonitorList {
   ConditionVariable monitor_add_condition_ GUARDED_BY(monitor_list_lock_);
   Monitors list_ GUARDED_BY(monitor_list_lock_);
 
+  // Deflation statistics, reported on SIGQUIT.
+  size_t deflation_passes_ GUARDED_BY(monitor_list_lock_);
+  size_t deflated_monitors_ GUARDED_BY(monitor_list_lock_);
+
   friend class Monitor;
   DISALLOW_COPY_AND_ASSIGN(MonitorList);
 };
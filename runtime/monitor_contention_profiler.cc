@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_contention_profiler.h"
+
+#include <ostream>
+
+#include "art_method-inl.h"
+#include "base/time_utils.h"
+#include "class_linker.h"
+#include "dex/dex_file-inl.h"
+#include "dex/primitive.h"
+#include "linear_alloc.h"
+#include "mirror/class-inl.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+MonitorContentionProfiler::MonitorContentionProfiler(size_t capacity)
+    : capacity_(capacity),
+      samples_(new RawSample[capacity]()),
+      total_samples_(0u),
+      total_wait_ns_(0u),
+      lock_("Monitor contention profiler lock", kProfilerLock) {
+  DCHECK_NE(capacity, 0u);
+}
+
+bool MonitorContentionProfiler::BeginWrite(RawSample* raw, /*out*/ uint64_t* sequence) {
+  uint64_t old_sequence = raw->sequence.load(std::memory_order_relaxed);
+  if ((old_sequence & 1u) != 0u ||
+      !raw->sequence.compare_exchange_strong(
+          old_sequence, old_sequence + 1u, std::memory_order_relaxed)) {
+    return false;
+  }
+  // Make the odd sequence visible before any of the new fields.
+  std::atomic_thread_fence(std::memory_order_release);
+  *sequence = old_sequence;
+  return true;
+}
+
+void MonitorContentionProfiler::AddSample(ObjPtr<mirror::Class> monitor_class,
+                                          ArtMethod* owner_method,
+                                          uint32_t owner_dex_pc,
+                                          ArtMethod* waiter_method,
+                                          uint32_t waiter_dex_pc,
+                                          uint64_t wait_ns) {
+  total_wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+  uint64_t index = total_samples_.fetch_add(1u, std::memory_order_relaxed);
+  RawSample* raw = &samples_[index % capacity_];
+  uint64_t sequence;
+  if (!BeginWrite(raw, &sequence)) {
+    return;  // Another thread is still writing this slot, drop the sample.
+  }
+  // Classes can move, keep where their descriptor comes from instead.
+  uint32_t dimensions = 0u;
+  while (monitor_class->IsArrayClass()) {
+    ++dimensions;
+    monitor_class = monitor_class->GetComponentType();
+  }
+  const DexFile* dex_file = nullptr;
+  uint32_t class_index = static_cast<uint32_t>(Primitive::kPrimNot);
+  if (monitor_class->IsPrimitive()) {
+    class_index = static_cast<uint32_t>(monitor_class->GetPrimitiveType());
+  } else if (!monitor_class->IsProxyClass()) {
+    dex_file = &monitor_class->GetDexFile();
+    class_index = monitor_class->GetDexTypeIndex().index_;
+  }
+  raw->class_dex_file.store(dex_file, std::memory_order_relaxed);
+  raw->class_index.store(class_index, std::memory_order_relaxed);
+  raw->class_dimensions.store(dimensions, std::memory_order_relaxed);
+  raw->owner_method.store(owner_method, std::memory_order_relaxed);
+  raw->owner_dex_pc.store(owner_dex_pc, std::memory_order_relaxed);
+  raw->waiter_method.store(waiter_method, std::memory_order_relaxed);
+  raw->waiter_dex_pc.store(waiter_dex_pc, std::memory_order_relaxed);
+  raw->wait_ns.store(wait_ns, std::memory_order_relaxed);
+  raw->sequence.store(sequence + 2u, std::memory_order_release);
+}
+
+bool MonitorContentionProfiler::ReadSample(const RawSample& raw, /*out*/ Sample* sample) const {
+  uint64_t sequence = raw.sequence.load(std::memory_order_acquire);
+  if (sequence == 0u || (sequence & 1u) != 0u) {
+    return false;
+  }
+  const DexFile* dex_file = raw.class_dex_file.load(std::memory_order_relaxed);
+  uint32_t class_index = raw.class_index.load(std::memory_order_relaxed);
+  uint32_t dimensions = raw.class_dimensions.load(std::memory_order_relaxed);
+  ArtMethod* owner_method = raw.owner_method.load(std::memory_order_relaxed);
+  uint32_t owner_dex_pc = raw.owner_dex_pc.load(std::memory_order_relaxed);
+  ArtMethod* waiter_method = raw.waiter_method.load(std::memory_order_relaxed);
+  uint32_t waiter_dex_pc = raw.waiter_dex_pc.load(std::memory_order_relaxed);
+  uint64_t wait_ns = raw.wait_ns.load(std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (raw.sequence.load(std::memory_order_relaxed) != sequence) {
+    return false;  // Overwritten while we were reading it.
+  }
+
+  sample->monitor_class = std::string(dimensions, '[');
+  if (dex_file != nullptr) {
+    // The dex file goes away with the class loader of the class.
+    if (!Runtime::Current()->GetClassLinker()->IsDexFileRegistered(Thread::Current(), *dex_file)) {
+      return false;
+    }
+    sample->monitor_class += dex_file->StringByTypeIdx(dex::TypeIndex(class_index));
+  } else if (class_index != static_cast<uint32_t>(Primitive::kPrimNot)) {
+    sample->monitor_class += Primitive::Descriptor(static_cast<Primitive::Type>(class_index));
+  } else {
+    sample->monitor_class += "<proxy>";
+  }
+  sample->owner_method = (owner_method != nullptr) ? owner_method->PrettyMethod() : "";
+  sample->owner_dex_pc = owner_dex_pc;
+  sample->waiter_method = ArtMethod::PrettyMethod(waiter_method);
+  sample->waiter_dex_pc = waiter_dex_pc;
+  sample->wait_ns = wait_ns;
+  return true;
+}
+
+std::vector<MonitorContentionProfiler::Sample> MonitorContentionProfiler::GetSamples() const {
+  MutexLock mu(Thread::Current(), lock_);
+  std::vector<Sample> samples;
+  size_t next = total_samples_.load(std::memory_order_relaxed) % capacity_;
+  for (size_t i = 0; i != capacity_; ++i) {
+    Sample sample;
+    if (ReadSample(samples_[(next + i) % capacity_], &sample)) {
+      samples.push_back(std::move(sample));
+    }
+  }
+  return samples;
+}
+
+void MonitorContentionProfiler::Dump(std::ostream& os) const {
+  ScopedObjectAccess soa(Thread::Current());
+  os << "Monitor contention: " << GetTotalSamples() << " contended acquisitions, waited "
+     << PrettyDuration(total_wait_ns_.load(std::memory_order_relaxed)) << "\n";
+  for (const Sample& sample : GetSamples()) {
+    os << "  " << PrettyDuration(sample.wait_ns) << " on " << sample.monitor_class << " held by ";
+    if (sample.owner_method.empty()) {
+      os << "<unknown>";
+    } else {
+      os << sample.owner_method << " at dex pc " << sample.owner_dex_pc;
+    }
+    os << " waited in " << sample.waiter_method << " at dex pc " << sample.waiter_dex_pc << "\n";
+  }
+}
+
+void MonitorContentionProfiler::RemoveSamplesIn(const LinearAlloc& alloc) {
+  MutexLock mu(Thread::Current(), lock_);
+  for (size_t i = 0; i != capacity_; ++i) {
+    RawSample* raw = &samples_[i];
+    if (!alloc.ContainsUnsafe(raw->owner_method.load(std::memory_order_relaxed)) &&
+        !alloc.ContainsUnsafe(raw->waiter_method.load(std::memory_order_relaxed))) {
+      continue;
+    }
+    // A thread writing the slot concurrently replaces the sample anyway.
+    uint64_t sequence;
+    if (BeginWrite(raw, &sequence)) {
+      raw->owner_method.store(nullptr, std::memory_order_relaxed);
+      raw->waiter_method.store(nullptr, std::memory_order_relaxed);
+      // Back to the never written state, so that readers skip the slot.
+      raw->sequence.store(0u, std::memory_order_release);
+    }
+  }
+}
+
+}  // namespace art
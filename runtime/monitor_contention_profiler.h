@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_MONITOR_CONTENTION_PROFILER_H_
+#define ART_RUNTIME_MONITOR_CONTENTION_PROFILER_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "obj_ptr.h"
+
+namespace art {
+
+class ArtMethod;
+class DexFile;
+class LinearAlloc;
+
+namespace mirror {
+class Class;
+}  // namespace mirror
+
+// Keeps the most recent contended monitor acquisitions in a ring buffer, for SIGQUIT dumps and
+// JVMTI. Unlike the lock contention logging of -Xlockprofthreshold, every contended acquisition
+// is recorded, whatever its duration.
+//
+// Recording a sample is lock-free and only stores raw method and dex file pointers, which are
+// symbolized when the samples are read. A sample is dropped if another thread is still writing
+// the same slot of the buffer.
+class MonitorContentionProfiler {
+ public:
+  struct Sample {
+    // Descriptor of the class of the contended object.
+    std::string monitor_class;
+    // Method holding the monitor, or empty if the owner did not report it in time.
+    std::string owner_method;
+    uint32_t owner_dex_pc;
+    // Method waiting for the monitor.
+    std::string waiter_method;
+    uint32_t waiter_dex_pc;
+    uint64_t wait_ns;
+  };
+
+  explicit MonitorContentionProfiler(size_t capacity);
+
+  void AddSample(ObjPtr<mirror::Class> monitor_class,
+                 ArtMethod* owner_method,
+                 uint32_t owner_dex_pc,
+                 ArtMethod* waiter_method,
+                 uint32_t waiter_dex_pc,
+                 uint64_t wait_ns)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Return the samples in the buffer, oldest first.
+  std::vector<Sample> GetSamples() const REQUIRES(!lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Number of samples recorded since startup, including the ones overwritten or dropped.
+  uint64_t GetTotalSamples() const {
+    return total_samples_.load(std::memory_order_relaxed);
+  }
+
+  void Dump(std::ostream& os) const REQUIRES(!lock_);
+
+  // Drop the samples with methods allocated in `alloc`, which belongs to a class loader being
+  // unloaded.
+  void RemoveSamplesIn(const LinearAlloc& alloc) REQUIRES(!lock_);
+
+ private:
+  // A sample, written with the fields below it and read with a sequence lock.
+  struct RawSample {
+    // Odd while the sample is being written, zero if it was never written.
+    std::atomic<uint64_t> sequence;
+    // Dex file and type index of the class of the contended object, or of its innermost
+    // component type for arrays. The dex file is null for primitive component types, whose
+    // type is then stored instead of the type index, and for proxies.
+    std::atomic<const DexFile*> class_dex_file;
+    std::atomic<uint32_t> class_index;
+    std::atomic<uint32_t> class_dimensions;
+    std::atomic<ArtMethod*> owner_method;
+    std::atomic<uint32_t> owner_dex_pc;
+    std::atomic<ArtMethod*> waiter_method;
+    std::atomic<uint32_t> waiter_dex_pc;
+    std::atomic<uint64_t> wait_ns;
+  };
+
+  // Claim `raw` for writing and return its previous sequence, or return false if another thread
+  // is writing it.
+  static bool BeginWrite(RawSample* raw, /*out*/ uint64_t* sequence);
+
+  // Symbolize `raw`. Returns false if it is being written or no longer describes a valid sample.
+  bool ReadSample(const RawSample& raw, /*out*/ Sample* sample) const
+      REQUIRES(lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  const size_t capacity_;
+  const std::unique_ptr<RawSample[]> samples_;
+  // Number of samples added, the next sample goes to slot `total_samples_ % capacity_`.
+  std::atomic<uint64_t> total_samples_;
+  std::atomic<uint64_t> total_wait_ns_;
+  // Serializes readers with the removal of the samples of unloaded class loaders.
+  mutable Mutex lock_;
+
+  DISALLOW_COPY_AND_ASSIGN(MonitorContentionProfiler);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_MONITOR_CONTENTION_PROFILER_H_
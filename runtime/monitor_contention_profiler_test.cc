@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "monitor_contention_profiler.h"
+
+#include <sstream>
+
+#include "art_method-inl.h"
+#include "class_root-inl.h"
+#include "common_runtime_test.h"
+#include "mirror/class-inl.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+class MonitorContentionProfilerTest : public CommonRuntimeTest {};
+
+TEST_F(MonitorContentionProfilerTest, RingBuffer) {
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> object_class = GetClassRoot<mirror::Object>();
+  ObjPtr<mirror::Class> string_class = GetClassRoot<mirror::String>();
+  MonitorContentionProfiler profiler(/* capacity= */ 2u);
+  EXPECT_TRUE(profiler.GetSamples().empty());
+
+  profiler.AddSample(object_class, nullptr, 0u, nullptr, 0u, 1u);
+  profiler.AddSample(string_class, nullptr, 0u, nullptr, 0u, 2u);
+  profiler.AddSample(object_class, nullptr, 0u, nullptr, 0u, 3u);
+  EXPECT_EQ(profiler.GetTotalSamples(), 3u);
+
+  // The oldest sample was overwritten, the others come oldest first.
+  std::vector<MonitorContentionProfiler::Sample> samples = profiler.GetSamples();
+  ASSERT_EQ(samples.size(), 2u);
+  EXPECT_EQ(samples[0].wait_ns, 2u);
+  EXPECT_EQ(samples[0].monitor_class, "Ljava/lang/String;");
+  EXPECT_EQ(samples[1].wait_ns, 3u);
+  EXPECT_EQ(samples[1].monitor_class, "Ljava/lang/Object;");
+  EXPECT_TRUE(samples[1].owner_method.empty());
+
+  std::ostringstream oss;
+  profiler.Dump(oss);
+  EXPECT_NE(oss.str().find("3 contended acquisitions"), std::string::npos) << oss.str();
+  EXPECT_NE(oss.str().find("Ljava/lang/String;"), std::string::npos) << oss.str();
+}
+
+TEST_F(MonitorContentionProfilerTest, Symbolize) {
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> object_class = GetClassRoot<mirror::Object>();
+  ArtMethod* method = &object_class->GetDirectMethodsSlice(kRuntimePointerSize)[0];
+  MonitorContentionProfiler profiler(/* capacity= */ 4u);
+
+  // Samples only keep raw pointers, the names are built when reading them.
+  profiler.AddSample(GetClassRoot(ClassRoot::kObjectArrayClass), method, 1u, method, 2u, 3u);
+  profiler.AddSample(GetClassRoot(ClassRoot::kIntArrayClass), nullptr, 0u, method, 4u, 5u);
+  std::vector<MonitorContentionProfiler::Sample> samples = profiler.GetSamples();
+  ASSERT_EQ(samples.size(), 2u);
+  EXPECT_EQ(samples[0].monitor_class, "[Ljava/lang/Object;");
+  EXPECT_EQ(samples[0].owner_method, method->PrettyMethod());
+  EXPECT_EQ(samples[0].owner_dex_pc, 1u);
+  EXPECT_EQ(samples[0].waiter_method, method->PrettyMethod());
+  EXPECT_EQ(samples[0].waiter_dex_pc, 2u);
+  EXPECT_EQ(samples[1].monitor_class, "[I");
+  EXPECT_TRUE(samples[1].owner_method.empty());
+  EXPECT_EQ(samples[1].wait_ns, 5u);
+}
+
+}  // namespace art
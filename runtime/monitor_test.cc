@@ -25,10 +25,12 @@
 #include "class_linker-inl.h"
 #include "common_runtime_test.h"
 #include "handle_scope-inl.h"
+#include "lock_word.h"
 #include "mirror/class-inl.h"
 #include "mirror/string-inl.h"  // Strings are easiest to allocate
 #include "object_lock.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_list.h"
 #include "thread_pool.h"
 
 namespace art {
@@ -375,5 +377,52 @@ TEST_F(MonitorTest, TestTryLock) {
   thread_pool.StopWorkers(self);
 }
 
+// Test that idle deflation only deflates monitors that stayed unused between two marking passes.
+TEST_F(MonitorTest, DeflateIdleMonitors) {
+  Thread* const self = Thread::Current();
+  MonitorList* const monitor_list = Runtime::Current()->GetMonitorList();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "hello, world!")));
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    // Asking for the hash code of a thin-locked object inflates its lock.
+    obj->IdentityHashCode();
+  }
+  ASSERT_EQ(obj->GetLockWord(false).GetState(), LockWord::kFatLocked);
+  auto deflate_idle = [&]() {
+    ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+    ScopedSuspendAll ssa(__FUNCTION__);
+    monitor_list->DeflateMonitors(/*only_idle=*/ true);
+  };
+
+  // The monitor was used since it was inflated, the first pass only marks it.
+  monitor_list->MarkIdleMonitors();
+  deflate_idle();
+  EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kFatLocked);
+
+  // Using the monitor again keeps it inflated.
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+  }
+  monitor_list->MarkIdleMonitors();
+  deflate_idle();
+  EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kFatLocked);
+
+  // A held monitor is not idle.
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    monitor_list->MarkIdleMonitors();
+  }
+  deflate_idle();
+  EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kFatLocked);
+
+  // The monitor stayed unused between two passes, it gets deflated and keeps its hash code.
+  monitor_list->MarkIdleMonitors();
+  EXPECT_GE(monitor_list->MarkIdleMonitors(), 1u);
+  deflate_idle();
+  EXPECT_EQ(obj->GetLockWord(false).GetState(), LockWord::kHashCode);
+}
 
 }  // namespace art
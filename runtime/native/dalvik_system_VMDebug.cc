@@ -19,6 +19,7 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <limits>
 #include <sstream>
 
 #include "nativehelper/jni_macros.h"
@@ -38,6 +39,7 @@
 #include "hprof/hprof.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
+#include "jni/jni_transition_profiler.h"
 #include "mirror/array-alloc-inl.h"
 #include "mirror/array-inl.h"
 #include "mirror/class.h"
@@ -316,6 +318,7 @@ enum class VMDebugRuntimeStatId {
   kArtGcObjectsAllocated,
   kArtGcTotalTimeWaitingForGc,
   kArtGcPreOomeGcCount,
+  kArtJniTransitionProfile,
   kNumRuntimeStats,
 };
 
@@ -368,6 +371,15 @@ static jstring VMDebug_getRuntimeStatInternal(JNIEnv* env, jclass, jint statId)
       std::string output = std::to_string(heap->GetPreOomeGcCount());
       return env->NewStringUTF(output.c_str());
     }
+    case VMDebugRuntimeStatId::kArtJniTransitionProfile: {
+      JniTransitionProfiler* profiler = Runtime::Current()->GetJniTransitionProfiler();
+      if (profiler == nullptr) {
+        return nullptr;
+      }
+      std::ostringstream output;
+      profiler->Dump(output, /* max_methods= */ std::numeric_limits<size_t>::max());
+      return env->NewStringUTF(output.str().c_str());
+    }
     default:
       return nullptr;
   }
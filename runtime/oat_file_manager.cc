@@ -16,8 +16,11 @@
 
 #include "oat_file_manager.h"
 
+#include <functional>
 #include <memory>
 #include <queue>
+#include <sstream>
+#include <unordered_map>
 #include <vector>
 #include <sys/stat.h>
 
@@ -26,30 +29,39 @@
 #include "android-base/strings.h"
 
 #include "art_field-inl.h"
+#include "art_method-inl.h"
+#include "base/bit_utils.h"
 #include "base/bit_vector-inl.h"
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex-inl.h"
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
+#include "base/time_utils.h"
 #include "base/systrace.h"
-#include "class_linker.h"
+#include "class_linker-inl.h"
 #include "class_loader_context.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_tracking_registrar.h"
+#include "dex/dex_instruction-inl.h"
+#include "dex/dex_instruction_utils.h"
 #include "gc/scoped_gc_critical_section.h"
 #include "gc/space/image_space.h"
 #include "handle_scope-inl.h"
 #include "jit/jit.h"
 #include "jni/java_vm_ext.h"
 #include "jni/jni_internal.h"
+#include "mirror/class-inl.h"
 #include "mirror/class_loader.h"
+#include "mirror/iftable-inl.h"
+#include "mirror/dex_cache-inl.h"
 #include "mirror/object-inl.h"
 #include "oat_file.h"
 #include "oat_file_assistant.h"
 #include "obj_ptr-inl.h"
+#include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "thread_list.h"
@@ -806,16 +818,619 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
       GetVdexFilename(odex_filename)));
 }
 
+// Number of startup classes loaded and verified by a single preload task.
+static constexpr size_t kStartupClassPreloadBatchSize = 32;
+
+// Startup classes of an application, shared by the tasks preloading them.
+class StartupClassList {
+ public:
+  explicit StartupClassList(jobject class_loader) : class_loader_(class_loader) {}
+
+  ~StartupClassList() {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    soa.Vm()->DeleteGlobalRef(self, class_loader_);
+  }
+
+  jobject GetClassLoader() const {
+    return class_loader_;
+  }
+
+  const std::vector<std::pair<const DexFile*, dex::TypeIndex>>& GetClasses() const {
+    return classes_;
+  }
+
+  void AddClass(const DexFile* dex_file, dex::TypeIndex type_index) {
+    classes_.emplace_back(dex_file, type_index);
+  }
+
+ private:
+  const jobject class_loader_;
+  std::vector<std::pair<const DexFile*, dex::TypeIndex>> classes_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassList);
+};
+
+// Number of startup classes initialized by a single initialization task.
+static constexpr size_t kStartupClassInitBatchSize = 8;
+// Number of the slowest static initializers reported once all startup classes are initialized.
+static constexpr size_t kSlowestStartupClassInits = 5;
+
+// Whether the static initializer of `klass`, if any, only computes values from constants and
+// the static fields of `klass` and of classes already initialized. Such an initializer cannot
+// need another class to be initialized, so it cannot wait for another thread.
+static bool HasTrivialClassInitializer(ObjPtr<mirror::Class> klass)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ArtMethod* clinit = klass->FindClassInitializer(kRuntimePointerSize);
+  if (clinit == nullptr) {
+    return true;
+  }
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+  const DexFile& dex_file = klass->GetDexFile();
+  for (const DexInstructionPcPair& inst : clinit->DexInstructions()) {
+    Instruction::Code opcode = inst->Opcode();
+    if (IsInstructionSGetOrSPut(opcode)) {
+      // The field id may name `klass` for a field inherited from a superclass or an interface,
+      // so look at the class declaring the field. Fields that are not resolved yet and cannot be
+      // found without loading classes are not trivial.
+      ArtField* field =
+          class_linker->LookupResolvedField(inst->VRegB_21c(), clinit, /*is_static=*/ true);
+      if (field == nullptr ||
+          (field->GetDeclaringClass() != klass && !field->GetDeclaringClass()->IsInitialized())) {
+        return false;
+      }
+    } else if (opcode == Instruction::NEW_ARRAY) {
+      // Only arrays of primitives, their classes need no initialization.
+      const char* descriptor = dex_file.StringByTypeIdx(dex::TypeIndex(inst->VRegC_22c()));
+      if (Primitive::GetType(descriptor[1]) == Primitive::kPrimNot) {
+        return false;
+      }
+    } else if (IsInstructionAGetOrAPut(opcode)) {
+      if (opcode == Instruction::AGET_OBJECT || opcode == Instruction::APUT_OBJECT) {
+        return false;
+      }
+    } else if ((opcode >= Instruction::NEG_INT && opcode <= Instruction::USHR_INT_LIT8) ||
+               (opcode >= Instruction::CMPL_FLOAT && opcode <= Instruction::IF_LEZ) ||
+               (opcode >= Instruction::MOVE && opcode <= Instruction::MOVE_OBJECT_16) ||
+               (opcode >= Instruction::CONST_4 && opcode <= Instruction::CONST_STRING_JUMBO) ||
+               IsInstructionGoto(opcode)) {
+      // Moves, constants, strings, arithmetic and branches.
+    } else if (opcode != Instruction::NOP &&
+               opcode != Instruction::RETURN_VOID &&
+               opcode != Instruction::ARRAY_LENGTH &&
+               opcode != Instruction::FILL_ARRAY_DATA &&
+               opcode != Instruction::PACKED_SWITCH &&
+               opcode != Instruction::SPARSE_SWITCH) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether initializing `klass` only runs trivial static initializers, see above. This covers
+// its superclasses and the superinterfaces with default methods that are not initialized yet.
+static bool CanInitializeInParallel(ObjPtr<mirror::Class> klass)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  for (ObjPtr<mirror::Class> k = klass;
+       k != nullptr && !k->IsInitialized();
+       k = k->GetSuperClass()) {
+    if (!HasTrivialClassInitializer(k)) {
+      return false;
+    }
+  }
+  for (int32_t i = 0, count = klass->GetIfTableCount(); i != count; ++i) {
+    ObjPtr<mirror::Class> iface = klass->GetIfTable()->GetInterface(i);
+    if (!iface->IsInitialized() &&
+        iface->HasDefaultMethods() &&
+        !HasTrivialClassInitializer(iface)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs the static initializers of the startup classes once they are all loaded and verified.
+// Classes are grouped by their depth in the hierarchy of the startup classes, and a level is
+// only started once the previous one is done: a class is initialized after its startup
+// superclass and superinterfaces, so that the workers initialize independent subtrees in
+// parallel instead of waiting for each other on the class initialization locks. The class
+// linker still does the locking, so races with the application are resolved as usual.
+//
+// Only classes with trivial static initializers are initialized. Other static initializers may
+// use other classes, and a worker and the main thread, or two workers, initializing classes
+// that use each other would deadlock. These classes are left to the application, which
+// initializes them on first use as usual.
+class StartupClassInitializer : public std::enable_shared_from_this<StartupClassInitializer> {
+ public:
+  StartupClassInitializer(std::shared_ptr<const StartupClassList> classes,
+                          ThreadPool* thread_pool,
+                          size_t num_preload_tasks)
+      : classes_(std::move(classes)),
+        thread_pool_(thread_pool),
+        pending_tasks_(num_preload_tasks),
+        current_level_(0u),
+        lock_("Startup class initializer lock", kGenericBottomLock) {}
+
+  // Called when a preload task is done. The last one starts the initialization.
+  void PreloadTaskDone(Thread* self) REQUIRES(!Locks::mutator_lock_, !lock_);
+
+  // Called when an initialization task is done. The last one of a level starts the next level.
+  void InitializeTaskDone(Thread* self) REQUIRES(!lock_);
+
+  void InitializeClass(Thread* self, size_t index) REQUIRES(!Locks::mutator_lock_, !lock_);
+
+  // Whether the pool was stopped at the end of startup. No more classes are initialized then.
+  bool IsStopped(Thread* self) {
+    return thread_pool_->IsFinishing(self);
+  }
+
+ private:
+  void ComputeLevels(Thread* self) REQUIRES(!Locks::mutator_lock_);
+  void StartLevel(Thread* self, size_t level) REQUIRES(!lock_);
+  void LogTimings(Thread* self) REQUIRES(!lock_);
+
+  const std::shared_ptr<const StartupClassList> classes_;
+  // The pool running the tasks. Stopping the pool drops the levels not started yet.
+  ThreadPool* const thread_pool_;
+  std::atomic<size_t> pending_tasks_;
+  // Indices of the classes to initialize, by depth. Only written before the first level starts.
+  std::vector<std::vector<size_t>> levels_;
+  // Only accessed by the thread starting a level.
+  size_t current_level_;
+
+  Mutex lock_;
+  std::vector<std::pair<const char*, uint64_t>> timings_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassInitializer);
+};
+
+// Runs the static initializers of a batch of startup classes of the same level.
+class StartupClassInitTask final : public Task {
+ public:
+  StartupClassInitTask(std::shared_ptr<StartupClassInitializer> initializer,
+                       std::vector<size_t>&& indices)
+      : initializer_(std::move(initializer)), indices_(std::move(indices)) {}
+
+  void Run(Thread* self) override {
+    // Static initializers are application code. Run them like the application would, so that
+    // they can call into class loaders.
+    bool was_runtime_thread = self->IsRuntimeThread();
+    self->SetIsRuntimeThread(false);
+    for (size_t index : indices_) {
+      if (initializer_->IsStopped(self)) {
+        break;
+      }
+      initializer_->InitializeClass(self, index);
+    }
+    self->SetIsRuntimeThread(was_runtime_thread);
+    initializer_->InitializeTaskDone(self);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::shared_ptr<StartupClassInitializer> initializer_;
+  const std::vector<size_t> indices_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassInitTask);
+};
+
+void StartupClassInitializer::PreloadTaskDone(Thread* self) {
+  if (pending_tasks_.fetch_sub(1u) != 1u) {
+    return;
+  }
+  ComputeLevels(self);
+  StartLevel(self, 0u);
+}
+
+void StartupClassInitializer::ComputeLevels(Thread* self) {
+  ScopedTrace trace("Order startup class initialization");
+  ScopedObjectAccess soa(self);
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+  ObjPtr<mirror::ClassLoader> loader =
+      soa.Decode<mirror::ClassLoader>(classes_->GetClassLoader());
+  // Nothing below suspends, so the classes can be kept as raw pointers.
+  std::unordered_map<mirror::Class*, size_t> indices;
+  for (size_t i = 0; i != classes_->GetClasses().size(); ++i) {
+    const DexFile* dex_file = classes_->GetClasses()[i].first;
+    const char* descriptor = dex_file->StringByTypeIdx(classes_->GetClasses()[i].second);
+    ObjPtr<mirror::Class> klass = class_linker->LookupClass(self, descriptor, loader);
+    if (klass != nullptr &&
+        &klass->GetDexFile() == dex_file &&
+        klass->IsVerified() &&
+        !klass->IsInitialized()) {
+      indices.emplace(klass.Ptr(), i);
+    }
+  }
+
+  // The depth of a class is one more than the deepest of its superclass and interfaces that
+  // are startup classes, or zero if there is none.
+  std::unordered_map<mirror::Class*, size_t> depths;
+  std::function<size_t(ObjPtr<mirror::Class>)> get_depth =
+      [&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) -> size_t {
+    auto it = depths.find(klass.Ptr());
+    if (it != depths.end()) {
+      return it->second;
+    }
+    size_t depth = 0u;
+    auto visit_dependency = [&](ObjPtr<mirror::Class> dependency)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (dependency != nullptr && indices.find(dependency.Ptr()) != indices.end()) {
+        depth = std::max(depth, get_depth(dependency) + 1u);
+      }
+    };
+    visit_dependency(klass->GetSuperClass());
+    for (int32_t i = 0, count = klass->GetIfTableCount(); i != count; ++i) {
+      visit_dependency(klass->GetIfTable()->GetInterface(i));
+    }
+    depths.emplace(klass.Ptr(), depth);
+    return depth;
+  };
+  size_t num_skipped = 0u;
+  for (const auto& entry : indices) {
+    if (!CanInitializeInParallel(entry.first)) {
+      ++num_skipped;
+      continue;
+    }
+    size_t depth = get_depth(entry.first);
+    if (levels_.size() <= depth) {
+      levels_.resize(depth + 1u);
+    }
+    levels_[depth].push_back(entry.second);
+  }
+  VLOG(class_linker) << "Initializing " << (indices.size() - num_skipped)
+                     << " startup classes in " << levels_.size() << " levels, leaving "
+                     << num_skipped << " with non-trivial static initializers to the application";
+}
+
+void StartupClassInitializer::StartLevel(Thread* self, size_t level) {
+  if (IsStopped(self)) {
+    // Startup is completed, leave the remaining classes to the application.
+    LogTimings(self);
+    return;
+  }
+  while (level < levels_.size() && levels_[level].empty()) {
+    ++level;
+  }
+  if (level == levels_.size()) {
+    LogTimings(self);
+    return;
+  }
+  current_level_ = level;
+  const std::vector<size_t>& indices = levels_[level];
+  size_t num_tasks =
+      RoundUp(indices.size(), kStartupClassInitBatchSize) / kStartupClassInitBatchSize;
+  // Set the count before adding tasks, as they may complete before we are done adding them.
+  pending_tasks_.store(num_tasks);
+  for (size_t begin = 0; begin < indices.size(); begin += kStartupClassInitBatchSize) {
+    size_t end = std::min(begin + kStartupClassInitBatchSize, indices.size());
+    thread_pool_->AddTask(
+        self,
+        new StartupClassInitTask(
+            shared_from_this(),
+            std::vector<size_t>(indices.begin() + begin, indices.begin() + end)));
+  }
+}
+
+void StartupClassInitializer::InitializeTaskDone(Thread* self) {
+  if (pending_tasks_.fetch_sub(1u) == 1u) {
+    StartLevel(self, current_level_ + 1u);
+  }
+}
+
+void StartupClassInitializer::InitializeClass(Thread* self, size_t index) {
+  const DexFile* dex_file = classes_->GetClasses()[index].first;
+  const char* descriptor = dex_file->StringByTypeIdx(classes_->GetClasses()[index].second);
+  ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Class> h_class(hs.NewHandle(class_linker->LookupClass(
+      self, descriptor, soa.Decode<mirror::ClassLoader>(classes_->GetClassLoader()))));
+  if (h_class == nullptr || h_class->IsInitialized()) {
+    // The application got there first.
+    return;
+  }
+  uint64_t start_time = NanoTime();
+  class_linker->EnsureInitialized(self, h_class, /*can_init_fields=*/ true,
+                                  /*can_init_parents=*/ true);
+  uint64_t init_time = NanoTime() - start_time;
+  if (self->IsExceptionPending()) {
+    // The class is now erroneous, the application will get the error when it uses the class.
+    VLOG(class_linker) << "Failed to initialize startup class " << descriptor << ": "
+                       << self->GetException()->Dump();
+    self->ClearException();
+  }
+  MutexLock mu(self, lock_);
+  timings_.emplace_back(descriptor, init_time);
+}
+
+void StartupClassInitializer::LogTimings(Thread* self) {
+  if (!VLOG_IS_ON(class_linker)) {
+    return;
+  }
+  MutexLock mu(self, lock_);
+  uint64_t total_time = 0u;
+  for (const auto& timing : timings_) {
+    total_time += timing.second;
+  }
+  size_t num_slowest = std::min(kSlowestStartupClassInits, timings_.size());
+  std::partial_sort(timings_.begin(),
+                    timings_.begin() + num_slowest,
+                    timings_.end(),
+                    [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+  std::ostringstream oss;
+  oss << "Initialized " << timings_.size() << " startup classes in "
+      << PrettyDuration(total_time);
+  for (size_t i = 0; i != num_slowest; ++i) {
+    oss << (i == 0u ? ", slowest: " : ", ") << timings_[i].first << " "
+        << PrettyDuration(timings_[i].second);
+  }
+  VLOG(class_linker) << oss.str();
+}
+
+// Loads, links and verifies a batch of startup classes. Races with the application
+// loading the same classes are resolved by the class linker, the first thread to get
+// to a class does the work and the other one waits for it.
+class StartupClassPreloadTask final : public Task {
+ public:
+  StartupClassPreloadTask(std::shared_ptr<const StartupClassList> classes,
+                          std::shared_ptr<StartupClassInitializer> initializer,
+                          size_t begin,
+                          size_t end)
+      : classes_(std::move(classes)),
+        initializer_(std::move(initializer)),
+        begin_(begin),
+        end_(end) {}
+
+  void Run(Thread* self) override {
+    ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+    for (size_t i = begin_; i != end_; ++i) {
+      const DexFile* dex_file = classes_->GetClasses()[i].first;
+      const char* descriptor = dex_file->StringByTypeIdx(classes_->GetClasses()[i].second);
+      if (descriptor[0] != 'L') {
+        // Array classes are created on demand and need no verification.
+        continue;
+      }
+      // Take handles inside the loop, like background verification, to not hold on to
+      // the mutator lock for the whole batch.
+      ScopedObjectAccess soa(self);
+      StackHandleScope<2> hs(self);
+      Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+          soa.Decode<mirror::ClassLoader>(classes_->GetClassLoader())));
+      Handle<mirror::Class> h_class(hs.NewHandle(
+          class_linker->FindClass(self, descriptor, h_loader)));
+      if (h_class == nullptr) {
+        CHECK(self->IsExceptionPending());
+        self->ClearException();
+        continue;
+      }
+      if (&h_class->GetDexFile() != dex_file || h_class->IsVerified()) {
+        // Either the class is defined by another dex file, or there is nothing left to do.
+        continue;
+      }
+      class_linker->VerifyClass(self, /* verifier_deps= */ nullptr, h_class);
+      if (self->IsExceptionPending()) {
+        // The application will get the error when it uses the class.
+        self->ClearException();
+      }
+    }
+    if (initializer_ != nullptr) {
+      initializer_->PreloadTaskDone(self);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::shared_ptr<const StartupClassList> classes_;
+  // Null unless the startup classes get initialized once preloaded.
+  const std::shared_ptr<StartupClassInitializer> initializer_;
+  const size_t begin_;
+  const size_t end_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassPreloadTask);
+};
+
+// Reads the profile of the application and splits its classes into preload tasks.
+class StartupClassProfileTask final : public Task {
+ public:
+  StartupClassProfileTask(ThreadPool* thread_pool,
+                          const std::vector<std::string>& code_paths,
+                          const std::string& profile_file,
+                          bool initialize)
+      : thread_pool_(thread_pool),
+        code_paths_(code_paths.begin(), code_paths.end()),
+        profile_file_(profile_file),
+        initialize_(initialize) {}
+
+  void Run(Thread* self) override {
+    ScopedTrace trace("Preload startup classes");
+    ProfileCompilationInfo profile_info(/* for_boot_image= */ false);
+    if (!profile_info.Load(profile_file_, /* clear_if_invalid= */ false) ||
+        profile_info.IsEmpty()) {
+      VLOG(class_linker) << "No startup classes to preload from " << profile_file_;
+      return;
+    }
+
+    std::vector<const DexFile*> dex_files;
+    jobject class_loader = nullptr;
+    {
+      ScopedObjectAccess soa(self);
+      ObjPtr<mirror::ClassLoader> loader = nullptr;
+      ClassLinker* const class_linker = Runtime::Current()->GetClassLinker();
+      {
+        ReaderMutexLock mu(self, *Locks::dex_lock_);
+        for (const auto& entry : class_linker->GetDexCachesData()) {
+          const DexFile* dex_file = entry.first;
+          if (code_paths_.find(DexFileLoader::GetBaseLocation(dex_file->GetLocation())) ==
+                  code_paths_.end()) {
+            continue;
+          }
+          ObjPtr<mirror::DexCache> dex_cache =
+              ObjPtr<mirror::DexCache>::DownCast(self->DecodeJObject(entry.second.weak_root));
+          if (dex_cache == nullptr) {
+            continue;
+          }
+          loader = dex_cache->GetClassLoader();
+          dex_files.push_back(dex_file);
+        }
+      }
+      if (loader == nullptr) {
+        VLOG(class_linker) << "No application dex file loaded for " << profile_file_;
+        return;
+      }
+      class_loader = soa.Vm()->AddGlobalRef(self, loader);
+    }
+    // The list owns the global reference from now on.
+    std::shared_ptr<StartupClassList> class_list =
+        std::make_shared<StartupClassList>(class_loader);
+
+    {
+      // We only preload for class loaders we know the lookup chain of, for the
+      // same reason as background verification: runtime threads do not call Java.
+      std::unique_ptr<ClassLoaderContext> context(
+          ClassLoaderContext::CreateContextForClassLoader(class_loader,
+                                                          /* dex_elements= */ nullptr));
+      if (context == nullptr) {
+        return;
+      }
+    }
+
+    if (profile_info.VerifyProfileData(dex_files)) {
+      for (const DexFile* dex_file : dex_files) {
+        std::set<dex::TypeIndex> class_types;
+        std::set<uint16_t> hot_methods;
+        std::set<uint16_t> startup_methods;
+        std::set<uint16_t> post_startup_methods;
+        if (profile_info.GetClassesAndMethods(*dex_file,
+                                              &class_types,
+                                              &hot_methods,
+                                              &startup_methods,
+                                              &post_startup_methods)) {
+          for (dex::TypeIndex type_index : class_types) {
+            class_list->AddClass(dex_file, type_index);
+          }
+        }
+      }
+    } else {
+      LOG(WARNING) << "Not preloading classes of stale profile " << profile_file_;
+    }
+
+    size_t num_classes = class_list->GetClasses().size();
+    VLOG(class_linker) << "Preloading " << num_classes << " startup classes from "
+                       << profile_file_;
+    std::shared_ptr<StartupClassInitializer> initializer;
+    if (initialize_ && num_classes != 0u) {
+      size_t num_tasks = RoundUp(num_classes, kStartupClassPreloadBatchSize) /
+          kStartupClassPreloadBatchSize;
+      initializer = std::make_shared<StartupClassInitializer>(class_list, thread_pool_, num_tasks);
+    }
+    if (thread_pool_->IsFinishing(self)) {
+      return;
+    }
+    for (size_t begin = 0; begin < num_classes; begin += kStartupClassPreloadBatchSize) {
+      size_t end = std::min(begin + kStartupClassPreloadBatchSize, num_classes);
+      thread_pool_->AddTask(
+          self, new StartupClassPreloadTask(class_list, initializer, begin, end));
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  // The pool running this task. Stopping the pool drops the preload tasks not added yet.
+  ThreadPool* const thread_pool_;
+  const std::set<std::string> code_paths_;
+  const std::string profile_file_;
+  const bool initialize_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassProfileTask);
+};
+
+void OatFileManager::PreloadStartupClasses(const std::vector<std::string>& code_paths,
+                                           const std::string& profile_file,
+                                           size_t num_threads,
+                                           bool initialize) {
+  Runtime* const runtime = Runtime::Current();
+  Thread* const self = Thread::Current();
+
+  if (runtime->IsJavaDebuggable()) {
+    // Runtime threads are not allowed to load classes when debuggable, see
+    // RunBackgroundVerification.
+    return;
+  }
+
+  if (!IsSdkVersionSetAndAtLeast(runtime->GetTargetSdkVersion(), SdkVersion::kQ)) {
+    // Do not run for legacy apps as they may depend on the previous class loader behaviour.
+    return;
+  }
+
+  if (profile_file.empty() || code_paths.empty()) {
+    return;
+  }
+
+  if (runtime->IsShuttingDown(self)) {
+    // Not allowed to create new threads during runtime shutdown.
+    return;
+  }
+
+  WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+  if (startup_class_thread_pool_ != nullptr) {
+    // Only preload the classes of the first application registered.
+    return;
+  }
+  // Static initializers may use their java.lang.Thread, so the workers need peers.
+  startup_class_thread_pool_.reset(
+      new ThreadPool("Startup class thread pool", num_threads, /*create_peers=*/ initialize));
+  startup_class_thread_pool_->StartWorkers(self);
+  startup_class_thread_pool_->AddTask(
+      self,
+      new StartupClassProfileTask(
+          startup_class_thread_pool_.get(), code_paths, profile_file, initialize));
+}
+
+void OatFileManager::StopStartupClassThreadPool() {
+  Thread* const self = Thread::Current();
+  ReaderMutexLock mu(self, *Locks::oat_file_manager_lock_);
+  if (startup_class_thread_pool_ != nullptr) {
+    // Tasks check this before adding more tasks.
+    startup_class_thread_pool_->SetFinishing(self);
+    startup_class_thread_pool_->RemoveAllTasks(self);
+  }
+}
+
+void OatFileManager::DeleteStartupClassThreadPool() {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool;
+  {
+    WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    thread_pool = std::move(startup_class_thread_pool_);
+  }
+  // Delete outside the lock, the workers may need it to finish their current task.
+  thread_pool.reset();
+}
+
 void OatFileManager::WaitForWorkersToBeCreated() {
   DCHECK(!Runtime::Current()->IsShuttingDown(Thread::Current()))
       << "Cannot create new threads during runtime shutdown";
   if (verification_thread_pool_ != nullptr) {
     verification_thread_pool_->WaitForWorkersToBeCreated();
   }
+  ReaderMutexLock mu(Thread::Current(), *Locks::oat_file_manager_lock_);
+  if (startup_class_thread_pool_ != nullptr) {
+    startup_class_thread_pool_->WaitForWorkersToBeCreated();
+  }
 }
 
 void OatFileManager::DeleteThreadPool() {
   verification_thread_pool_.reset(nullptr);
+  DeleteStartupClassThreadPool();
 }
 
 void OatFileManager::WaitForBackgroundVerificationTasks() {
@@ -134,6 +134,27 @@ class OatFileManager {
   // If allocated, delete a thread pool of background verification threads.
   void DeleteThreadPool();
 
+  // Load and verify in the background, on `num_threads` threads, the classes listed in the
+  // profile `profile_file` for the dex files of `code_paths`, so that the application finds
+  // them ready when it first uses them at startup. If `initialize` is true, also run their
+  // static initializers, superclasses and superinterfaces first.
+  void PreloadStartupClasses(const std::vector<std::string>& code_paths,
+                             const std::string& profile_file,
+                             size_t num_threads,
+                             bool initialize)
+      REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
+
+  // If allocated, stop the thread pool preloading startup classes without waiting for its
+  // workers, which may be running static initializers. Tasks not started yet are dropped and
+  // classes not loaded yet are left to the application. The idle workers are deleted with the
+  // other thread pools.
+  void StopStartupClassThreadPool()
+      REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
+
+  // If allocated, delete the thread pool preloading startup classes, waiting for its workers.
+  void DeleteStartupClassThreadPool()
+      REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
+
   // Wait for all background verification tasks to finish. This is only used by tests.
   void WaitForBackgroundVerificationTasks();
 
@@ -166,6 +187,10 @@ class OatFileManager {
   // Single-thread pool used to run the verifier in the background.
   std::unique_ptr<ThreadPool> verification_thread_pool_;
 
+  // Thread pool used to preload the startup classes of the application.
+  std::unique_ptr<ThreadPool> startup_class_thread_pool_
+      GUARDED_BY(Locks::oat_file_manager_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(OatFileManager);
 };
 
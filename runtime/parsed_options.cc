@@ -286,6 +286,23 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xjitzygotepthreadpriority:_")
           .WithType<int>()
           .IntoKey(M::JITZygotePoolThreadPthreadPriority)
+      .Define("-Xjitcpubudget:_")
+          .WithType<unsigned int>().WithRange(0u, 100u)
+          .WithHelp("Percentage of a CPU the JIT may use per budget window while the process is "
+                    "saturated. 0 disables the budget.")
+          .IntoKey(M::JITCpuBudgetPercent)
+      .Define("-Xjitcpubudgetwindow:_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::JITCpuBudgetWindow)
+      .Define("-Xjitstartupprofile:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .WithHelp("Compile the hot methods of the primary profile in the background at startup.")
+          .IntoKey(M::JITCompileStartupProfile)
+      .Define("-Xjitstartupprofilemaxsize:_")
+          .WithType<MemoryKiB>()
+          .WithHelp("Maximum amount of dex code compiled from the primary profile at startup.")
+          .IntoKey(M::JITStartupProfileMaxSize)
       .Define("-Xjitsaveprofilinginfo")
           .WithType<ProfileSaverOptions>()
           .AppendValues()
@@ -341,6 +358,23 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-Xstackdumplockprofthreshold:_")
           .WithType<unsigned int>()
           .IntoKey(M::StackDumpLockProfThreshold)
+      .Define("-XX:MonitorContentionSamples=_")
+          .WithType<unsigned int>()
+          .WithHelp("Number of recent contended monitor acquisitions kept for SIGQUIT and JVMTI.\n"
+                    "0 (default) disables the monitor contention profiler.")
+          .IntoKey(M::MonitorContentionSamples)
+      .Define("-XX:JniTransitionSampleInterval=_")
+          .WithType<unsigned int>()
+          .WithHelp("Count the JNI transitions of each native method, and time one in N of them,\n"
+                    "for SIGQUIT and VMDebug. 0 (default) disables the JNI transition profiler.")
+          .IntoKey(M::JniTransitionSampleInterval)
+      .Define("-XX:NativeMethodPromotionFile=_")
+          .WithType<std::string>()
+          .WithHelp("File listing unannotated native methods to treat as @FastNative or\n"
+                    "@CriticalNative, one 'fast|critical Lpkg/Cls;->name(sig)' per line.\n"
+                    "Synchronized methods are not promoted, and critical ones must be static\n"
+                    "and only take and return primitive values.")
+          .IntoKey(M::NativeMethodPromotionFile)
       .Define("-Xmethod-trace")
           .IntoKey(M::MethodTrace)
       .Define("-Xmethod-trace-file:_")
@@ -396,6 +430,11 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:ThreadSuspendTimeout=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::ThreadSuspendTimeout)
+      .Define("-XX:TimeToSafepointRecords=_")
+          .WithType<unsigned int>()
+          .WithHelp("Number of recent suspend all requests kept with their time-to-safepoint\n"
+                    "phases for SIGQUIT. 0 (default) disables the tracing.")
+          .IntoKey(M::TimeToSafepointRecords)
       .Define("-XX:MonitorTimeoutEnable=_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -452,6 +491,46 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::VerifierMissingKThrowFatal)
+      .Define("-XX:StartupClassPreloadThreads=_")
+          .WithType<unsigned int>()
+          .WithHelp("Number of threads loading and verifying the startup classes of the\n"
+                    "application profile in the background. 0 (default) disables it.")
+          .IntoKey(M::StartupClassPreloadThreads)
+      .Define("-XX:StartupClassInitialization=_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .WithHelp("Also run the static initializers of the preloaded startup classes, in\n"
+                    "parallel for independent class hierarchies. false (default) leaves them\n"
+                    "to the application.")
+          .IntoKey(M::StartupClassInitialization)
+      .Define("-XX:ParallelCheckpointThreads=_")
+          .WithType<unsigned int>()
+          .WithHelp("Number of threads running checkpoints on behalf of suspended threads.\n"
+                    "0 (default) runs them on the thread requesting the checkpoint.")
+          .IntoKey(M::ParallelCheckpointThreads)
+      .Define("-XX:FullDexCacheArrayLimit=_")
+          .WithType<unsigned int>()
+          .WithHelp("Maximum number of ids of a kind in a dex file for its dex cache array to\n"
+                    "be indexed directly instead of hashed. 0 (default) hashes all arrays.")
+          .IntoKey(M::FullDexCacheArrayLimit)
+      .Define("-XX:DexCacheStats=_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .WithHelp("Count hits, misses and evictions in the dex cache arrays and dump them\n"
+                    "on SIGQUIT.")
+          .IntoKey(M::DexCacheStats)
+      .Define("-XX:InterpreterCacheSecondLevelSize=_")
+          .WithType<unsigned int>()
+          .WithHelp("Number of entries of the second level of the thread-local interpreter\n"
+                    "caches, which keeps the entries evicted from the first level.\n"
+                    "0 (default) disables it.")
+          .IntoKey(M::InterpreterCacheSecondLevelSize)
+      .Define("-XX:InterpreterCacheStats=_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .WithHelp("Dump the hits, misses, evictions and clears of the thread-local interpreter\n"
+                    "caches with the threads on SIGQUIT.")
+          .IntoKey(M::InterpreterCacheStats)
       .Define("-XX:ForceJavaZygoteForkLoop=_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -31,6 +31,7 @@
 #include "mirror/object_array-inl.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "nth_caller_visitor.h"
+#include "reflective_invoke_cache.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack_reference.h"
 #include "thread-inl.h"
@@ -41,6 +42,50 @@ namespace {
 
 using android::base::StringPrintf;
 
+// Returns the primitive type boxed by instances of `klass`, or `kPrimNot` if `klass` is
+// not one of the java.lang box classes. This is cheaper than comparing the descriptor of
+// `klass` with the descriptor of each box class in turn.
+ALWAYS_INLINE Primitive::Type GetBoxedPrimitiveType(ObjPtr<mirror::Class> klass)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  // Box classes have a single instance field, holding the boxed value.
+  if (klass->NumInstanceFields() != 1u) {
+    return Primitive::kPrimNot;
+  }
+  Primitive::Type type = klass->GetInstanceField(0)->GetTypeAsPrimitiveType();
+  jmethodID value_of;
+  switch (type) {
+    case Primitive::kPrimBoolean:
+      value_of = WellKnownClasses::java_lang_Boolean_valueOf;
+      break;
+    case Primitive::kPrimByte:
+      value_of = WellKnownClasses::java_lang_Byte_valueOf;
+      break;
+    case Primitive::kPrimChar:
+      value_of = WellKnownClasses::java_lang_Character_valueOf;
+      break;
+    case Primitive::kPrimShort:
+      value_of = WellKnownClasses::java_lang_Short_valueOf;
+      break;
+    case Primitive::kPrimInt:
+      value_of = WellKnownClasses::java_lang_Integer_valueOf;
+      break;
+    case Primitive::kPrimLong:
+      value_of = WellKnownClasses::java_lang_Long_valueOf;
+      break;
+    case Primitive::kPrimFloat:
+      value_of = WellKnownClasses::java_lang_Float_valueOf;
+      break;
+    case Primitive::kPrimDouble:
+      value_of = WellKnownClasses::java_lang_Double_valueOf;
+      break;
+    default:
+      return Primitive::kPrimNot;
+  }
+  // The valueOf methods are declared by the box classes themselves.
+  return (jni::DecodeArtMethod(value_of)->GetDeclaringClass() == klass) ? type
+                                                                        : Primitive::kPrimNot;
+}
+
 class ArgArray {
  public:
   ArgArray(const char* shorty, uint32_t shorty_len)
@@ -225,6 +270,7 @@ class ArgArray {
   bool BuildArgArrayFromObjectArray(ObjPtr<mirror::Object> receiver,
                                     ObjPtr<mirror::ObjectArray<mirror::Object>> raw_args,
                                     ArtMethod* m,
+                                    const ReflectiveInvokeCache::Entry& entry,
                                     Thread* self)
       REQUIRES_SHARED(Locks::mutator_lock_) {
     const dex::TypeList* classes = m->GetParameterTypeList();
@@ -238,7 +284,7 @@ class ArgArray {
         hs.NewHandle<mirror::ObjectArray<mirror::Object>>(raw_args));
     for (size_t i = 1, args_offset = 0; i < shorty_len_; ++i, ++args_offset) {
       arg.Assign(args->Get(args_offset));
-      if (((shorty_[i] == 'L') && (arg != nullptr)) ||
+      if (((shorty_[i] == 'L') && (arg != nullptr) && !entry.IsUncheckedParameter(args_offset)) ||
           ((arg == nullptr && shorty_[i] != 'L'))) {
         // TODO: The method's parameter's type must have been previously resolved, yet
         // we've seen cases where it's not b/34440020.
@@ -258,16 +304,17 @@ class ArgArray {
           return false;
         }
       }
+      const Primitive::Type boxed_type = (shorty_[i] != 'L')
+          ? GetBoxedPrimitiveType(arg->GetClass())
+          : Primitive::kPrimNot;
 
-#define DO_FIRST_ARG(match_descriptor, get_fn, append) { \
-          if (LIKELY(arg != nullptr && \
-              arg->GetClass()->DescriptorEquals(match_descriptor))) { \
+#define DO_FIRST_ARG(match_type, get_fn, append) { \
+          if (LIKELY(boxed_type == (match_type))) { \
             ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
             append(primitive_field-> get_fn(arg.Get()));
 
-#define DO_ARG(match_descriptor, get_fn, append) \
-          } else if (LIKELY(arg != nullptr && \
-                            arg->GetClass<>()->DescriptorEquals(match_descriptor))) { \
+#define DO_ARG(match_type, get_fn, append) \
+          } else if (LIKELY(boxed_type == (match_type))) { \
             ArtField* primitive_field = arg->GetClass()->GetInstanceField(0); \
             append(primitive_field-> get_fn(arg.Get()));
 
@@ -293,54 +340,54 @@ class ArgArray {
           Append(arg.Get());
           break;
         case 'Z':
-          DO_FIRST_ARG("Ljava/lang/Boolean;", GetBoolean, Append)
+          DO_FIRST_ARG(Primitive::kPrimBoolean, GetBoolean, Append)
           DO_FAIL("boolean")
           break;
         case 'B':
-          DO_FIRST_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Primitive::kPrimByte, GetByte, Append)
           DO_FAIL("byte")
           break;
         case 'C':
-          DO_FIRST_ARG("Ljava/lang/Character;", GetChar, Append)
+          DO_FIRST_ARG(Primitive::kPrimChar, GetChar, Append)
           DO_FAIL("char")
           break;
         case 'S':
-          DO_FIRST_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Primitive::kPrimShort, GetShort, Append)
+          DO_ARG(Primitive::kPrimByte, GetByte, Append)
           DO_FAIL("short")
           break;
         case 'I':
-          DO_FIRST_ARG("Ljava/lang/Integer;", GetInt, Append)
-          DO_ARG("Ljava/lang/Character;", GetChar, Append)
-          DO_ARG("Ljava/lang/Short;", GetShort, Append)
-          DO_ARG("Ljava/lang/Byte;", GetByte, Append)
+          DO_FIRST_ARG(Primitive::kPrimInt, GetInt, Append)
+          DO_ARG(Primitive::kPrimChar, GetChar, Append)
+          DO_ARG(Primitive::kPrimShort, GetShort, Append)
+          DO_ARG(Primitive::kPrimByte, GetByte, Append)
           DO_FAIL("int")
           break;
         case 'J':
-          DO_FIRST_ARG("Ljava/lang/Long;", GetLong, AppendWide)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendWide)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendWide)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendWide)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendWide)
+          DO_FIRST_ARG(Primitive::kPrimLong, GetLong, AppendWide)
+          DO_ARG(Primitive::kPrimInt, GetInt, AppendWide)
+          DO_ARG(Primitive::kPrimChar, GetChar, AppendWide)
+          DO_ARG(Primitive::kPrimShort, GetShort, AppendWide)
+          DO_ARG(Primitive::kPrimByte, GetByte, AppendWide)
           DO_FAIL("long")
           break;
         case 'F':
-          DO_FIRST_ARG("Ljava/lang/Float;", GetFloat, AppendFloat)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendFloat)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendFloat)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendFloat)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendFloat)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendFloat)
+          DO_FIRST_ARG(Primitive::kPrimFloat, GetFloat, AppendFloat)
+          DO_ARG(Primitive::kPrimLong, GetLong, AppendFloat)
+          DO_ARG(Primitive::kPrimInt, GetInt, AppendFloat)
+          DO_ARG(Primitive::kPrimChar, GetChar, AppendFloat)
+          DO_ARG(Primitive::kPrimShort, GetShort, AppendFloat)
+          DO_ARG(Primitive::kPrimByte, GetByte, AppendFloat)
           DO_FAIL("float")
           break;
         case 'D':
-          DO_FIRST_ARG("Ljava/lang/Double;", GetDouble, AppendDouble)
-          DO_ARG("Ljava/lang/Float;", GetFloat, AppendDouble)
-          DO_ARG("Ljava/lang/Long;", GetLong, AppendDouble)
-          DO_ARG("Ljava/lang/Integer;", GetInt, AppendDouble)
-          DO_ARG("Ljava/lang/Character;", GetChar, AppendDouble)
-          DO_ARG("Ljava/lang/Short;", GetShort, AppendDouble)
-          DO_ARG("Ljava/lang/Byte;", GetByte, AppendDouble)
+          DO_FIRST_ARG(Primitive::kPrimDouble, GetDouble, AppendDouble)
+          DO_ARG(Primitive::kPrimFloat, GetFloat, AppendDouble)
+          DO_ARG(Primitive::kPrimLong, GetLong, AppendDouble)
+          DO_ARG(Primitive::kPrimInt, GetInt, AppendDouble)
+          DO_ARG(Primitive::kPrimChar, GetChar, AppendDouble)
+          DO_ARG(Primitive::kPrimShort, GetShort, AppendDouble)
+          DO_ARG(Primitive::kPrimByte, GetByte, AppendDouble)
           DO_FAIL("double")
           break;
 #ifndef NDEBUG
@@ -459,11 +506,10 @@ void InvokeWithArgArray(const ScopedObjectAccessAlreadyRunnable& soa,
 }
 
 ALWAYS_INLINE
-bool CheckArgsForInvokeMethod(ArtMethod* np_method,
+bool CheckArgsForInvokeMethod(const ReflectiveInvokeCache::Entry& entry,
                               ObjPtr<mirror::ObjectArray<mirror::Object>> objects)
     REQUIRES_SHARED(Locks::mutator_lock_) {
-  const dex::TypeList* classes = np_method->GetParameterTypeList();
-  uint32_t classes_size = (classes == nullptr) ? 0 : classes->Size();
+  uint32_t classes_size = entry.shorty_len - 1u;
   uint32_t arg_count = (objects == nullptr) ? 0 : objects->GetLength();
   if (UNLIKELY(arg_count != classes_size)) {
     ThrowIllegalArgumentException(StringPrintf("Wrong number of arguments; expected %d, got %d",
@@ -476,16 +522,16 @@ bool CheckArgsForInvokeMethod(ArtMethod* np_method,
 ALWAYS_INLINE
 bool InvokeMethodImpl(const ScopedObjectAccessAlreadyRunnable& soa,
                       ArtMethod* m,
-                      ArtMethod* np_method,
+                      const ReflectiveInvokeCache::Entry& entry,
                       ObjPtr<mirror::Object> receiver,
                       ObjPtr<mirror::ObjectArray<mirror::Object>> objects,
                       const char** shorty,
                       JValue* result) REQUIRES_SHARED(Locks::mutator_lock_) {
   // Invoke the method.
-  uint32_t shorty_len = 0;
-  *shorty = np_method->GetShorty(&shorty_len);
-  ArgArray arg_array(*shorty, shorty_len);
-  if (!arg_array.BuildArgArrayFromObjectArray(receiver, objects, np_method, soa.Self())) {
+  *shorty = entry.shorty;
+  ArgArray arg_array(entry.shorty, entry.shorty_len);
+  if (!arg_array.BuildArgArrayFromObjectArray(
+          receiver, objects, entry.method, entry, soa.Self())) {
     CHECK(soa.Self()->IsExceptionPending());
     return false;
   }
@@ -520,6 +566,48 @@ bool InvokeMethodImpl(const ScopedObjectAccessAlreadyRunnable& soa,
   return true;
 }
 
+ArtMethod* GetCallingMethod(Thread* self, size_t num_frames) REQUIRES_SHARED(Locks::mutator_lock_) {
+  NthCallerVisitor visitor(self, num_frames);
+  visitor.WalkStack();
+  return visitor.caller;
+}
+
+// Same as `VerifyAccess`, but skips the check if the calling method is the last one that
+// passed it for `accessed_method`, which the cache records for members that are not
+// protected.
+ALWAYS_INLINE
+bool VerifyAccessForInvoke(Thread* self,
+                           ArtMethod* accessed_method,
+                           const ReflectiveInvokeCache::Entry& entry,
+                           ObjPtr<mirror::Object> obj,
+                           ObjPtr<mirror::Class> declaring_class,
+                           uint32_t access_flags,
+                           ObjPtr<mirror::Class>* calling_class,
+                           size_t num_frames) REQUIRES_SHARED(Locks::mutator_lock_) {
+  if ((access_flags & kAccPublic) != 0) {
+    return true;
+  }
+  ArtMethod* caller = GetCallingMethod(self, num_frames);
+  if (UNLIKELY(caller == nullptr)) {
+    // The caller is an attached native thread.
+    return false;
+  }
+  if (entry.IsAccessVerified(accessed_method, caller)) {
+    return true;
+  }
+  *calling_class = caller->GetDeclaringClass();
+  if (!VerifyAccess(obj, declaring_class, access_flags, *calling_class)) {
+    return false;
+  }
+  if ((access_flags & kAccProtected) == 0) {
+    ReflectiveInvokeCache::Entry* cached =
+        self->GetReflectiveInvokeCache()->GetOrCreate(entry.method);
+    cached->accessed_method = accessed_method;
+    cached->accessor = caller;
+  }
+  return true;
+}
+
 }  // anonymous namespace
 
 template <>
@@ -705,7 +793,8 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
 
   ObjPtr<mirror::Executable> executable = soa.Decode<mirror::Executable>(javaMethod);
   const bool accessible = executable->IsAccessible();
-  ArtMethod* m = executable->GetArtMethod();
+  ArtMethod* const accessed_method = executable->GetArtMethod();
+  ArtMethod* m = accessed_method;
 
   ObjPtr<mirror::Class> declaring_class = m->GetDeclaringClass();
   if (UNLIKELY(!declaring_class->IsVisiblyInitialized())) {
@@ -742,18 +831,23 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
   ObjPtr<mirror::ObjectArray<mirror::Object>> objects =
       soa.Decode<mirror::ObjectArray<mirror::Object>>(javaArgs);
   auto* np_method = m->GetInterfaceMethodIfProxy(kPointerSize);
-  if (!CheckArgsForInvokeMethod(np_method, objects)) {
+  // Copy the entry, the cache may be updated by calls made while building the arguments.
+  const ReflectiveInvokeCache::Entry entry =
+      *soa.Self()->GetReflectiveInvokeCache()->GetOrCreate(np_method);
+  if (!CheckArgsForInvokeMethod(entry, objects)) {
     return nullptr;
   }
 
   // If method is not set to be accessible, verify it can be accessed by the caller.
   ObjPtr<mirror::Class> calling_class;
-  if (!accessible && !VerifyAccess(soa.Self(),
-                                   receiver,
-                                   declaring_class,
-                                   m->GetAccessFlags(),
-                                   &calling_class,
-                                   num_frames)) {
+  if (!accessible && !VerifyAccessForInvoke(soa.Self(),
+                                            accessed_method,
+                                            entry,
+                                            receiver,
+                                            declaring_class,
+                                            m->GetAccessFlags(),
+                                            &calling_class,
+                                            num_frames)) {
     ThrowIllegalAccessException(
         StringPrintf("Class %s cannot access %s method %s of class %s",
             calling_class == nullptr ? "null" : calling_class->PrettyClass().c_str(),
@@ -767,7 +861,7 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
   // Invoke the method.
   JValue result;
   const char* shorty;
-  if (!InvokeMethodImpl(soa, m, np_method, receiver, objects, &shorty, &result)) {
+  if (!InvokeMethodImpl(soa, m, entry, receiver, objects, &shorty, &result)) {
     return nullptr;
   }
   return soa.AddLocalReference<jobject>(BoxPrimitive(Primitive::GetType(shorty[0]), result));
@@ -819,14 +913,16 @@ void InvokeConstructor(const ScopedObjectAccessAlreadyRunnable& soa,
   ObjPtr<mirror::ObjectArray<mirror::Object>> objects =
       soa.Decode<mirror::ObjectArray<mirror::Object>>(javaArgs);
   ArtMethod* np_method = constructor->GetInterfaceMethodIfProxy(kRuntimePointerSize);
-  if (!CheckArgsForInvokeMethod(np_method, objects)) {
+  const ReflectiveInvokeCache::Entry entry =
+      *soa.Self()->GetReflectiveInvokeCache()->GetOrCreate(np_method);
+  if (!CheckArgsForInvokeMethod(entry, objects)) {
     return;
   }
 
   // Invoke the constructor.
   JValue result;
   const char* shorty;
-  InvokeMethodImpl(soa, constructor, np_method, receiver, objects, &shorty, &result);
+  InvokeMethodImpl(soa, constructor, entry, receiver, objects, &shorty, &result);
 }
 
 ObjPtr<mirror::Object> BoxPrimitive(Primitive::Type src_class, const JValue& value) {
@@ -951,39 +1047,41 @@ static bool UnboxPrimitive(ObjPtr<mirror::Object> o,
 
   JValue boxed_value;
   ObjPtr<mirror::Class> klass = o->GetClass();
-  Primitive::Type primitive_type;
+  Primitive::Type primitive_type = GetBoxedPrimitiveType(klass);
   ArtField* primitive_field = &klass->GetIFieldsPtr()->At(0);
-  if (klass->DescriptorEquals("Ljava/lang/Boolean;")) {
-    primitive_type = Primitive::kPrimBoolean;
-    boxed_value.SetZ(primitive_field->GetBoolean(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Byte;")) {
-    primitive_type = Primitive::kPrimByte;
-    boxed_value.SetB(primitive_field->GetByte(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Character;")) {
-    primitive_type = Primitive::kPrimChar;
-    boxed_value.SetC(primitive_field->GetChar(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Float;")) {
-    primitive_type = Primitive::kPrimFloat;
-    boxed_value.SetF(primitive_field->GetFloat(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Double;")) {
-    primitive_type = Primitive::kPrimDouble;
-    boxed_value.SetD(primitive_field->GetDouble(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Integer;")) {
-    primitive_type = Primitive::kPrimInt;
-    boxed_value.SetI(primitive_field->GetInt(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Long;")) {
-    primitive_type = Primitive::kPrimLong;
-    boxed_value.SetJ(primitive_field->GetLong(o));
-  } else if (klass->DescriptorEquals("Ljava/lang/Short;")) {
-    primitive_type = Primitive::kPrimShort;
-    boxed_value.SetS(primitive_field->GetShort(o));
-  } else {
-    std::string temp;
-    ThrowIllegalArgumentException(
-        StringPrintf("%s has type %s, got %s", UnboxingFailureKind(f).c_str(),
-            dst_class->PrettyDescriptor().c_str(),
-            PrettyDescriptor(o->GetClass()->GetDescriptor(&temp)).c_str()).c_str());
-    return false;
+  switch (primitive_type) {
+    case Primitive::kPrimBoolean:
+      boxed_value.SetZ(primitive_field->GetBoolean(o));
+      break;
+    case Primitive::kPrimByte:
+      boxed_value.SetB(primitive_field->GetByte(o));
+      break;
+    case Primitive::kPrimChar:
+      boxed_value.SetC(primitive_field->GetChar(o));
+      break;
+    case Primitive::kPrimFloat:
+      boxed_value.SetF(primitive_field->GetFloat(o));
+      break;
+    case Primitive::kPrimDouble:
+      boxed_value.SetD(primitive_field->GetDouble(o));
+      break;
+    case Primitive::kPrimInt:
+      boxed_value.SetI(primitive_field->GetInt(o));
+      break;
+    case Primitive::kPrimLong:
+      boxed_value.SetJ(primitive_field->GetLong(o));
+      break;
+    case Primitive::kPrimShort:
+      boxed_value.SetS(primitive_field->GetShort(o));
+      break;
+    default: {
+      std::string temp;
+      ThrowIllegalArgumentException(
+          StringPrintf("%s has type %s, got %s", UnboxingFailureKind(f).c_str(),
+              dst_class->PrettyDescriptor().c_str(),
+              PrettyDescriptor(o->GetClass()->GetDescriptor(&temp)).c_str()).c_str());
+      return false;
+    }
   }
 
   return ConvertPrimitiveValue(unbox_for_result,
@@ -1007,9 +1105,8 @@ bool UnboxPrimitiveForResult(ObjPtr<mirror::Object> o,
 }
 
 ObjPtr<mirror::Class> GetCallingClass(Thread* self, size_t num_frames) {
-  NthCallerVisitor visitor(self, num_frames);
-  visitor.WalkStack();
-  return visitor.caller != nullptr ? visitor.caller->GetDeclaringClass() : nullptr;
+  ArtMethod* caller = GetCallingMethod(self, num_frames);
+  return caller != nullptr ? caller->GetDeclaringClass() : nullptr;
 }
 
 bool VerifyAccess(Thread* self,
@@ -27,6 +27,7 @@
 #include "jni/jni_internal.h"
 #include "mirror/class-alloc-inl.h"
 #include "nativehelper/scoped_local_ref.h"
+#include "reflective_invoke_cache.h"
 #include "scoped_thread_state_change-inl.h"
 
 namespace art {
@@ -634,4 +635,45 @@ TEST_F(ReflectionTest, NonStaticSumDoubleDoubleDoubleDoubleDoubleMethod) {
   InvokeSumDoubleDoubleDoubleDoubleDoubleMethod(false);
 }
 
+TEST_F(ReflectionTest, ReflectiveInvokeCache) {
+  ScopedObjectAccess soa(Thread::Current());
+  ObjPtr<mirror::Class> object_class =
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/Object;");
+  ArtMethod* equals =
+      object_class->FindClassMethod("equals", "(Ljava/lang/Object;)Z", kRuntimePointerSize);
+  ASSERT_TRUE(equals != nullptr);
+  ObjPtr<mirror::Class> string_class =
+      class_linker_->FindSystemClass(soa.Self(), "Ljava/lang/String;");
+  ArtMethod* index_of =
+      string_class->FindClassMethod("indexOf", "(Ljava/lang/String;I)I", kRuntimePointerSize);
+  ASSERT_TRUE(index_of != nullptr);
+
+  ReflectiveInvokeCache* cache = soa.Self()->GetReflectiveInvokeCache();
+  cache->Clear();
+
+  ReflectiveInvokeCache::Entry* entry = cache->GetOrCreate(equals);
+  EXPECT_EQ(entry->method, equals);
+  EXPECT_STREQ(entry->shorty, "ZL");
+  EXPECT_EQ(entry->shorty_len, 2u);
+  // Arguments of an Object parameter do not need a type check.
+  EXPECT_TRUE(entry->IsUncheckedParameter(0));
+  EXPECT_FALSE(entry->IsAccessVerified(equals, index_of));
+
+  entry = cache->GetOrCreate(index_of);
+  EXPECT_EQ(entry->method, index_of);
+  EXPECT_STREQ(entry->shorty, "ILI");
+  EXPECT_FALSE(entry->IsUncheckedParameter(0));
+  EXPECT_FALSE(entry->IsUncheckedParameter(1));
+  entry->accessed_method = index_of;
+  entry->accessor = equals;
+  EXPECT_TRUE(entry->IsAccessVerified(index_of, equals));
+  // The entry of a cached method is returned as is.
+  EXPECT_EQ(cache->GetOrCreate(index_of), entry);
+  EXPECT_TRUE(cache->GetOrCreate(index_of)->IsAccessVerified(index_of, equals));
+
+  cache->Clear();
+  EXPECT_EQ(entry->method, nullptr);
+  EXPECT_FALSE(cache->GetOrCreate(index_of)->IsAccessVerified(index_of, equals));
+}
+
 }  // namespace art
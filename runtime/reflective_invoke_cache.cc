@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reflective_invoke_cache.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "art_method-inl.h"
+#include "dex/dex_file-inl.h"
+#include "object_callbacks.h"
+
+namespace art {
+
+void ReflectiveInvokeCache::Fill(Entry* entry, ArtMethod* method) {
+  DCHECK(!method->IsProxyMethod());
+  uint32_t shorty_len = 0u;
+  const char* shorty = method->GetShorty(&shorty_len);
+  uint32_t unchecked_parameters = 0u;
+  const dex::TypeList* parameters = method->GetParameterTypeList();
+  size_t num_parameters = std::min<size_t>(shorty_len - 1u, kMaxUncheckedParameters);
+  for (size_t i = 0; i != num_parameters; ++i) {
+    if (shorty[i + 1u] == 'L' &&
+        strcmp(method->GetDexFile()->GetTypeDescriptor(parameters->GetTypeItem(i).type_idx_),
+               "Ljava/lang/Object;") == 0) {
+      unchecked_parameters |= 1u << i;
+    }
+  }
+  entry->shorty = shorty;
+  entry->shorty_len = shorty_len;
+  entry->unchecked_parameters = unchecked_parameters;
+  entry->accessed_method = nullptr;
+  entry->accessor = nullptr;
+  // Write the key last, a concurrent `Sweep` only ever clears it.
+  entry->method = method;
+}
+
+static bool IsMethodMarked(ArtMethod* method, IsMarkedVisitor* visitor)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  mirror::Class* klass = method->GetDeclaringClassUnchecked<kWithoutReadBarrier>().Ptr();
+  return visitor->IsMarked(klass) != nullptr;
+}
+
+void ReflectiveInvokeCache::Sweep(IsMarkedVisitor* visitor) {
+  for (Entry& entry : data_) {
+    ArtMethod* method = entry.method;
+    if (method == nullptr) {
+      continue;
+    }
+    if (!IsMethodMarked(method, visitor)) {
+      // The class is being unloaded and its methods may be reused for other classes.
+      entry.method = nullptr;
+      continue;
+    }
+    ArtMethod* accessor = entry.accessor;
+    ArtMethod* accessed_method = entry.accessed_method;
+    if (accessor != nullptr &&
+        (!IsMethodMarked(accessor, visitor) || !IsMethodMarked(accessed_method, visitor))) {
+      entry.accessor = nullptr;
+    }
+  }
+}
+
+}  // namespace art
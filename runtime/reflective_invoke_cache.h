@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_REFLECTIVE_INVOKE_CACHE_H_
+#define ART_RUNTIME_REFLECTIVE_INVOKE_CACHE_H_
+
+#include <array>
+
+#include "base/bit_utils.h"
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art {
+
+class ArtMethod;
+class IsMarkedVisitor;
+class Thread;
+
+// Small thread-local cache for the targets of Method.invoke and Constructor.newInstance.
+//
+// Without it, every reflective call decodes the shorty and the parameter types of its
+// target from the dex file, resolves the type of each reference argument to check it,
+// and, for members that are not accessible, compares the packages of the caller and the
+// target. Targets that are called repeatedly from a thread stay in its cache, and only
+// pay for a lookup keyed by their ArtMethod (the interface method for proxies).
+//
+// All operations must be done from the owning thread, or at a point when the owning
+// thread is suspended, with the exception of `Sweep` which only ever clears entries.
+// Entries point into dex files, so the cache is cleared with the interpreter caches
+// whenever a dex file is unloaded, and entries of unloaded classes are swept by the GC.
+class ReflectiveInvokeCache {
+ public:
+  // Direct mapped. Serialization and dependency injection frameworks typically call
+  // a few dozen distinct methods in their hot loops.
+  static constexpr size_t kSize = 32;
+
+  // Parameters past this index always get their type checked.
+  static constexpr size_t kMaxUncheckedParameters = 32;
+
+  struct Entry {
+    // The target of the call, or null if the entry is empty.
+    ArtMethod* method;
+    const char* shorty;
+    uint32_t shorty_len;
+    // Bit `i` is set if parameter `i` is declared as java.lang.Object, which accepts any
+    // argument without resolving its type.
+    uint32_t unchecked_parameters;
+    // The last caller that passed the access check for `method`, when invoked through
+    // a Method object of `accessed_method`. Only set for members that are not protected,
+    // since protected access also depends on the receiver.
+    ArtMethod* accessed_method;
+    ArtMethod* accessor;
+
+    bool IsUncheckedParameter(size_t index) const {
+      return index < kMaxUncheckedParameters && (unchecked_parameters & (1u << index)) != 0u;
+    }
+
+    bool IsAccessVerified(ArtMethod* accessed, ArtMethod* caller) const {
+      return accessor == caller && accessed_method == accessed;
+    }
+  };
+
+  ReflectiveInvokeCache() {
+    Clear();
+  }
+
+  // Returns the entry of `method`, computing it if it is not in the cache.
+  ALWAYS_INLINE Entry* GetOrCreate(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Entry* entry = &data_[IndexOf(method)];
+    if (LIKELY(entry->method == method)) {
+      return entry;
+    }
+    Fill(entry, method);
+    return entry;
+  }
+
+  void Clear() {
+    data_.fill(Entry{});
+  }
+
+  // Clear the entries that refer to methods of classes that are no longer marked.
+  void Sweep(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  static size_t IndexOf(ArtMethod* method) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    // ArtMethods are at least 16 bytes apart.
+    return (reinterpret_cast<uintptr_t>(method) >> 4) & (kSize - 1);
+  }
+
+  static void Fill(Entry* entry, ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  std::array<Entry, kSize> data_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReflectiveInvokeCache);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_REFLECTIVE_INVOKE_CACHE_H_
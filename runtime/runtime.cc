@@ -97,7 +97,10 @@
 #include "jit/jit_code_cache.h"
 #include "jit/profile_saver.h"
 #include "jni/java_vm_ext.h"
+#include "jni/jni_extensions.h"
+#include "jni/jni_transition_profiler.h"
 #include "jni/jni_id_manager.h"
+#include "jni/native_method_promotions.h"
 #include "jni_id_type.h"
 #include "linear_alloc.h"
 #include "memory_representation.h"
@@ -116,6 +119,7 @@
 #include "mirror/throwable.h"
 #include "mirror/var_handle.h"
 #include "monitor.h"
+#include "monitor_contention_profiler.h"
 #include "native/dalvik_system_DexFile.h"
 #include "native/dalvik_system_BaseDexClassLoader.h"
 #include "native/dalvik_system_VMDebug.h"
@@ -308,6 +312,13 @@ Runtime::Runtime()
       zygote_no_threads_(false),
       verifier_logging_threshold_ms_(100),
       verifier_missing_kthrow_fatal_(false),
+      startup_class_preload_threads_(0u),
+      startup_class_initialization_(false),
+      parallel_checkpoint_threads_(0u),
+      full_dex_cache_array_limit_(0u),
+      dex_cache_stats_enabled_(false),
+      interpreter_cache_second_level_size_(0u),
+      interpreter_cache_stats_enabled_(false),
       perfetto_hprof_enabled_(false),
       perfetto_javaheapprof_enabled_(false) {
   static_assert(Runtime::kCalleeSaveSize ==
@@ -445,6 +456,7 @@ Runtime::~Runtime() {
   }
   DeleteThreadPool();
   CHECK(thread_pool_ == nullptr);
+  thread_list_->DeleteCheckpointThreadPool();
 
   // Make sure our internal threads are dead before we start tearing down things they're using.
   GetRuntimeCallbacks()->StopDebugger();
@@ -738,6 +750,9 @@ void Runtime::SweepSystemWeaks(IsMarkedVisitor* visitor) {
     GetJit()->GetCodeCache()->SweepRootTables(visitor);
   }
   thread_list_->SweepInterpreterCaches(visitor);
+  if (jni_transition_profiler_ != nullptr) {
+    jni_transition_profiler_->Sweep(visitor);
+  }
 
   // All other generic system-weak holders.
   for (gc::AbstractSystemWeakHolder* holder : system_weak_holders_) {
@@ -1108,6 +1123,9 @@ void Runtime::InitNonZygoteOrPostFork(
     thread_pool_.reset(new ThreadPool("Runtime", num_workers, /*create_peers=*/false, kStackSize));
     thread_pool_->StartWorkers(Thread::Current());
   }
+  if (parallel_checkpoint_threads_ != 0u) {
+    thread_list_->CreateCheckpointThreadPool(parallel_checkpoint_threads_);
+  }
 
   // Reset the gc performance data and metrics at zygote fork so that the events from
   // before fork aren't attributed to an app.
@@ -1360,6 +1378,14 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   MemMap::Init();
 
   verifier_missing_kthrow_fatal_ = runtime_options.GetOrDefault(Opt::VerifierMissingKThrowFatal);
+  startup_class_preload_threads_ = runtime_options.GetOrDefault(Opt::StartupClassPreloadThreads);
+  startup_class_initialization_ = runtime_options.GetOrDefault(Opt::StartupClassInitialization);
+  parallel_checkpoint_threads_ = runtime_options.GetOrDefault(Opt::ParallelCheckpointThreads);
+  full_dex_cache_array_limit_ = runtime_options.GetOrDefault(Opt::FullDexCacheArrayLimit);
+  dex_cache_stats_enabled_ = runtime_options.GetOrDefault(Opt::DexCacheStats);
+  interpreter_cache_second_level_size_ =
+      runtime_options.GetOrDefault(Opt::InterpreterCacheSecondLevelSize);
+  interpreter_cache_stats_enabled_ = runtime_options.GetOrDefault(Opt::InterpreterCacheStats);
   force_java_zygote_fork_loop_ = runtime_options.GetOrDefault(Opt::ForceJavaZygoteForkLoop);
   perfetto_hprof_enabled_ = runtime_options.GetOrDefault(Opt::PerfettoHprof);
   perfetto_javaheapprof_enabled_ = runtime_options.GetOrDefault(Opt::PerfettoJavaHeapStackProf);
@@ -1467,7 +1493,28 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   monitor_list_ = new MonitorList;
   monitor_pool_ = MonitorPool::Create();
-  thread_list_ = new ThreadList(runtime_options.GetOrDefault(Opt::ThreadSuspendTimeout));
+  if (runtime_options.GetOrDefault(Opt::MonitorContentionSamples) != 0u) {
+    monitor_contention_profiler_.reset(new MonitorContentionProfiler(
+        runtime_options.GetOrDefault(Opt::MonitorContentionSamples)));
+  }
+  if (runtime_options.GetOrDefault(Opt::JniTransitionSampleInterval) != 0u) {
+    jni_transition_profiler_.reset(new JniTransitionProfiler(
+        runtime_options.GetOrDefault(Opt::JniTransitionSampleInterval)));
+  }
+  // Promotions only apply to the JNI stubs of the running process, not to compiled code.
+  if (runtime_options.Exists(Opt::NativeMethodPromotionFile) && !IsAotCompiler()) {
+    std::string error_msg;
+    native_method_promotions_ = NativeMethodPromotions::Create(
+        runtime_options.GetOrDefault(Opt::NativeMethodPromotionFile), &error_msg);
+    if (native_method_promotions_ == nullptr) {
+      LOG(ERROR) << "Ignoring native method promotions: " << error_msg;
+    } else {
+      VLOG(jni) << "Loaded " << native_method_promotions_->Size()
+                << " native method promotions";
+    }
+  }
+  thread_list_ = new ThreadList(runtime_options.GetOrDefault(Opt::ThreadSuspendTimeout),
+                                runtime_options.GetOrDefault(Opt::TimeToSafepointRecords));
   intern_table_ = new InternTable;
 
   monitor_timeout_enable_ = runtime_options.GetOrDefault(Opt::MonitorTimeoutEnable);
@@ -1717,6 +1764,7 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   // Add the JniEnv handler.
   // TODO Refactor this stuff.
   java_vm_->AddEnvironmentHook(JNIEnvExt::GetEnvHandler);
+  java_vm_->AddEnvironmentHook(GetJniExtensionsEnvHandler);
 
   Thread::Startup();
 
@@ -2228,6 +2276,13 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
     os << "Running non JIT\n";
   }
   DumpDeoptimizations(os);
+  monitor_list_->DumpForSigQuit(os);
+  if (monitor_contention_profiler_ != nullptr) {
+    monitor_contention_profiler_->Dump(os);
+  }
+  if (jni_transition_profiler_ != nullptr) {
+    jni_transition_profiler_->Dump(os);
+  }
   TrackedAllocators::Dump(os);
   GetMetrics()->DumpForSigQuit(os);
   os << "\n";
@@ -2631,6 +2686,15 @@ void Runtime::RegisterAppInfo(const std::string& package_name,
     metrics_reporter_->NotifyAppInfoUpdated(&app_info_);
   }
 
+  if (startup_class_preload_threads_ != 0u && !GetStartupCompleted()) {
+    // Prefer the reference profile, which the application was compiled with.
+    oat_file_manager_->PreloadStartupClasses(
+        code_paths,
+        ref_profile_filename.empty() ? profile_output_filename : ref_profile_filename,
+        startup_class_preload_threads_,
+        startup_class_initialization_);
+  }
+
   if (jit_.get() == nullptr) {
     // We are not JITing. Nothing to do.
     return;
@@ -3218,6 +3282,9 @@ class Runtime::NotifyStartupCompletedTask : public gc::HeapTask {
       // Delete the thread pool used for app image loading since startup is assumed to be completed.
       ScopedTrace trace2("Delete thread pool");
       runtime->DeleteThreadPool();
+      // Stop preloading startup classes. Do not wait for the workers, they may be running
+      // application static initializers and would hold up the heap tasks queued after us.
+      runtime->GetOatFileManager().StopStartupClassThreadPool();
     }
   }
 };
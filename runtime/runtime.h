@@ -98,8 +98,11 @@ class InternTable;
 class IsMarkedVisitor;
 class JavaVMExt;
 class LinearAlloc;
+class JniTransitionProfiler;
+class MonitorContentionProfiler;
 class MonitorList;
 class MonitorPool;
+class NativeMethodPromotions;
 class NullPointerHandler;
 class OatFileAssistantTest;
 class OatFileManager;
@@ -366,6 +369,19 @@ class Runtime {
     return monitor_pool_;
   }
 
+  // Returns null if the monitor contention profiler is disabled.
+  MonitorContentionProfiler* GetMonitorContentionProfiler() const {
+    return monitor_contention_profiler_.get();
+  }
+
+  JniTransitionProfiler* GetJniTransitionProfiler() const {
+    return jni_transition_profiler_.get();
+  }
+
+  const NativeMethodPromotions* GetNativeMethodPromotions() const {
+    return native_method_promotions_.get();
+  }
+
   // Is the given object the special object used to mark a cleared JNI weak global?
   bool IsClearedJniWeakGlobal(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -614,14 +630,10 @@ class Runtime {
       REQUIRES_SHARED(Locks::mutator_lock_);
   void RecordWriteArray(mirror::Array* array, size_t index, uint64_t value)
       REQUIRES_SHARED(Locks::mutator_lock_);
-  void RecordStrongStringInsertion(ObjPtr<mirror::String> s)
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordWeakStringInsertion(ObjPtr<mirror::String> s)
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordStrongStringRemoval(ObjPtr<mirror::String> s)
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordWeakStringRemoval(ObjPtr<mirror::String> s)
-      REQUIRES(Locks::intern_table_lock_);
+  void RecordStrongStringInsertion(ObjPtr<mirror::String> s);
+  void RecordWeakStringInsertion(ObjPtr<mirror::String> s);
+  void RecordStrongStringRemoval(ObjPtr<mirror::String> s);
+  void RecordWeakStringRemoval(ObjPtr<mirror::String> s);
   void RecordResolveString(ObjPtr<mirror::DexCache> dex_cache, dex::StringIndex string_idx)
       REQUIRES_SHARED(Locks::mutator_lock_);
   void RecordResolveMethodType(ObjPtr<mirror::DexCache> dex_cache, dex::ProtoIndex proto_idx)
@@ -1023,6 +1035,34 @@ class Runtime {
     return verifier_missing_kthrow_fatal_;
   }
 
+  unsigned int GetStartupClassPreloadThreads() const {
+    return startup_class_preload_threads_;
+  }
+
+  bool IsStartupClassInitializationEnabled() const {
+    return startup_class_initialization_;
+  }
+
+  unsigned int GetParallelCheckpointThreads() const {
+    return parallel_checkpoint_threads_;
+  }
+
+  unsigned int GetFullDexCacheArrayLimit() const {
+    return full_dex_cache_array_limit_;
+  }
+
+  bool AreDexCacheStatsEnabled() const {
+    return dex_cache_stats_enabled_;
+  }
+
+  unsigned int GetInterpreterCacheSecondLevelSize() const {
+    return interpreter_cache_second_level_size_;
+  }
+
+  bool AreInterpreterCacheStatsEnabled() const {
+    return interpreter_cache_stats_enabled_;
+  }
+
   bool IsJavaZygoteForkLoopRequired() const {
     return force_java_zygote_fork_loop_;
   }
@@ -1194,6 +1234,9 @@ class Runtime {
   size_t max_spins_before_thin_lock_inflation_;
   MonitorList* monitor_list_;
   MonitorPool* monitor_pool_;
+  std::unique_ptr<MonitorContentionProfiler> monitor_contention_profiler_;
+  std::unique_ptr<JniTransitionProfiler> jni_transition_profiler_;
+  std::unique_ptr<NativeMethodPromotions> native_method_promotions_;
 
   ThreadList* thread_list_;
 
@@ -1457,6 +1500,13 @@ class Runtime {
   std::atomic<bool> startup_completed_ = false;
 
   bool verifier_missing_kthrow_fatal_;
+  unsigned int startup_class_preload_threads_;
+  bool startup_class_initialization_;
+  unsigned int parallel_checkpoint_threads_;
+  unsigned int full_dex_cache_array_limit_;
+  bool dex_cache_stats_enabled_;
+  unsigned int interpreter_cache_second_level_size_;
+  bool interpreter_cache_stats_enabled_;
   bool force_java_zygote_fork_loop_;
   bool perfetto_hprof_enabled_;
   bool perfetto_javaheapprof_enabled_;
@@ -180,6 +180,11 @@ void Thread::InitTlsEntryPoints() {
   }
   bool monitor_jni_entry_exit = false;
   PaletteShouldReportJniInvocations(&monitor_jni_entry_exit);
+  // The JNI transition profiler also relies on the monitored JNI entrypoints.
+  Runtime* runtime = Runtime::Current();
+  if (runtime != nullptr && runtime->GetJniTransitionProfiler() != nullptr) {
+    monitor_jni_entry_exit = true;
+  }
   if (monitor_jni_entry_exit) {
     AtomicSetFlag(ThreadFlag::kMonitorJniEntryExit);
   }
@@ -974,6 +979,8 @@ bool Thread::Init(ThreadList* thread_list, JavaVMExt* java_vm, JNIEnvExt* jni_en
     }
   }
 
+  interpreter_cache_.SetSecondLevelSize(Runtime::Current()->GetInterpreterCacheSecondLevelSize());
+
   ScopedTrace trace3("ThreadList::Register");
   thread_list->Register(this);
   return true;
@@ -1513,6 +1520,7 @@ bool Thread::PassActiveSuspendBarriers(Thread* self) {
     AtomicClearFlag(ThreadFlag::kActiveSuspendBarrier);
   }
 
+  last_suspend_barrier_pass_ns_.store(NanoTime(), std::memory_order_relaxed);
   uint32_t barrier_count = 0;
   for (uint32_t i = 0; i < kMaxSuspendBarriers; i++) {
     AtomicInteger* pending_threads = pass_barriers[i];
@@ -2026,6 +2034,12 @@ void Thread::DumpState(std::ostream& os, const Thread* thread, pid_t tid) {
     os << "  | stack=" << reinterpret_cast<void*>(thread->tlsPtr_.stack_begin) << "-"
         << reinterpret_cast<void*>(thread->tlsPtr_.stack_end) << " stackSize="
         << PrettySize(thread->tlsPtr_.stack_size) << "\n";
+    Runtime* runtime = Runtime::Current();
+    if (runtime != nullptr && runtime->AreInterpreterCacheStatsEnabled()) {
+      os << "  | interpreter cache: ";
+      thread->interpreter_cache_.DumpStats(os);
+      os << "\n";
+    }
     // Dump the held mutexes.
     os << "  | held mutexes=";
     for (size_t i = 0; i < kLockLevelCount; ++i) {
@@ -4235,41 +4249,53 @@ void Thread::VisitRoots(RootVisitor* visitor) {
 }
 #pragma GCC diagnostic pop
 
-void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
-  for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetArray()) {
-    const Instruction* inst = reinterpret_cast<const Instruction*>(entry.first);
-    if (inst != nullptr) {
-      if (inst->Opcode() == Instruction::NEW_INSTANCE ||
-          inst->Opcode() == Instruction::CHECK_CAST ||
-          inst->Opcode() == Instruction::INSTANCE_OF ||
-          inst->Opcode() == Instruction::NEW_ARRAY ||
-          inst->Opcode() == Instruction::CONST_CLASS) {
-        mirror::Class* cls = reinterpret_cast<mirror::Class*>(entry.second);
-        if (cls == nullptr || cls == Runtime::GetWeakClassSentinel()) {
-          // Entry got deleted in a previous sweep.
-          continue;
-        }
-        Runtime::ProcessWeakClass(
-            reinterpret_cast<GcRoot<mirror::Class>*>(&entry.second),
-            visitor,
-            Runtime::GetWeakClassSentinel());
-      } else if (inst->Opcode() == Instruction::CONST_STRING ||
-                 inst->Opcode() == Instruction::CONST_STRING_JUMBO) {
-        mirror::Object* object = reinterpret_cast<mirror::Object*>(entry.second);
-        mirror::Object* new_object = visitor->IsMarked(object);
-        // We know the string is marked because it's a strongly-interned string that
-        // is always alive (see b/117621117 for trying to make those strings weak).
-        // The IsMarked implementation of the CMS collector returns
-        // null for newly allocated objects, but we know those haven't moved. Therefore,
-        // only update the entry if we get a different non-null string.
-        if (new_object != nullptr && new_object != object) {
-          entry.second = reinterpret_cast<size_t>(new_object);
-        }
+static void SweepInterpreterCacheEntry(InterpreterCache::Entry& entry, IsMarkedVisitor* visitor)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  const Instruction* inst = reinterpret_cast<const Instruction*>(entry.first);
+  if (inst != nullptr) {
+    if (inst->Opcode() == Instruction::NEW_INSTANCE ||
+        inst->Opcode() == Instruction::CHECK_CAST ||
+        inst->Opcode() == Instruction::INSTANCE_OF ||
+        inst->Opcode() == Instruction::NEW_ARRAY ||
+        inst->Opcode() == Instruction::CONST_CLASS) {
+      mirror::Class* cls = reinterpret_cast<mirror::Class*>(entry.second);
+      if (cls == nullptr || cls == Runtime::GetWeakClassSentinel()) {
+        // Entry got deleted in a previous sweep.
+        return;
+      }
+      Runtime::ProcessWeakClass(
+          reinterpret_cast<GcRoot<mirror::Class>*>(&entry.second),
+          visitor,
+          Runtime::GetWeakClassSentinel());
+    } else if (inst->Opcode() == Instruction::CONST_STRING ||
+               inst->Opcode() == Instruction::CONST_STRING_JUMBO) {
+      mirror::Object* object = reinterpret_cast<mirror::Object*>(entry.second);
+      mirror::Object* new_object = visitor->IsMarked(object);
+      // We know the string is marked because it's a strongly-interned string that
+      // is always alive (see b/117621117 for trying to make those strings weak).
+      // The IsMarked implementation of the CMS collector returns
+      // null for newly allocated objects, but we know those haven't moved. Therefore,
+      // only update the entry if we get a different non-null string.
+      if (new_object != nullptr && new_object != object) {
+        entry.second = reinterpret_cast<size_t>(new_object);
       }
     }
   }
 }
 
+void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
+  for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetArray()) {
+    SweepInterpreterCacheEntry(entry, visitor);
+  }
+  for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetSecondLevelArray()) {
+    SweepInterpreterCacheEntry(entry, visitor);
+  }
+}
+
+void Thread::SweepReflectiveInvokeCache(IsMarkedVisitor* visitor) {
+  GetReflectiveInvokeCache()->Sweep(visitor);
+}
+
 // FIXME: clang-r433403 reports the below function exceeds frame size limit.
 // http://b/197647048
 #pragma GCC diagnostic push
@@ -4483,6 +4509,8 @@ void Thread::ClearAllInterpreterCaches() {
   static struct ClearInterpreterCacheClosure : Closure {
     void Run(Thread* thread) override {
       thread->GetInterpreterCache()->Clear(thread);
+      // The reflective invoke cache also holds pointers into dex files.
+      thread->GetReflectiveInvokeCache()->Clear();
     }
   } closure;
   Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
@@ -44,6 +44,7 @@
 #include "offsets.h"
 #include "read_barrier_config.h"
 #include "reflective_handle_scope.h"
+#include "reflective_invoke_cache.h"
 #include "runtime_globals.h"
 #include "runtime_stats.h"
 #include "thread_state.h"
@@ -1029,6 +1030,12 @@ class Thread {
     is_runtime_thread_ = is_runtime_thread;
   }
 
+  // Time at which the thread last passed a suspend barrier of ThreadList::SuspendAll, for
+  // time-to-safepoint tracing.
+  uint64_t GetLastSuspendBarrierPassTime() const {
+    return last_suspend_barrier_pass_ns_.load(std::memory_order_relaxed);
+  }
+
   uint32_t CorePlatformApiCookie() {
     return core_platform_api_cookie_;
   }
@@ -1343,6 +1350,10 @@ class Thread {
   // called if the pre-conditions might no longer hold true.
   static void ClearAllInterpreterCaches();
 
+  ReflectiveInvokeCache* GetReflectiveInvokeCache() {
+    return &reflective_invoke_cache_;
+  }
+
   template<PointerSize pointer_size>
   static constexpr ThreadOffset<pointer_size> InterpreterCacheOffset() {
     return ThreadOffset<pointer_size>(OFFSETOF_MEMBER(Thread, interpreter_cache_));
@@ -1526,6 +1537,7 @@ class Thread {
   void VisitRoots(RootVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
 
   void SweepInterpreterCache(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+  void SweepReflectiveInvokeCache(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
 
   static bool IsAotCompiler();
 
@@ -2013,10 +2025,16 @@ class Thread {
   // True if the thread is some form of runtime thread (ex, GC or JIT).
   bool is_runtime_thread_;
 
+  // See GetLastSuspendBarrierPassTime().
+  std::atomic<uint64_t> last_suspend_barrier_pass_ns_{0u};
+
   // Set during execution of JNI methods that get field and method id's as part of determining if
   // the caller is allowed to access all fields and methods in the Core Platform API.
   uint32_t core_platform_api_cookie_ = 0;
 
+  // Small thread-local cache for reflective calls, keyed by the target ArtMethod.
+  ReflectiveInvokeCache reflective_invoke_cache_;
+
   friend class gc::collector::SemiSpace;  // For getting stack traces.
   friend class Runtime;  // For CreatePeer.
   friend class QuickExceptionHandler;  // For dumping the stack.
@@ -28,6 +28,7 @@
 #include "nativehelper/scoped_local_ref.h"
 #include "nativehelper/scoped_utf_chars.h"
 
+#include "art_method.h"
 #include "base/aborting.h"
 #include "base/histogram-inl.h"
 #include "base/mutex-inl.h"
@@ -46,6 +47,8 @@
 #include "native_stack_dump.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
+#include "thread_pool.h"
+#include "time_to_safepoint_tracer.h"
 #include "trace.h"
 #include "well_known_classes.h"
 
@@ -71,7 +74,11 @@ static constexpr useconds_t kThreadSuspendMaxSleepUs = 5000;
 // some history.
 static constexpr bool kDumpUnattachedThreadNativeStackForSigQuit = true;
 
-ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
+// Number of suspended threads a checkpoint worker runs the checkpoint function for in one task.
+// The requesting thread takes the first batch itself.
+static constexpr size_t kSuspendedThreadsPerCheckpointTask = 16;
+
+ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns, size_t time_to_safepoint_records)
     : suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_historam_("suspend all histogram", 16, 64),
@@ -80,6 +87,9 @@ ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
       empty_checkpoint_barrier_(new Barrier(0)) {
   CHECK(Monitor::IsValidLockWord(LockWord::FromThinLockId(kMaxThreadId, 1, 0U)));
+  if (time_to_safepoint_records != 0u) {
+    time_to_safepoint_tracer_.reset(new TimeToSafepointTracer(time_to_safepoint_records));
+  }
 }
 
 ThreadList::~ThreadList() {
@@ -142,6 +152,9 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_historam_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
   }
+  if (time_to_safepoint_tracer_ != nullptr) {
+    time_to_safepoint_tracer_->Dump(os);
+  }
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   Dump(os, dump_native_stack);
   DumpUnattachedThreads(os, dump_native_stack && kDumpUnattachedThreadNativeStackForSigQuit);
@@ -314,6 +327,7 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback
   Locks::thread_list_lock_->AssertNotHeld(self);
   Locks::thread_suspend_count_lock_->AssertNotHeld(self);
 
+  const uint64_t start_time = NanoTime();
   std::vector<Thread*> suspended_count_modified_threads;
   size_t count = 0;
   {
@@ -374,16 +388,7 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback
   checkpoint_function->Run(self);
 
   // Run the checkpoint on the suspended threads.
-  for (const auto& thread : suspended_count_modified_threads) {
-    // We know for sure that the thread is suspended at this point.
-    DCHECK(thread->IsSuspended());
-    checkpoint_function->Run(thread);
-    {
-      MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
-      bool updated = thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
-      DCHECK(updated);
-    }
-  }
+  RunCheckpointOnSuspendedThreads(self, checkpoint_function, suspended_count_modified_threads);
 
   {
     // Imitate ResumeAll, threads may be waiting on Thread::resume_cond_ since we raised their
@@ -392,14 +397,133 @@ size_t ThreadList::RunCheckpoint(Closure* checkpoint_function, Closure* callback
     Thread::resume_cond_->Broadcast(self);
   }
 
+  Runtime::Current()->GetMetrics()->CheckpointTime()->Add(
+      static_cast<int64_t>(NsToUs(NanoTime() - start_time)));
   return count;
 }
 
+static void RunCheckpointOnSuspendedThread(Thread* self,
+                                           Closure* checkpoint_function,
+                                           Thread* thread)
+    REQUIRES(!Locks::thread_suspend_count_lock_) {
+  // We know for sure that the thread is suspended at this point.
+  DCHECK(thread->IsSuspended());
+  checkpoint_function->Run(thread);
+  MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+  bool updated = thread->ModifySuspendCount(self, -1, nullptr, SuspendReason::kInternal);
+  DCHECK(updated);
+}
+
+class SuspendedThreadsCheckpointTask final : public Task {
+ public:
+  SuspendedThreadsCheckpointTask(Closure* checkpoint_function,
+                                 Thread* const* threads,
+                                 size_t num_threads,
+                                 Barrier* barrier)
+      : checkpoint_function_(checkpoint_function),
+        threads_(threads),
+        num_threads_(num_threads),
+        barrier_(barrier),
+        done_(false) {}
+
+  void Run(Thread* self) override NO_THREAD_SAFETY_ANALYSIS {
+    // Run the checkpoint function with the mutator lock held, like the requester does. Take it
+    // directly rather than becoming runnable: the requester may be runnable and waiting for us,
+    // so a pending suspend all would wait for the requester while we wait for the suspend all.
+    // Tasks left over when the pool is deleted run on the thread deleting it, which may already
+    // hold the lock.
+    if (Locks::mutator_lock_->IsSharedHeld(self)) {
+      RunCheckpoints(self);
+    } else {
+      ReaderMutexLock mu(self, *Locks::mutator_lock_);
+      RunCheckpoints(self);
+    }
+    done_ = true;
+    barrier_->Pass(self);
+  }
+
+  void Finalize() override {
+    // Tasks left over when the pool is deleted must still run, the requester waits for them.
+    if (!done_) {
+      Run(Thread::Current());
+    }
+    delete this;
+  }
+
+ private:
+  void RunCheckpoints(Thread* self) REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t i = 0; i != num_threads_; ++i) {
+      RunCheckpointOnSuspendedThread(self, checkpoint_function_, threads_[i]);
+    }
+  }
+
+  Closure* const checkpoint_function_;
+  Thread* const* const threads_;
+  const size_t num_threads_;
+  Barrier* const barrier_;
+  bool done_;
+};
+
+void ThreadList::RunCheckpointOnSuspendedThreads(Thread* self,
+                                                 Closure* checkpoint_function,
+                                                 const std::vector<Thread*>& threads) {
+  // The workers pass the barrier before we wait on it, so it starts at zero and we only add the
+  // number of tasks once we have run our own batch.
+  Barrier barrier(0);
+  size_t num_tasks = 0;
+  size_t num_local_threads = threads.size();
+  // Only checkpoint functions that opt in may run concurrently on other threads.
+  if (threads.size() > kSuspendedThreadsPerCheckpointTask && checkpoint_function->IsThreadSafe()) {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    if (checkpoint_thread_pool_ != nullptr) {
+      for (size_t begin = kSuspendedThreadsPerCheckpointTask;
+           begin < threads.size();
+           begin += kSuspendedThreadsPerCheckpointTask) {
+        size_t end = std::min(begin + kSuspendedThreadsPerCheckpointTask, threads.size());
+        checkpoint_thread_pool_->AddTask(
+            self,
+            new SuspendedThreadsCheckpointTask(
+                checkpoint_function, threads.data() + begin, end - begin, &barrier));
+        ++num_tasks;
+      }
+      num_local_threads = kSuspendedThreadsPerCheckpointTask;
+    }
+  }
+  for (size_t i = 0; i != num_local_threads; ++i) {
+    RunCheckpointOnSuspendedThread(self, checkpoint_function, threads[i]);
+  }
+  if (num_tasks != 0) {
+    // The caller may be runnable and hold other locks. The workers never need them: they only
+    // run the checkpoint function, like we would have done ourselves.
+    barrier.Increment<Barrier::kAllowHoldingLocks>(self, num_tasks);
+  }
+}
+
+void ThreadList::CreateCheckpointThreadPool(size_t num_threads) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<ThreadPool> pool(
+      new ThreadPool("Checkpoint thread pool", num_threads, /*create_peers=*/ false));
+  pool->StartWorkers(self);
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  CHECK(checkpoint_thread_pool_ == nullptr);
+  checkpoint_thread_pool_ = std::move(pool);
+}
+
+void ThreadList::DeleteCheckpointThreadPool() {
+  std::unique_ptr<ThreadPool> pool;
+  {
+    MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
+    pool = std::move(checkpoint_thread_pool_);
+  }
+  // Delete the pool outside of the lock, as its workers need it to detach.
+}
+
 void ThreadList::RunEmptyCheckpoint() {
   Thread* self = Thread::Current();
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
   Locks::thread_suspend_count_lock_->AssertNotHeld(self);
+  const uint64_t start_time = NanoTime();
   std::vector<uint32_t> runnable_thread_ids;
   size_t count = 0;
   Barrier* barrier = empty_checkpoint_barrier_.get();
@@ -499,6 +623,8 @@ void ThreadList::RunEmptyCheckpoint() {
       }
     }
   }
+  Runtime::Current()->GetMetrics()->EmptyCheckpointTime()->Add(
+      static_cast<int64_t>(NsToUs(NanoTime() - start_time)));
 }
 
 // A checkpoint/suspend-all hybrid to switch thread roots from
@@ -610,7 +736,9 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     ScopedTrace trace("Suspending mutator threads");
     const uint64_t start_time = NanoTime();
 
-    SuspendAllInternal(self, self);
+    SuspendAllPhases phases;
+    SuspendAllInternal(self, self, nullptr, SuspendReason::kInternal, &phases);
+    const uint64_t lock_start_time = NanoTime();
     // All threads are known to have suspended (but a thread may still own the mutator lock)
     // Make sure this thread grabs exclusive access to the mutator lock and its protected data.
 #if HAVE_TIMED_RWLOCK
@@ -635,9 +763,15 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     const uint64_t end_time = NanoTime();
     const uint64_t suspend_time = end_time - start_time;
     suspend_all_historam_.AdjustAndAddValue(suspend_time);
+    Runtime::Current()->GetMetrics()->SuspendAllTime()->Add(
+        static_cast<int64_t>(NsToUs(suspend_time)));
     if (suspend_time > kLongThreadSuspendThreshold) {
       LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
     }
+    if (time_to_safepoint_tracer_ != nullptr) {
+      Locks::mutator_lock_->AssertExclusiveHeld(self);
+      RecordTimeToSafepoint(self, cause, start_time, phases, lock_start_time, end_time);
+    }
 
     if (kDebugLocking) {
       // Debug check that all threads are suspended.
@@ -657,7 +791,8 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
 void ThreadList::SuspendAllInternal(Thread* self,
                                     Thread* ignore1,
                                     Thread* ignore2,
-                                    SuspendReason reason) {
+                                    SuspendReason reason,
+                                    SuspendAllPhases* phases) {
   Locks::mutator_lock_->AssertNotExclusiveHeld(self);
   Locks::thread_list_lock_->AssertNotHeld(self);
   Locks::thread_suspend_count_lock_->AssertNotHeld(self);
@@ -682,6 +817,8 @@ void ThreadList::SuspendAllInternal(Thread* self,
   if (ignore2 != nullptr && ignore1 != ignore2) {
     ++num_ignored;
   }
+  const uint64_t request_start_time = NanoTime();
+  size_t num_runnable_threads = 0u;
   {
     MutexLock mu(self, *Locks::thread_list_lock_);
     MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
@@ -704,8 +841,17 @@ void ThreadList::SuspendAllInternal(Thread* self,
         // Only clear the counter for the current thread.
         thread->ClearSuspendBarrier(&pending_threads);
         pending_threads.fetch_sub(1, std::memory_order_seq_cst);
+      } else {
+        ++num_runnable_threads;
       }
     }
+    if (phases != nullptr) {
+      phases->num_threads = list_.size() - num_ignored;
+      phases->num_runnable_threads = num_runnable_threads;
+    }
+  }
+  if (phases != nullptr) {
+    phases->request_end_ns = NanoTime();
   }
 
   // Wait for the barrier to be passed by all runnable threads. This wait
@@ -755,6 +901,48 @@ void ThreadList::SuspendAllInternal(Thread* self,
       break;
     }
   }
+  Runtime::Current()->GetMetrics()->TimeToSafepoint()->Add(
+      static_cast<int64_t>(NsToUs(NanoTime() - request_start_time)));
+}
+
+void ThreadList::RecordTimeToSafepoint(Thread* self,
+                                       const char* cause,
+                                       uint64_t start_time,
+                                       const SuspendAllPhases& phases,
+                                       uint64_t lock_start_time,
+                                       uint64_t end_time) {
+  TimeToSafepointTracer::Record record;
+  record.cause = cause;
+  record.num_threads = phases.num_threads;
+  record.num_runnable_threads = phases.num_runnable_threads;
+  record.request_ns = phases.request_end_ns - start_time;
+  record.wait_ns = lock_start_time - phases.request_end_ns;
+  record.lock_ns = end_time - lock_start_time;
+  if (phases.num_runnable_threads != 0u) {
+    // All threads are suspended where they reached the suspend point, so the last thread to pass
+    // the barrier is still in the method that held up the suspension.
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    Thread* last_thread = nullptr;
+    uint64_t last_pass_time = start_time;
+    for (Thread* thread : list_) {
+      uint64_t pass_time = thread->GetLastSuspendBarrierPassTime();
+      if (thread != self && pass_time >= last_pass_time) {
+        last_thread = thread;
+        last_pass_time = pass_time;
+      }
+    }
+    if (last_thread != nullptr) {
+      last_thread->GetThreadName(record.last_thread);
+      uint32_t dex_pc = 0u;
+      ArtMethod* method = last_thread->GetCurrentMethod(&dex_pc,
+                                                        /*check_suspended=*/ true,
+                                                        /*abort_on_error=*/ false);
+      record.last_method = (method == nullptr)
+          ? "<no managed frame>"
+          : StringPrintf("%s@%u", method->PrettyMethod().c_str(), dex_pc);
+    }
+  }
+  time_to_safepoint_tracer_->AddRecord(std::move(record));
 }
 
 void ThreadList::ResumeAll() {
@@ -1411,6 +1599,7 @@ void ThreadList::SweepInterpreterCaches(IsMarkedVisitor* visitor) const {
   MutexLock mu(Thread::Current(), *Locks::thread_list_lock_);
   for (const auto& thread : list_) {
     thread->SweepInterpreterCache(visitor);
+    thread->SweepReflectiveInvokeCache(visitor);
   }
 }
 
@@ -27,6 +27,7 @@
 
 #include <bitset>
 #include <list>
+#include <memory>
 #include <vector>
 
 namespace art {
@@ -40,6 +41,8 @@ class Closure;
 class IsMarkedVisitor;
 class RootVisitor;
 class Thread;
+class ThreadPool;
+class TimeToSafepointTracer;
 class TimingLogger;
 enum VisitRootFlags : uint8_t;
 
@@ -51,7 +54,7 @@ class ThreadList {
   static constexpr uint64_t kDefaultThreadSuspendTimeout =
       kIsDebugBuild ? 50'000'000'000ull : 10'000'000'000ull;
 
-  explicit ThreadList(uint64_t thread_suspend_timeout_ns);
+  ThreadList(uint64_t thread_suspend_timeout_ns, size_t time_to_safepoint_records);
   ~ThreadList();
 
   void ShutDown();
@@ -114,10 +117,22 @@ class ThreadList {
   // return value includes already suspended threads for b/24191051. Runs or requests the
   // callback, if non-null, inside the thread_list_lock critical section after determining the
   // runnable/suspended states of the threads. Does not wait for completion of the callbacks in
-  // running threads.
+  // running threads. If there is a checkpoint thread pool and the checkpoint function is thread
+  // safe (see Closure::IsThreadSafe), it may be run on behalf of suspended threads by the
+  // workers of that pool, concurrently with the caller and with the mutator lock shared-held.
   size_t RunCheckpoint(Closure* checkpoint_function, Closure* callback = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Create or delete the pool of workers that RunCheckpoint uses to run the checkpoint function
+  // on behalf of suspended threads when there are many of them.
+  void CreateCheckpointThreadPool(size_t num_threads) REQUIRES(!Locks::thread_list_lock_);
+  void DeleteCheckpointThreadPool() REQUIRES(!Locks::thread_list_lock_);
+
+  // Null unless -XX:TimeToSafepointRecords is set.
+  TimeToSafepointTracer* GetTimeToSafepointTracer() const {
+    return time_to_safepoint_tracer_.get();
+  }
+
   // Run an empty checkpoint on threads. Wait until threads pass the next suspend point or are
   // suspended. This is used to ensure that the threads finish or aren't in the middle of an
   // in-flight mutator heap access (eg. a read barrier.) Runnable threads will respond by
@@ -194,18 +209,43 @@ class ThreadList {
   size_t RunCheckpoint(Closure* checkpoint_function, bool includeSuspended)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Run the checkpoint function on behalf of the given suspended threads, and decrement their
+  // suspend count.
+  void RunCheckpointOnSuspendedThreads(Thread* self,
+                                       Closure* checkpoint_function,
+                                       const std::vector<Thread*>& threads)
+      REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
+
   void DumpUnattachedThreads(std::ostream& os, bool dump_native_stack)
       REQUIRES(!Locks::thread_list_lock_);
 
   void SuspendAllDaemonThreadsForShutdown()
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // What SuspendAllInternal saw, for time-to-safepoint tracing.
+  struct SuspendAllPhases {
+    // Time at which all suspend counts were raised.
+    uint64_t request_end_ns = 0u;
+    size_t num_threads = 0u;
+    size_t num_runnable_threads = 0u;
+  };
+
   void SuspendAllInternal(Thread* self,
                           Thread* ignore1,
                           Thread* ignore2 = nullptr,
-                          SuspendReason reason = SuspendReason::kInternal)
+                          SuspendReason reason = SuspendReason::kInternal,
+                          SuspendAllPhases* phases = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
+  // Add a time-to-safepoint record for a SuspendAll that started at start_time.
+  void RecordTimeToSafepoint(Thread* self,
+                             const char* cause,
+                             uint64_t start_time,
+                             const SuspendAllPhases& phases,
+                             uint64_t lock_start_time,
+                             uint64_t end_time)
+      REQUIRES(!Locks::thread_list_lock_) REQUIRES(Locks::mutator_lock_);
+
   void AssertThreadsAreSuspended(Thread* self, Thread* ignore1, Thread* ignore2 = nullptr)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
@@ -236,6 +276,11 @@ class ThreadList {
 
   std::unique_ptr<Barrier> empty_checkpoint_barrier_;
 
+  // Workers running checkpoints on behalf of suspended threads, see RunCheckpoint.
+  std::unique_ptr<ThreadPool> checkpoint_thread_pool_ GUARDED_BY(Locks::thread_list_lock_);
+
+  std::unique_ptr<TimeToSafepointTracer> time_to_safepoint_tracer_;
+
   friend class Thread;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadList);
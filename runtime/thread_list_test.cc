@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_list.h"
+
+#include <set>
+
+#include "base/atomic.h"
+#include "base/mutex-inl.h"
+#include "common_runtime_test.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread-current-inl.h"
+#include "thread_pool.h"
+
+namespace art {
+
+// Counts the runs without the mutator lock, the runs for the threads of `threads`, and the ones
+// of those not on `requester`, if set.
+class CountingCheckpoint : public Closure {
+ public:
+  CountingCheckpoint(const std::set<Thread*>& threads, Thread* requester, bool thread_safe)
+      : threads_(threads), requester_(requester), thread_safe_(thread_safe) {}
+
+  void Run(Thread* thread) override {
+    Thread* self = Thread::Current();
+    if (!Locks::mutator_lock_->IsSharedHeld(self)) {
+      ++unlocked_runs_;
+    }
+    if (threads_.find(thread) != threads_.end()) {
+      ++runs_;
+      if (requester_ != nullptr && self != requester_) {
+        ++other_thread_runs_;
+      }
+    }
+  }
+
+  bool IsThreadSafe() const override {
+    return thread_safe_;
+  }
+
+  int32_t GetRuns() const { return runs_.load(std::memory_order_seq_cst); }
+  int32_t GetUnlockedRuns() const { return unlocked_runs_.load(std::memory_order_seq_cst); }
+  int32_t GetOtherThreadRuns() const { return other_thread_runs_.load(std::memory_order_seq_cst); }
+
+ private:
+  const std::set<Thread*>& threads_;
+  Thread* const requester_;
+  const bool thread_safe_;
+  AtomicInteger runs_{0};
+  AtomicInteger unlocked_runs_{0};
+  AtomicInteger other_thread_runs_{0};
+};
+
+class ThreadListTest : public CommonRuntimeTest {
+ protected:
+  static constexpr size_t kNumSuspendedThreads = 64;
+  static constexpr size_t kNumCheckpointThreads = 4;
+};
+
+// Idle thread pool workers wait in native code, so they are suspended for RunCheckpoint, which
+// runs the checkpoint function on their behalf.
+TEST_F(ThreadListTest, CheckpointOnSuspendedThreads) {
+  Thread* self = Thread::Current();
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  ThreadPool idle_pool("Idle thread pool", kNumSuspendedThreads);
+  std::set<Thread*> idle_threads;
+  for (ThreadPoolWorker* worker : idle_pool.GetWorkers()) {
+    idle_threads.insert(worker->GetThread());
+  }
+  ASSERT_EQ(idle_threads.size(), kNumSuspendedThreads);
+  thread_list->CreateCheckpointThreadPool(kNumCheckpointThreads);
+
+  for (int i = 0; i < 10; ++i) {
+    CountingCheckpoint checkpoint(idle_threads, /* requester= */ nullptr, /* thread_safe= */ true);
+    {
+      ScopedObjectAccess soa(self);
+      thread_list->RunCheckpoint(&checkpoint);
+    }
+    EXPECT_EQ(checkpoint.GetRuns(), static_cast<int32_t>(kNumSuspendedThreads));
+    EXPECT_EQ(checkpoint.GetUnlockedRuns(), 0);
+  }
+
+  // Checkpoints that do not opt in only run on the requester.
+  CountingCheckpoint checkpoint(idle_threads, self, /* thread_safe= */ false);
+  {
+    ScopedObjectAccess soa(self);
+    thread_list->RunCheckpoint(&checkpoint);
+  }
+  EXPECT_EQ(checkpoint.GetRuns(), static_cast<int32_t>(kNumSuspendedThreads));
+  EXPECT_EQ(checkpoint.GetUnlockedRuns(), 0);
+  EXPECT_EQ(checkpoint.GetOtherThreadRuns(), 0);
+
+  thread_list->DeleteCheckpointThreadPool();
+}
+
+}  // namespace art
@@ -159,6 +159,16 @@ void ThreadPool::RemoveAllTasks(Thread* self) {
   tasks_.clear();
 }
 
+void ThreadPool::SetFinishing(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  finishing_ = true;
+}
+
+bool ThreadPool::IsFinishing(Thread* self) {
+  MutexLock mu(self, task_queue_lock_);
+  return finishing_ || shutting_down_;
+}
+
 ThreadPool::ThreadPool(const char* name,
                        size_t num_threads,
                        bool create_peers,
@@ -169,6 +179,7 @@ ThreadPool::ThreadPool(const char* name,
     completion_condition_("task completion condition", task_queue_lock_),
     started_(false),
     shutting_down_(false),
+    finishing_(false),
     waiting_count_(0),
     start_time_(0),
     total_wait_time_(0),
@@ -323,6 +334,15 @@ void ThreadPool::SetPthreadPriority(int priority) {
   }
 }
 
+ThreadPoolWorker* ThreadPool::GetWorker(Thread* self) {
+  for (ThreadPoolWorker* worker : GetWorkers()) {
+    if (worker->GetThread() == self) {
+      return worker;
+    }
+  }
+  return nullptr;
+}
+
 void ThreadPool::CheckPthreadPriority(int priority) {
 #if defined(ART_TARGET_ANDROID)
   for (ThreadPoolWorker* worker : threads_) {
@@ -33,6 +33,11 @@ class Closure {
  public:
   virtual ~Closure() { }
   virtual void Run(Thread* self) = 0;
+
+  // Whether Run may be called for different threads at the same time, and from threads other
+  // than the one that requested it. Checkpoints opting in may be run on behalf of suspended
+  // threads by the workers of the checkpoint thread pool, see ThreadList::RunCheckpoint.
+  virtual bool IsThreadSafe() const { return false; }
 };
 
 class FunctionClosure : public Closure {
@@ -130,6 +135,14 @@ class ThreadPool {
   // Remove all tasks in the queue.
   void RemoveAllTasks(Thread* self) REQUIRES(!task_queue_lock_);
 
+  // Tell tasks that re-enqueue themselves to stop doing so, for example before waiting for the
+  // pool to drain at shutdown.
+  void SetFinishing(Thread* self) REQUIRES(!task_queue_lock_);
+
+  // Whether SetFinishing was called or the threads are being deleted. Tasks that re-enqueue
+  // themselves must check this in Finalize and delete themselves instead.
+  bool IsFinishing(Thread* self) REQUIRES(!task_queue_lock_);
+
   // Create a named thread pool with the given number of threads.
   //
   // If create_peers is true, all worker threads will have a Java peer object. Note that if the
@@ -166,6 +179,9 @@ class ThreadPool {
   // Set the "nice" priority for threads in the pool.
   void SetPthreadPriority(int priority);
 
+  // Return the worker running on `self`, or null if `self` is not a worker of this pool.
+  ThreadPoolWorker* GetWorker(Thread* self);
+
   // CHECK that the "nice" priority of threads in the pool is the given
   // `priority`.
   void CheckPthreadPriority(int priority);
@@ -196,6 +212,7 @@ class ThreadPool {
   ConditionVariable completion_condition_ GUARDED_BY(task_queue_lock_);
   volatile bool started_ GUARDED_BY(task_queue_lock_);
   volatile bool shutting_down_ GUARDED_BY(task_queue_lock_);
+  bool finishing_ GUARDED_BY(task_queue_lock_);
   // How many worker threads are waiting on the condition.
   volatile size_t waiting_count_ GUARDED_BY(task_queue_lock_);
   std::deque<Task*> tasks_ GUARDED_BY(task_queue_lock_);
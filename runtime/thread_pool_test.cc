@@ -160,6 +160,48 @@ TEST_F(ThreadPoolTest, RecursiveTest) {
   EXPECT_EQ((1 << depth) - 1, count.load(std::memory_order_seq_cst));
 }
 
+// A task that re-enqueues itself until its pool is finishing, like the JIT startup profile task.
+class RequeueTask : public Task {
+ public:
+  RequeueTask(ThreadPool* const thread_pool, AtomicInteger* count)
+      : thread_pool_(thread_pool), count_(count) {}
+
+  void Run(Thread* self ATTRIBUTE_UNUSED) override {
+    usleep(100);
+    ++*count_;
+  }
+
+  void Finalize() override {
+    Thread* self = Thread::Current();
+    if (thread_pool_->IsFinishing(self)) {
+      delete this;
+    } else {
+      thread_pool_->AddTask(self, this);
+    }
+  }
+
+ private:
+  ThreadPool* const thread_pool_;
+  AtomicInteger* const count_;
+};
+
+// Test that waiting for a finishing pool terminates even with tasks that re-enqueue themselves.
+TEST_F(ThreadPoolTest, FinishingTest) {
+  Thread* self = Thread::Current();
+  ThreadPool thread_pool("Thread pool test thread pool", num_threads);
+  AtomicInteger count(0);
+  EXPECT_FALSE(thread_pool.IsFinishing(self));
+  thread_pool.AddTask(self, new RequeueTask(&thread_pool, &count));
+  thread_pool.StartWorkers(self);
+  while (count.load(std::memory_order_seq_cst) < 10) {
+    usleep(100);
+  }
+  thread_pool.SetFinishing(self);
+  EXPECT_TRUE(thread_pool.IsFinishing(self));
+  thread_pool.Wait(self, /* do_work= */ false, /* may_hold_locks= */ false);
+  EXPECT_EQ(thread_pool.GetTaskCount(self), 0u);
+}
+
 class PeerTask : public Task {
  public:
   PeerTask() {}
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "time_to_safepoint_tracer.h"
+
+#include <ostream>
+
+#include "base/time_utils.h"
+#include "thread-current-inl.h"
+
+namespace art {
+
+TimeToSafepointTracer::TimeToSafepointTracer(size_t capacity)
+    : capacity_(capacity),
+      lock_("Time to safepoint tracer lock", kGenericBottomLock),
+      next_(0u),
+      total_records_(0u) {
+  DCHECK_NE(capacity, 0u);
+}
+
+void TimeToSafepointTracer::AddRecord(Record&& record) {
+  MutexLock mu(Thread::Current(), lock_);
+  ++total_records_;
+  if (records_.size() < capacity_) {
+    records_.push_back(std::move(record));
+  } else {
+    records_[next_] = std::move(record);
+    next_ = (next_ + 1u) % capacity_;
+  }
+}
+
+std::vector<TimeToSafepointTracer::Record> TimeToSafepointTracer::GetRecords() const {
+  MutexLock mu(Thread::Current(), lock_);
+  std::vector<Record> records;
+  records.reserve(records_.size());
+  records.insert(records.end(), records_.begin() + next_, records_.end());
+  records.insert(records.end(), records_.begin(), records_.begin() + next_);
+  return records;
+}
+
+uint64_t TimeToSafepointTracer::GetTotalRecords() const {
+  MutexLock mu(Thread::Current(), lock_);
+  return total_records_;
+}
+
+void TimeToSafepointTracer::Dump(std::ostream& os) const {
+  os << "Time to safepoint: " << GetTotalRecords() << " suspend all requests\n";
+  for (const Record& record : GetRecords()) {
+    os << "  " << record.cause << ": request " << PrettyDuration(record.request_ns)
+       << ", wait " << PrettyDuration(record.wait_ns)
+       << ", lock " << PrettyDuration(record.lock_ns)
+       << ", " << record.num_runnable_threads << "/" << record.num_threads << " runnable";
+    if (!record.last_thread.empty()) {
+      os << ", last \"" << record.last_thread << "\" in " << record.last_method;
+    }
+    os << "\n";
+  }
+}
+
+}  // namespace art
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_TIME_TO_SAFEPOINT_TRACER_H_
+#define ART_RUNTIME_TIME_TO_SAFEPOINT_TRACER_H_
+
+#include <stdint.h>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/locks.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+
+namespace art {
+
+// Keeps the most recent ThreadList::SuspendAll requests in a ring buffer, with the time spent in
+// each phase and the thread that was the last to reach a suspend point, for SIGQUIT dumps.
+class TimeToSafepointTracer {
+ public:
+  struct Record {
+    // Cause passed to SuspendAll.
+    std::string cause;
+    // Number of threads asked to suspend, and how many of them were runnable and had to reach
+    // a suspend point.
+    size_t num_threads;
+    size_t num_runnable_threads;
+    // Time to raise the suspend counts of all threads.
+    uint64_t request_ns;
+    // Time for the runnable threads to reach a suspend point after the request.
+    uint64_t wait_ns;
+    // Time to acquire the mutator lock exclusively once all threads are suspended.
+    uint64_t lock_ns;
+    // Name of the last thread to reach a suspend point, empty if no thread was runnable.
+    std::string last_thread;
+    // Method the last thread was running when it reached the suspend point.
+    std::string last_method;
+  };
+
+  explicit TimeToSafepointTracer(size_t capacity);
+
+  void AddRecord(Record&& record) REQUIRES(!lock_);
+
+  // Return the records in the buffer, oldest first.
+  std::vector<Record> GetRecords() const REQUIRES(!lock_);
+
+  // Number of records added since startup, including the ones overwritten.
+  uint64_t GetTotalRecords() const REQUIRES(!lock_);
+
+  void Dump(std::ostream& os) const REQUIRES(!lock_);
+
+ private:
+  const size_t capacity_;
+  mutable Mutex lock_;
+  std::vector<Record> records_ GUARDED_BY(lock_);
+  // Index of the slot the next record goes to, once the buffer is full.
+  size_t next_ GUARDED_BY(lock_);
+  uint64_t total_records_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(TimeToSafepointTracer);
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_TIME_TO_SAFEPOINT_TRACER_H_
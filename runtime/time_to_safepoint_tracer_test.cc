@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "time_to_safepoint_tracer.h"
+
+#include <sstream>
+
+#include "common_runtime_test.h"
+#include "thread_list.h"
+
+namespace art {
+
+class TimeToSafepointTracerTest : public CommonRuntimeTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    options->push_back(std::make_pair("-XX:TimeToSafepointRecords=4", nullptr));
+  }
+};
+
+static TimeToSafepointTracer::Record MakeRecord(const char* cause, uint64_t wait_ns) {
+  TimeToSafepointTracer::Record record;
+  record.cause = cause;
+  record.num_threads = 2u;
+  record.num_runnable_threads = 1u;
+  record.request_ns = 0u;
+  record.wait_ns = wait_ns;
+  record.lock_ns = 0u;
+  record.last_thread = "worker";
+  record.last_method = "void Main.loop()";
+  return record;
+}
+
+TEST_F(TimeToSafepointTracerTest, RingBuffer) {
+  TimeToSafepointTracer tracer(/* capacity= */ 2u);
+  EXPECT_TRUE(tracer.GetRecords().empty());
+
+  tracer.AddRecord(MakeRecord("first", 1u));
+  tracer.AddRecord(MakeRecord("second", 2u));
+  tracer.AddRecord(MakeRecord("third", 3u));
+  EXPECT_EQ(tracer.GetTotalRecords(), 3u);
+
+  // The oldest record was overwritten, the others come oldest first.
+  std::vector<TimeToSafepointTracer::Record> records = tracer.GetRecords();
+  ASSERT_EQ(records.size(), 2u);
+  EXPECT_EQ(records[0].cause, "second");
+  EXPECT_EQ(records[1].cause, "third");
+  EXPECT_EQ(records[1].wait_ns, 3u);
+
+  std::ostringstream oss;
+  tracer.Dump(oss);
+  EXPECT_NE(oss.str().find("3 suspend all requests"), std::string::npos) << oss.str();
+  EXPECT_NE(oss.str().find("last \"worker\" in void Main.loop()"), std::string::npos) << oss.str();
+}
+
+// SuspendAll records its phases when tracing is enabled.
+TEST_F(TimeToSafepointTracerTest, SuspendAll) {
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  ASSERT_NE(thread_list->GetTimeToSafepointTracer(), nullptr);
+  uint64_t total_records = thread_list->GetTimeToSafepointTracer()->GetTotalRecords();
+  {
+    ScopedSuspendAll ssa("TimeToSafepointTracerTest");
+  }
+  EXPECT_EQ(thread_list->GetTimeToSafepointTracer()->GetTotalRecords(), total_records + 1u);
+  EXPECT_EQ(thread_list->GetTimeToSafepointTracer()->GetRecords().back().cause,
+            "TimeToSafepointTracerTest");
+}
+
+}  // namespace art
@@ -103,7 +103,8 @@ enum TraceAction {
 
 // Class for recording event traces. Trace data is either collected
 // synchronously during execution (TracingMode::kMethodTracingActive),
-// or by a separate sampling thread (TracingMode::kSampleProfilingActive).
+// or by checkpoints requested from a separate sampling thread
+// (TracingMode::kSampleProfilingActive).
 class Trace final : public instrumentation::InstrumentationListener {
  public:
   enum TraceFlag {
@@ -220,10 +221,6 @@ class Trace final : public instrumentation::InstrumentationListener {
       REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(!unique_methods_lock_) override;
   void WatchedFramePop(Thread* thread, const ShadowFrame& frame)
       REQUIRES_SHARED(Locks::mutator_lock_) override;
-  // Reuse an old stack trace if it exists, otherwise allocate a new one.
-  static std::vector<ArtMethod*>* AllocStackTrace();
-  // Clear and store an old stack trace for later use.
-  static void FreeStackTrace(std::vector<ArtMethod*>* stack_trace);
   // Save id and name of a thread before it exits.
   static void StoreExitingThreadInfo(Thread* thread);
 
@@ -302,9 +299,6 @@ class Trace final : public instrumentation::InstrumentationListener {
   // Sampling thread, non-zero when sampling.
   static pthread_t sampling_pthread_;
 
-  // Used to remember an unused stack trace to avoid re-allocation during sampling.
-  static std::unique_ptr<std::vector<ArtMethod*>> temp_stack_trace_;
-
   // File to write trace data out to, null if direct to ddms.
   std::unique_ptr<File> trace_file_;
 
@@ -347,9 +341,8 @@ class Trace final : public instrumentation::InstrumentationListener {
   // so cur_offset_ can move forwards and backwards.
   //
   // When not in streaming mode, the buf_ writes can come from
-  // multiple threads when the trace mode is kMethodTracing. When
-  // trace mode is kSampling, writes only come from the sampling
-  // thread.
+  // multiple threads, either from method tracing events or from
+  // sampling checkpoints.
   //
   // Reads to the buffer happen after the event sources writing to the
   // buffer have been shutdown and all stores have completed. The
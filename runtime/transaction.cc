@@ -288,7 +288,6 @@ void Transaction::RecordWeakStringRemoval(ObjPtr<mirror::String> s) {
 }
 
 void Transaction::LogInternedString(InternStringLog&& log) {
-  Locks::intern_table_lock_->AssertExclusiveHeld(Thread::Current());
   DCHECK(assert_no_new_records_reason_ == nullptr) << assert_no_new_records_reason_;
   intern_string_logs_.push_front(std::move(log));
 }
@@ -110,15 +110,12 @@ class Transaction final {
   void RecordWriteArray(mirror::Array* array, size_t index, uint64_t value)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Record intern string table changes.
-  void RecordStrongStringInsertion(ObjPtr<mirror::String> s)
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordWeakStringInsertion(ObjPtr<mirror::String> s)
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordStrongStringRemoval(ObjPtr<mirror::String> s)
-      REQUIRES(Locks::intern_table_lock_);
-  void RecordWeakStringRemoval(ObjPtr<mirror::String> s)
-      REQUIRES(Locks::intern_table_lock_);
+  // Record intern string table changes. Called with the intern table shard lock held, dex2oat
+  // uses a single shard.
+  void RecordStrongStringInsertion(ObjPtr<mirror::String> s);
+  void RecordWeakStringInsertion(ObjPtr<mirror::String> s);
+  void RecordStrongStringRemoval(ObjPtr<mirror::String> s);
+  void RecordWeakStringRemoval(ObjPtr<mirror::String> s);
 
   // Record resolve string.
   void RecordResolveString(ObjPtr<mirror::DexCache> dex_cache, dex::StringIndex string_idx)
@@ -286,8 +283,7 @@ class Transaction final {
     DISALLOW_COPY_AND_ASSIGN(ResolveMethodTypeLog);
   };
 
-  void LogInternedString(InternStringLog&& log)
-      REQUIRES(Locks::intern_table_lock_);
+  void LogInternedString(InternStringLog&& log);
 
   void UndoObjectModifications()
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -0,0 +1,1625 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Run the const-string, const-class and new-instance instructions of methods
+// with more of them than the first level of the interpreter cache holds, while
+// another thread runs GCs. The references found in the second level of the
+// cache must be the up-to-date ones.
+public class Main {
+  static final int ITERATIONS = 200;
+  static volatile boolean done = false;
+
+  static class A { int value = 1; }
+  static class B { int value = 2; }
+  static class C { int value = 3; }
+  static class D { int value = 4; }
+  static class E { int value = 5; }
+  static class F { int value = 6; }
+  static class G { int value = 7; }
+  static class H { int value = 8; }
+
+  static String[] loadStrings() {
+    return new String[] {
+      "string0",
+      "string1",
+      "string2",
+      "string3",
+      "string4",
+      "string5",
+      "string6",
+      "string7",
+      "string8",
+      "string9",
+      "string10",
+      "string11",
+      "string12",
+      "string13",
+      "string14",
+      "string15",
+      "string16",
+      "string17",
+      "string18",
+      "string19",
+      "string20",
+      "string21",
+      "string22",
+      "string23",
+      "string24",
+      "string25",
+      "string26",
+      "string27",
+      "string28",
+      "string29",
+      "string30",
+      "string31",
+      "string32",
+      "string33",
+      "string34",
+      "string35",
+      "string36",
+      "string37",
+      "string38",
+      "string39",
+      "string40",
+      "string41",
+      "string42",
+      "string43",
+      "string44",
+      "string45",
+      "string46",
+      "string47",
+      "string48",
+      "string49",
+      "string50",
+      "string51",
+      "string52",
+      "string53",
+      "string54",
+      "string55",
+      "string56",
+      "string57",
+      "string58",
+      "string59",
+      "string60",
+      "string61",
+      "string62",
+      "string63",
+      "string64",
+      "string65",
+      "string66",
+      "string67",
+      "string68",
+      "string69",
+      "string70",
+      "string71",
+      "string72",
+      "string73",
+      "string74",
+      "string75",
+      "string76",
+      "string77",
+      "string78",
+      "string79",
+      "string80",
+      "string81",
+      "string82",
+      "string83",
+      "string84",
+      "string85",
+      "string86",
+      "string87",
+      "string88",
+      "string89",
+      "string90",
+      "string91",
+      "string92",
+      "string93",
+      "string94",
+      "string95",
+      "string96",
+      "string97",
+      "string98",
+      "string99",
+      "string100",
+      "string101",
+      "string102",
+      "string103",
+      "string104",
+      "string105",
+      "string106",
+      "string107",
+      "string108",
+      "string109",
+      "string110",
+      "string111",
+      "string112",
+      "string113",
+      "string114",
+      "string115",
+      "string116",
+      "string117",
+      "string118",
+      "string119",
+      "string120",
+      "string121",
+      "string122",
+      "string123",
+      "string124",
+      "string125",
+      "string126",
+      "string127",
+      "string128",
+      "string129",
+      "string130",
+      "string131",
+      "string132",
+      "string133",
+      "string134",
+      "string135",
+      "string136",
+      "string137",
+      "string138",
+      "string139",
+      "string140",
+      "string141",
+      "string142",
+      "string143",
+      "string144",
+      "string145",
+      "string146",
+      "string147",
+      "string148",
+      "string149",
+      "string150",
+      "string151",
+      "string152",
+      "string153",
+      "string154",
+      "string155",
+      "string156",
+      "string157",
+      "string158",
+      "string159",
+      "string160",
+      "string161",
+      "string162",
+      "string163",
+      "string164",
+      "string165",
+      "string166",
+      "string167",
+      "string168",
+      "string169",
+      "string170",
+      "string171",
+      "string172",
+      "string173",
+      "string174",
+      "string175",
+      "string176",
+      "string177",
+      "string178",
+      "string179",
+      "string180",
+      "string181",
+      "string182",
+      "string183",
+      "string184",
+      "string185",
+      "string186",
+      "string187",
+      "string188",
+      "string189",
+      "string190",
+      "string191",
+      "string192",
+      "string193",
+      "string194",
+      "string195",
+      "string196",
+      "string197",
+      "string198",
+      "string199",
+      "string200",
+      "string201",
+      "string202",
+      "string203",
+      "string204",
+      "string205",
+      "string206",
+      "string207",
+      "string208",
+      "string209",
+      "string210",
+      "string211",
+      "string212",
+      "string213",
+      "string214",
+      "string215",
+      "string216",
+      "string217",
+      "string218",
+      "string219",
+      "string220",
+      "string221",
+      "string222",
+      "string223",
+      "string224",
+      "string225",
+      "string226",
+      "string227",
+      "string228",
+      "string229",
+      "string230",
+      "string231",
+      "string232",
+      "string233",
+      "string234",
+      "string235",
+      "string236",
+      "string237",
+      "string238",
+      "string239",
+      "string240",
+      "string241",
+      "string242",
+      "string243",
+      "string244",
+      "string245",
+      "string246",
+      "string247",
+      "string248",
+      "string249",
+      "string250",
+      "string251",
+      "string252",
+      "string253",
+      "string254",
+      "string255",
+      "string256",
+      "string257",
+      "string258",
+      "string259",
+      "string260",
+      "string261",
+      "string262",
+      "string263",
+      "string264",
+      "string265",
+      "string266",
+      "string267",
+      "string268",
+      "string269",
+      "string270",
+      "string271",
+      "string272",
+      "string273",
+      "string274",
+      "string275",
+      "string276",
+      "string277",
+      "string278",
+      "string279",
+      "string280",
+      "string281",
+      "string282",
+      "string283",
+      "string284",
+      "string285",
+      "string286",
+      "string287",
+      "string288",
+      "string289",
+      "string290",
+      "string291",
+      "string292",
+      "string293",
+      "string294",
+      "string295",
+      "string296",
+      "string297",
+      "string298",
+      "string299",
+      "string300",
+      "string301",
+      "string302",
+      "string303",
+      "string304",
+      "string305",
+      "string306",
+      "string307",
+      "string308",
+      "string309",
+      "string310",
+      "string311",
+      "string312",
+      "string313",
+      "string314",
+      "string315",
+      "string316",
+      "string317",
+      "string318",
+      "string319",
+      "string320",
+      "string321",
+      "string322",
+      "string323",
+      "string324",
+      "string325",
+      "string326",
+      "string327",
+      "string328",
+      "string329",
+      "string330",
+      "string331",
+      "string332",
+      "string333",
+      "string334",
+      "string335",
+      "string336",
+      "string337",
+      "string338",
+      "string339",
+      "string340",
+      "string341",
+      "string342",
+      "string343",
+      "string344",
+      "string345",
+      "string346",
+      "string347",
+      "string348",
+      "string349",
+      "string350",
+      "string351",
+      "string352",
+      "string353",
+      "string354",
+      "string355",
+      "string356",
+      "string357",
+      "string358",
+      "string359",
+      "string360",
+      "string361",
+      "string362",
+      "string363",
+      "string364",
+      "string365",
+      "string366",
+      "string367",
+      "string368",
+      "string369",
+      "string370",
+      "string371",
+      "string372",
+      "string373",
+      "string374",
+      "string375",
+      "string376",
+      "string377",
+      "string378",
+      "string379",
+      "string380",
+      "string381",
+      "string382",
+      "string383",
+      "string384",
+      "string385",
+      "string386",
+      "string387",
+      "string388",
+      "string389",
+      "string390",
+      "string391",
+      "string392",
+      "string393",
+      "string394",
+      "string395",
+      "string396",
+      "string397",
+      "string398",
+      "string399",
+      "string400",
+      "string401",
+      "string402",
+      "string403",
+      "string404",
+      "string405",
+      "string406",
+      "string407",
+      "string408",
+      "string409",
+      "string410",
+      "string411",
+      "string412",
+      "string413",
+      "string414",
+      "string415",
+      "string416",
+      "string417",
+      "string418",
+      "string419",
+      "string420",
+      "string421",
+      "string422",
+      "string423",
+      "string424",
+      "string425",
+      "string426",
+      "string427",
+      "string428",
+      "string429",
+      "string430",
+      "string431",
+      "string432",
+      "string433",
+      "string434",
+      "string435",
+      "string436",
+      "string437",
+      "string438",
+      "string439",
+      "string440",
+      "string441",
+      "string442",
+      "string443",
+      "string444",
+      "string445",
+      "string446",
+      "string447",
+      "string448",
+      "string449",
+      "string450",
+      "string451",
+      "string452",
+      "string453",
+      "string454",
+      "string455",
+      "string456",
+      "string457",
+      "string458",
+      "string459",
+      "string460",
+      "string461",
+      "string462",
+      "string463",
+      "string464",
+      "string465",
+      "string466",
+      "string467",
+      "string468",
+      "string469",
+      "string470",
+      "string471",
+      "string472",
+      "string473",
+      "string474",
+      "string475",
+      "string476",
+      "string477",
+      "string478",
+      "string479",
+      "string480",
+      "string481",
+      "string482",
+      "string483",
+      "string484",
+      "string485",
+      "string486",
+      "string487",
+      "string488",
+      "string489",
+      "string490",
+      "string491",
+      "string492",
+      "string493",
+      "string494",
+      "string495",
+      "string496",
+      "string497",
+      "string498",
+      "string499",
+      "string500",
+      "string501",
+      "string502",
+      "string503",
+      "string504",
+      "string505",
+      "string506",
+      "string507",
+      "string508",
+      "string509",
+      "string510",
+      "string511"
+    };
+  }
+
+  static Class<?>[] loadClasses() {
+    return new Class<?>[] {
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class,
+      A.class,
+      B.class,
+      C.class,
+      D.class,
+      E.class,
+      F.class,
+      G.class,
+      H.class
+    };
+  }
+
+  static int allocate() {
+    int count = 0;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    count += new A().value;
+    count += new B().value;
+    count += new C().value;
+    count += new D().value;
+    count += new E().value;
+    count += new F().value;
+    count += new G().value;
+    count += new H().value;
+    return count;
+  }
+
+  static void check() throws Exception {
+    String[] strings = loadStrings();
+    for (int i = 0; i < strings.length; ++i) {
+      if (strings[i] != ("string" + i).intern()) {
+        throw new Error("Unexpected string " + strings[i] + " at " + i);
+      }
+    }
+    Class<?>[] classes = loadClasses();
+    for (int i = 0; i < classes.length; ++i) {
+      String name = "Main$" + "ABCDEFGH".charAt(i % 8);
+      if (classes[i] != Class.forName(name)) {
+        throw new Error("Unexpected class " + classes[i] + " at " + i);
+      }
+    }
+    int expected = (1 + 2 + 3 + 4 + 5 + 6 + 7 + 8) * (512 / 8);
+    int count = allocate();
+    if (count != expected) {
+      throw new Error("Expected " + expected + ", got " + count);
+    }
+  }
+
+  public static void main(String[] args) throws Exception {
+    Thread gcThread = new Thread() {
+      public void run() {
+        while (!done) {
+          Runtime.getRuntime().gc();
+        }
+      }
+    };
+    gcThread.start();
+    try {
+      for (int i = 0; i < ITERATIONS; ++i) {
+        check();
+      }
+    } finally {
+      done = true;
+      gcThread.join();
+    }
+    System.out.println("passed");
+  }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class Main {
+  static Class<?> testClass;
+  static Class<?> otherClass;
+  static Object other;
+
+  static void check(int expected, int actual, String what) {
+    if (expected != actual) {
+      throw new Error(what + ": expected " + expected + ", got " + actual);
+    }
+  }
+
+  static int call(Class<?> cls, String name, Class<?>[] types, Object... args) throws Exception {
+    Method method = cls.getDeclaredMethod(name, types);
+    Object result = method.invoke(null, args);
+    return (result != null) ? (Integer) result : 0;
+  }
+
+  static void test() throws Exception {
+    Class<?>[] intInt = { int.class, int.class };
+    check(3, call(testClass, "$noinline$invokeExactStatic", intInt, 1, 2), "invokeExactStatic");
+    int calls = testClass.getField("calls").getInt(null);
+    call(testClass, "$noinline$invokeDropResult", intInt, 1, 2);
+    check(calls + 1, testClass.getField("calls").getInt(null), "invokeDropResult");
+    Class<?>[] stringType = { String.class };
+    check(3, call(testClass, "$noinline$invokeReturnString", stringType, "abc"),
+          "invokeReturnString");
+    Class<?>[] otherType = { otherClass };
+    check(42, call(otherClass, "$noinline$callPriv", otherType, other), "callPriv");
+    check(42, call(testClass, "$noinline$callPrivFromOutside", otherType, other),
+          "callPrivFromOutside");
+  }
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    testClass = Class.forName("MethodHandleTest");
+    otherClass = Class.forName("Other");
+    other = otherClass.getDeclaredConstructor().newInstance();
+    // Run the methods in the interpreter first, so that the handles and their types are
+    // resolved when the methods are compiled.
+    test();
+    ensureJitCompiled(testClass, "$noinline$invokeExactStatic");
+    ensureJitCompiled(testClass, "$noinline$invokeDropResult");
+    ensureJitCompiled(testClass, "$noinline$invokeReturnString");
+    ensureJitCompiled(otherClass, "$noinline$callPriv");
+    ensureJitCompiled(testClass, "$noinline$callPrivFromOutside");
+    test();
+    System.out.println("passed");
+  }
+
+  private static native void ensureJitCompiled(Class<?> cls, String methodName);
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class Main {
+  // Time given to the startup class workers to initialize the startup classes.
+  static final long WAIT_MS = 1000;
+  // VMRuntime.CODE_PATH_TYPE_PRIMARY_APK.
+  static final int CODE_PATH_TYPE_PRIMARY_APK = 1;
+
+  public static void main(String[] args) throws Exception {
+    String dexLocation = System.getenv("DEX_LOCATION");
+    String profile = dexLocation + "/2240-startup-class-init-deadlock.prof";
+    String codePath = dexLocation + "/2240-startup-class-init-deadlock.jar";
+    Class<?> vmRuntime = Class.forName("dalvik.system.VMRuntime");
+    Method registerAppInfo = vmRuntime.getDeclaredMethod("registerAppInfo",
+        String.class, String.class, String.class, String[].class, int.class);
+    registerAppInfo.invoke(
+        null, "test.app", profile, profile, new String[] { codePath }, CODE_PATH_TYPE_PRIMARY_APK);
+
+    Thread.sleep(WAIT_MS);
+    // Static initializers that use other classes are left to the application. A worker running
+    // them could deadlock with the main thread or another worker.
+    if (Flags.aStarted || Flags.bStarted || Flags.iStarted) {
+      System.out.println("Non-trivial static initializer run by a startup class worker");
+    }
+    // Initializing A initializes B on the main thread.
+    if (A.value + B.value != 3) {
+      throw new Error("Unexpected values " + A.value + " and " + B.value);
+    }
+    if (C.value != 2) {
+      throw new Error("Unexpected value " + C.value);
+    }
+    System.out.println("passed");
+  }
+}
+
+class Flags {
+  static volatile boolean aStarted;
+  static volatile boolean bStarted;
+  static volatile boolean iStarted;
+}
+
+// The static initializers of A and B use each other. Initializing them on different threads at
+// the same time deadlocks, so they must not be initialized by the startup class workers.
+class A {
+  static int value;
+  static {
+    Flags.aStarted = true;
+    sleep();
+    value = B.value + 1;
+  }
+
+  static void sleep() {
+    try {
+      Thread.sleep(100);
+    } catch (InterruptedException e) {
+      throw new Error(e);
+    }
+  }
+}
+
+class B {
+  static int value;
+  static {
+    Flags.bStarted = true;
+    A.sleep();
+    value = A.value + 1;
+  }
+}
+
+// The static initializer of C reads a field inherited from I, which initializes I. The field
+// is referenced through C, but the static initializer of I is not trivial.
+interface I {
+  int X = I.init();
+
+  static int init() {
+    Flags.iStarted = true;
+    return 1;
+  }
+}
+
+class C implements I {
+  static int value = X + 1;
+}
+
+// Classes with trivial static initializers, which are initialized in parallel.
+class Filler0 { static int value; }
+class Filler1 { static int value; }
+class Filler2 { static int value; }
+class Filler3 { static int value; }
+class Filler4 { static int value; }
+class Filler5 { static int value; }
+class Filler6 { static int value; }
+class Filler7 { static int value; }
+class Filler8 { static int value; }
+class Filler9 { static int value; }
+class Filler10 { static int value; }
+class Filler11 { static int value; }
+class Filler12 { static int value; }
+class Filler13 { static int value; }
+class Filler14 { static int value; }
+class Filler15 { static int value; }
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "art_method-inl.h"
+#include "interpreter/mterp/nterp.h"
+#include "jit/jit.h"
+#include "jit/jit_code_cache.h"
+#include "jni.h"
+#include "mirror/class-inl.h"
+#include "nativehelper/ScopedUtfChars.h"
+#include "nterp_helpers.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+static ArtMethod* FindDirectMethod(ScopedObjectAccess& soa, jclass cls, jstring method_name)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  ScopedUtfChars chars(soa.Env(), method_name);
+  CHECK(chars.c_str() != nullptr);
+  ArtMethod* method = soa.Decode<mirror::Class>(cls)->FindDeclaredDirectMethodByName(
+      chars.c_str(), kRuntimePointerSize);
+  CHECK(method != nullptr) << chars.c_str();
+  return method;
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_countsLoopsInNterp(JNIEnv*,
+                                                                   jclass,
+                                                                   jclass cls,
+                                                                   jstring method_name) {
+  ScopedObjectAccess soa(Thread::Current());
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  if (jit == nullptr || !jit->UseJitCompilation() || jit->JitAtFirstUse()) {
+    return JNI_FALSE;
+  }
+  ArtMethod* method = FindDirectMethod(soa, cls, method_name);
+  return interpreter::CanRuntimeUseNterp() && CanMethodUseNterp(method);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_hasOsrCode(JNIEnv*,
+                                                           jclass,
+                                                           jclass cls,
+                                                           jstring method_name) {
+  ScopedObjectAccess soa(Thread::Current());
+  ArtMethod* method = FindDirectMethod(soa, cls, method_name);
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  return jit->GetCodeCache()->LookupOsrMethodHeader(method) != nullptr;
+}
+
+}  // namespace art
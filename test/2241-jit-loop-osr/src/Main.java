@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  // Enough back edges for the hotness counter of the method to run out several times.
+  private static final int ITERATIONS = 1000000;
+
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    if (!hasJit() ||
+        isAotCompiled(Main.class, "$noinline$loop") ||
+        !countsLoopsInNterp(Main.class, "$noinline$loop")) {
+      // Loops are only counted when nterp runs the method with the JIT enabled.
+      System.out.println("passed");
+      return;
+    }
+
+    // Stop the compiler threads, so that neither the baseline code nor the OSR code of the
+    // method can be installed while the loop runs in nterp. The OSR compilation is then only
+    // requested if nterp counts the loop before the method has been compiled.
+    stopJit();
+    long sum = $noinline$loop(ITERATIONS);
+    startJit();
+    waitForCompilation();
+
+    if (sum != (long) ITERATIONS * (ITERATIONS - 1) / 2) {
+      throw new Error("Unexpected sum " + sum);
+    }
+    if (!hasOsrCode(Main.class, "$noinline$loop")) {
+      System.out.println("The hot loop did not request an OSR compilation");
+    }
+    System.out.println("passed");
+  }
+
+  public static long $noinline$loop(int iterations) {
+    long sum = 0;
+    for (int i = 0; i < iterations; ++i) {
+      sum += i;
+    }
+    return sum;
+  }
+
+  private static native boolean hasJit();
+  private static native boolean isAotCompiled(Class<?> cls, String methodName);
+  private static native boolean countsLoopsInNterp(Class<?> cls, String methodName);
+  private static native boolean hasOsrCode(Class<?> cls, String methodName);
+  private static native void stopJit();
+  private static native void startJit();
+  private static native void waitForCompilation();
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+public class Main {
+  private static final int CALLS = 100;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    for (int i = 0; i < CALLS; ++i) {
+      hasJit();
+    }
+
+    Class<?> vmDebug = Class.forName("dalvik.system.VMDebug");
+    Method getJniTransitionProfile = vmDebug.getDeclaredMethod("getJniTransitionProfile");
+    String profile = (String) getJniTransitionProfile.invoke(null);
+    if (profile == null) {
+      throw new Error("The JNI transition profiler is not enabled");
+    }
+    if (!profile.startsWith("JNI transitions: ")) {
+      throw new Error("Unexpected profile:\n" + profile);
+    }
+    if (!profile.contains("boolean Main.hasJit()")) {
+      throw new Error("Main.hasJit() is missing from the profile:\n" + profile);
+    }
+    System.out.println("passed");
+  }
+
+  private static native boolean hasJit();
+}
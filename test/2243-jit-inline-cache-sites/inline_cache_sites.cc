@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "art_method-inl.h"
+#include "jit/jit.h"
+#include "jit/profiling_info.h"
+#include "jni.h"
+#include "mirror/class-inl.h"
+#include "nativehelper/ScopedUtfChars.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+
+namespace art {
+
+// Return the ProfilingInfo of the static method `method_name` of `cls`, creating it if needed,
+// or null if there is no JIT.
+static ProfilingInfo* GetProfilingInfo(ScopedObjectAccess& soa, jclass cls, jstring method_name)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (Runtime::Current()->GetJit() == nullptr) {
+    return nullptr;
+  }
+  ScopedUtfChars chars(soa.Env(), method_name);
+  CHECK(chars.c_str() != nullptr);
+  ArtMethod* method = soa.Decode<mirror::Class>(cls)->FindDeclaredDirectMethodByName(
+      chars.c_str(), kRuntimePointerSize);
+  CHECK(method != nullptr) << chars.c_str();
+  return ProfilingInfo::Create(soa.Self(), method, /*retry_allocation=*/ true);
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_numberOfInlineCaches(JNIEnv* env,
+                                                                 jclass,
+                                                                 jclass cls,
+                                                                 jstring method_name) {
+  ScopedObjectAccess soa(env);
+  ProfilingInfo* info = GetProfilingInfo(soa, cls, method_name);
+  return (info == nullptr) ? -1 : static_cast<jint>(info->GetNumberOfInlineCaches());
+}
+
+extern "C" JNIEXPORT jint JNICALL Java_Main_numberOfSkippedInlineCaches(JNIEnv* env,
+                                                                        jclass,
+                                                                        jclass cls,
+                                                                        jstring method_name) {
+  ScopedObjectAccess soa(env);
+  ProfilingInfo* info = GetProfilingInfo(soa, cls, method_name);
+  return (info == nullptr) ? -1 : static_cast<jint>(info->GetNumberOfSkippedInlineCaches());
+}
+
+}  // namespace art
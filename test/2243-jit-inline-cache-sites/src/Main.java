@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+public class Main {
+  public static void main(String[] args) {
+    System.loadLibrary(args[0]);
+    // Run the method once, so that its callees are resolved when the profiling info is created.
+    if ($noinline$calls(new Base(), new Leaf(), new Base()) != 10) {
+      throw new Error("Unexpected result");
+    }
+    if (!hasJit() || isAotCompiled(Main.class, "$noinline$calls")) {
+      // Profiling infos are only created with the JIT, and compiled code may call final
+      // methods without resolving them.
+      System.out.println("passed");
+      return;
+    }
+    int caches = numberOfInlineCaches(Main.class, "$noinline$calls");
+    int skipped = numberOfSkippedInlineCaches(Main.class, "$noinline$calls");
+    // Base.virtualMethod() and Itf.interfaceMethod() may have several targets, while
+    // Base.finalMethod() and Leaf.leafMethod() cannot.
+    if (caches != 2 || skipped != 2) {
+      throw new Error("Unexpected inline caches: " + caches + " with " + skipped + " skipped");
+    }
+    System.out.println("passed");
+  }
+
+  public static int $noinline$calls(Base base, Leaf leaf, Itf itf) {
+    return base.virtualMethod() + base.finalMethod() + leaf.leafMethod() + itf.interfaceMethod();
+  }
+
+  private static native boolean hasJit();
+  private static native boolean isAotCompiled(Class<?> cls, String methodName);
+  private static native int numberOfInlineCaches(Class<?> cls, String methodName);
+  private static native int numberOfSkippedInlineCaches(Class<?> cls, String methodName);
+}
+
+interface Itf {
+  int interfaceMethod();
+}
+
+class Base implements Itf {
+  public int virtualMethod() {
+    return 1;
+  }
+
+  public final int finalMethod() {
+    return 2;
+  }
+
+  public int interfaceMethod() {
+    return 3;
+  }
+}
+
+final class Leaf {
+  public int leafMethod() {
+    return 4;
+  }
+}
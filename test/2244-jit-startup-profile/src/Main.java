@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.system.PathClassLoader;
+import java.lang.reflect.Method;
+
+public class Main {
+  // Time given to the JIT to compile the first batch of the profile.
+  static final long TIMEOUT_MS = 30000;
+  // VMRuntime.CODE_PATH_TYPE_PRIMARY_APK.
+  static final int CODE_PATH_TYPE_PRIMARY_APK = 1;
+
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+    if (!hasJit() || isDebuggable()) {
+      // The startup profile is only compiled by the JIT, and not for debuggable apps.
+      System.out.println("passed");
+      return;
+    }
+
+    String dexLocation = System.getenv("DEX_LOCATION");
+    String profile = dexLocation + "/2244-jit-startup-profile.prof";
+    String codePath = dexLocation + "/2244-jit-startup-profile.jar";
+    // Open the code path again in another class loader. Its dex file has the same location as
+    // the one of the application, but the profile must be compiled for the application.
+    ClassLoader otherLoader = new PathClassLoader(codePath, Object.class.getClassLoader());
+    Class<?> otherMain = Class.forName("Main", false, otherLoader);
+    if (otherMain == Main.class) {
+      throw new Error("Main loaded by the application class loader");
+    }
+
+    Class<?> vmRuntime = Class.forName("dalvik.system.VMRuntime");
+    Method registerAppInfo = vmRuntime.getDeclaredMethod("registerAppInfo",
+        String.class, String.class, String.class, String[].class, int.class);
+    registerAppInfo.invoke(
+        null, "test.app", profile, profile, new String[] { codePath }, CODE_PATH_TYPE_PRIMARY_APK);
+
+    // The profiled method of Main is never called, so only the startup profile task compiles it.
+    long deadline = System.currentTimeMillis() + TIMEOUT_MS;
+    while (!hasJitCompiledCode(Main.class, "$noinline$profiled")) {
+      if (System.currentTimeMillis() > deadline) {
+        System.out.println("The profiled method was not compiled");
+        break;
+      }
+      Thread.sleep(10);
+    }
+    if (hasJitCompiledCode(otherMain, "$noinline$profiled")) {
+      System.out.println("The profiled method was compiled for another class loader");
+    }
+    if (hasJitCompiledCode(Main.class, "$noinline$notProfiled")) {
+      System.out.println("A method not in the profile was compiled");
+    }
+    // Return while the methods of Other, in later batches, are still being compiled. The task
+    // must stop re-enqueueing itself for the JIT thread pool to shut down.
+    System.out.println("passed");
+  }
+
+  public static int $noinline$profiled() {
+    return 42;
+  }
+
+  public static int $noinline$notProfiled() {
+    return 43;
+  }
+
+  private static native boolean hasJit();
+  private static native boolean isDebuggable();
+  private static native boolean hasJitCompiledCode(Class<?> cls, String methodName);
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Profiled methods compiled after the ones of Main, in later batches.
+class Other {
+  static int $noinline$m0() { return 0; }
+  static int $noinline$m1() { return 1; }
+  static int $noinline$m2() { return 2; }
+  static int $noinline$m3() { return 3; }
+  static int $noinline$m4() { return 4; }
+  static int $noinline$m5() { return 5; }
+  static int $noinline$m6() { return 6; }
+  static int $noinline$m7() { return 7; }
+  static int $noinline$m8() { return 8; }
+  static int $noinline$m9() { return 9; }
+  static int $noinline$m10() { return 10; }
+  static int $noinline$m11() { return 11; }
+  static int $noinline$m12() { return 12; }
+  static int $noinline$m13() { return 13; }
+  static int $noinline$m14() { return 14; }
+  static int $noinline$m15() { return 15; }
+  static int $noinline$m16() { return 16; }
+  static int $noinline$m17() { return 17; }
+  static int $noinline$m18() { return 18; }
+  static int $noinline$m19() { return 19; }
+  static int $noinline$m20() { return 20; }
+  static int $noinline$m21() { return 21; }
+  static int $noinline$m22() { return 22; }
+  static int $noinline$m23() { return 23; }
+  static int $noinline$m24() { return 24; }
+  static int $noinline$m25() { return 25; }
+  static int $noinline$m26() { return 26; }
+  static int $noinline$m27() { return 27; }
+  static int $noinline$m28() { return 28; }
+  static int $noinline$m29() { return 29; }
+  static int $noinline$m30() { return 30; }
+  static int $noinline$m31() { return 31; }
+  static int $noinline$m32() { return 32; }
+  static int $noinline$m33() { return 33; }
+  static int $noinline$m34() { return 34; }
+  static int $noinline$m35() { return 35; }
+  static int $noinline$m36() { return 36; }
+  static int $noinline$m37() { return 37; }
+  static int $noinline$m38() { return 38; }
+  static int $noinline$m39() { return 39; }
+  static int $noinline$m40() { return 40; }
+  static int $noinline$m41() { return 41; }
+  static int $noinline$m42() { return 42; }
+  static int $noinline$m43() { return 43; }
+  static int $noinline$m44() { return 44; }
+  static int $noinline$m45() { return 45; }
+  static int $noinline$m46() { return 46; }
+  static int $noinline$m47() { return 47; }
+  static int $noinline$m48() { return 48; }
+  static int $noinline$m49() { return 49; }
+  static int $noinline$m50() { return 50; }
+  static int $noinline$m51() { return 51; }
+  static int $noinline$m52() { return 52; }
+  static int $noinline$m53() { return 53; }
+  static int $noinline$m54() { return 54; }
+  static int $noinline$m55() { return 55; }
+  static int $noinline$m56() { return 56; }
+  static int $noinline$m57() { return 57; }
+  static int $noinline$m58() { return 58; }
+  static int $noinline$m59() { return 59; }
+  static int $noinline$m60() { return 60; }
+  static int $noinline$m61() { return 61; }
+  static int $noinline$m62() { return 62; }
+  static int $noinline$m63() { return 63; }
+  static int $noinline$m64() { return 64; }
+  static int $noinline$m65() { return 65; }
+  static int $noinline$m66() { return 66; }
+  static int $noinline$m67() { return 67; }
+  static int $noinline$m68() { return 68; }
+  static int $noinline$m69() { return 69; }
+  static int $noinline$m70() { return 70; }
+  static int $noinline$m71() { return 71; }
+  static int $noinline$m72() { return 72; }
+  static int $noinline$m73() { return 73; }
+  static int $noinline$m74() { return 74; }
+  static int $noinline$m75() { return 75; }
+  static int $noinline$m76() { return 76; }
+  static int $noinline$m77() { return 77; }
+  static int $noinline$m78() { return 78; }
+  static int $noinline$m79() { return 79; }
+  static int $noinline$m80() { return 80; }
+  static int $noinline$m81() { return 81; }
+  static int $noinline$m82() { return 82; }
+  static int $noinline$m83() { return 83; }
+  static int $noinline$m84() { return 84; }
+  static int $noinline$m85() { return 85; }
+  static int $noinline$m86() { return 86; }
+  static int $noinline$m87() { return 87; }
+  static int $noinline$m88() { return 88; }
+  static int $noinline$m89() { return 89; }
+  static int $noinline$m90() { return 90; }
+  static int $noinline$m91() { return 91; }
+  static int $noinline$m92() { return 92; }
+  static int $noinline$m93() { return 93; }
+  static int $noinline$m94() { return 94; }
+  static int $noinline$m95() { return 95; }
+  static int $noinline$m96() { return 96; }
+  static int $noinline$m97() { return 97; }
+  static int $noinline$m98() { return 98; }
+  static int $noinline$m99() { return 99; }
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.io.File;
+import java.lang.reflect.Method;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.util.ArrayDeque;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.concurrent.CountDownLatch;
+
+public class Main {
+  // Sampling interval, and how long the main thread spins while being sampled.
+  static final int INTERVAL_US = 1000;
+  static final long SPIN_MS = 500;
+  static final int TRACE_MAGIC = 0x574f4c53;
+  static final int METHOD_ENTER = 0;
+  static final int METHOD_EXIT = 1;
+
+  static volatile boolean stopSleeping;
+  static volatile long sink;
+
+  public static void main(String[] args) throws Exception {
+    File file = File.createTempFile("2245-trace-sampling", ".trace");
+    try {
+      test(file);
+    } finally {
+      file.delete();
+    }
+    System.out.println("passed");
+  }
+
+  static void test(File file) throws Exception {
+    // The sleeper is suspended for most of the trace, so its stack is sampled on its behalf.
+    // The main thread is running, so it samples its own stack.
+    CountDownLatch sleeping = new CountDownLatch(1);
+    Thread sleeper = new Thread(() -> $noinline$sleep(sleeping), "Sleeper");
+    sleeper.start();
+    sleeping.await();
+
+    startSamplingTracing(file.getPath(), INTERVAL_US);
+    $noinline$spin(SPIN_MS);
+    stopMethodTracing();
+    stopSleeping = true;
+    sleeper.join();
+
+    Trace trace = new Trace(Files.readAllBytes(file.toPath()));
+    trace.checkSampled("main", "Main.$noinline$spin");
+    trace.checkSampled("Sleeper", "Main.$noinline$sleep");
+  }
+
+  public static void $noinline$spin(long ms) {
+    long end = System.currentTimeMillis() + ms;
+    long sum = 0;
+    while (System.currentTimeMillis() < end) {
+      for (int i = 0; i < 1000; ++i) {
+        sum += i;
+      }
+    }
+    sink = sum;
+  }
+
+  public static void $noinline$sleep(CountDownLatch sleeping) {
+    sleeping.countDown();
+    while (!stopSleeping) {
+      try {
+        Thread.sleep(10);
+      } catch (InterruptedException e) {
+        throw new Error(e);
+      }
+    }
+  }
+
+  // A trace in the format of dmtrace: a text header listing the threads and the methods,
+  // followed by the binary records.
+  static class Trace {
+    final Map<Integer, String> threads = new HashMap<>();
+    final Map<Integer, String> methods = new HashMap<>();
+    // Events of each thread, in order, as method id | action.
+    final Map<Integer, ArrayDeque<Integer>> events = new HashMap<>();
+
+    Trace(byte[] data) {
+      String end = "*end\n";
+      String text = new String(data, StandardCharsets.ISO_8859_1);
+      int headerEnd = text.indexOf(end);
+      if (headerEnd < 0) {
+        throw new Error("No end of header");
+      }
+      String section = "";
+      for (String line : text.substring(0, headerEnd).split("\n")) {
+        if (line.startsWith("*")) {
+          section = line;
+        } else if (section.equals("*threads")) {
+          String[] fields = line.split("\t");
+          threads.put(Integer.parseInt(fields[0]) & 0xffff, fields[1]);
+        } else if (section.equals("*methods")) {
+          String[] fields = line.split("\t");
+          methods.put(Integer.decode(fields[0]), fields[1] + "." + fields[2]);
+        }
+      }
+
+      ByteBuffer buffer = ByteBuffer.wrap(data, headerEnd + end.length(),
+          data.length - headerEnd - end.length()).slice().order(ByteOrder.LITTLE_ENDIAN);
+      if (buffer.getInt(0) != TRACE_MAGIC) {
+        throw new Error("Bad magic " + Integer.toHexString(buffer.getInt(0)));
+      }
+      int version = buffer.getShort(4);
+      int offset = buffer.getShort(6);
+      int recordSize = (version >= 3) ? buffer.getShort(16) : 10;
+      for (int position = offset; position < buffer.limit(); position += recordSize) {
+        int tid = buffer.getShort(position) & 0xffff;
+        int value = buffer.getInt(position + 2);
+        events.computeIfAbsent(tid, k -> new ArrayDeque<>()).add(value);
+      }
+    }
+
+    // Check that the method was sampled on the thread, and that the samples of the thread
+    // form a well nested call tree: each exit leaves the innermost entered method.
+    void checkSampled(String threadName, String methodName) {
+      Integer tid = null;
+      for (Map.Entry<Integer, String> entry : threads.entrySet()) {
+        if (entry.getValue().equals(threadName)) {
+          tid = entry.getKey();
+        }
+      }
+      if (tid == null || !events.containsKey(tid)) {
+        throw new Error("No samples for thread " + threadName);
+      }
+      boolean sampled = false;
+      ArrayDeque<Integer> stack = new ArrayDeque<>();
+      for (int value : events.get(tid)) {
+        int method = value & ~3;
+        int action = value & 3;
+        String name = methods.get(method);
+        if (name == null) {
+          throw new Error("Unknown method " + Integer.toHexString(method));
+        }
+        if (action == METHOD_ENTER) {
+          stack.push(method);
+          sampled |= name.equals(methodName);
+        } else if (action == METHOD_EXIT) {
+          if (stack.isEmpty() || stack.peek() != method) {
+            throw new Error("Exit from " + name + " on " + threadName + " does not match " +
+                (stack.isEmpty() ? "an empty stack" : methods.get(stack.peek())));
+          }
+          stack.pop();
+        } else {
+          throw new Error("Unexpected action " + action + " for " + name);
+        }
+      }
+      if (!sampled) {
+        throw new Error(methodName + " not sampled on " + threadName);
+      }
+    }
+  }
+
+  static void startSamplingTracing(String fileName, int intervalUs) throws Exception {
+    Class<?> c = Class.forName("dalvik.system.VMDebug");
+    Method m = c.getDeclaredMethod("startMethodTracing", String.class, Integer.TYPE,
+        Integer.TYPE, Boolean.TYPE, Integer.TYPE);
+    m.invoke(null, fileName, /* bufferSize */ 0, /* flags */ 0, /* samplingEnabled */ true,
+        intervalUs);
+  }
+
+  static void stopMethodTracing() throws Exception {
+    Class<?> c = Class.forName("dalvik.system.VMDebug");
+    c.getDeclaredMethod("stopMethodTracing").invoke(null);
+  }
+}
@@ -55,6 +55,7 @@ class DexAnalyze {
         << "    -analyze-strings (Analyze string data)\n"
         << "    -analyze-debug-info (Analyze debug info)\n"
         << "    -new-bytecode (Bytecode optimizations)\n"
+        << "    -analyze-native-methods (List native methods to promote, with -v 2)\n"
         << "    -i (Ignore Dex checksum and verification failures)\n"
         << "    -a (Run all experiments)\n"
         << "    -n <int> (run experiment with 1 .. n as argument)\n"
@@ -100,6 +101,8 @@ class DexAnalyze {
           exp_debug_info_ = true;
         } else if (arg == "-new-bytecode") {
           exp_bytecode_ = true;
+        } else if (arg == "-analyze-native-methods") {
+          exp_native_methods_ = true;
         } else if (arg == "-d") {
           dump_per_input_dex_ = true;
         } else if (!arg.empty() && arg[0] == '-') {
@@ -124,6 +127,7 @@ class DexAnalyze {
     bool exp_analyze_strings_ = false;
     bool exp_debug_info_ = false;
     bool exp_bytecode_ = false;
+    bool exp_native_methods_ = false;
     bool run_all_experiments_ = false;
     uint64_t experiment_max_ = 1u;
     std::vector<std::string> filenames_;
@@ -144,6 +148,9 @@ class DexAnalyze {
       if (options->run_all_experiments_ || options->exp_debug_info_) {
         experiments_.emplace_back(new AnalyzeDebugInfo);
       }
+      if (options->run_all_experiments_ || options->exp_native_methods_) {
+        experiments_.emplace_back(new AnalyzeNativeMethods);
+      }
       if (options->run_all_experiments_ || options->exp_bytecode_) {
         for (size_t i = 0; i < options->experiment_max_; ++i) {
           uint64_t exp_value = 0u;
@@ -21,13 +21,16 @@
 #include <inttypes.h>
 #include <iostream>
 #include <map>
+#include <string_view>
 #include <vector>
 
 #include "android-base/stringprintf.h"
+#include "base/leb128.h"
 #include "dex/class_accessor-inl.h"
 #include "dex/class_iterator.h"
 #include "dex/code_item_accessors-inl.h"
 #include "dex/dex_instruction-inl.h"
+#include "dex/modifiers.h"
 #include "dex/standard_dex_file.h"
 #include "dex/utf-inl.h"
 
@@ -617,5 +620,86 @@ void CodeMetrics::Dump(std::ostream& os, uint64_t total_size) const {
   os << "Low arg savings: " << Percent(low_arg_total * 2, total_size) << "\n";
 }
 
+void AnalyzeNativeMethods::ProcessDexFile(const DexFile& dex_file) {
+  for (ClassAccessor accessor : dex_file.GetClasses()) {
+    // Collect the @FastNative and @CriticalNative methods of the class.
+    std::map<uint32_t, uint32_t> annotated_methods;
+    const dex::AnnotationsDirectoryItem* annotations_dir =
+        dex_file.GetAnnotationsDirectory(accessor.GetClassDef());
+    if (annotations_dir != nullptr) {
+      const dex::MethodAnnotationsItem* method_annotations =
+          dex_file.GetMethodAnnotations(annotations_dir);
+      for (uint32_t i = 0; i < annotations_dir->methods_size_; ++i) {
+        const dex::AnnotationSetItem* annotation_set =
+            dex_file.GetMethodAnnotationSetItem(method_annotations[i]);
+        for (uint32_t j = 0; annotation_set != nullptr && j < annotation_set->size_; ++j) {
+          const uint8_t* annotation = dex_file.GetAnnotationItem(annotation_set, j)->annotation_;
+          std::string_view descriptor =
+              dex_file.StringByTypeIdx(dex::TypeIndex(DecodeUnsignedLeb128(&annotation)));
+          if (descriptor == "Ldalvik/annotation/optimization/FastNative;") {
+            annotated_methods.emplace(method_annotations[i].method_idx_, kAccFastNative);
+          } else if (descriptor == "Ldalvik/annotation/optimization/CriticalNative;") {
+            annotated_methods.emplace(method_annotations[i].method_idx_, kAccCriticalNative);
+          }
+        }
+      }
+    }
+
+    for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+      const uint32_t access_flags = method.GetAccessFlags();
+      if ((access_flags & kAccNative) == 0u) {
+        continue;
+      }
+      ++native_methods_;
+      auto it = annotated_methods.find(method.GetIndex());
+      if (it != annotated_methods.end()) {
+        if (it->second == kAccFastNative) {
+          ++fast_native_methods_;
+        } else {
+          ++critical_native_methods_;
+        }
+        continue;
+      }
+      if ((access_flags & kAccSynchronized) != 0u) {
+        ++synchronized_native_methods_;
+        continue;
+      }
+      const dex::MethodId& method_id = dex_file.GetMethodId(method.GetIndex());
+      std::string descriptor = std::string(dex_file.GetMethodDeclaringClassDescriptor(method_id)) +
+                               "->" + dex_file.GetMethodName(method_id) +
+                               dex_file.GetMethodSignature(method_id).ToString();
+      // Same rules as for @CriticalNative: static and no references.
+      bool critical = (access_flags & kAccStatic) != 0u &&
+                      strchr(dex_file.GetMethodShorty(method_id), 'L') == nullptr;
+      candidates_.emplace(descriptor, critical);
+    }
+  }
+}
+
+void AnalyzeNativeMethods::Dump(std::ostream& os, uint64_t total_size ATTRIBUTE_UNUSED) const {
+  const uint64_t critical_candidates =
+      std::count_if(candidates_.begin(), candidates_.end(), [](const auto& pair) {
+        return pair.second;
+      });
+  os << "Native methods: " << native_methods_ << "\n";
+  os << "@FastNative methods: " << Percent(fast_native_methods_, native_methods_) << "\n";
+  os << "@CriticalNative methods: " << Percent(critical_native_methods_, native_methods_) << "\n";
+  os << "Synchronized native methods: "
+     << Percent(synchronized_native_methods_, native_methods_) << "\n";
+  os << "Promotion candidates: " << Percent(candidates_.size(), native_methods_)
+     << ", of which could be critical: " << Percent(critical_candidates, native_methods_) << "\n";
+  if (verbose_level_ >= VerboseLevel::kEverything) {
+    // Only list methods as fast: critical ones need the native code to drop the JNIEnv* and
+    // jclass arguments.
+    for (const auto& pair : candidates_) {
+      os << "fast " << pair.first;
+      if (pair.second) {
+        os << "  # Or critical, with the @CriticalNative signature.";
+      }
+      os << "\n";
+    }
+  }
+}
+
 }  // namespace dexanalyze
 }  // namespace art
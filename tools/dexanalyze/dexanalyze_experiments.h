@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <map>
 #include <memory>
 #include <set>
 #include <unordered_map>
@@ -172,6 +173,24 @@ class CodeMetrics : public Experiment {
   uint64_t move_result_savings_ = 0u;
 };
 
+// Find the native methods that could be listed in a -XX:NativeMethodPromotionFile, the ones
+// that are neither annotated with @FastNative or @CriticalNative nor synchronized. With -v 2,
+// print them in the format of the promotion file.
+class AnalyzeNativeMethods : public Experiment {
+ public:
+  void ProcessDexFile(const DexFile& dex_file) override;
+
+  void Dump(std::ostream& os, uint64_t total_size) const override;
+
+ private:
+  uint64_t native_methods_ = 0u;
+  uint64_t fast_native_methods_ = 0u;
+  uint64_t critical_native_methods_ = 0u;
+  uint64_t synchronized_native_methods_ = 0u;
+  // Candidates, as in "Lpkg/Cls;->name(I)V", mapped to whether they could also be critical.
+  std::map<std::string, bool> candidates_;
+};
+
 }  // namespace dexanalyze
 }  // namespace art
 
@@ -48,6 +48,11 @@ TEST_F(DexAnalyzeTest, TestAnalyzeMultidex) {
   DexAnalyzeExec({ "-a", GetTestDexFileName("MultiDex") }, /*expect_success=*/ true);
 }
 
+TEST_F(DexAnalyzeTest, TestAnalyzeNativeMethods) {
+  DexAnalyzeExec({ "-analyze-native-methods", "-v", "2", GetTestDexFileName("MyClassNatives") },
+                 /*expect_success=*/ true);
+}
+
 TEST_F(DexAnalyzeTest, TestAnalizeCoreDex) {
   DexAnalyzeExec({ "-a", GetLibCoreDexFileNames()[0] }, /*expect_success=*/ true);
 }